@@ -13,5 +13,6 @@ public class AdvancedSessions : ModuleRules
        // PrivateIncludePaths.AddRange(new string[] { "AdvancedSessions/Private"/*, "OnlineSubsystemSteam/Private"*/ });
        // PublicIncludePaths.AddRange(new string[] { "AdvancedSessions/Public" });
         PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "OnlineSubsystem", "CoreUObject", "OnlineSubsystemUtils", "Networking", "Sockets"/*"Voice", "OnlineSubsystemSteam"*/ });
+        PrivateDependencyModuleNames.AddRange(new string[] { "Icmp" });
     }
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "BlueprintDataDefinitions.h"
+#include "Interfaces/OnlineFriendsInterface.h"
+#include "Interfaces/OnlinePresenceInterface.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "AdvancedFriendsCache.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBlueprintFriendsCacheRowDelegate, int32, FriendIndex, const FBPFriendInfo&, Friend);
+
+// Keeps the local player's friends list between reads and applies presence changes to it as they arrive.
+// Every friend keeps the same index for as long as they stay on the list, so a friends panel can bind
+// one row per index and only redraw the rows these events name.
+UCLASS()
+class UAdvancedFriendsCache : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	UPROPERTY(BlueprintAssignable, Category = "Online|AdvancedFriends|FriendsCache")
+	FBlueprintFriendsCacheRowDelegate OnFriendAdded;
+
+	UPROPERTY(BlueprintAssignable, Category = "Online|AdvancedFriends|FriendsCache")
+	FBlueprintFriendsCacheRowDelegate OnFriendChanged;
+
+	// Passes the last known info, the index is free to be reused afterwards
+	UPROPERTY(BlueprintAssignable, Category = "Online|AdvancedFriends|FriendsCache")
+	FBlueprintFriendsCacheRowDelegate OnFriendRemoved;
+
+	// Reads the friends list again and reports the differences, also starts listening for presence and list changes
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedFriends|FriendsCache")
+	void RefreshFriends(APlayerController* PlayerController);
+
+	// Indices run up to this, some may be empty after friends were removed
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedFriends|FriendsCache")
+	int32 GetNumFriendSlots() const { return Slots.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedFriends|FriendsCache")
+	int32 GetNumFriends() const { return FriendIndices.Num(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedFriends|FriendsCache")
+	bool GetFriendAt(int32 FriendIndex, FBPFriendInfo& Friend) const;
+
+	// INDEX_NONE when they are not on the list
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedFriends|FriendsCache")
+	int32 FindFriendIndex(const FBPUniqueNetId& FriendUniqueNetId) const;
+
+	// Every friend in the order the online subsystem last listed them, for callers that want the whole list
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedFriends|FriendsCache")
+	void GetCachedFriends(TArray<FBPFriendInfo>& FriendsList) const;
+
+	// Diffs a friends list read from the online subsystem against the cache
+	void ApplyFriendsList(int32 LocalUserNum, const TArray<TSharedRef<FOnlineFriend>>& FriendList);
+
+	// Copies the friend into Info, returns whether anything differed
+	static bool UpdateFriendInfo(const FOnlineFriend& Friend, FBPFriendInfo& Info);
+	static bool UpdatePresenceInfo(const FOnlineUserPresence& Presence, FBPFriendInfo& Info);
+
+private:
+
+	void BindOnlineDelegates(int32 LocalUserNum);
+	void UnbindOnlineDelegates();
+
+	void OnPresenceReceived(const FUniqueNetId& UserId, const TSharedRef<FOnlineUserPresence>& Presence);
+	void OnFriendsChanged();
+	void OnReadFriendsListCompleted(int32 LocalUserNum, bool bWasSuccessful, const FString& ListName, const FString& ErrorString);
+
+	struct FFriendSlot
+	{
+		FBPFriendInfo Info;
+		bool bValid = false;
+	};
+
+	TArray<FFriendSlot> Slots;
+	TArray<int32> FreeSlots;
+
+	// Slot indices in the order of the last list read, slots are reused so their own order means nothing
+	TArray<int32> ListOrder;
+
+	// Keyed by FUniqueNetId::ToString
+	TMap<FString, int32> FriendIndices;
+
+	int32 BoundLocalUserNum = INDEX_NONE;
+	FDelegateHandle PresenceReceivedHandle;
+	FDelegateHandle FriendsChangeHandle;
+};
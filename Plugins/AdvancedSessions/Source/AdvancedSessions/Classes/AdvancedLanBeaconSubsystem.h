@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "BlueprintDataDefinitions.h"
+#include "Containers/Ticker.h"
+#include "IPAddress.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "AdvancedLanBeaconSubsystem.generated.h"
+
+class FSocket;
+class APlayerController;
+
+// Session info for a result found only by the LAN beacon. No online subsystem knows this class, so these results cannot
+// go through JoinSession or GetResolvedConnectString. UAdvancedLanBeaconSubsystem::JoinLanBeaconSession travels to
+// HostAddr instead.
+class FAdvancedLanSessionInfo : public FOnlineSessionInfo
+{
+public:
+	FAdvancedLanSessionInfo(const TSharedRef<FInternetAddr>& InHostAddr, const FString& InSessionId);
+
+	virtual const uint8* GetBytes() const override { return nullptr; }
+	virtual int32 GetSize() const override { return sizeof(FAdvancedLanSessionInfo); }
+	virtual bool IsValid() const override;
+	virtual FString ToString() const override { return SessionId->ToString(); }
+	virtual FString ToDebugString() const override;
+	virtual const FUniqueNetId& GetSessionId() const override { return *SessionId; }
+
+	// The host's game address and port
+	TSharedPtr<FInternetAddr> HostAddr;
+
+	// The id the host's session interface gave the session, so results found both ways are merged. Its type is
+	// LanBeaconSessionType, which is how a beacon result is told apart from one the subsystem found.
+	FUniqueNetIdStringRef SessionId;
+
+	static const FName LanBeaconSessionType;
+};
+
+// Finds LAN hosts in a fraction of a second instead of waiting out the online subsystem's LAN search.
+// A host binds the first free port in [BasePort, BasePort + NumPorts) and answers probes with a compact binary
+// description of its game session. A query sends one probe to every port in the range on both the broadcast and the
+// loopback address and collects answers for a short window, so several instances on one machine find each other.
+// FindSessionsAdvanced runs a query alongside a LAN search when given a LanBeaconWindow.
+// A host only answers well formed probes, and at most MaxRepliesPerSource times a second to any one address.
+UCLASS()
+class ADVANCEDSESSIONS_API UAdvancedLanBeaconSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// Answers probes with the current game session until stopped, does nothing while already advertising.
+	// Started automatically when CreateAdvancedSession creates a LAN session. Stops by itself when the game session
+	// ends or is destroyed, call it again to advertise a session that was restarted.
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|LanBeacon")
+	bool StartLanBeacon();
+
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|LanBeacon")
+	void StopLanBeacon();
+
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedSessions|LanBeacon")
+	bool IsAdvertising() const { return HostSocket != nullptr; }
+
+	// The beacon port this instance answers on, 0 while not advertising
+	int32 GetAdvertisedPort() const;
+
+	// True for a result only the LAN beacon found, those have to be joined with JoinLanBeaconSession
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedSessions|LanBeacon")
+	static bool IsLanBeaconResult(const FBlueprintSessionResult& SearchResult);
+
+	// The host's game address of a LAN beacon result, as ip:port
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedSessions|LanBeacon")
+	static bool GetLanBeaconConnectString(const FBlueprintSessionResult& SearchResult, FString& ConnectString);
+
+	// Travels PlayerController to the host of a LAN beacon result. Join Session cannot take these results, the Null
+	// subsystem reads its own private session info from whatever it is handed. Returns false for any other result.
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|LanBeacon")
+	static bool JoinLanBeaconSession(APlayerController* PlayerController, const FBlueprintSessionResult& SearchResult);
+
+	// Called on the game thread once the window is up, bSuccess is false if no probe could be sent
+	typedef TFunction<void(bool bSuccess, TArray<FOnlineSessionSearchResult>&& Results)> FOnLanBeaconQueryComplete;
+
+	// Probes the LAN and reports every host of this build that answered within Window seconds
+	void QueryLanBeacons(float Window, FOnLanBeaconQueryComplete&& OnComplete);
+
+	static constexpr int32 BasePort = 14650;
+	static constexpr int32 NumPorts = 8;
+
+	// Anything larger is not sent, extra settings that do not fit are left out of the description
+	static constexpr int32 MaxPacketSize = 1024;
+
+	// The magic, the version, the packet type and the query's nonce, anything else is not a probe
+	static constexpr int32 ProbeSize = sizeof(uint32) + 2 * sizeof(uint8) + sizeof(uint64);
+
+	// A response is up to MaxPacketSize bytes for a ProbeSize probe, so replies to any one address are capped per second
+	static constexpr int32 MaxRepliesPerSource = 8;
+
+	// Sources tracked for the cap at once, probes from further addresses go unanswered until the window rolls over
+	static constexpr int32 MaxTrackedSources = 256;
+
+private:
+
+	struct FQuery
+	{
+		FSocket* Socket = nullptr;
+		uint64 Nonce = 0;
+		double SendTime = 0.0;
+		double EndTime = 0.0;
+		TArray<FOnlineSessionSearchResult> Results;
+		TSet<FString> SessionIdsFound;
+		FOnLanBeaconQueryComplete OnComplete;
+	};
+
+	struct FReplyBudget
+	{
+		double WindowStart = 0.0;
+		int32 NumReplies = 0;
+	};
+
+	bool Tick(float DeltaTime);
+	void EnsureTicking();
+
+	void PollHost();
+
+	// Whether From may get another reply this second, and counts it if so
+	bool ConsumeReplyBudget(const FInternetAddr& From, double Now);
+
+	void OnGameSessionEnded(FName SessionName, bool bWasSuccessful);
+	void PollQuery(FQuery& Query);
+
+	// Writes the response to a probe, false when there is no game session to describe
+	bool WriteDescription(uint64 Nonce, TArray<uint8>& OutPacket) const;
+
+	// Reads a response into a search result, false if it is malformed or not for this build
+	static bool ReadDescription(const uint8* Data, int32 Size, uint64 Nonce, const FInternetAddr& From, double PingSeconds, FOnlineSessionSearchResult& OutResult);
+
+	static void DestroySocket(FSocket*& Socket);
+
+	FSocket* HostSocket = nullptr;
+	TArray<TUniquePtr<FQuery>> Queries;
+
+	// Keyed by the source's IP without its port
+	TMap<FString, FReplyBudget> ReplyBudgets;
+
+	FDelegateHandle EndSessionHandle;
+	FDelegateHandle DestroySessionHandle;
+
+	FTSTicker::FDelegateHandle TickHandle;
+};
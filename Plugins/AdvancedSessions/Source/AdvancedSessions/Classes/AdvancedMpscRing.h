@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * Bounded lock-free ring that carries fixed size entries from any number of producer threads to one consumer thread.
+ * Pushing never allocates or blocks, a full ring refuses the entry instead. Entries are written in place, so
+ * EntryType should be a plain struct sized for the largest payload.
+ */
+template<typename EntryType, uint32 InCapacity>
+class TAdvancedMpscRing
+{
+public:
+
+	static constexpr uint32 Capacity = InCapacity;
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	TAdvancedMpscRing()
+	{
+		for (uint32 Index = 0; Index < Capacity; Index++)
+		{
+			Slots[Index].Sequence.store(Index, std::memory_order_relaxed);
+		}
+	}
+
+	// Claims a slot and calls Fill(EntryType&) to write it, false without calling Fill when the ring is full
+	template<typename FillType>
+	bool TryPush(FillType&& Fill)
+	{
+		// A slot is free for position Pos once the consumer has stored Pos into its sequence
+		uint32 Pos = WriteIndex.load(std::memory_order_relaxed);
+		FSlot* Slot = nullptr;
+		for (;;)
+		{
+			Slot = &Slots[Pos & (Capacity - 1)];
+			const int32 Diff = static_cast<int32>(Slot->Sequence.load(std::memory_order_acquire) - Pos);
+			if (Diff == 0)
+			{
+				if (WriteIndex.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (Diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				Pos = WriteIndex.load(std::memory_order_relaxed);
+			}
+		}
+
+		Fill(Slot->Entry);
+
+		Slot->Sequence.store(Pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// TryPush, counting the entry as dropped when the ring is full
+	template<typename FillType>
+	bool Push(FillType&& Fill)
+	{
+		if (TryPush(Forward<FillType>(Fill)))
+			return true;
+
+		Dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	//Calls Visitor for every queued entry in order, only ever from the consumer thread
+	template<typename VisitorType>
+	void Drain(VisitorType&& Visitor)
+	{
+		for (;;)
+		{
+			FSlot& Slot = Slots[ReadIndex & (Capacity - 1)];
+			if (Slot.Sequence.load(std::memory_order_acquire) != ReadIndex + 1)
+			{
+				return;
+			}
+
+			Visitor(static_cast<const EntryType&>(Slot.Entry));
+
+			Slot.Sequence.store(ReadIndex + Capacity, std::memory_order_release);
+			ReadIndex++;
+		}
+	}
+
+	//Claimed slots not yet drained, including ones still being written
+	int32 NumQueued() const { return static_cast<int32>(WriteIndex.load(std::memory_order_relaxed) - ReadIndex); }
+
+	//Number of entries Push lost to a full ring since the last call
+	uint32 TakeDropped() { return Dropped.exchange(0, std::memory_order_relaxed); }
+
+private:
+
+	struct FSlot
+	{
+		std::atomic<uint32> Sequence;
+		EntryType Entry;
+	};
+
+	FSlot Slots[Capacity];
+	std::atomic<uint32> WriteIndex{ 0 };
+	std::atomic<uint32> Dropped{ 0 };
+	uint32 ReadIndex = 0;
+};
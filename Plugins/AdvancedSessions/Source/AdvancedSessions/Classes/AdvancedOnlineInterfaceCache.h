@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "OnlineSubsystem.h"
+#include "Interfaces/VoiceInterface.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "Interfaces/OnlineFriendsInterface.h"
+
+class UWorld;
+
+// Remembers which online subsystem and interfaces belong to a world, so library functions that Blueprints call every
+// frame do not go through the online subsystem module each time. A hit is one map lookup, the cached subsystem is not
+// checked again. Entries are dropped when their world is cleaned up, when a subsystem instance is created and when any
+// module is unloaded, which covers the online subsystem modules shutting their instances down. Code that destroys an
+// instance itself with IOnlineSubsystem::Destroy must call InvalidateAll, no delegate reports that. An interface that
+// expired means its subsystem went away, so the entry is dropped and looked up again. A null world means the default
+// instance. Game thread only.
+class ADVANCEDSESSIONS_API FAdvancedOnlineInterfaceCache
+{
+public:
+
+	static IOnlineSubsystem* GetSubsystem(const UWorld* World, FName SystemName = NAME_None);
+	static IOnlineVoicePtr GetVoiceInterface(const UWorld* World = nullptr);
+	static IOnlineSessionPtr GetSessionInterface(const UWorld* World = nullptr);
+	static IOnlineFriendsPtr GetFriendsInterface(const UWorld* World = nullptr);
+
+	static void Invalidate(const UWorld* World);
+	static void InvalidateAll();
+
+	// Lookups for World that do not name a subsystem, which is every library function and callback proxy, resolve to
+	// SystemName rather than the default platform service. Lets tests drive the proxies through a subsystem that is not
+	// the configured default. Passing NAME_None clears it, so does cleaning up the world.
+	static void SetDefaultSubsystemOverride(const UWorld* World, FName SystemName);
+
+	// Hooks the delegates that invalidate the cache, called by the module
+	static void Startup();
+	static void Shutdown();
+
+private:
+
+	struct FEntry
+	{
+		// Valid until one of the invalidation hooks fires
+		IOnlineSubsystem* Subsystem = nullptr;
+
+		TWeakPtr<IOnlineVoice, ESPMode::ThreadSafe> Voice;
+		TWeakPtr<IOnlineSession, ESPMode::ThreadSafe> Session;
+		TWeakPtr<IOnlineFriends, ESPMode::ThreadSafe> Friends;
+	};
+
+	// bOutCreated is set when the entry was made by this call rather than found
+	static FEntry* FindEntry(const UWorld* World, FName SystemName, bool* bOutCreated = nullptr);
+	static void RemoveEntry(const UWorld* World, FName SystemName);
+
+	// Pins the cached interface, or fetches it from the subsystem when it was never asked for or has expired
+	template<typename InterfaceType, typename GetterType>
+	static TSharedPtr<InterfaceType, ESPMode::ThreadSafe> Resolve(const UWorld* World, TWeakPtr<InterfaceType, ESPMode::ThreadSafe> FEntry::* Cached, GetterType Getter)
+	{
+		bool bCreated = false;
+		FEntry* Entry = FindEntry(World, NAME_None, &bCreated);
+		if (!Entry)
+			return nullptr;
+
+		TSharedPtr<InterfaceType, ESPMode::ThreadSafe> Interface = (Entry->*Cached).Pin();
+		if (Interface.IsValid())
+			return Interface;
+
+		// Subsystems hold their interfaces until they shut down, so the rest of an older entry is suspect as well
+		if (!bCreated)
+		{
+			RemoveEntry(World, NAME_None);
+			Entry = FindEntry(World, NAME_None);
+			if (!Entry)
+				return nullptr;
+		}
+
+		Interface = Getter(Entry->Subsystem);
+		Entry->*Cached = Interface;
+		return Interface;
+	}
+
+	// A lookup by NAME_None for World resolves to the override, if it has one
+	static FName ResolveSystemName(const UWorld* World, FName SystemName);
+
+	static TMap<TPair<TObjectKey<UWorld>, FName>, FEntry> Entries;
+	static TMap<TObjectKey<UWorld>, FName> DefaultOverrides;
+	static FDelegateHandle WorldCleanupHandle;
+	static FDelegateHandle SubsystemCreatedHandle;
+	static FDelegateHandle ModulesChangedHandle;
+};
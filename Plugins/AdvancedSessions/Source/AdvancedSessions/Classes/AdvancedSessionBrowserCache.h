@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "FindSessionsCallbackProxy.h"
+#include "BlueprintDataDefinitions.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "AdvancedSessionBrowserCache.generated.h"
+
+class UFindSessionsCallbackProxyAdvanced;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FBlueprintSessionBrowserDelta, const TArray<FBlueprintSessionResult>&, Added, const TArray<FBlueprintSessionResult>&, Updated, const TArray<FString>&, RemovedSessionIds);
+
+// Query the browser keeps refreshing
+USTRUCT(BlueprintType)
+struct FSessionBrowserQuery
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedSessions|SessionBrowser")
+	int32 MaxResults = 100;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedSessions|SessionBrowser")
+	bool bUseLAN = false;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedSessions|SessionBrowser")
+	EBPServerPresenceSearchType ServerTypeToSearch = EBPServerPresenceSearchType::AllServers;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedSessions|SessionBrowser")
+	TArray<FSessionsSearchSetting> Filters;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedSessions|SessionBrowser")
+	bool bEmptyServersOnly = false;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedSessions|SessionBrowser")
+	bool bNonEmptyServersOnly = false;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedSessions|SessionBrowser")
+	bool bSecureServersOnly = false;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedSessions|SessionBrowser")
+	bool bSearchLobbies = true;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedSessions|SessionBrowser")
+	int32 MinSlotsAvailable = 0;
+};
+
+// Keeps the results of a session search around and refreshes them in the background.
+// Instead of handing out a new array every search, it reports which sessions were added, changed or went away,
+// so a server browser only touches the rows that changed. Sessions that are not seen again within the TTL are removed.
+UCLASS()
+class UAdvancedSessionBrowserCache : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// Called after every refresh that changed something, and while a refresh is still streaming in results
+	UPROPERTY(BlueprintAssignable, Category = "Online|AdvancedSessions|SessionBrowser")
+	FBlueprintSessionBrowserDelta OnSessionsChanged;
+
+	// Starts searching with Query right away and then every RefreshInterval seconds until StopBrowsing.
+	// Results from a previous query are kept and age out through the TTL.
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionBrowser")
+	void StartBrowsing(APlayerController* PlayerController, const FSessionBrowserQuery& Query, float RefreshInterval = 30.0f, float TimeToLive = 90.0f);
+
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionBrowser")
+	void StopBrowsing();
+
+	// Searches now instead of waiting for the next refresh, does nothing while a search is running
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionBrowser")
+	void RefreshNow();
+
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedSessions|SessionBrowser")
+	bool IsRefreshing() const { return ActiveSearch != nullptr; }
+
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedSessions|SessionBrowser")
+	int32 GetNumCachedSessions() const { return Sessions.Num(); }
+
+	// Reads a page out of the cache without querying the online subsystem, sessions stay in the order they were first found
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionBrowser")
+	void GetPage(int32 PageIndex, int32 PageSize, TArray<FBlueprintSessionResult>& PageResults) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionBrowser")
+	bool FindCachedSession(const FString& SessionId, FBlueprintSessionResult& Result) const;
+
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedSessions|SessionBrowser")
+	static FString GetSessionId(const FBlueprintSessionResult& Result);
+
+private:
+
+	UFUNCTION()
+	void OnSearchResults(const TArray<FBlueprintSessionResult>& Results);
+
+	UFUNCTION()
+	void OnSearchFinished(const TArray<FBlueprintSessionResult>& Results);
+
+	// Drops everything not seen within the TTL
+	void ExpireSessions(TArray<FString>& RemovedSessionIds);
+
+	void BroadcastDelta(TArray<FString>&& RemovedSessionIds);
+
+	struct FCachedSession
+	{
+		FBlueprintSessionResult Result;
+		double LastSeen;
+	};
+
+	// In the order they were found, SessionIndices maps a session ID to its slot
+	TArray<FCachedSession> Sessions;
+	TMap<FString, int32> SessionIndices;
+
+	// Collected until the next broadcast
+	TArray<FBlueprintSessionResult> PendingAdded;
+	TArray<FBlueprintSessionResult> PendingUpdated;
+
+	UPROPERTY()
+	TObjectPtr<UFindSessionsCallbackProxyAdvanced> ActiveSearch;
+
+	TWeakObjectPtr<APlayerController> PlayerControllerWeakPtr;
+	FSessionBrowserQuery CurrentQuery;
+	double SessionTimeToLive = 90.0;
+	FTimerHandle RefreshHandle;
+};
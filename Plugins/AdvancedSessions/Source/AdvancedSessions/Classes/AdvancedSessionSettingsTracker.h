@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "BlueprintDataDefinitions.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "AdvancedSessionSettingsTracker.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBlueprintSessionSettingsPushed, bool, bWasSuccessful, const TArray<FName>&, ChangedKeys);
+
+// Lets a host change extra session settings as often as it likes while only updating the session when something
+// actually changed. Values are compared against what the session currently advertises, changes are collected for
+// CoalesceInterval seconds and then go out together in one UpdateSession that touches only the changed keys.
+// Changes made while an update is in flight go out with the next one. Failed keys are retried with a growing delay,
+// and dropped after MaxUpdateRetries failures in a row.
+UCLASS()
+class UAdvancedSessionSettingsTracker : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// Called after every update that went out, with the keys it carried
+	UPROPERTY(BlueprintAssignable, Category = "Online|AdvancedSessions|SessionSettings")
+	FBlueprintSessionSettingsPushed OnSettingsPushed;
+
+	// How long changes are collected before they are sent, 0 sends on the next tick
+	UPROPERTY(BlueprintReadWrite, Category = "Online|AdvancedSessions|SessionSettings")
+	float CoalesceInterval = 2.0f;
+
+	// Stages a setting, it only goes out if it differs from what is advertised once the interval is up
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionSettings")
+	void SetSessionSetting(const FSessionPropertyKeyPair& Setting);
+
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionSettings")
+	void SetSessionSettings(const TArray<FSessionPropertyKeyPair>& Settings);
+
+	// Sends whatever is staged now instead of waiting for the interval
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSessions|SessionSettings")
+	void FlushSessionSettings();
+
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedSessions|SessionSettings")
+	int32 GetNumPendingSettings() const { return PendingSettings.Num(); }
+
+private:
+
+	void ScheduleFlush();
+	void OnUpdateCompleted(FName SessionName, bool bWasSuccessful);
+
+	IOnlineSessionPtr GetSessions() const;
+
+	// Staged since the last update went out, the latest value per key wins
+	TMap<FName, FVariantData> PendingSettings;
+
+	// Carried by the update in flight, put back into PendingSettings if it fails
+	TMap<FName, FVariantData> InFlightSettings;
+
+	// Keys whose last update failed, sent even though the session's copy already matches
+	TSet<FName> ForcedKeys;
+
+	// Failed updates in a row, each one doubles the wait before the next flush
+	int32 NumFailedUpdates = 0;
+
+	bool bUpdateInFlight = false;
+	FTimerHandle FlushHandle;
+	FDelegateHandle UpdateCompleteHandle;
+};
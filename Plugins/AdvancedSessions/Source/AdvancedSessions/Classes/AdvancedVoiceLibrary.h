@@ -24,7 +24,7 @@ DECLARE_LOG_CATEGORY_EXTERN(AdvancedVoiceLog, Log, All);
 
 
 UCLASS()
-class UAdvancedVoiceLibrary : public UBlueprintFunctionLibrary
+class ADVANCEDSESSIONS_API UAdvancedVoiceLibrary : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
 public:
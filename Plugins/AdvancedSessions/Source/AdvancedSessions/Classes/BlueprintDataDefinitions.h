@@ -14,6 +14,7 @@
 #include "GameFramework/PlayerController.h"
 #include "Modules/ModuleManager.h"
 #include "OnlineSubsystemUtilsClasses.h"
+#include "AdvancedOnlineInterfaceCache.h"
 #include "BlueprintDataDefinitions.generated.h"	
 
 UENUM(BlueprintType)
@@ -107,6 +108,16 @@ enum class EBPServerPresenceSearchType : uint8
 	DedicatedServersOnly
 };
 
+// How FilterSessionResults orders what passes the filters
+UENUM(BlueprintType)
+enum class EBPSessionResultSort : uint8
+{
+	// Keep the search order
+	None,
+	LowestPing,
+	MostOpenSlots
+};
+
 // Wanted this to be switchable in the editor
 UENUM(BlueprintType)
 enum class EBPOnlinePresenceState : uint8
@@ -351,7 +362,7 @@ struct FOnlineSubsystemBPCallHelperAdvanced
 {
 public:
 	FOnlineSubsystemBPCallHelperAdvanced(const TCHAR* CallFunctionContext, UWorld* World, FName SystemName = NAME_None)
-		: OnlineSub(Online::GetSubsystem(World, SystemName))
+		: OnlineSub(FAdvancedOnlineInterfaceCache::GetSubsystem(World, SystemName))
 		, FunctionContext(CallFunctionContext)
 	{
 		if (OnlineSub == nullptr)
@@ -26,15 +26,24 @@ class UFindSessionsCallbackProxyAdvanced : public UOnlineBlueprintCallProxyBase
 	UPROPERTY(BlueprintAssignable)
 	FBlueprintFindSessionsResultDelegate OnFailure;
 
+	// Called with everything found so far when one search of an AllServers query finishes before the other
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintFindSessionsResultDelegate OnPartialResults;
+
 	// Searches for advertised sessions with the default online subsystem and includes an array of filters
+	// SearchTimeout is in seconds, when it runs out the query finishes with whatever was found so far. 0 waits forever.
+	// LAN searches on the Null subsystem can also probe the LAN beacon for LanBeaconWindow seconds, 0 (the default) leaves it off.
+	// bLanBeaconOnly skips the subsystem's own LAN search, so the query finishes as soon as the window is up.
+	// A session the subsystem finds as well is reported as the subsystem's result, the rest are joined with JoinLanBeaconSession.
 	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", AutoCreateRefTerm="Filters"), Category = "Online|AdvancedSessions")
-	static UFindSessionsCallbackProxyAdvanced* FindSessionsAdvanced(UObject* WorldContextObject, class APlayerController* PlayerController, int32 MaxResults, bool bUseLAN, EBPServerPresenceSearchType ServerTypeToSearch, const TArray<FSessionsSearchSetting> &Filters, bool bEmptyServersOnly = false, bool bNonEmptyServersOnly = false, bool bSecureServersOnly = false, bool bSearchLobbies = true, int MinSlotsAvailable = 0);
+	static ADVANCEDSESSIONS_API UFindSessionsCallbackProxyAdvanced* FindSessionsAdvanced(UObject* WorldContextObject, class APlayerController* PlayerController, int32 MaxResults, bool bUseLAN, EBPServerPresenceSearchType ServerTypeToSearch, const TArray<FSessionsSearchSetting> &Filters, bool bEmptyServersOnly = false, bool bNonEmptyServersOnly = false, bool bSecureServersOnly = false, bool bSearchLobbies = true, int MinSlotsAvailable = 0, float SearchTimeout = 15.0f, float LanBeaconWindow = 0.0f, bool bLanBeaconOnly = false);
 
 	static bool CompareVariants(const FVariantData &A, const FVariantData &B, EOnlineComparisonOpRedux Comparator);
 	
 	// Filters an array of session results by the given search parameters, returns a new array with the filtered results
+	// Optionally orders them by SortBy and keeps only the best TopK, 0 keeps all of them
 	UFUNCTION(BluePrintCallable, meta = (Category = "Online|AdvancedSessions"))
-	static void FilterSessionResults(const TArray<FBlueprintSessionResult> &SessionResults, const TArray<FSessionsSearchSetting> &Filters, TArray<FBlueprintSessionResult> &FilteredResults);
+	static ADVANCEDSESSIONS_API void FilterSessionResults(const TArray<FBlueprintSessionResult> &SessionResults, const TArray<FSessionsSearchSetting> &Filters, TArray<FBlueprintSessionResult> &FilteredResults, EBPSessionResultSort SortBy = EBPSessionResultSort::None, int32 TopK = 0);
 	
 	// Removed, the default built in versions work fine in the normal FindSessionsCallbackProxy
 	/*UFUNCTION(BlueprintPure, Category = "Online|Session")
@@ -55,14 +64,46 @@ class UFindSessionsCallbackProxyAdvanced : public UOnlineBlueprintCallProxyBase
 	// End of UOnlineBlueprintCallProxyBase interface
 
 private:
-	// Internal callback when the session search completes, calls out to the public success/failure callbacks
+	// Internal callback when a session search completes, merges whichever search finished and calls out to the public callbacks
 	void OnCompleted(bool bSuccess);
 
+	// Merges a finished search into SessionSearchResults
+	void MergeResults(const FOnlineSessionSearch& Search);
+
+	// Merges what the LAN beacon found, applying the filters the subsystem would have applied on the host
+	void OnLanBeaconCompleted(bool bSuccess, TArray<FOnlineSessionSearchResult>&& Results);
+
+	bool AllSearchesDone() const;
+
+	// Calls out to the public success/failure callbacks with everything found, at most once.
+	// bCancelRunning cancels any of our searches the subsystem is still running, used when giving up on a timeout.
+	void Finish(bool bCancelRunning = false);
+
+	void OnTimeout();
+
+	// Whether the dedicated search runs alongside the presence search
 	bool bRunSecondSearch;
-	bool bIsOnSecondSearch;
+
+	// Set once a search's results have been merged
+	bool bPresenceSearchDone;
+	bool bDedicatedSearchDone;
+
+	// The subsystem ignored the dedicated search because it only runs one at a time, it starts once the presence search is done
+	bool bDedicatedSearchQueued;
+
+	bool bFinished;
+
+	// Set while the LAN beacon query runs, and once it found anything or came back empty without an error
+	bool bLanBeaconPending;
+	bool bLanBeaconSucceeded;
+
+	FTimerHandle TimeoutHandle;
 
 	TArray<FBlueprintSessionResult> SessionSearchResults;
 
+	// Session IDs already in SessionSearchResults, and where they are
+	TMap<FString, int32> SessionIdsFound;
+
 private:
 	// The player controller triggering things
 	TWeakObjectPtr<APlayerController> PlayerControllerWeakPtr;
@@ -104,6 +145,15 @@ private:
 	// Min slots requires to search
 	int MinSlotsAvailable;
 
+	// Seconds to wait for all searches before finishing with partial results
+	float SearchTimeout;
+
+	// Seconds to collect LAN beacon answers for, 0 does not probe
+	float LanBeaconWindow;
+
+	// Whether the beacon is the only LAN search
+	bool bLanBeaconOnly;
+
 	// The world context object in which this call is taking place
 	TWeakObjectPtr<UObject> WorldContextObject;
 };
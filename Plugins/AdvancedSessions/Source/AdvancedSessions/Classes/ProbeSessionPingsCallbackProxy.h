@@ -0,0 +1,66 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "FindSessionsCallbackProxy.h"
+#include "BlueprintDataDefinitions.h"
+#include "ProbeSessionPingsCallbackProxy.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBlueprintSessionPingUpdated, int32, ResultIndex, int32, PingInMs);
+
+UENUM(BlueprintType)
+enum class EBPSessionPingProbe : uint8
+{
+	// ICMP echo to the host, needs no listener but is often firewalled
+	Icmp,
+	// UDP echo to the game port, only for hosts that run their own echo responder, the engine's net driver does not answer.
+	// The responder has to send every datagram back unchanged.
+	Udp
+};
+
+UCLASS(MinimalAPI)
+class UProbeSessionPingsCallbackProxy : public UOnlineBlueprintCallProxyBase
+{
+	GENERATED_UCLASS_BODY()
+
+	// Called every time a probe answers or gives up, with the index into the results that were passed in
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintSessionPingUpdated OnPingUpdated;
+
+	// Called once every probe is done, with the results and their measured pings
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintFindSessionsResultDelegate OnCompleted;
+
+	// Measures the ping to each result's host, at most MaxInFlight at a time, and writes it into PingInMs.
+	// Hosts that do not answer within Timeout seconds keep the ping the search reported.
+	// Results without an IP connect string (Steam P2P and the like) keep the ping the search reported.
+	// Udp only measures hosts that run an echo responder on their game port, the game itself does not answer, so
+	// without one every probe times out and every result keeps the ping the search reported.
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "Online|AdvancedSessions")
+	static ADVANCEDSESSIONS_API UProbeSessionPingsCallbackProxy* ProbeSessionPings(UObject* WorldContextObject, const TArray<FBlueprintSessionResult>& SessionResults, EBPSessionPingProbe ProbeType = EBPSessionPingProbe::Icmp, int32 MaxInFlight = 8, float Timeout = 1.0f);
+
+	// UOnlineBlueprintCallProxyBase interface
+	virtual void Activate() override;
+	// End of UOnlineBlueprintCallProxyBase interface
+
+private:
+	// Starts probes until MaxInFlight are running or none are left
+	void StartProbes();
+
+	void OnProbeCompleted(int32 ResultIndex, bool bSuccess, float Seconds);
+
+	TArray<FBlueprintSessionResult> Results;
+
+	// Result index and the address to probe, in the order they are started
+	TArray<TPair<int32, FString>> PendingProbes;
+	int32 NextProbe;
+	int32 ProbesInFlight;
+
+	EBPSessionPingProbe ProbeType;
+	int32 MaxInFlight;
+	float Timeout;
+	bool bFinished;
+
+	// The world context object in which this call is taking place
+	TWeakObjectPtr<UObject> WorldContextObject;
+};
@@ -0,0 +1,238 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvancedFriendsCache.h"
+#include "GetFriendsCallbackProxy.h"
+#include "Online.h"
+#include "OnlineSubsystemUtils.h"
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+
+//////////////////////////////////////////////////////////////////////////
+// UAdvancedFriendsCache
+
+template<typename T>
+static bool AssignIfDifferent(T& Target, const T& Value)
+{
+	if (Target == Value)
+		return false;
+
+	Target = Value;
+	return true;
+}
+
+bool UAdvancedFriendsCache::UpdatePresenceInfo(const FOnlineUserPresence& Presence, FBPFriendInfo& Info)
+{
+	// The presence flags are bitfields, hence the casts
+	const EBPOnlinePresenceState State = ((EBPOnlinePresenceState)((int32)Presence.Status.State));
+
+	bool bChanged = false;
+	bChanged |= AssignIfDifferent(Info.OnlineState, State);
+	bChanged |= AssignIfDifferent(Info.bIsPlayingSameGame, (bool)Presence.bIsPlayingThisGame);
+	bChanged |= AssignIfDifferent(Info.PresenceInfo.bIsOnline, (bool)Presence.bIsOnline);
+	bChanged |= AssignIfDifferent(Info.PresenceInfo.bHasVoiceSupport, (bool)Presence.bHasVoiceSupport);
+	bChanged |= AssignIfDifferent(Info.PresenceInfo.bIsPlaying, (bool)Presence.bIsPlaying);
+	bChanged |= AssignIfDifferent(Info.PresenceInfo.PresenceState, State);
+	bChanged |= AssignIfDifferent(Info.PresenceInfo.StatusString, Presence.Status.StatusStr);
+	bChanged |= AssignIfDifferent(Info.PresenceInfo.bIsJoinable, (bool)Presence.bIsJoinable);
+	bChanged |= AssignIfDifferent(Info.PresenceInfo.bIsPlayingThisGame, (bool)Presence.bIsPlayingThisGame);
+	return bChanged;
+}
+
+bool UAdvancedFriendsCache::UpdateFriendInfo(const FOnlineFriend& Friend, FBPFriendInfo& Info)
+{
+	bool bChanged = false;
+	bChanged |= AssignIfDifferent(Info.DisplayName, Friend.GetDisplayName());
+	bChanged |= AssignIfDifferent(Info.RealName, Friend.GetRealName());
+
+	if (!Info.UniqueNetId.IsValid())
+	{
+		Info.UniqueNetId.SetUniqueNetId(Friend.GetUserId());
+		bChanged = true;
+	}
+
+	bChanged |= UpdatePresenceInfo(Friend.GetPresence(), Info);
+	return bChanged;
+}
+
+void UAdvancedFriendsCache::Deinitialize()
+{
+	UnbindOnlineDelegates();
+	Super::Deinitialize();
+}
+
+void UAdvancedFriendsCache::RefreshFriends(APlayerController* PlayerController)
+{
+	ULocalPlayer* Player = PlayerController ? Cast<ULocalPlayer>(PlayerController->Player) : nullptr;
+	if (!Player)
+	{
+		UE_LOG(AdvancedGetFriendsLog, Warning, TEXT("RefreshFriends received a bad player controller!"));
+		return;
+	}
+
+	const int32 LocalUserNum = Player->GetControllerId();
+	BindOnlineDelegates(LocalUserNum);
+
+	IOnlineSubsystem* OnlineSub = Online::GetSubsystem(GetGameInstance()->GetWorld());
+	IOnlineFriendsPtr Friends = OnlineSub ? OnlineSub->GetFriendsInterface() : nullptr;
+	if (Friends.IsValid())
+	{
+		Friends->ReadFriendsList(LocalUserNum, EFriendsLists::ToString((EFriendsLists::Default)), FOnReadFriendsListComplete::CreateUObject(this, &ThisClass::OnReadFriendsListCompleted));
+	}
+}
+
+bool UAdvancedFriendsCache::GetFriendAt(int32 FriendIndex, FBPFriendInfo& Friend) const
+{
+	if (!Slots.IsValidIndex(FriendIndex) || !Slots[FriendIndex].bValid)
+		return false;
+
+	Friend = Slots[FriendIndex].Info;
+	return true;
+}
+
+int32 UAdvancedFriendsCache::FindFriendIndex(const FBPUniqueNetId& FriendUniqueNetId) const
+{
+	if (!FriendUniqueNetId.IsValid())
+		return INDEX_NONE;
+
+	const int32* Index = FriendIndices.Find(FriendUniqueNetId.GetUniqueNetId()->ToString());
+	return Index ? *Index : INDEX_NONE;
+}
+
+void UAdvancedFriendsCache::GetCachedFriends(TArray<FBPFriendInfo>& FriendsList) const
+{
+	FriendsList.Reset(ListOrder.Num());
+	for (int32 Index : ListOrder)
+	{
+		FriendsList.Add(Slots[Index].Info);
+	}
+}
+
+void UAdvancedFriendsCache::ApplyFriendsList(int32 LocalUserNum, const TArray<TSharedRef<FOnlineFriend>>& FriendList)
+{
+	BindOnlineDelegates(LocalUserNum);
+
+	TBitArray<> Seen(false, Slots.Num());
+	ListOrder.Reset(FriendList.Num());
+	for (const TSharedRef<FOnlineFriend>& Friend : FriendList)
+	{
+		const FString FriendId = Friend->GetUserId()->ToString();
+		if (const int32* Index = FriendIndices.Find(FriendId))
+		{
+			// A list that names someone twice keeps them once, in their first position
+			if (Seen[*Index])
+				continue;
+
+			Seen[*Index] = true;
+			ListOrder.Add(*Index);
+			if (UpdateFriendInfo(*Friend, Slots[*Index].Info))
+				OnFriendChanged.Broadcast(*Index, Slots[*Index].Info);
+			continue;
+		}
+
+		// Reuse the slot of a friend that was removed so indices stay dense
+		const int32 Index = FreeSlots.Num() > 0 ? FreeSlots.Pop(EAllowShrinking::No) : Slots.AddDefaulted();
+		if (Index >= Seen.Num())
+			Seen.Add(true);
+		else
+			Seen[Index] = true;
+
+		FFriendSlot& Slot = Slots[Index];
+		Slot.Info = FBPFriendInfo();
+		Slot.bValid = true;
+		UpdateFriendInfo(*Friend, Slot.Info);
+		FriendIndices.Add(FriendId, Index);
+		ListOrder.Add(Index);
+		OnFriendAdded.Broadcast(Index, Slot.Info);
+	}
+
+	for (int32 Index = 0; Index < Slots.Num(); Index++)
+	{
+		if (!Slots[Index].bValid || Seen[Index])
+			continue;
+
+		FFriendSlot& Slot = Slots[Index];
+		Slot.bValid = false;
+		FriendIndices.Remove(Slot.Info.UniqueNetId.GetUniqueNetId()->ToString());
+		FreeSlots.Add(Index);
+		OnFriendRemoved.Broadcast(Index, Slot.Info);
+	}
+}
+
+void UAdvancedFriendsCache::BindOnlineDelegates(int32 LocalUserNum)
+{
+	if (BoundLocalUserNum == LocalUserNum)
+		return;
+
+	UnbindOnlineDelegates();
+
+	IOnlineSubsystem* OnlineSub = Online::GetSubsystem(GetGameInstance()->GetWorld());
+	if (!OnlineSub)
+		return;
+
+	BoundLocalUserNum = LocalUserNum;
+
+	if (IOnlinePresencePtr Presence = OnlineSub->GetPresenceInterface())
+	{
+		PresenceReceivedHandle = Presence->AddOnPresenceReceivedDelegate_Handle(FOnPresenceReceivedDelegate::CreateUObject(this, &ThisClass::OnPresenceReceived));
+	}
+
+	if (IOnlineFriendsPtr Friends = OnlineSub->GetFriendsInterface())
+	{
+		FriendsChangeHandle = Friends->AddOnFriendsChangeDelegate_Handle(LocalUserNum, FOnFriendsChangeDelegate::CreateUObject(this, &ThisClass::OnFriendsChanged));
+	}
+}
+
+void UAdvancedFriendsCache::UnbindOnlineDelegates()
+{
+	if (BoundLocalUserNum == INDEX_NONE)
+		return;
+
+	UGameInstance* GameInstance = GetGameInstance();
+	if (IOnlineSubsystem* OnlineSub = Online::GetSubsystem(GameInstance ? GameInstance->GetWorld() : nullptr))
+	{
+		if (IOnlinePresencePtr Presence = OnlineSub->GetPresenceInterface())
+			Presence->ClearOnPresenceReceivedDelegate_Handle(PresenceReceivedHandle);
+
+		if (IOnlineFriendsPtr Friends = OnlineSub->GetFriendsInterface())
+			Friends->ClearOnFriendsChangeDelegate_Handle(BoundLocalUserNum, FriendsChangeHandle);
+	}
+
+	BoundLocalUserNum = INDEX_NONE;
+}
+
+void UAdvancedFriendsCache::OnPresenceReceived(const FUniqueNetId& UserId, const TSharedRef<FOnlineUserPresence>& Presence)
+{
+	// Only the one row changes, nothing else is read again
+	const int32* Index = FriendIndices.Find(UserId.ToString());
+	if (Index && UpdatePresenceInfo(*Presence, Slots[*Index].Info))
+	{
+		OnFriendChanged.Broadcast(*Index, Slots[*Index].Info);
+	}
+}
+
+void UAdvancedFriendsCache::OnFriendsChanged()
+{
+	IOnlineSubsystem* OnlineSub = Online::GetSubsystem(GetGameInstance()->GetWorld());
+	IOnlineFriendsPtr Friends = OnlineSub ? OnlineSub->GetFriendsInterface() : nullptr;
+	if (Friends.IsValid() && BoundLocalUserNum != INDEX_NONE)
+	{
+		Friends->ReadFriendsList(BoundLocalUserNum, EFriendsLists::ToString((EFriendsLists::Default)), FOnReadFriendsListComplete::CreateUObject(this, &ThisClass::OnReadFriendsListCompleted));
+	}
+}
+
+void UAdvancedFriendsCache::OnReadFriendsListCompleted(int32 LocalUserNum, bool bWasSuccessful, const FString& ListName, const FString& ErrorString)
+{
+	if (!bWasSuccessful)
+	{
+		UE_LOG(AdvancedGetFriendsLog, Warning, TEXT("Friends cache could not read the friends list: %s"), *ErrorString);
+		return;
+	}
+
+	IOnlineSubsystem* OnlineSub = Online::GetSubsystem(GetGameInstance()->GetWorld());
+	IOnlineFriendsPtr Friends = OnlineSub ? OnlineSub->GetFriendsInterface() : nullptr;
+	if (Friends.IsValid())
+	{
+		TArray<TSharedRef<FOnlineFriend>> FriendList;
+		Friends->GetFriendsList(LocalUserNum, ListName, FriendList);
+		ApplyFriendsList(LocalUserNum, FriendList);
+	}
+}
@@ -1,5 +1,6 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include "AdvancedFriendsLibrary.h"
+#include "AdvancedOnlineInterfaceCache.h"
 
 
 
@@ -24,7 +25,7 @@ void UAdvancedFriendsLibrary::SendSessionInviteToFriends(APlayerController *Play
 		return;
 	}
 
-	IOnlineSessionPtr SessionInterface = Online::GetSessionInterface();
+	IOnlineSessionPtr SessionInterface = FAdvancedOnlineInterfaceCache::GetSessionInterface();
 
 	if (!SessionInterface.IsValid())
 	{
@@ -76,7 +77,7 @@ void UAdvancedFriendsLibrary::SendSessionInviteToFriend(APlayerController *Playe
 		return;
 	}
 
-	IOnlineSessionPtr SessionInterface = Online::GetSessionInterface();
+	IOnlineSessionPtr SessionInterface = FAdvancedOnlineInterfaceCache::GetSessionInterface();
 
 	if (!SessionInterface.IsValid())
 	{
@@ -119,7 +120,7 @@ void UAdvancedFriendsLibrary::GetFriend(APlayerController *PlayerController, con
 		return;
 	}
 
-	IOnlineFriendsPtr FriendsInterface = Online::GetFriendsInterface();
+	IOnlineFriendsPtr FriendsInterface = FAdvancedOnlineInterfaceCache::GetFriendsInterface();
 
 	if (!FriendsInterface.IsValid())
 	{
@@ -169,7 +170,7 @@ void UAdvancedFriendsLibrary::IsAFriend(APlayerController *PlayerController, con
 		return;
 	}
 
-	IOnlineFriendsPtr FriendsInterface = Online::GetFriendsInterface();
+	IOnlineFriendsPtr FriendsInterface = FAdvancedOnlineInterfaceCache::GetFriendsInterface();
 
 	if (!FriendsInterface.IsValid())
 	{
@@ -190,7 +191,7 @@ void UAdvancedFriendsLibrary::IsAFriend(APlayerController *PlayerController, con
 
 void UAdvancedFriendsLibrary::GetStoredRecentPlayersList(FBPUniqueNetId UniqueNetId, TArray<FBPOnlineRecentPlayer> &PlayersList)
 {
-	IOnlineFriendsPtr FriendsInterface = Online::GetFriendsInterface();
+	IOnlineFriendsPtr FriendsInterface = FAdvancedOnlineInterfaceCache::GetFriendsInterface();
 	
 	if (!FriendsInterface.IsValid())
 	{
@@ -229,7 +230,7 @@ void UAdvancedFriendsLibrary::GetStoredFriendsList(APlayerController *PlayerCont
 		return;
 	}
 
-	IOnlineFriendsPtr FriendsInterface = Online::GetFriendsInterface();
+	IOnlineFriendsPtr FriendsInterface = FAdvancedOnlineInterfaceCache::GetFriendsInterface();
 	
 	if (!FriendsInterface.IsValid())
 	{
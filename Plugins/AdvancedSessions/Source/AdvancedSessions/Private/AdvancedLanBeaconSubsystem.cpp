@@ -0,0 +1,592 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvancedLanBeaconSubsystem.h"
+#include "AdvancedSessionsLibrary.h"
+#include "Common/UdpSocketBuilder.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/PlayerController.h"
+#include "IPAddress.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+// Every packet starts with the magic, the version and its type. A probe is followed by the query's nonce, a response
+// by the nonce, the build id, the game port, the player counts, the session flags, the session id, the owner's name
+// and the advertised extra settings. Numbers are little endian, strings are a length byte followed by UTF-8.
+static constexpr uint32 LanBeaconMagic = 0x424C4556;
+static constexpr uint8 LanBeaconVersion = 1;
+
+enum class ELanBeaconPacket : uint8
+{
+	Probe = 1,
+	Response = 2
+};
+
+enum ELanBeaconFlags : uint8
+{
+	LanBeaconFlag_Dedicated = 1 << 0,
+	LanBeaconFlag_AllowJoinInProgress = 1 << 1,
+	LanBeaconFlag_AllowInvites = 1 << 2,
+	LanBeaconFlag_UsesPresence = 1 << 3,
+	LanBeaconFlag_AntiCheatProtected = 1 << 4
+};
+
+class FLanBeaconWriter
+{
+public:
+	FLanBeaconWriter(TArray<uint8>& InBuffer) : Buffer(InBuffer) {}
+
+	template<typename T>
+	void Write(T Value)
+	{
+		Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+	}
+
+	void WriteString(const FString& Value)
+	{
+		FTCHARToUTF8 Utf8(*Value);
+		const uint8 Length = (uint8)FMath::Min(Utf8.Length(), 255);
+		Write(Length);
+		Buffer.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Length);
+	}
+
+	// Only the types a session setting is normally made of, false for the rest
+	bool WriteVariant(const FVariantData& Data)
+	{
+		const EOnlineKeyValuePairDataType::Type Type = Data.GetType();
+		switch (Type)
+		{
+		case EOnlineKeyValuePairDataType::Int32: { int32 Value; Data.GetValue(Value); Write((uint8)Type); Write(Value); return true; }
+		case EOnlineKeyValuePairDataType::UInt32: { uint32 Value; Data.GetValue(Value); Write((uint8)Type); Write(Value); return true; }
+		case EOnlineKeyValuePairDataType::Int64: { int64 Value; Data.GetValue(Value); Write((uint8)Type); Write(Value); return true; }
+		case EOnlineKeyValuePairDataType::UInt64: { uint64 Value; Data.GetValue(Value); Write((uint8)Type); Write(Value); return true; }
+		case EOnlineKeyValuePairDataType::Float: { float Value; Data.GetValue(Value); Write((uint8)Type); Write(Value); return true; }
+		case EOnlineKeyValuePairDataType::Double: { double Value; Data.GetValue(Value); Write((uint8)Type); Write(Value); return true; }
+		case EOnlineKeyValuePairDataType::Bool: { bool Value; Data.GetValue(Value); Write((uint8)Type); Write((uint8)Value); return true; }
+		case EOnlineKeyValuePairDataType::String: { FString Value; Data.GetValue(Value); Write((uint8)Type); WriteString(Value); return true; }
+		default:
+			return false;
+		}
+	}
+
+private:
+	TArray<uint8>& Buffer;
+};
+
+// Reads packets from anyone on the network, so every read is bounds checked and a short packet only sets bError
+class FLanBeaconReader
+{
+public:
+	FLanBeaconReader(const uint8* InData, int32 InSize) : Data(InData), Size(InSize) {}
+
+	bool bError = false;
+
+	template<typename T>
+	T Read()
+	{
+		T Value{};
+		if (bError || Offset + (int32)sizeof(T) > Size)
+		{
+			bError = true;
+			return Value;
+		}
+		FMemory::Memcpy(&Value, Data + Offset, sizeof(T));
+		Offset += sizeof(T);
+		return Value;
+	}
+
+	FString ReadString()
+	{
+		const int32 Length = Read<uint8>();
+		if (bError || Offset + Length > Size)
+		{
+			bError = true;
+			return FString();
+		}
+		FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Data + Offset), Length);
+		Offset += Length;
+		return FString(Converted.Length(), Converted.Get());
+	}
+
+	bool ReadVariant(FVariantData& OutData)
+	{
+		switch ((EOnlineKeyValuePairDataType::Type)Read<uint8>())
+		{
+		case EOnlineKeyValuePairDataType::Int32: OutData.SetValue(Read<int32>()); break;
+		case EOnlineKeyValuePairDataType::UInt32: OutData.SetValue(Read<uint32>()); break;
+		case EOnlineKeyValuePairDataType::Int64: OutData.SetValue(Read<int64>()); break;
+		case EOnlineKeyValuePairDataType::UInt64: OutData.SetValue(Read<uint64>()); break;
+		case EOnlineKeyValuePairDataType::Float: OutData.SetValue(Read<float>()); break;
+		case EOnlineKeyValuePairDataType::Double: OutData.SetValue(Read<double>()); break;
+		case EOnlineKeyValuePairDataType::Bool: OutData.SetValue(Read<uint8>() != 0); break;
+		case EOnlineKeyValuePairDataType::String: OutData.SetValue(ReadString()); break;
+		default:
+			bError = true;
+			break;
+		}
+		return !bError;
+	}
+
+private:
+	const uint8* Data;
+	int32 Size;
+	int32 Offset = 0;
+};
+
+static void WriteHeader(FLanBeaconWriter& Writer, ELanBeaconPacket Type)
+{
+	Writer.Write(LanBeaconMagic);
+	Writer.Write(LanBeaconVersion);
+	Writer.Write((uint8)Type);
+}
+
+static bool ReadHeader(FLanBeaconReader& Reader, ELanBeaconPacket Type)
+{
+	const uint32 Magic = Reader.Read<uint32>();
+	const uint8 Version = Reader.Read<uint8>();
+	const uint8 PacketType = Reader.Read<uint8>();
+	return !Reader.bError && Magic == LanBeaconMagic && Version == LanBeaconVersion && PacketType == (uint8)Type;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FAdvancedLanSessionInfo
+
+const FName FAdvancedLanSessionInfo::LanBeaconSessionType(TEXT("LANBEACON"));
+
+FAdvancedLanSessionInfo::FAdvancedLanSessionInfo(const TSharedRef<FInternetAddr>& InHostAddr, const FString& InSessionId)
+	: HostAddr(InHostAddr)
+	, SessionId(FUniqueNetIdString::Create(InSessionId, LanBeaconSessionType))
+{
+}
+
+bool FAdvancedLanSessionInfo::IsValid() const
+{
+	return HostAddr.IsValid() && HostAddr->IsValid();
+}
+
+FString FAdvancedLanSessionInfo::ToDebugString() const
+{
+	return FString::Printf(TEXT("HostIP: %s SessionId: %s"), HostAddr.IsValid() ? *HostAddr->ToString(true) : TEXT("INVALID"), *SessionId->ToDebugString());
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UAdvancedLanBeaconSubsystem
+
+void UAdvancedLanBeaconSubsystem::Deinitialize()
+{
+	if (TickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		TickHandle.Reset();
+	}
+
+	StopLanBeacon();
+
+	// Nobody is left to hear about them
+	for (TUniquePtr<FQuery>& Query : Queries)
+	{
+		DestroySocket(Query->Socket);
+	}
+	Queries.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UAdvancedLanBeaconSubsystem::StartLanBeacon()
+{
+	if (HostSocket)
+		return true;
+
+	// Not reusable, so a port another instance on this machine holds fails to bind and the next one is tried
+	for (int32 Port = BasePort; Port < BasePort + NumPorts && !HostSocket; Port++)
+	{
+		HostSocket = FUdpSocketBuilder(TEXT("AdvancedLanBeaconHost"))
+			.AsNonBlocking()
+			.WithBroadcast()
+			.BoundToAddress(FIPv4Address::Any)
+			.BoundToPort(Port)
+			.Build();
+	}
+
+	if (!HostSocket)
+	{
+		UE_LOG(AdvancedSessionsLog, Warning, TEXT("UAdvancedLanBeaconSubsystem: all %d beacon ports from %d are taken, not advertising"), NumPorts, BasePort);
+		return false;
+	}
+
+	// Once the session is gone there is nothing to describe, and nobody should keep hearing about it
+	UGameInstance* GameInstance = GetGameInstance();
+	IOnlineSessionPtr Sessions = FAdvancedOnlineInterfaceCache::GetSessionInterface(GameInstance ? GameInstance->GetWorld() : nullptr);
+	if (Sessions.IsValid())
+	{
+		EndSessionHandle = Sessions->AddOnEndSessionCompleteDelegate_Handle(FOnEndSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnGameSessionEnded));
+		DestroySessionHandle = Sessions->AddOnDestroySessionCompleteDelegate_Handle(FOnDestroySessionCompleteDelegate::CreateUObject(this, &ThisClass::OnGameSessionEnded));
+	}
+
+	ReplyBudgets.Reset();
+	EnsureTicking();
+	return true;
+}
+
+void UAdvancedLanBeaconSubsystem::StopLanBeacon()
+{
+	if (EndSessionHandle.IsValid() || DestroySessionHandle.IsValid())
+	{
+		UGameInstance* GameInstance = GetGameInstance();
+		IOnlineSessionPtr Sessions = FAdvancedOnlineInterfaceCache::GetSessionInterface(GameInstance ? GameInstance->GetWorld() : nullptr);
+		if (Sessions.IsValid())
+		{
+			Sessions->ClearOnEndSessionCompleteDelegate_Handle(EndSessionHandle);
+			Sessions->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionHandle);
+		}
+		EndSessionHandle.Reset();
+		DestroySessionHandle.Reset();
+	}
+
+	DestroySocket(HostSocket);
+	ReplyBudgets.Reset();
+}
+
+void UAdvancedLanBeaconSubsystem::OnGameSessionEnded(FName SessionName, bool bWasSuccessful)
+{
+	if (SessionName == NAME_GameSession)
+	{
+		StopLanBeacon();
+	}
+}
+
+int32 UAdvancedLanBeaconSubsystem::GetAdvertisedPort() const
+{
+	return HostSocket ? HostSocket->GetPortNo() : 0;
+}
+
+bool UAdvancedLanBeaconSubsystem::IsLanBeaconResult(const FBlueprintSessionResult& SearchResult)
+{
+	const TSharedPtr<FOnlineSessionInfo>& SessionInfo = SearchResult.OnlineResult.Session.SessionInfo;
+	return SessionInfo.IsValid() && SessionInfo->GetSessionId().GetType() == FAdvancedLanSessionInfo::LanBeaconSessionType;
+}
+
+bool UAdvancedLanBeaconSubsystem::GetLanBeaconConnectString(const FBlueprintSessionResult& SearchResult, FString& ConnectString)
+{
+	if (!IsLanBeaconResult(SearchResult))
+		return false;
+
+	// Only ReadDescription makes session infos with this id type
+	const FAdvancedLanSessionInfo* SessionInfo = static_cast<const FAdvancedLanSessionInfo*>(SearchResult.OnlineResult.Session.SessionInfo.Get());
+	if (!SessionInfo->IsValid())
+		return false;
+
+	ConnectString = SessionInfo->HostAddr->ToString(true);
+	return true;
+}
+
+bool UAdvancedLanBeaconSubsystem::JoinLanBeaconSession(APlayerController* PlayerController, const FBlueprintSessionResult& SearchResult)
+{
+	FString ConnectString;
+	if (!IsValid(PlayerController) || !GetLanBeaconConnectString(SearchResult, ConnectString))
+		return false;
+
+	PlayerController->ClientTravel(ConnectString, TRAVEL_Absolute);
+	return true;
+}
+
+void UAdvancedLanBeaconSubsystem::QueryLanBeacons(float Window, FOnLanBeaconQueryComplete&& OnComplete)
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	FSocket* Socket = SocketSubsystem ? FUdpSocketBuilder(TEXT("AdvancedLanBeaconQuery")).AsNonBlocking().WithBroadcast().Build() : nullptr;
+	if (!Socket)
+	{
+		UE_LOG(AdvancedSessionsLog, Warning, TEXT("UAdvancedLanBeaconSubsystem: could not open a socket to probe the LAN"));
+		OnComplete(false, TArray<FOnlineSessionSearchResult>());
+		return;
+	}
+
+	TUniquePtr<FQuery> Query = MakeUnique<FQuery>();
+	Query->Socket = Socket;
+	Query->Nonce = ((uint64)FMath::Rand() << 32) ^ (uint64)FMath::Rand() ^ FPlatformTime::Cycles64();
+	Query->OnComplete = MoveTemp(OnComplete);
+
+	TArray<uint8> Probe;
+	FLanBeaconWriter Writer(Probe);
+	WriteHeader(Writer, ELanBeaconPacket::Probe);
+	Writer.Write(Query->Nonce);
+
+	// Broadcast reaches the other machines, loopback the other instances on this one
+	TSharedRef<FInternetAddr> Broadcast = SocketSubsystem->CreateInternetAddr();
+	Broadcast->SetBroadcastAddress();
+	TSharedRef<FInternetAddr> Loopback = SocketSubsystem->CreateInternetAddr();
+	Loopback->SetLoopbackAddress();
+
+	int32 NumSent = 0;
+	for (int32 Port = BasePort; Port < BasePort + NumPorts; Port++)
+	{
+		int32 BytesSent = 0;
+		Broadcast->SetPort(Port);
+		NumSent += Socket->SendTo(Probe.GetData(), Probe.Num(), BytesSent, *Broadcast) ? 1 : 0;
+		Loopback->SetPort(Port);
+		NumSent += Socket->SendTo(Probe.GetData(), Probe.Num(), BytesSent, *Loopback) ? 1 : 0;
+	}
+
+	if (NumSent == 0)
+	{
+		UE_LOG(AdvancedSessionsLog, Warning, TEXT("UAdvancedLanBeaconSubsystem: no probe could be sent"));
+		DestroySocket(Query->Socket);
+		Query->OnComplete(false, TArray<FOnlineSessionSearchResult>());
+		return;
+	}
+
+	Query->SendTime = FPlatformTime::Seconds();
+	Query->EndTime = Query->SendTime + FMath::Max(Window, 0.0f);
+	Queries.Add(MoveTemp(Query));
+	EnsureTicking();
+}
+
+void UAdvancedLanBeaconSubsystem::EnsureTicking()
+{
+	if (!TickHandle.IsValid())
+	{
+		TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::Tick));
+	}
+}
+
+bool UAdvancedLanBeaconSubsystem::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_AdvancedLanBeacon_Tick);
+
+	if (HostSocket)
+	{
+		PollHost();
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Queries.Num(); i++)
+	{
+		PollQuery(*Queries[i]);
+		if (Now < Queries[i]->EndTime)
+			continue;
+
+		// Removed before the callback, which may well start another query
+		TUniquePtr<FQuery> Done = MoveTemp(Queries[i]);
+		Queries.RemoveAt(i--);
+		DestroySocket(Done->Socket);
+		Done->OnComplete(true, MoveTemp(Done->Results));
+	}
+
+	if (!HostSocket && Queries.Num() == 0)
+	{
+		TickHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+void UAdvancedLanBeaconSubsystem::PollHost()
+{
+	TSharedRef<FInternetAddr> From = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	uint8 Buffer[MaxPacketSize];
+	TArray<uint8> Response;
+
+	uint32 PendingSize = 0;
+	while (HostSocket->HasPendingData(PendingSize))
+	{
+		int32 BytesRead = 0;
+		if (!HostSocket->RecvFrom(Buffer, MaxPacketSize, BytesRead, *From))
+			break;
+
+		// Anyone can send to the port, so only an exact probe gets an answer
+		if (BytesRead != ProbeSize)
+			continue;
+
+		FLanBeaconReader Reader(Buffer, BytesRead);
+		if (!ReadHeader(Reader, ELanBeaconPacket::Probe))
+			continue;
+
+		const uint64 Nonce = Reader.Read<uint64>();
+		if (Reader.bError || !ConsumeReplyBudget(*From, FPlatformTime::Seconds()))
+			continue;
+
+		// Without a session there is nothing to join, the probe goes unanswered
+		Response.Reset();
+		if (!WriteDescription(Nonce, Response))
+			continue;
+
+		int32 BytesSent = 0;
+		HostSocket->SendTo(Response.GetData(), Response.Num(), BytesSent, *From);
+	}
+}
+
+bool UAdvancedLanBeaconSubsystem::ConsumeReplyBudget(const FInternetAddr& From, double Now)
+{
+	const FString Source = From.ToString(false);
+	FReplyBudget* Budget = ReplyBudgets.Find(Source);
+	if (!Budget)
+	{
+		// Spoofed sources could grow the map without end, forget them all once the oldest window is over
+		if (ReplyBudgets.Num() >= MaxTrackedSources)
+		{
+			for (auto It = ReplyBudgets.CreateIterator(); It; ++It)
+			{
+				if (Now - It.Value().WindowStart >= 1.0)
+				{
+					It.RemoveCurrent();
+				}
+			}
+			if (ReplyBudgets.Num() >= MaxTrackedSources)
+				return false;
+		}
+		Budget = &ReplyBudgets.Add(Source);
+		Budget->WindowStart = Now;
+	}
+
+	if (Now - Budget->WindowStart >= 1.0)
+	{
+		Budget->WindowStart = Now;
+		Budget->NumReplies = 0;
+	}
+
+	if (Budget->NumReplies >= MaxRepliesPerSource)
+		return false;
+
+	Budget->NumReplies++;
+	return true;
+}
+
+void UAdvancedLanBeaconSubsystem::PollQuery(FQuery& Query)
+{
+	TSharedRef<FInternetAddr> From = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	uint8 Buffer[MaxPacketSize];
+
+	uint32 PendingSize = 0;
+	while (Query.Socket->HasPendingData(PendingSize))
+	{
+		int32 BytesRead = 0;
+		if (!Query.Socket->RecvFrom(Buffer, MaxPacketSize, BytesRead, *From))
+			break;
+
+		FOnlineSessionSearchResult Result;
+		if (!ReadDescription(Buffer, BytesRead, Query.Nonce, *From, FPlatformTime::Seconds() - Query.SendTime, Result))
+			continue;
+
+		// A host on this machine hears both the broadcast and the loopback probe
+		bool bAlreadyFound = false;
+		Query.SessionIdsFound.Add(Result.GetSessionIdStr(), &bAlreadyFound);
+		if (!bAlreadyFound)
+		{
+			Query.Results.Add(MoveTemp(Result));
+		}
+	}
+}
+
+bool UAdvancedLanBeaconSubsystem::WriteDescription(uint64 Nonce, TArray<uint8>& OutPacket) const
+{
+	UGameInstance* GameInstance = GetGameInstance();
+	IOnlineSessionPtr Sessions = FAdvancedOnlineInterfaceCache::GetSessionInterface(GameInstance ? GameInstance->GetWorld() : nullptr);
+	const FNamedOnlineSession* Session = Sessions.IsValid() ? Sessions->GetNamedSession(NAME_GameSession) : nullptr;
+	if (!Session || !Session->SessionInfo.IsValid() || !Session->SessionInfo->IsValid())
+		return false;
+
+	const FOnlineSessionSettings& Settings = Session->SessionSettings;
+	const UWorld* World = GameInstance->GetWorld();
+	const int32 GamePort = (World && World->URL.Port > 0) ? World->URL.Port : FURL::UrlConfig.DefaultPort;
+
+	uint8 Flags = 0;
+	Flags |= Settings.bIsDedicated ? LanBeaconFlag_Dedicated : 0;
+	Flags |= Settings.bAllowJoinInProgress ? LanBeaconFlag_AllowJoinInProgress : 0;
+	Flags |= Settings.bAllowInvites ? LanBeaconFlag_AllowInvites : 0;
+	Flags |= Settings.bUsesPresence ? LanBeaconFlag_UsesPresence : 0;
+	Flags |= Settings.bAntiCheatProtected ? LanBeaconFlag_AntiCheatProtected : 0;
+
+	FLanBeaconWriter Writer(OutPacket);
+	WriteHeader(Writer, ELanBeaconPacket::Response);
+	Writer.Write(Nonce);
+	Writer.Write((int32)Settings.BuildUniqueId);
+	Writer.Write((uint16)GamePort);
+	Writer.Write((uint16)FMath::Clamp(Settings.NumPublicConnections, 0, (int32)MAX_uint16));
+	Writer.Write((uint16)FMath::Clamp(Session->NumOpenPublicConnections, 0, (int32)MAX_uint16));
+	Writer.Write(Flags);
+	Writer.WriteString(Session->SessionInfo->GetSessionId().ToString());
+	Writer.WriteString(Session->OwningUserName);
+
+	// Count first, then as many settings as fit
+	const int32 CountOffset = OutPacket.Num();
+	uint8 NumSettings = 0;
+	Writer.Write(NumSettings);
+
+	TArray<uint8> Setting;
+	FLanBeaconWriter SettingWriter(Setting);
+	for (const TPair<FName, FOnlineSessionSetting>& Pair : Settings.Settings)
+	{
+		if (Pair.Value.AdvertisementType == EOnlineDataAdvertisementType::DontAdvertise || NumSettings == MAX_uint8)
+			continue;
+
+		Setting.Reset();
+		SettingWriter.WriteString(Pair.Key.ToString());
+		if (!SettingWriter.WriteVariant(Pair.Value.Data) || OutPacket.Num() + Setting.Num() > MaxPacketSize)
+			continue;
+
+		OutPacket.Append(Setting);
+		NumSettings++;
+	}
+	OutPacket[CountOffset] = NumSettings;
+
+	return true;
+}
+
+bool UAdvancedLanBeaconSubsystem::ReadDescription(const uint8* Data, int32 Size, uint64 Nonce, const FInternetAddr& From, double PingSeconds, FOnlineSessionSearchResult& OutResult)
+{
+	FLanBeaconReader Reader(Data, Size);
+	if (!ReadHeader(Reader, ELanBeaconPacket::Response) || Reader.Read<uint64>() != Nonce)
+		return false;
+
+	const int32 BuildUniqueId = Reader.Read<int32>();
+	const uint16 GamePort = Reader.Read<uint16>();
+	const uint16 NumPublic = Reader.Read<uint16>();
+	const uint16 NumOpen = Reader.Read<uint16>();
+	const uint8 Flags = Reader.Read<uint8>();
+	const FString SessionId = Reader.ReadString();
+	const FString OwnerName = Reader.ReadString();
+	const uint8 NumSettings = Reader.Read<uint8>();
+
+	// Only hosts running this exact build can be joined, same as the online subsystem's own LAN search
+	if (Reader.bError || BuildUniqueId != GetBuildUniqueId() || SessionId.IsEmpty())
+		return false;
+
+	FOnlineSessionSettings& Settings = OutResult.Session.SessionSettings;
+	for (int32 i = 0; i < NumSettings; i++)
+	{
+		const FName Key(*Reader.ReadString());
+		FVariantData Value;
+		if (!Reader.ReadVariant(Value))
+			return false;
+
+		Settings.Settings.Add(Key, FOnlineSessionSetting(Value, EOnlineDataAdvertisementType::ViaOnlineService));
+	}
+
+	Settings.BuildUniqueId = BuildUniqueId;
+	Settings.NumPublicConnections = NumPublic;
+	Settings.bIsLANMatch = true;
+	Settings.bShouldAdvertise = true;
+	Settings.bIsDedicated = (Flags & LanBeaconFlag_Dedicated) != 0;
+	Settings.bAllowJoinInProgress = (Flags & LanBeaconFlag_AllowJoinInProgress) != 0;
+	Settings.bAllowInvites = (Flags & LanBeaconFlag_AllowInvites) != 0;
+	Settings.bUsesPresence = (Flags & LanBeaconFlag_UsesPresence) != 0;
+	Settings.bAntiCheatProtected = (Flags & LanBeaconFlag_AntiCheatProtected) != 0;
+
+	// The answer came from the host itself, so its source address is the one to connect to
+	TSharedRef<FInternetAddr> HostAddr = From.Clone();
+	HostAddr->SetPort(GamePort);
+
+	OutResult.Session.OwningUserName = OwnerName;
+	OutResult.Session.NumOpenPublicConnections = NumOpen;
+	OutResult.Session.SessionInfo = MakeShared<FAdvancedLanSessionInfo>(HostAddr, SessionId);
+	OutResult.PingInMs = FMath::Max(1, FMath::RoundToInt(PingSeconds * 1000.0));
+	return true;
+}
+
+void UAdvancedLanBeaconSubsystem::DestroySocket(FSocket*& Socket)
+{
+	if (!Socket)
+		return;
+
+	Socket->Close();
+	ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+	Socket = nullptr;
+}
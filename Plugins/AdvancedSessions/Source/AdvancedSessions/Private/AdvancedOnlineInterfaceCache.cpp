@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvancedOnlineInterfaceCache.h"
+#include "OnlineSubsystemUtils.h"
+#include "OnlineDelegates.h"
+#include "Engine/World.h"
+#include "Modules/ModuleManager.h"
+
+TMap<TPair<TObjectKey<UWorld>, FName>, FAdvancedOnlineInterfaceCache::FEntry> FAdvancedOnlineInterfaceCache::Entries;
+TMap<TObjectKey<UWorld>, FName> FAdvancedOnlineInterfaceCache::DefaultOverrides;
+FDelegateHandle FAdvancedOnlineInterfaceCache::WorldCleanupHandle;
+FDelegateHandle FAdvancedOnlineInterfaceCache::SubsystemCreatedHandle;
+FDelegateHandle FAdvancedOnlineInterfaceCache::ModulesChangedHandle;
+
+void FAdvancedOnlineInterfaceCache::Startup()
+{
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		Invalidate(World);
+		DefaultOverrides.Remove(World);
+	});
+
+	// A new instance can replace the one an entry points at, for example when the default subsystem is reloaded
+	SubsystemCreatedHandle = FOnlineSubsystemDelegates::OnOnlineSubsystemCreated.AddLambda([](IOnlineSubsystem* NewSubsystem)
+	{
+		InvalidateAll();
+	});
+
+	// An online subsystem module shuts its instances down when it is unloaded, and so does the OnlineSubsystem module
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddLambda([](FName ModuleName, EModuleChangeReason Reason)
+	{
+		if (Reason == EModuleChangeReason::ModuleUnloaded)
+		{
+			InvalidateAll();
+		}
+	});
+}
+
+void FAdvancedOnlineInterfaceCache::Shutdown()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	FOnlineSubsystemDelegates::OnOnlineSubsystemCreated.Remove(SubsystemCreatedHandle);
+	FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+	InvalidateAll();
+	DefaultOverrides.Reset();
+}
+
+IOnlineSubsystem* FAdvancedOnlineInterfaceCache::GetSubsystem(const UWorld* World, FName SystemName)
+{
+	FEntry* Entry = FindEntry(World, SystemName);
+	return Entry ? Entry->Subsystem : nullptr;
+}
+
+IOnlineVoicePtr FAdvancedOnlineInterfaceCache::GetVoiceInterface(const UWorld* World)
+{
+	return Resolve(World, &FEntry::Voice, [](IOnlineSubsystem* Subsystem) { return Subsystem->GetVoiceInterface(); });
+}
+
+IOnlineSessionPtr FAdvancedOnlineInterfaceCache::GetSessionInterface(const UWorld* World)
+{
+	return Resolve(World, &FEntry::Session, [](IOnlineSubsystem* Subsystem) { return Subsystem->GetSessionInterface(); });
+}
+
+IOnlineFriendsPtr FAdvancedOnlineInterfaceCache::GetFriendsInterface(const UWorld* World)
+{
+	return Resolve(World, &FEntry::Friends, [](IOnlineSubsystem* Subsystem) { return Subsystem->GetFriendsInterface(); });
+}
+
+void FAdvancedOnlineInterfaceCache::Invalidate(const UWorld* World)
+{
+	const TObjectKey<UWorld> WorldKey(World);
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It.Key().Key == WorldKey)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FAdvancedOnlineInterfaceCache::InvalidateAll()
+{
+	Entries.Reset();
+}
+
+void FAdvancedOnlineInterfaceCache::SetDefaultSubsystemOverride(const UWorld* World, FName SystemName)
+{
+	check(IsInGameThread());
+
+	if (SystemName.IsNone())
+	{
+		DefaultOverrides.Remove(World);
+	}
+	else
+	{
+		DefaultOverrides.Add(World, SystemName);
+	}
+
+	// Interfaces already cached for the world came from the subsystem it resolved to before
+	Invalidate(World);
+}
+
+FName FAdvancedOnlineInterfaceCache::ResolveSystemName(const UWorld* World, FName SystemName)
+{
+	if (SystemName.IsNone() && DefaultOverrides.Num() > 0)
+	{
+		if (const FName* Override = DefaultOverrides.Find(World))
+			return *Override;
+	}
+	return SystemName;
+}
+
+FAdvancedOnlineInterfaceCache::FEntry* FAdvancedOnlineInterfaceCache::FindEntry(const UWorld* World, FName SystemName, bool* bOutCreated)
+{
+	check(IsInGameThread());
+
+	if (bOutCreated)
+	{
+		*bOutCreated = false;
+	}
+
+	SystemName = ResolveSystemName(World, SystemName);
+	const TPair<TObjectKey<UWorld>, FName> Key(TObjectKey<UWorld>(World), SystemName);
+	if (FEntry* Entry = Entries.Find(Key))
+		return Entry;
+
+	// Failures are not cached, the subsystem may simply not be up yet
+	IOnlineSubsystem* Subsystem = Online::GetSubsystem(World, SystemName);
+	if (!Subsystem)
+		return nullptr;
+
+	FEntry& Entry = Entries.Add(Key);
+	Entry.Subsystem = Subsystem;
+	if (bOutCreated)
+	{
+		*bOutCreated = true;
+	}
+	return &Entry;
+}
+
+void FAdvancedOnlineInterfaceCache::RemoveEntry(const UWorld* World, FName SystemName)
+{
+	Entries.Remove(TPair<TObjectKey<UWorld>, FName>(TObjectKey<UWorld>(World), ResolveSystemName(World, SystemName)));
+}
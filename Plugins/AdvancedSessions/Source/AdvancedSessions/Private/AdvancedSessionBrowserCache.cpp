@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvancedSessionBrowserCache.h"
+#include "FindSessionsCallbackProxyAdvanced.h"
+#include "Engine/GameInstance.h"
+#include "TimerManager.h"
+
+//////////////////////////////////////////////////////////////////////////
+// UAdvancedSessionBrowserCache
+
+static bool HasSessionChanged(const FOnlineSessionSearchResult& Old, const FOnlineSessionSearchResult& New)
+{
+	if (Old.PingInMs != New.PingInMs ||
+		Old.Session.NumOpenPublicConnections != New.Session.NumOpenPublicConnections ||
+		Old.Session.NumOpenPrivateConnections != New.Session.NumOpenPrivateConnections)
+		return true;
+
+	const FSessionSettings& OldSettings = Old.Session.SessionSettings.Settings;
+	const FSessionSettings& NewSettings = New.Session.SessionSettings.Settings;
+	if (OldSettings.Num() != NewSettings.Num())
+		return true;
+
+	for (const TPair<FName, FOnlineSessionSetting>& Setting : NewSettings)
+	{
+		const FOnlineSessionSetting* OldSetting = OldSettings.Find(Setting.Key);
+		if (!OldSetting || !(OldSetting->Data == Setting.Value.Data))
+			return true;
+	}
+	return false;
+}
+
+void UAdvancedSessionBrowserCache::Deinitialize()
+{
+	StopBrowsing();
+	Super::Deinitialize();
+}
+
+void UAdvancedSessionBrowserCache::StartBrowsing(APlayerController* PlayerController, const FSessionBrowserQuery& Query, float RefreshInterval, float TimeToLive)
+{
+	PlayerControllerWeakPtr = PlayerController;
+	CurrentQuery = Query;
+	SessionTimeToLive = TimeToLive;
+
+	GetGameInstance()->GetTimerManager().SetTimer(RefreshHandle, FTimerDelegate::CreateUObject(this, &ThisClass::RefreshNow), FMath::Max(RefreshInterval, 1.0f), true);
+	RefreshNow();
+}
+
+void UAdvancedSessionBrowserCache::StopBrowsing()
+{
+	if (UGameInstance* GameInstance = GetGameInstance())
+	{
+		GameInstance->GetTimerManager().ClearTimer(RefreshHandle);
+	}
+
+	// Let a running search finish on its own, its results are just no longer wanted
+	if (ActiveSearch)
+	{
+		ActiveSearch->OnPartialResults.RemoveAll(this);
+		ActiveSearch->OnSuccess.RemoveAll(this);
+		ActiveSearch->OnFailure.RemoveAll(this);
+		ActiveSearch = nullptr;
+	}
+}
+
+void UAdvancedSessionBrowserCache::RefreshNow()
+{
+	if (ActiveSearch)
+		return;
+
+	APlayerController* PlayerController = PlayerControllerWeakPtr.Get();
+	if (!PlayerController)
+		PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
+
+	ActiveSearch = UFindSessionsCallbackProxyAdvanced::FindSessionsAdvanced(GetGameInstance(), PlayerController, CurrentQuery.MaxResults, CurrentQuery.bUseLAN, CurrentQuery.ServerTypeToSearch, CurrentQuery.Filters,
+		CurrentQuery.bEmptyServersOnly, CurrentQuery.bNonEmptyServersOnly, CurrentQuery.bSecureServersOnly, CurrentQuery.bSearchLobbies, CurrentQuery.MinSlotsAvailable);
+
+	ActiveSearch->OnPartialResults.AddDynamic(this, &ThisClass::OnSearchResults);
+	ActiveSearch->OnSuccess.AddDynamic(this, &ThisClass::OnSearchFinished);
+	ActiveSearch->OnFailure.AddDynamic(this, &ThisClass::OnSearchFinished);
+	ActiveSearch->Activate();
+}
+
+void UAdvancedSessionBrowserCache::GetPage(int32 PageIndex, int32 PageSize, TArray<FBlueprintSessionResult>& PageResults) const
+{
+	PageResults.Reset();
+	if (PageIndex < 0 || PageSize <= 0)
+		return;
+
+	const int32 First = PageIndex * PageSize;
+	const int32 Last = FMath::Min(First + PageSize, Sessions.Num());
+	PageResults.Reserve(FMath::Max(Last - First, 0));
+	for (int32 i = First; i < Last; i++)
+	{
+		PageResults.Add(Sessions[i].Result);
+	}
+}
+
+bool UAdvancedSessionBrowserCache::FindCachedSession(const FString& SessionId, FBlueprintSessionResult& Result) const
+{
+	const int32* Index = SessionIndices.Find(SessionId);
+	if (!Index)
+		return false;
+
+	Result = Sessions[*Index].Result;
+	return true;
+}
+
+FString UAdvancedSessionBrowserCache::GetSessionId(const FBlueprintSessionResult& Result)
+{
+	return Result.OnlineResult.GetSessionIdStr();
+}
+
+void UAdvancedSessionBrowserCache::OnSearchResults(const TArray<FBlueprintSessionResult>& Results)
+{
+	// Partial results are cumulative, a session already seen this refresh is only reported again if it changed
+	const double Now = FPlatformTime::Seconds();
+	for (const FBlueprintSessionResult& Result : Results)
+	{
+		const FString SessionId = Result.OnlineResult.GetSessionIdStr();
+		if (const int32* Index = SessionIndices.Find(SessionId))
+		{
+			FCachedSession& Cached = Sessions[*Index];
+			Cached.LastSeen = Now;
+			if (HasSessionChanged(Cached.Result.OnlineResult, Result.OnlineResult))
+			{
+				Cached.Result = Result;
+				PendingUpdated.Add(Result);
+			}
+			continue;
+		}
+
+		SessionIndices.Add(SessionId, Sessions.Num());
+		Sessions.Add({ Result, Now });
+		PendingAdded.Add(Result);
+	}
+
+	BroadcastDelta(TArray<FString>());
+}
+
+void UAdvancedSessionBrowserCache::OnSearchFinished(const TArray<FBlueprintSessionResult>& Results)
+{
+	ActiveSearch = nullptr;
+
+	// A failed search says nothing about whether sessions are gone, so only the TTL removes them
+	OnSearchResults(Results);
+
+	TArray<FString> RemovedSessionIds;
+	ExpireSessions(RemovedSessionIds);
+	BroadcastDelta(MoveTemp(RemovedSessionIds));
+}
+
+void UAdvancedSessionBrowserCache::ExpireSessions(TArray<FString>& RemovedSessionIds)
+{
+	const double Oldest = FPlatformTime::Seconds() - SessionTimeToLive;
+	const int32 NumBefore = Sessions.Num();
+
+	Sessions.RemoveAll([Oldest, &RemovedSessionIds](const FCachedSession& Cached)
+	{
+		if (Cached.LastSeen >= Oldest)
+			return false;
+
+		RemovedSessionIds.Add(Cached.Result.OnlineResult.GetSessionIdStr());
+		return true;
+	});
+
+	// Removing keeps the order, so only the indices need rebuilding
+	if (Sessions.Num() != NumBefore)
+	{
+		SessionIndices.Reset();
+		for (int32 i = 0; i < Sessions.Num(); i++)
+		{
+			SessionIndices.Add(Sessions[i].Result.OnlineResult.GetSessionIdStr(), i);
+		}
+	}
+}
+
+void UAdvancedSessionBrowserCache::BroadcastDelta(TArray<FString>&& RemovedSessionIds)
+{
+	if (PendingAdded.Num() == 0 && PendingUpdated.Num() == 0 && RemovedSessionIds.Num() == 0)
+		return;
+
+	const TArray<FBlueprintSessionResult> Added = MoveTemp(PendingAdded);
+	const TArray<FBlueprintSessionResult> Updated = MoveTemp(PendingUpdated);
+	PendingAdded.Reset();
+	PendingUpdated.Reset();
+
+	OnSessionsChanged.Broadcast(Added, Updated, RemovedSessionIds);
+}
@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvancedSessionSettingsTracker.h"
+#include "AdvancedOnlineInterfaceCache.h"
+#include "Engine/GameInstance.h"
+#include "TimerManager.h"
+
+// Failed updates are retried this many times in a row, the wait doubles each time up to MaxRetryDelay seconds
+static constexpr int32 MaxUpdateRetries = 5;
+static constexpr float MaxRetryDelay = 60.0f;
+
+//////////////////////////////////////////////////////////////////////////
+// UAdvancedSessionSettingsTracker
+
+void UAdvancedSessionSettingsTracker::Deinitialize()
+{
+	if (UGameInstance* GameInstance = GetGameInstance())
+	{
+		GameInstance->GetTimerManager().ClearTimer(FlushHandle);
+	}
+
+	if (IOnlineSessionPtr Sessions = GetSessions())
+	{
+		Sessions->ClearOnUpdateSessionCompleteDelegate_Handle(UpdateCompleteHandle);
+	}
+
+	PendingSettings.Reset();
+	InFlightSettings.Reset();
+	ForcedKeys.Reset();
+	NumFailedUpdates = 0;
+	bUpdateInFlight = false;
+
+	Super::Deinitialize();
+}
+
+void UAdvancedSessionSettingsTracker::SetSessionSetting(const FSessionPropertyKeyPair& Setting)
+{
+	PendingSettings.Add(Setting.Key, Setting.Data);
+	ScheduleFlush();
+}
+
+void UAdvancedSessionSettingsTracker::SetSessionSettings(const TArray<FSessionPropertyKeyPair>& Settings)
+{
+	for (const FSessionPropertyKeyPair& Setting : Settings)
+	{
+		PendingSettings.Add(Setting.Key, Setting.Data);
+	}
+	ScheduleFlush();
+}
+
+void UAdvancedSessionSettingsTracker::ScheduleFlush()
+{
+	// Already waiting, or the completion of the update in flight picks the new values up
+	FTimerManager& TimerManager = GetGameInstance()->GetTimerManager();
+	if (bUpdateInFlight || TimerManager.IsTimerActive(FlushHandle) || PendingSettings.Num() == 0)
+		return;
+
+	// A backend that keeps failing is not hammered with the same update every interval
+	float Delay = CoalesceInterval;
+	if (NumFailedUpdates > 0)
+	{
+		Delay = FMath::Min(FMath::Max(CoalesceInterval, 1.0f) * (float)(1 << NumFailedUpdates), MaxRetryDelay);
+	}
+
+	if (Delay > 0.0f)
+	{
+		TimerManager.SetTimer(FlushHandle, FTimerDelegate::CreateUObject(this, &ThisClass::FlushSessionSettings), Delay, false);
+	}
+	else
+	{
+		FlushHandle = TimerManager.SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &ThisClass::FlushSessionSettings));
+	}
+}
+
+void UAdvancedSessionSettingsTracker::FlushSessionSettings()
+{
+	GetGameInstance()->GetTimerManager().ClearTimer(FlushHandle);
+	if (bUpdateInFlight || PendingSettings.Num() == 0)
+		return;
+
+	IOnlineSessionPtr Sessions = GetSessions();
+	FOnlineSessionSettings* Settings = Sessions.IsValid() ? Sessions->GetSessionSettings(NAME_GameSession) : nullptr;
+	if (!Settings)
+	{
+		// No session to advertise on, the values stay staged for when there is one
+		UE_LOG(AdvancedSessionsLog, Warning, TEXT("UAdvancedSessionSettingsTracker: no game session to update"));
+		return;
+	}
+
+	// The session's own settings are what is advertised, anything equal to them is dropped here
+	InFlightSettings.Reset();
+	TArray<FName> ChangedKeys;
+	for (TPair<FName, FVariantData>& Pending : PendingSettings)
+	{
+		FOnlineSessionSetting* Existing = Settings->Settings.Find(Pending.Key);
+		if (Existing && Existing->Data == Pending.Value && !ForcedKeys.Contains(Pending.Key))
+			continue;
+
+		ForcedKeys.Remove(Pending.Key);
+
+		if (Existing)
+		{
+			Existing->Data = Pending.Value;
+		}
+		else
+		{
+			Settings->Settings.Add(Pending.Key, FOnlineSessionSetting(Pending.Value, EOnlineDataAdvertisementType::ViaOnlineService));
+		}
+
+		ChangedKeys.Add(Pending.Key);
+		InFlightSettings.Add(Pending.Key, MoveTemp(Pending.Value));
+	}
+	PendingSettings.Reset();
+
+	if (ChangedKeys.Num() == 0)
+		return;
+
+	bUpdateInFlight = true;
+	UpdateCompleteHandle = Sessions->AddOnUpdateSessionCompleteDelegate_Handle(FOnUpdateSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnUpdateCompleted));
+	Sessions->UpdateSession(NAME_GameSession, *Settings, true);
+}
+
+void UAdvancedSessionSettingsTracker::OnUpdateCompleted(FName SessionName, bool bWasSuccessful)
+{
+	if (SessionName != NAME_GameSession)
+		return;
+
+	if (IOnlineSessionPtr Sessions = GetSessions())
+	{
+		Sessions->ClearOnUpdateSessionCompleteDelegate_Handle(UpdateCompleteHandle);
+	}
+	bUpdateInFlight = false;
+
+	TArray<FName> ChangedKeys;
+	InFlightSettings.GetKeys(ChangedKeys);
+
+	if (bWasSuccessful)
+	{
+		NumFailedUpdates = 0;
+	}
+	else
+	{
+		// The session's copy already holds these values, so whenever they are staged again they are sent without diffing
+		ForcedKeys.Append(ChangedKeys);
+
+		if (++NumFailedUpdates > MaxUpdateRetries)
+		{
+			UE_LOG(AdvancedSessionsLog, Error, TEXT("UAdvancedSessionSettingsTracker: UpdateSession failed %d times in a row, dropping %d settings"), NumFailedUpdates, ChangedKeys.Num());
+			NumFailedUpdates = 0;
+		}
+		else
+		{
+			UE_LOG(AdvancedSessionsLog, Warning, TEXT("UAdvancedSessionSettingsTracker: UpdateSession failed, retrying %d settings"), ChangedKeys.Num());
+			for (TPair<FName, FVariantData>& Failed : InFlightSettings)
+			{
+				// A newer staged value takes precedence over the one that failed
+				if (!PendingSettings.Contains(Failed.Key))
+				{
+					PendingSettings.Add(Failed.Key, MoveTemp(Failed.Value));
+				}
+			}
+		}
+	}
+	InFlightSettings.Reset();
+
+	OnSettingsPushed.Broadcast(bWasSuccessful, ChangedKeys);
+	ScheduleFlush();
+}
+
+IOnlineSessionPtr UAdvancedSessionSettingsTracker::GetSessions() const
+{
+	UGameInstance* GameInstance = GetGameInstance();
+	return FAdvancedOnlineInterfaceCache::GetSessionInterface(GameInstance ? GameInstance->GetWorld() : nullptr);
+}
@@ -1,12 +1,15 @@
 //#include "StandAlonePrivatePCH.h"
 #include "AdvancedSessions.h"
+#include "AdvancedOnlineInterfaceCache.h"
 
 void AdvancedSessions::StartupModule()
 {
+	FAdvancedOnlineInterfaceCache::Startup();
 }
  
 void AdvancedSessions::ShutdownModule()
 {
+	FAdvancedOnlineInterfaceCache::Shutdown();
 }
  
 IMPLEMENT_MODULE(AdvancedSessions, AdvancedSessions)
\ No newline at end of file
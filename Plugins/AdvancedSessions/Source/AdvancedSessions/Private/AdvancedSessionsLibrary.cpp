@@ -1,5 +1,6 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include "AdvancedSessionsLibrary.h"
+#include "AdvancedOnlineInterfaceCache.h"
 #include "GameFramework/PlayerState.h"
 #include "GameFramework/GameStateBase.h"
 
@@ -64,7 +65,7 @@ void UAdvancedSessionsLibrary::GetSessionID_AsString(const FBlueprintSessionResu
 void UAdvancedSessionsLibrary::GetCurrentSessionID_AsString(UObject* WorldContextObject, FString& SessionID)
 {
 	UWorld* const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
-	IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(World);
+	IOnlineSessionPtr SessionInterface = FAdvancedOnlineInterfaceCache::GetSessionInterface(World);
 
 	if (!SessionInterface.IsValid()) 
 	{
@@ -166,7 +167,7 @@ void UAdvancedSessionsLibrary::GetExtraSettings(FBlueprintSessionResult SessionR
 void UAdvancedSessionsLibrary::GetSessionState(UObject* WorldContextObject, EBPOnlineSessionState &SessionState)
 {
 	UWorld* const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
-	IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(World);
+	IOnlineSessionPtr SessionInterface = FAdvancedOnlineInterfaceCache::GetSessionInterface(World);
 
 	if (!SessionInterface.IsValid())
 	{
@@ -180,7 +181,7 @@ void UAdvancedSessionsLibrary::GetSessionState(UObject* WorldContextObject, EBPO
 void UAdvancedSessionsLibrary::GetSessionSettings(UObject* WorldContextObject, int32 &NumConnections, int32 &NumPrivateConnections, bool &bIsLAN, bool &bIsDedicated, bool &bAllowInvites, bool &bAllowJoinInProgress, bool &bIsAnticheatEnabled, int32 &BuildUniqueID, TArray<FSessionPropertyKeyPair> &ExtraSettings, EBlueprintResultSwitch &Result)
 {
 	UWorld* const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
-	IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(World);
+	IOnlineSessionPtr SessionInterface = FAdvancedOnlineInterfaceCache::GetSessionInterface(World);
 
 	if (!SessionInterface.IsValid())
 	{
@@ -221,7 +222,7 @@ void UAdvancedSessionsLibrary::GetSessionSettings(UObject* WorldContextObject, i
 void UAdvancedSessionsLibrary::IsPlayerInSession(UObject* WorldContextObject, const FBPUniqueNetId &PlayerToCheck, bool &bIsInSession)
 {
 	UWorld* const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
-	IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(World);
+	IOnlineSessionPtr SessionInterface = FAdvancedOnlineInterfaceCache::GetSessionInterface(World);
 
 	if (!SessionInterface.IsValid())
 	{
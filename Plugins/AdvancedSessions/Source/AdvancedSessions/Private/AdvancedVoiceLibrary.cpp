@@ -1,5 +1,6 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include "AdvancedVoiceLibrary.h"
+#include "AdvancedOnlineInterfaceCache.h"
 
 
 //General Log
@@ -14,7 +15,7 @@ void UAdvancedVoiceLibrary::IsHeadsetPresent(UObject* WorldContextObject, bool &
 		return;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -35,7 +36,7 @@ void UAdvancedVoiceLibrary::StartNetworkedVoice(UObject* WorldContextObject, uin
 		return;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -55,7 +56,7 @@ void UAdvancedVoiceLibrary::StopNetworkedVoice(UObject* WorldContextObject, uint
 		return;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -74,7 +75,7 @@ bool UAdvancedVoiceLibrary::RegisterLocalTalker(UObject* WorldContextObject, uin
 		return false;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -94,7 +95,7 @@ void UAdvancedVoiceLibrary::RegisterAllLocalTalkers(UObject* WorldContextObject)
 		return;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -115,7 +116,7 @@ void UAdvancedVoiceLibrary::UnRegisterLocalTalker(UObject* WorldContextObject, u
 		return;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -135,7 +136,7 @@ void UAdvancedVoiceLibrary::UnRegisterAllLocalTalkers(UObject* WorldContextObjec
 		return;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -160,7 +161,7 @@ bool UAdvancedVoiceLibrary::RegisterRemoteTalker(UObject* WorldContextObject, co
 		return false;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -185,7 +186,7 @@ bool UAdvancedVoiceLibrary::UnRegisterRemoteTalker(UObject* WorldContextObject,
 		return false;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -205,7 +206,7 @@ void UAdvancedVoiceLibrary::RemoveAllRemoteTalkers(UObject* WorldContextObject)
 		return;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -225,7 +226,7 @@ bool UAdvancedVoiceLibrary::IsLocalPlayerTalking(UObject* WorldContextObject, ui
 		return false;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -250,7 +251,7 @@ bool UAdvancedVoiceLibrary::IsRemotePlayerTalking(UObject* WorldContextObject, c
 		return false;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -275,7 +276,7 @@ bool UAdvancedVoiceLibrary::IsPlayerMuted(UObject* WorldContextObject, uint8 Loc
 		return false;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -300,7 +301,7 @@ bool UAdvancedVoiceLibrary::MuteRemoteTalker(UObject* WorldContextObject, uint8
 		return false;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -325,7 +326,7 @@ bool UAdvancedVoiceLibrary::UnMuteRemoteTalker(UObject* WorldContextObject, uint
 		return false;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
@@ -346,7 +347,7 @@ void UAdvancedVoiceLibrary::GetNumLocalTalkers(UObject* WorldContextObject, int3
 		return;
 	}
 
-	IOnlineVoicePtr VoiceInterface = Online::GetVoiceInterface(World);
+	IOnlineVoicePtr VoiceInterface = FAdvancedOnlineInterfaceCache::GetVoiceInterface(World);
 
 	if (!VoiceInterface.IsValid())
 	{
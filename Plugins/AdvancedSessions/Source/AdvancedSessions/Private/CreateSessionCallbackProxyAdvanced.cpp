@@ -1,5 +1,6 @@
 // Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
 #include "CreateSessionCallbackProxyAdvanced.h"
+#include "AdvancedLanBeaconSubsystem.h"
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -133,6 +134,16 @@ void UCreateSessionCallbackProxyAdvanced::OnCreateCompleted(FName SessionName, b
 			
 			if (bWasSuccessful)
 			{
+				// Lets FindSessionsAdvanced find the session without waiting out the subsystem's LAN search
+				UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject.Get(), EGetWorldErrorMode::ReturnNull);
+				if (bUseLAN && World && World->GetGameInstance())
+				{
+					if (UAdvancedLanBeaconSubsystem* LanBeacon = World->GetGameInstance()->GetSubsystem<UAdvancedLanBeaconSubsystem>())
+					{
+						LanBeacon->StartLanBeacon();
+					}
+				}
+
 				if (this->bStartAfterCreate)
 				{
 					UE_LOG_ONLINE_SESSION(Display, TEXT("Session creation completed. Automatic start is turned on, starting session now."));
@@ -1,7 +1,16 @@
 // Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
 #include "FindSessionsCallbackProxyAdvanced.h"
+#include "AdvancedLanBeaconSubsystem.h"
+#include "AdvancedOnlineInterfaceCache.h"
 
 #include "Online/OnlineSessionNames.h"
+#include "TimerManager.h"
+#include <algorithm>
+
+static bool IsSearchFinished(const FOnlineSessionSearch& Search)
+{
+	return Search.SearchState == EOnlineAsyncTaskState::Done || Search.SearchState == EOnlineAsyncTaskState::Failed;
+}
 
 //////////////////////////////////////////////////////////////////////////
 // UFindSessionsCallbackProxyAdvanced
@@ -11,12 +20,20 @@ UFindSessionsCallbackProxyAdvanced::UFindSessionsCallbackProxyAdvanced(const FOb
 	: Super(ObjectInitializer)
 	, Delegate(FOnFindSessionsCompleteDelegate::CreateUObject(this, &ThisClass::OnCompleted))
 	, bUseLAN(false)
+	, SearchTimeout(15.0f)
+	, LanBeaconWindow(0.0f)
+	, bLanBeaconOnly(false)
 {
 	bRunSecondSearch = false;
-	bIsOnSecondSearch = false;
+	bPresenceSearchDone = false;
+	bDedicatedSearchDone = false;
+	bDedicatedSearchQueued = false;
+	bFinished = false;
+	bLanBeaconPending = false;
+	bLanBeaconSucceeded = false;
 }
 
-UFindSessionsCallbackProxyAdvanced* UFindSessionsCallbackProxyAdvanced::FindSessionsAdvanced(UObject* WorldContextObject, class APlayerController* PlayerController, int MaxResults, bool bUseLAN, EBPServerPresenceSearchType ServerTypeToSearch, const TArray<FSessionsSearchSetting> &Filters, bool bEmptyServersOnly, bool bNonEmptyServersOnly, bool bSecureServersOnly, bool bSearchLobbies, int MinSlotsAvailable)
+UFindSessionsCallbackProxyAdvanced* UFindSessionsCallbackProxyAdvanced::FindSessionsAdvanced(UObject* WorldContextObject, class APlayerController* PlayerController, int MaxResults, bool bUseLAN, EBPServerPresenceSearchType ServerTypeToSearch, const TArray<FSessionsSearchSetting> &Filters, bool bEmptyServersOnly, bool bNonEmptyServersOnly, bool bSecureServersOnly, bool bSearchLobbies, int MinSlotsAvailable, float SearchTimeout, float LanBeaconWindow, bool bLanBeaconOnly)
 {
 	UFindSessionsCallbackProxyAdvanced* Proxy = NewObject<UFindSessionsCallbackProxyAdvanced>();	
 	Proxy->PlayerControllerWeakPtr = PlayerController;
@@ -30,6 +47,9 @@ UFindSessionsCallbackProxyAdvanced* UFindSessionsCallbackProxyAdvanced::FindSess
 	Proxy->bSecureServersOnly = bSecureServersOnly;
 	Proxy->bSearchLobbies = bSearchLobbies;
 	Proxy->MinSlotsAvailable = MinSlotsAvailable;
+	Proxy->SearchTimeout = SearchTimeout;
+	Proxy->LanBeaconWindow = LanBeaconWindow;
+	Proxy->bLanBeaconOnly = bLanBeaconOnly;
 	return Proxy;
 }
 
@@ -45,7 +65,14 @@ void UFindSessionsCallbackProxyAdvanced::Activate()
 		{
 			// Re-initialize here, otherwise I think there might be issues with people re-calling search for some reason before it is destroyed
 			bRunSecondSearch = false;
-			bIsOnSecondSearch = false;
+			bPresenceSearchDone = false;
+			bDedicatedSearchDone = false;
+			bDedicatedSearchQueued = false;
+			bFinished = false;
+			bLanBeaconPending = false;
+			bLanBeaconSucceeded = false;
+			SessionSearchResults.Reset();
+			SessionIdsFound.Reset();
 
 			DelegateHandle = Sessions->AddOnFindSessionsCompleteDelegate_Handle(Delegate);
 
@@ -155,7 +182,71 @@ void UFindSessionsCallbackProxyAdvanced::Activate()
 			// Copy the derived temp variable over to it's base class
 			SearchObject->QuerySettings = tem;
 
-			Sessions->FindSessions(*Helper.UserID, SearchObject.ToSharedRef());
+			UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject.Get(), EGetWorldErrorMode::ReturnNull);
+			if (SearchTimeout > 0.0f && World)
+			{
+				World->GetTimerManager().SetTimer(TimeoutHandle, FTimerDelegate::CreateUObject(this, &ThisClass::OnTimeout), SearchTimeout, false);
+			}
+
+			// The beacon's session info is laid out for the Null subsystem, other subsystems could not join its results
+			UAdvancedLanBeaconSubsystem* LanBeacon = nullptr;
+			if (bUseLAN && LanBeaconWindow > 0.0f && World && World->GetGameInstance() && Helper.OnlineSub->GetSubsystemName() == NULL_SUBSYSTEM)
+			{
+				LanBeacon = World->GetGameInstance()->GetSubsystem<UAdvancedLanBeaconSubsystem>();
+			}
+
+			// Set before either search starts, one that completes synchronously must not finish the query without the beacon
+			bLanBeaconPending = LanBeacon != nullptr;
+
+			if (LanBeacon && bLanBeaconOnly)
+			{
+				bPresenceSearchDone = true;
+				bDedicatedSearchDone = true;
+			}
+			// Issue both searches at once, the results are merged as each one completes
+			else if (!Sessions->FindSessions(*Helper.UserID, SearchObject.ToSharedRef()))
+			{
+				bPresenceSearchDone = true;
+			}
+
+			if (bRunSecondSearch && !bDedicatedSearchDone)
+			{
+				if (!Sessions->FindSessions(*Helper.UserID, SearchObjectDedicated.ToSharedRef()))
+				{
+					bDedicatedSearchDone = true;
+				}
+				else if (SearchObjectDedicated->SearchState == EOnlineAsyncTaskState::NotStarted)
+				{
+					// Subsystems like Steam only run one search at a time and quietly ignore the second one
+					bDedicatedSearchQueued = true;
+				}
+			}
+
+			if (bPresenceSearchDone && bDedicatedSearchQueued)
+			{
+				bDedicatedSearchQueued = false;
+				if (!Sessions->FindSessions(*Helper.UserID, SearchObjectDedicated.ToSharedRef()))
+				{
+					bDedicatedSearchDone = true;
+				}
+			}
+
+			if (LanBeacon)
+			{
+				TWeakObjectPtr<UFindSessionsCallbackProxyAdvanced> WeakThis(this);
+				LanBeacon->QueryLanBeacons(LanBeaconWindow, [WeakThis](bool bSuccess, TArray<FOnlineSessionSearchResult>&& Results)
+				{
+					if (WeakThis.IsValid())
+					{
+						WeakThis->OnLanBeaconCompleted(bSuccess, MoveTemp(Results));
+					}
+				});
+			}
+
+			if (AllSearchesDone())
+			{
+				Finish();
+			}
 
 			// OnQueryCompleted will get called, nothing more to do now
 			return;
@@ -172,130 +263,427 @@ void UFindSessionsCallbackProxyAdvanced::Activate()
 
 void UFindSessionsCallbackProxyAdvanced::OnCompleted(bool bSuccess)
 {
+	if (bFinished)
+		return;
+
 	FOnlineSubsystemBPCallHelperAdvanced Helper(TEXT("FindSessionsCallback"), GEngine->GetWorldFromContextObject(WorldContextObject.Get(), EGetWorldErrorMode::LogAndReturnNull));
 	Helper.QueryIDFromPlayerController(PlayerControllerWeakPtr.Get());
 
 	if (!Helper.IsValid())
 	{
-		// Fail immediately
-		OnFailure.Broadcast(SessionSearchResults);
+		// We lost our player controller
+		Finish();
 		return;
 	}
 
-	if (!bRunSecondSearch && Helper.IsValid())
+	// The delegate does not say which search completed, and it also fires for other searches on the same interface,
+	// so look at the state of each of ours instead
+	bool bMergedAny = false;
+	if (!bPresenceSearchDone && SearchObject.IsValid() && IsSearchFinished(*SearchObject))
+	{
+		bPresenceSearchDone = true;
+		MergeResults(*SearchObject);
+		bMergedAny = true;
+	}
+
+	if (bRunSecondSearch && !bDedicatedSearchDone && !bDedicatedSearchQueued && SearchObjectDedicated.IsValid() && IsSearchFinished(*SearchObjectDedicated))
 	{
+		bDedicatedSearchDone = true;
+		MergeResults(*SearchObjectDedicated);
+		bMergedAny = true;
+	}
+
+	if (bDedicatedSearchQueued && bPresenceSearchDone)
+	{
+		bDedicatedSearchQueued = false;
 		auto Sessions = Helper.OnlineSub->GetSessionInterface();
-		if (Sessions.IsValid())
+		if (!Sessions.IsValid() || !Sessions->FindSessions(*Helper.UserID, SearchObjectDedicated.ToSharedRef()))
 		{
-			Sessions->ClearOnFindSessionsCompleteDelegate_Handle(DelegateHandle);
+			bDedicatedSearchDone = true;
 		}
 	}
 
-	if (bSuccess)
+	if (AllSearchesDone())
 	{
-		if (bIsOnSecondSearch)
-		{
-			if (SearchObjectDedicated.IsValid())
-			{
-				// Just log the results for now, will need to add a blueprint-compatible search result struct
-				for (auto& Result : SearchObjectDedicated->SearchResults)
-				{
-					FString ResultText = FString::Printf(TEXT("Found a session. Ping is %d"), Result.PingInMs);
+		Finish();
+	}
+	else if (bMergedAny)
+	{
+		OnPartialResults.Broadcast(SessionSearchResults);
+	}
+}
+
+void UFindSessionsCallbackProxyAdvanced::MergeResults(const FOnlineSessionSearch& Search)
+{
+	for (auto& Result : Search.SearchResults)
+	{
+		FString ResultText = FString::Printf(TEXT("Found a session. Ping is %d"), Result.PingInMs);
 
-					FFrame::KismetExecutionMessage(*ResultText, ELogVerbosity::Log);
+		FFrame::KismetExecutionMessage(*ResultText, ELogVerbosity::Log);
 
-					FBlueprintSessionResult BPResult;
-					BPResult.OnlineResult = Result;
-					SessionSearchResults.AddUnique(BPResult);
-				}
-				OnSuccess.Broadcast(SessionSearchResults);
-				return;
-			}
-		}
-		else
+		// Both searches can return the same session, and so can the LAN beacon. The beacon's copy gives way, Join
+		// Session can only take the subsystem's.
+		const int32 Index = SessionIdsFound.FindOrAdd(Result.GetSessionIdStr(), SessionSearchResults.Num());
+		if (Index != SessionSearchResults.Num())
 		{
-			if (SearchObject.IsValid())
+			if (UAdvancedLanBeaconSubsystem::IsLanBeaconResult(SessionSearchResults[Index]))
 			{
-				// Just log the results for now, will need to add a blueprint-compatible search result struct
-				for (auto& Result : SearchObject->SearchResults)
-				{
-					FString ResultText = FString::Printf(TEXT("Found a session. Ping is %d"), Result.PingInMs);
+				SessionSearchResults[Index].OnlineResult = Result;
+			}
+			continue;
+		}
 
-					FFrame::KismetExecutionMessage(*ResultText, ELogVerbosity::Log);
+		FBlueprintSessionResult& BPResult = SessionSearchResults.AddDefaulted_GetRef();
+		BPResult.OnlineResult = Result;
+	}
+}
 
-					FBlueprintSessionResult BPResult;
-					BPResult.OnlineResult = Result;
-					SessionSearchResults.AddUnique(BPResult);
-				}
-				if (!bRunSecondSearch)
-				{
-					OnSuccess.Broadcast(SessionSearchResults);
-					return;
-				}
-			}
+bool UFindSessionsCallbackProxyAdvanced::AllSearchesDone() const
+{
+	return bPresenceSearchDone && (!bRunSecondSearch || bDedicatedSearchDone) && !bLanBeaconPending;
+}
+
+void UFindSessionsCallbackProxyAdvanced::Finish(bool bCancelRunning)
+{
+	if (bFinished)
+		return;
+	bFinished = true;
+
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject.Get(), EGetWorldErrorMode::ReturnNull);
+	if (World)
+	{
+		World->GetTimerManager().ClearTimer(TimeoutHandle);
+	}
+
+	// The same subsystem the helper started the searches on
+	IOnlineSessionPtr Sessions = FAdvancedOnlineInterfaceCache::GetSessionInterface(World);
+	if (Sessions.IsValid())
+	{
+		Sessions->ClearOnFindSessionsCompleteDelegate_Handle(DelegateHandle);
+
+		// Otherwise the subsystem keeps searching for nobody, and refuses the next search until it is done
+		const bool bPresenceRunning = !bPresenceSearchDone && SearchObject.IsValid() && SearchObject->SearchState == EOnlineAsyncTaskState::InProgress;
+		const bool bDedicatedRunning = bRunSecondSearch && !bDedicatedSearchDone && !bDedicatedSearchQueued && SearchObjectDedicated.IsValid() && SearchObjectDedicated->SearchState == EOnlineAsyncTaskState::InProgress;
+		if (bCancelRunning && (bPresenceRunning || bDedicatedRunning))
+		{
+			Sessions->CancelFindSessions();
 		}
 	}
+
+	// Need to account for only one of the searches failing
+	const bool bAnySucceeded = (SearchObject.IsValid() && SearchObject->SearchState == EOnlineAsyncTaskState::Done) ||
+		(bRunSecondSearch && SearchObjectDedicated.IsValid() && SearchObjectDedicated->SearchState == EOnlineAsyncTaskState::Done);
+
+	if (bAnySucceeded || bLanBeaconSucceeded || SessionSearchResults.Num() > 0)
+		OnSuccess.Broadcast(SessionSearchResults);
 	else
+		OnFailure.Broadcast(SessionSearchResults);
+}
+
+void UFindSessionsCallbackProxyAdvanced::OnTimeout()
+{
+	if (bFinished)
+		return;
+
+	// Pick up a search that finished without its delegate reaching us, then give up on the rest
+	if (!bPresenceSearchDone && SearchObject.IsValid() && IsSearchFinished(*SearchObject))
+	{
+		bPresenceSearchDone = true;
+		MergeResults(*SearchObject);
+	}
+	if (bRunSecondSearch && !bDedicatedSearchDone && !bDedicatedSearchQueued && SearchObjectDedicated.IsValid() && IsSearchFinished(*SearchObjectDedicated))
 	{
-		if (!bRunSecondSearch)
+		bDedicatedSearchDone = true;
+		MergeResults(*SearchObjectDedicated);
+	}
+
+	FFrame::KismetExecutionMessage(TEXT("FindSessionsAdvanced timed out, returning the results found so far"), ELogVerbosity::Log);
+	Finish(true);
+}
+
+
+// A filter with its type and comparison resolved once, evaluating it reads the session setting in place
+struct FCompiledSessionFilter
+{
+	FName Key;
+	EOnlineKeyValuePairDataType::Type Type;
+	EOnlineComparisonOpRedux Op;
+
+	// The comparison makes no sense for the type, CompareVariants fails these as well
+	bool bAlwaysFails;
+
+	// Bool, Int32, Float and Double all compare exactly as doubles
+	double Number;
+	int64 Int64Value;
+	uint64 UInt64Value;
+
+	// The filter's own data, an exact match against it needs no copy of the session's string
+	FVariantData Variant;
+
+	// Extracted once for the case-insensitive compare
+	FString String;
+};
+
+typedef TArray<FCompiledSessionFilter, TInlineAllocator<8>> FCompiledSessionFilters;
+
+static void CompileSessionFilters(const TArray<FSessionsSearchSetting>& Filters, FCompiledSessionFilters& OutProgram)
+{
+	OutProgram.Reserve(Filters.Num());
+	for (const FSessionsSearchSetting& Filter : Filters)
+	{
+		const FVariantData& Data = Filter.PropertyKeyPair.Data;
+		const bool bEqualityOnly = Filter.ComparisonOp == EOnlineComparisonOpRedux::Equals || Filter.ComparisonOp == EOnlineComparisonOpRedux::NotEquals;
+
+		FCompiledSessionFilter& Compiled = OutProgram.AddZeroed_GetRef();
+		Compiled.Key = Filter.PropertyKeyPair.Key;
+		Compiled.Type = Data.GetType();
+		Compiled.Op = Filter.ComparisonOp;
+
+		switch (Compiled.Type)
 		{
-			// Need to account for only one of the searches failing
-			if (SessionSearchResults.Num() > 0)
-				OnSuccess.Broadcast(SessionSearchResults);
-			else
-				OnFailure.Broadcast(SessionSearchResults);
-			return;
+		case EOnlineKeyValuePairDataType::Bool:
+		{
+			bool Value;
+			Data.GetValue(Value);
+			Compiled.Number = Value ? 1.0 : 0.0;
+			Compiled.bAlwaysFails = !bEqualityOnly;
+		}
+		break;
+		case EOnlineKeyValuePairDataType::Int32:
+		{
+			int32 Value;
+			Data.GetValue(Value);
+			Compiled.Number = Value;
+		}
+		break;
+		case EOnlineKeyValuePairDataType::Float:
+		{
+			float Value;
+			Data.GetValue(Value);
+			Compiled.Number = Value;
+		}
+		break;
+		case EOnlineKeyValuePairDataType::Double:
+			Data.GetValue(Compiled.Number);
+			break;
+		case EOnlineKeyValuePairDataType::Int64:
+			Data.GetValue(Compiled.Int64Value);
+			break;
+		case EOnlineKeyValuePairDataType::UInt64:
+			Data.GetValue(Compiled.UInt64Value);
+			break;
+		case EOnlineKeyValuePairDataType::String:
+			Compiled.Variant = Data;
+			Data.GetValue(Compiled.String);
+			Compiled.bAlwaysFails = !bEqualityOnly;
+			break;
+		default:
+			Compiled.bAlwaysFails = true;
+			break;
 		}
 	}
+}
 
-	if (Helper.IsValid() && bRunSecondSearch && ServerSearchType == EBPServerPresenceSearchType::AllServers)
+template<typename T>
+static bool CompareOrdered(T A, T B, EOnlineComparisonOpRedux Comparator)
+{
+	switch (Comparator)
 	{
-		bRunSecondSearch = false;
-		bIsOnSecondSearch = true;
-		auto Sessions = Helper.OnlineSub->GetSessionInterface();
-		Sessions->FindSessions(*Helper.UserID, SearchObjectDedicated.ToSharedRef());
+	case EOnlineComparisonOpRedux::Equals:
+		return A == B;
+	case EOnlineComparisonOpRedux::NotEquals:
+		return A != B;
+	case EOnlineComparisonOpRedux::GreaterThanEquals:
+		return A >= B;
+	case EOnlineComparisonOpRedux::LessThanEquals:
+		return A <= B;
+	case EOnlineComparisonOpRedux::GreaterThan:
+		return A > B;
+	case EOnlineComparisonOpRedux::LessThan:
+		return A < B;
+	default:
+		return false;
 	}
-	else // We lost our player controller
+}
+
+// Scratch holds string values that had to be copied out, callers keep one across all the sessions they filter
+static bool PassesSessionFilters(const FOnlineSessionSettings& SessionSettings, const FCompiledSessionFilters& Program, FString& Scratch)
+{
+	for (const FCompiledSessionFilter& Filter : Program)
 	{
-		if (bSuccess && SessionSearchResults.Num() > 0)
-			OnSuccess.Broadcast(SessionSearchResults);
-		else
-			OnFailure.Broadcast(SessionSearchResults);
+		const FOnlineSessionSetting* Setting = SessionSettings.Settings.Find(Filter.Key);
+
+		// Couldn't find this key
+		if (!Setting)
+			continue;
+
+		const FVariantData& Data = Setting->Data;
+		if (Filter.bAlwaysFails || Data.GetType() != Filter.Type)
+			return false;
+
+		bool bPasses = false;
+		switch (Filter.Type)
+		{
+		case EOnlineKeyValuePairDataType::Bool:
+		{
+			bool Value;
+			Data.GetValue(Value);
+			bPasses = CompareOrdered(Value ? 1.0 : 0.0, Filter.Number, Filter.Op);
+		}
+		break;
+		case EOnlineKeyValuePairDataType::Int32:
+		{
+			int32 Value;
+			Data.GetValue(Value);
+			bPasses = CompareOrdered((double)Value, Filter.Number, Filter.Op);
+		}
+		break;
+		case EOnlineKeyValuePairDataType::Float:
+		{
+			float Value;
+			Data.GetValue(Value);
+			bPasses = CompareOrdered((double)Value, Filter.Number, Filter.Op);
+		}
+		break;
+		case EOnlineKeyValuePairDataType::Double:
+		{
+			double Value;
+			Data.GetValue(Value);
+			bPasses = CompareOrdered(Value, Filter.Number, Filter.Op);
+		}
+		break;
+		case EOnlineKeyValuePairDataType::Int64:
+		{
+			int64 Value;
+			Data.GetValue(Value);
+			bPasses = CompareOrdered(Value, Filter.Int64Value, Filter.Op);
+		}
+		break;
+		case EOnlineKeyValuePairDataType::UInt64:
+		{
+			uint64 Value;
+			Data.GetValue(Value);
+			bPasses = CompareOrdered(Value, Filter.UInt64Value, Filter.Op);
+		}
+		break;
+		case EOnlineKeyValuePairDataType::String:
+		{
+			// FVariantData's operator== compares in place but is case sensitive, players type server names and map names in any case.
+			// FVariantData cannot hand out its string without copying it, so only values that differ in more than case are copied.
+			bool bEqual = Data == Filter.Variant;
+			if (!bEqual)
+			{
+				Data.GetValue(Scratch);
+				bEqual = Scratch.Equals(Filter.String, ESearchCase::IgnoreCase);
+			}
+			bPasses = bEqual == (Filter.Op == EOnlineComparisonOpRedux::Equals);
+		}
+		break;
+		default:
+			break;
+		}
+
+		if (!bPasses)
+			return false;
 	}
+	return true;
 }
 
-
-void UFindSessionsCallbackProxyAdvanced::FilterSessionResults(const TArray<FBlueprintSessionResult> &SessionResults, const TArray<FSessionsSearchSetting> &Filters, TArray<FBlueprintSessionResult> &FilteredResults)
+void UFindSessionsCallbackProxyAdvanced::FilterSessionResults(const TArray<FBlueprintSessionResult> &SessionResults, const TArray<FSessionsSearchSetting> &Filters, TArray<FBlueprintSessionResult> &FilteredResults, EBPSessionResultSort SortBy, int32 TopK)
 {
+	FCompiledSessionFilters Program;
+	CompileSessionFilters(Filters, Program);
+
+	// Filter to indices first so sorting never moves whole search results around
+	TArray<int32> Passed;
+	Passed.Reserve(SessionResults.Num());
+	FString Scratch;
 	for (int j = 0; j < SessionResults.Num(); j++)
 	{
-		bool bAddResult = true;
+		if (PassesSessionFilters(SessionResults[j].OnlineResult.Session.SessionSettings, Program, Scratch))
+			Passed.Add(j);
+	}
+
+	const int32 Count = (TopK > 0) ? FMath::Min(TopK, Passed.Num()) : Passed.Num();
 
-		// Filter results
-		if (Filters.Num() > 0)
+	if (SortBy != EBPSessionResultSort::None && Passed.Num() > 1)
+	{
+		// Sort key and index, the index keeps ties in search order
+		TArray<TPair<int32, int32>> Keys;
+		Keys.Reserve(Passed.Num());
+		for (int32 Index : Passed)
 		{
-			const FOnlineSessionSetting * setting;
-			for (int i = 0; i < Filters.Num(); i++)
-			{
-				setting = SessionResults[j].OnlineResult.Session.SessionSettings.Settings.Find(Filters[i].PropertyKeyPair.Key);
+			const FOnlineSessionSearchResult& Result = SessionResults[Index].OnlineResult;
+			const int32 Key = (SortBy == EBPSessionResultSort::LowestPing) ? Result.PingInMs : -Result.Session.NumOpenPublicConnections;
+			Keys.Emplace(Key, Index);
+		}
 
-				// Couldn't find this key
-				if (!setting)
-					continue;
+		// Only the first Count need to be in order
+		std::partial_sort(Keys.GetData(), Keys.GetData() + Count, Keys.GetData() + Keys.Num(), [](const TPair<int32, int32>& A, const TPair<int32, int32>& B)
+		{
+			return A.Key < B.Key || (A.Key == B.Key && A.Value < B.Value);
+		});
 
-				if (!CompareVariants(setting->Data, Filters[i].PropertyKeyPair.Data, Filters[i].ComparisonOp))
-				{
-					bAddResult = false;
-					break;
-				}
-			}
+		for (int32 i = 0; i < Count; i++)
+		{
+			Passed[i] = Keys[i].Value;
 		}
+	}
+
+	FilteredResults.Reserve(FilteredResults.Num() + Count);
+	for (int32 i = 0; i < Count; i++)
+	{
+		FilteredResults.Add(SessionResults[Passed[i]]);
+	}
+}
+
+void UFindSessionsCallbackProxyAdvanced::OnLanBeaconCompleted(bool bSuccess, TArray<FOnlineSessionSearchResult>&& Results)
+{
+	if (bFinished)
+		return;
+
+	bLanBeaconPending = false;
+	bLanBeaconSucceeded = bSuccess;
 
-		if (bAddResult)
-			FilteredResults.Add(SessionResults[j]);
+	FCompiledSessionFilters Program;
+	CompileSessionFilters(SearchSettings, Program);
+	FString Scratch;
+
+	bool bMergedAny = false;
+	for (FOnlineSessionSearchResult& Result : Results)
+	{
+		if (MaxResults > 0 && SessionSearchResults.Num() >= MaxResults)
+			break;
+
+		const FOnlineSessionSettings& Settings = Result.Session.SessionSettings;
+		const int32 NumOpen = Result.Session.NumOpenPublicConnections;
+		if ((bEmptyServersOnly && NumOpen < Settings.NumPublicConnections) ||
+			(bNonEmptyServersOnly && NumOpen >= Settings.NumPublicConnections) ||
+			(bSecureServersOnly && !Settings.bAntiCheatProtected) ||
+			(MinSlotsAvailable > 0 && NumOpen < MinSlotsAvailable) ||
+			(ServerSearchType == EBPServerPresenceSearchType::ClientServersOnly && Settings.bIsDedicated) ||
+			(ServerSearchType == EBPServerPresenceSearchType::DedicatedServersOnly && !Settings.bIsDedicated) ||
+			!PassesSessionFilters(Settings, Program, Scratch))
+			continue;
+
+		// The subsystem's own LAN search finds the same hosts
+		const int32 Index = SessionIdsFound.FindOrAdd(Result.GetSessionIdStr(), SessionSearchResults.Num());
+		if (Index != SessionSearchResults.Num())
+			continue;
+
+		FBlueprintSessionResult& BPResult = SessionSearchResults.AddDefaulted_GetRef();
+		BPResult.OnlineResult = MoveTemp(Result);
+		bMergedAny = true;
 	}
 
-	return;
+	if (AllSearchesDone())
+	{
+		Finish();
+	}
+	else if (bMergedAny)
+	{
+		OnPartialResults.Broadcast(SessionSearchResults);
+	}
 }
 
 
@@ -1,5 +1,7 @@
 // Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
 #include "GetFriendsCallbackProxy.h"
+#include "AdvancedFriendsCache.h"
+#include "Kismet/GameplayStatics.h"
 
 #include "Online.h"
 #include "Interfaces/OnlineFriendsInterface.h"
@@ -78,27 +80,20 @@ void UGetFriendsCallbackProxy::OnReadFriendsListCompleted(int32 LocalUserNum, bo
 			TArray< TSharedRef<FOnlineFriend> > FriendList;
 			Friends->GetFriendsList(LocalUserNum, ListName, FriendList);
 
-			for (int32 i = 0; i < FriendList.Num(); i++)
+			// The friends cache only touches friends that changed, and its events tell the UI which rows to redraw
+			UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject.Get());
+			if (UAdvancedFriendsCache* Cache = GameInstance ? GameInstance->GetSubsystem<UAdvancedFriendsCache>() : nullptr)
 			{
-				TSharedRef<FOnlineFriend> Friend = FriendList[i];
-				FBPFriendInfo BPF;
-				FOnlineUserPresence pres = Friend->GetPresence();
-				BPF.OnlineState = ((EBPOnlinePresenceState)((int32)pres.Status.State));
-				BPF.DisplayName = Friend->GetDisplayName();
-				BPF.RealName = Friend->GetRealName();
-				BPF.UniqueNetId.SetUniqueNetId(Friend->GetUserId());
-				BPF.bIsPlayingSameGame = pres.bIsPlayingThisGame;
-
-				BPF.PresenceInfo.bIsOnline = pres.bIsOnline;
-				BPF.PresenceInfo.bHasVoiceSupport = pres.bHasVoiceSupport;
-				BPF.PresenceInfo.bIsPlaying = pres.bIsPlaying;
-				BPF.PresenceInfo.PresenceState = ((EBPOnlinePresenceState)((int32)pres.Status.State));
-				BPF.PresenceInfo.StatusString = pres.Status.StatusStr;
-				BPF.PresenceInfo.bIsJoinable = pres.bIsJoinable;
-				BPF.PresenceInfo.bIsPlayingThisGame = pres.bIsPlayingThisGame;
-
-
-				FriendsListOut.Add(BPF);
+				Cache->ApplyFriendsList(LocalUserNum, FriendList);
+				Cache->GetCachedFriends(FriendsListOut);
+			}
+			else
+			{
+				FriendsListOut.Reserve(FriendList.Num());
+				for (const TSharedRef<FOnlineFriend>& Friend : FriendList)
+				{
+					UAdvancedFriendsCache::UpdateFriendInfo(*Friend, FriendsListOut.AddDefaulted_GetRef());
+				}
 			}
 
 			OnSuccess.Broadcast(FriendsListOut);
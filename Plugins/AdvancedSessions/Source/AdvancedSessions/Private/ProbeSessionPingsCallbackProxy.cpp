@@ -0,0 +1,112 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+#include "ProbeSessionPingsCallbackProxy.h"
+#include "AdvancedOnlineInterfaceCache.h"
+#include "Icmp.h"
+#include "OnlineSubsystemUtils.h"
+#include "IPAddress.h"
+#include "SocketSubsystem.h"
+
+//////////////////////////////////////////////////////////////////////////
+// UProbeSessionPingsCallbackProxy
+
+UProbeSessionPingsCallbackProxy::UProbeSessionPingsCallbackProxy(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, NextProbe(0)
+	, ProbesInFlight(0)
+	, ProbeType(EBPSessionPingProbe::Icmp)
+	, MaxInFlight(8)
+	, Timeout(1.0f)
+	, bFinished(false)
+{
+}
+
+UProbeSessionPingsCallbackProxy* UProbeSessionPingsCallbackProxy::ProbeSessionPings(UObject* WorldContextObject, const TArray<FBlueprintSessionResult>& SessionResults, EBPSessionPingProbe ProbeType, int32 MaxInFlight, float Timeout)
+{
+	UProbeSessionPingsCallbackProxy* Proxy = NewObject<UProbeSessionPingsCallbackProxy>();
+	Proxy->WorldContextObject = WorldContextObject;
+	Proxy->Results = SessionResults;
+	Proxy->ProbeType = ProbeType;
+	Proxy->MaxInFlight = FMath::Max(MaxInFlight, 1);
+	Proxy->Timeout = Timeout;
+	return Proxy;
+}
+
+void UProbeSessionPingsCallbackProxy::Activate()
+{
+	NextProbe = 0;
+	ProbesInFlight = 0;
+	bFinished = false;
+	PendingProbes.Reset();
+
+	IOnlineSessionPtr Sessions = FAdvancedOnlineInterfaceCache::GetSessionInterface(GEngine->GetWorldFromContextObject(WorldContextObject.Get(), EGetWorldErrorMode::LogAndReturnNull));
+
+	if (Sessions.IsValid())
+	{
+		for (int32 i = 0; i < Results.Num(); i++)
+		{
+			FString ConnectString;
+			if (!Results[i].OnlineResult.IsValid() || !Sessions->GetResolvedConnectString(Results[i].OnlineResult, NAME_GamePort, ConnectString))
+				continue;
+
+			// Only plain IP hosts can be pinged, P2P addresses like "steam.1234" are left alone
+			TSharedPtr<FInternetAddr> Addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetAddressFromString(ConnectString);
+			if (!Addr.IsValid() || !Addr->IsValid())
+				continue;
+
+			PendingProbes.Emplace(i, (ProbeType == EBPSessionPingProbe::Udp) ? ConnectString : Addr->ToString(false));
+		}
+	}
+	else
+	{
+		FFrame::KismetExecutionMessage(TEXT("Sessions not supported by Online Subsystem, pings were not probed"), ELogVerbosity::Warning);
+	}
+
+	StartProbes();
+}
+
+void UProbeSessionPingsCallbackProxy::StartProbes()
+{
+	while (ProbesInFlight < MaxInFlight && NextProbe < PendingProbes.Num())
+	{
+		const TPair<int32, FString>& Probe = PendingProbes[NextProbe++];
+		ProbesInFlight++;
+
+		// Echo results come back on the game thread
+		TWeakObjectPtr<UProbeSessionPingsCallbackProxy> WeakThis(this);
+		const int32 ResultIndex = Probe.Key;
+		FIcmpEchoResultCallback Callback = [WeakThis, ResultIndex](FIcmpEchoResult Result)
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnProbeCompleted(ResultIndex, Result.Status == EIcmpResponseStatus::Success, Result.Time);
+			}
+		};
+
+		if (ProbeType == EBPSessionPingProbe::Udp)
+			FUDPPing::UDPEcho(Probe.Value, Timeout, Callback);
+		else
+			FIcmp::IcmpEcho(Probe.Value, Timeout, Callback);
+	}
+
+	// A probe that fails right away completes inside the loop above, and may already have finished us
+	if (!bFinished && ProbesInFlight == 0 && NextProbe >= PendingProbes.Num())
+	{
+		bFinished = true;
+		OnCompleted.Broadcast(Results);
+	}
+}
+
+void UProbeSessionPingsCallbackProxy::OnProbeCompleted(int32 ResultIndex, bool bSuccess, float Seconds)
+{
+	ProbesInFlight--;
+
+	// A host that drops the probe (a firewall, no echo responder) is not necessarily far away, keep what the search said
+	int32& PingInMs = Results[ResultIndex].OnlineResult.PingInMs;
+	if (bSuccess)
+	{
+		PingInMs = FMath::Max(FMath::RoundToInt(Seconds * 1000.0f), 1);
+	}
+	OnPingUpdated.Broadcast(ResultIndex, PingInMs);
+
+	StartProbes();
+}
@@ -55,7 +55,17 @@ void UUpdateSessionCallbackProxyAdvanced::Activate()
 				return;
 			}
 
-			OnUpdateSessionCompleteDelegateHandle = Sessions->AddOnUpdateSessionCompleteDelegate_Handle(OnUpdateSessionCompleteDelegate);
+			PreviousSettings = *Settings;
+
+			// Only touch what differs from what is already advertised, and skip the backend entirely if nothing does,
+			// unless the caller asked for the online data to be refreshed
+			bool bChanged = Settings->NumPublicConnections != NumPublicConnections ||
+				Settings->NumPrivateConnections != NumPrivateConnections ||
+				Settings->bShouldAdvertise != bShouldAdvertise ||
+				Settings->bAllowJoinInProgress != bAllowJoinInProgress ||
+				Settings->bIsLANMatch != bUseLAN ||
+				Settings->bAllowInvites != bAllowInvites ||
+				Settings->bIsDedicated != bDedicatedServer;
 
 		//	FOnlineSessionSettings Settings;
 			//Settings->BuildUniqueId = GetBuildUniqueId();
@@ -78,16 +88,29 @@ void UUpdateSessionCallbackProxyAdvanced::Activate()
 
 				if (fSetting)
 				{
-					fSetting->Data = ExtraSettings[i].Data;
+					if (!(fSetting->Data == ExtraSettings[i].Data))
+					{
+						fSetting->Data = ExtraSettings[i].Data;
+						bChanged = true;
+					}
 				}
 				else
 				{
 					ExtraSetting.Data = ExtraSettings[i].Data;
 					ExtraSetting.AdvertisementType = EOnlineDataAdvertisementType::ViaOnlineService;
 					Settings->Settings.Add(ExtraSettings[i].Key, ExtraSetting);
+					bChanged = true;
 				}
 			}
 
+			if (!bChanged && !bRefreshOnlineData)
+			{
+				OnSuccess.Broadcast();
+				return;
+			}
+
+			OnUpdateSessionCompleteDelegateHandle = Sessions->AddOnUpdateSessionCompleteDelegate_Handle(OnUpdateSessionCompleteDelegate);
+
 			Sessions->UpdateSession(NAME_GameSession, *Settings, bRefreshOnlineData);
 
 			// OnUpdateCompleted will get called, nothing more to do now
@@ -119,6 +142,12 @@ void UUpdateSessionCallbackProxyAdvanced::OnUpdateCompleted(FName SessionName, b
 				OnSuccess.Broadcast();
 				return;
 			}
+
+			// The local copy was changed before sending, but the backend still advertises the old values
+			if (FOnlineSessionSettings* Settings = Sessions->GetSessionSettings(SessionName))
+			{
+				*Settings = PreviousSettings;
+			}
 		}
 	}
 
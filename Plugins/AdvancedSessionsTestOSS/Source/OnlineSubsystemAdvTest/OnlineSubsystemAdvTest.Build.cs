@@ -0,0 +1,12 @@
+using UnrealBuildTool;
+ 
+public class OnlineSubsystemAdvTest : ModuleRules
+{
+    public OnlineSubsystemAdvTest(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "OnlineSubsystem" });
+        PrivateDependencyModuleNames.AddRange(new string[] { "Engine", "OnlineSubsystemUtils", "Sockets", "Networking", "AdvancedSessions" });
+    }
+}
@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OnlineFriendsAdvTest.h"
+#include "OnlineSubsystemAdvTest.h"
+
+//////////////////////////////////////////////////////////////////////////
+// FOnlineFriendAdvTest
+
+FOnlineFriendAdvTest::FOnlineFriendAdvTest(const FUniqueNetIdRef& InUserId, const FString& InDisplayName, bool bInOnline)
+	: UserId(InUserId)
+	, DisplayName(InDisplayName)
+{
+	Presence.bIsOnline = bInOnline;
+	Presence.bIsPlaying = bInOnline;
+	Presence.bIsPlayingThisGame = bInOnline;
+	Presence.bIsJoinable = false;
+	Presence.bHasVoiceSupport = false;
+	Presence.Status.State = bInOnline ? EOnlinePresenceState::Online : EOnlinePresenceState::Offline;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FOnlineRecentPlayerAdvTest
+
+FOnlineRecentPlayerAdvTest::FOnlineRecentPlayerAdvTest(const FUniqueNetIdRef& InUserId, const FString& InDisplayName, const FDateTime& InLastSeen)
+	: UserId(InUserId)
+	, DisplayName(InDisplayName)
+	, LastSeen(InLastSeen)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FOnlineFriendsAdvTest
+
+FOnlineFriendsAdvTest::FOnlineFriendsAdvTest(FOnlineSubsystemAdvTest* InSubsystem)
+	: Subsystem(InSubsystem)
+{
+}
+
+bool FOnlineFriendsAdvTest::ReadFriendsList(int32 LocalUserNum, const FString& ListName, const FOnReadFriendsListComplete& Delegate)
+{
+	Subsystem->QueueRequest([this, LocalUserNum, ListName, Delegate]()
+	{
+		if (Subsystem->GetTestSettings().bFailRequests)
+		{
+			Delegate.ExecuteIfBound(LocalUserNum, false, ListName, TEXT("ADVTEST is set to fail requests"));
+			return;
+		}
+
+		const int32 NumFriends = Subsystem->GetTestSettings().NumFriends;
+		TArray<TSharedRef<FOnlineFriend>>& Friends = FriendsLists.FindOrAdd(LocalUserNum);
+		Friends.Reset(NumFriends);
+		for (int32 Index = 0; Index < NumFriends; Index++)
+		{
+			Friends.Add(MakeShared<FOnlineFriendAdvTest>(FOnlineSubsystemAdvTest::MakeUserId(Index), FString::Printf(TEXT("Friend %04d"), Index), (Index % 3) != 0));
+		}
+
+		Delegate.ExecuteIfBound(LocalUserNum, true, ListName, FString());
+	});
+	return true;
+}
+
+bool FOnlineFriendsAdvTest::DeleteFriendsList(int32 LocalUserNum, const FString& ListName, const FOnDeleteFriendsListComplete& Delegate)
+{
+	Delegate.ExecuteIfBound(LocalUserNum, false, ListName, TEXT("Not supported by ADVTEST"));
+	return false;
+}
+
+bool FOnlineFriendsAdvTest::SendInvite(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName, const FOnSendInviteComplete& Delegate)
+{
+	Delegate.ExecuteIfBound(LocalUserNum, false, FriendId, ListName, TEXT("Not supported by ADVTEST"));
+	return false;
+}
+
+bool FOnlineFriendsAdvTest::AcceptInvite(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName, const FOnAcceptInviteComplete& Delegate)
+{
+	Delegate.ExecuteIfBound(LocalUserNum, false, FriendId, ListName, TEXT("Not supported by ADVTEST"));
+	return false;
+}
+
+bool FOnlineFriendsAdvTest::RejectInvite(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName)
+{
+	return false;
+}
+
+void FOnlineFriendsAdvTest::SetFriendAlias(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName, const FString& Alias, const FOnSetFriendAliasComplete& Delegate)
+{
+	Delegate.ExecuteIfBound(LocalUserNum, FriendId, ListName, FOnlineError(false));
+}
+
+void FOnlineFriendsAdvTest::DeleteFriendAlias(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName, const FOnDeleteFriendAliasComplete& Delegate)
+{
+	Delegate.ExecuteIfBound(LocalUserNum, FriendId, ListName, FOnlineError(false));
+}
+
+bool FOnlineFriendsAdvTest::DeleteFriend(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName)
+{
+	return false;
+}
+
+bool FOnlineFriendsAdvTest::GetFriendsList(int32 LocalUserNum, const FString& ListName, TArray<TSharedRef<FOnlineFriend>>& OutFriends)
+{
+	const TArray<TSharedRef<FOnlineFriend>>* Friends = FriendsLists.Find(LocalUserNum);
+	if (!Friends)
+		return false;
+
+	OutFriends = *Friends;
+	return true;
+}
+
+TSharedPtr<FOnlineFriend> FOnlineFriendsAdvTest::GetFriend(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName)
+{
+	if (const TArray<TSharedRef<FOnlineFriend>>* Friends = FriendsLists.Find(LocalUserNum))
+	{
+		for (const TSharedRef<FOnlineFriend>& Friend : *Friends)
+		{
+			if (*Friend->GetUserId() == FriendId)
+				return Friend;
+		}
+	}
+	return nullptr;
+}
+
+bool FOnlineFriendsAdvTest::IsFriend(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName)
+{
+	return GetFriend(LocalUserNum, FriendId, ListName).IsValid();
+}
+
+bool FOnlineFriendsAdvTest::QueryRecentPlayers(const FUniqueNetId& UserId, const FString& Namespace)
+{
+	const FUniqueNetIdRef UserIdRef = UserId.AsShared();
+	Subsystem->QueueRequest([this, UserIdRef, Namespace]()
+	{
+		if (Subsystem->GetTestSettings().bFailRequests)
+		{
+			TriggerOnQueryRecentPlayersCompleteDelegates(*UserIdRef, Namespace, false, TEXT("ADVTEST is set to fail requests"));
+			return;
+		}
+
+		const int32 NumRecentPlayers = Subsystem->GetTestSettings().NumRecentPlayers;
+		const FDateTime Now = FDateTime::UtcNow();
+		TArray<TSharedRef<FOnlineRecentPlayer>>& Players = RecentPlayers.FindOrAdd(UserIdRef->ToString());
+		Players.Reset(NumRecentPlayers);
+		for (int32 Index = 0; Index < NumRecentPlayers; Index++)
+		{
+			Players.Add(MakeShared<FOnlineRecentPlayerAdvTest>(FOnlineSubsystemAdvTest::MakeUserId(50000 + Index), FString::Printf(TEXT("Recent %04d"), Index), Now - FTimespan::FromMinutes(Index)));
+		}
+
+		TriggerOnQueryRecentPlayersCompleteDelegates(*UserIdRef, Namespace, true, FString());
+	});
+	return true;
+}
+
+bool FOnlineFriendsAdvTest::GetRecentPlayers(const FUniqueNetId& UserId, const FString& Namespace, TArray<TSharedRef<FOnlineRecentPlayer>>& OutRecentPlayers)
+{
+	const TArray<TSharedRef<FOnlineRecentPlayer>>* Players = RecentPlayers.Find(UserId.ToString());
+	if (!Players)
+		return false;
+
+	OutRecentPlayers = *Players;
+	return true;
+}
+
+void FOnlineFriendsAdvTest::DumpRecentPlayers() const
+{
+	for (const TPair<FString, TArray<TSharedRef<FOnlineRecentPlayer>>>& Pair : RecentPlayers)
+	{
+		UE_LOG(LogOnline, Display, TEXT("ADVTEST recent players of %s: %d"), *Pair.Key, Pair.Value.Num());
+	}
+}
+
+bool FOnlineFriendsAdvTest::BlockPlayer(int32 LocalUserNum, const FUniqueNetId& PlayerId)
+{
+	return false;
+}
+
+bool FOnlineFriendsAdvTest::UnblockPlayer(int32 LocalUserNum, const FUniqueNetId& PlayerId)
+{
+	return false;
+}
+
+bool FOnlineFriendsAdvTest::QueryBlockedPlayers(const FUniqueNetId& UserId)
+{
+	TriggerOnQueryBlockedPlayersCompleteDelegates(UserId, true, FString());
+	return true;
+}
+
+bool FOnlineFriendsAdvTest::GetBlockedPlayers(const FUniqueNetId& UserId, TArray<TSharedRef<FOnlineBlockedPlayer>>& OutBlockedPlayers)
+{
+	OutBlockedPlayers.Reset();
+	return true;
+}
+
+void FOnlineFriendsAdvTest::DumpBlockedPlayers() const
+{
+}
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Interfaces/OnlineFriendsInterface.h"
+#include "Interfaces/OnlinePresenceInterface.h"
+
+class FOnlineSubsystemAdvTest;
+
+class FOnlineFriendAdvTest : public FOnlineFriend
+{
+public:
+
+	FOnlineFriendAdvTest(const FUniqueNetIdRef& InUserId, const FString& InDisplayName, bool bInOnline);
+
+	// FOnlineUser
+	virtual FUniqueNetIdRef GetUserId() const override { return UserId; }
+	virtual FString GetRealName() const override { return DisplayName; }
+	virtual FString GetDisplayName(const FString& Platform = FString()) const override { return DisplayName; }
+	virtual bool GetUserAttribute(const FString& AttrName, FString& OutAttrValue) const override { return false; }
+
+	// FOnlineFriend
+	virtual EInviteStatus::Type GetInviteStatus() const override { return EInviteStatus::Accepted; }
+	virtual const FOnlineUserPresence& GetPresence() const override { return Presence; }
+
+private:
+
+	FUniqueNetIdRef UserId;
+	FString DisplayName;
+	FOnlineUserPresence Presence;
+};
+
+class FOnlineRecentPlayerAdvTest : public FOnlineRecentPlayer
+{
+public:
+
+	FOnlineRecentPlayerAdvTest(const FUniqueNetIdRef& InUserId, const FString& InDisplayName, const FDateTime& InLastSeen);
+
+	// FOnlineUser
+	virtual FUniqueNetIdRef GetUserId() const override { return UserId; }
+	virtual FString GetRealName() const override { return DisplayName; }
+	virtual FString GetDisplayName(const FString& Platform = FString()) const override { return DisplayName; }
+	virtual bool GetUserAttribute(const FString& AttrName, FString& OutAttrValue) const override { return false; }
+
+	// FOnlineRecentPlayer
+	virtual FDateTime GetLastSeen() const override { return LastSeen; }
+
+private:
+
+	FUniqueNetIdRef UserId;
+	FString DisplayName;
+	FDateTime LastSeen;
+};
+
+// Friends interface of the ADVTEST subsystem. Lists are generated at the configured sizes when they are read,
+// friends are named "Friend 0000" upwards and every third one is offline.
+class FOnlineFriendsAdvTest : public IOnlineFriends
+{
+public:
+
+	explicit FOnlineFriendsAdvTest(FOnlineSubsystemAdvTest* InSubsystem);
+	virtual ~FOnlineFriendsAdvTest() = default;
+
+	// IOnlineFriends
+	virtual bool ReadFriendsList(int32 LocalUserNum, const FString& ListName, const FOnReadFriendsListComplete& Delegate = FOnReadFriendsListComplete()) override;
+	virtual bool DeleteFriendsList(int32 LocalUserNum, const FString& ListName, const FOnDeleteFriendsListComplete& Delegate = FOnDeleteFriendsListComplete()) override;
+	virtual bool SendInvite(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName, const FOnSendInviteComplete& Delegate = FOnSendInviteComplete()) override;
+	virtual bool AcceptInvite(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName, const FOnAcceptInviteComplete& Delegate = FOnAcceptInviteComplete()) override;
+	virtual bool RejectInvite(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName) override;
+	virtual void SetFriendAlias(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName, const FString& Alias, const FOnSetFriendAliasComplete& Delegate = FOnSetFriendAliasComplete()) override;
+	virtual void DeleteFriendAlias(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName, const FOnDeleteFriendAliasComplete& Delegate = FOnDeleteFriendAliasComplete()) override;
+	virtual bool DeleteFriend(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName) override;
+	virtual bool GetFriendsList(int32 LocalUserNum, const FString& ListName, TArray<TSharedRef<FOnlineFriend>>& OutFriends) override;
+	virtual TSharedPtr<FOnlineFriend> GetFriend(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName) override;
+	virtual bool IsFriend(int32 LocalUserNum, const FUniqueNetId& FriendId, const FString& ListName) override;
+	virtual bool QueryRecentPlayers(const FUniqueNetId& UserId, const FString& Namespace) override;
+	virtual bool GetRecentPlayers(const FUniqueNetId& UserId, const FString& Namespace, TArray<TSharedRef<FOnlineRecentPlayer>>& OutRecentPlayers) override;
+	virtual void DumpRecentPlayers() const override;
+	virtual bool BlockPlayer(int32 LocalUserNum, const FUniqueNetId& PlayerId) override;
+	virtual bool UnblockPlayer(int32 LocalUserNum, const FUniqueNetId& PlayerId) override;
+	virtual bool QueryBlockedPlayers(const FUniqueNetId& UserId) override;
+	virtual bool GetBlockedPlayers(const FUniqueNetId& UserId, TArray<TSharedRef<FOnlineBlockedPlayer>>& OutBlockedPlayers) override;
+	virtual void DumpBlockedPlayers() const override;
+
+private:
+
+	FOnlineSubsystemAdvTest* Subsystem;
+
+	// Filled when a read completes, empty until then like a real backend
+	TMap<int32, TArray<TSharedRef<FOnlineFriend>>> FriendsLists;
+
+	// Keyed by FUniqueNetId::ToString of the user they were queried for
+	TMap<FString, TArray<TSharedRef<FOnlineRecentPlayer>>> RecentPlayers;
+};
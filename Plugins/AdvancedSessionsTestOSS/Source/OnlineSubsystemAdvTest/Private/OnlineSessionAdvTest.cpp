@@ -0,0 +1,425 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OnlineSessionAdvTest.h"
+#include "OnlineSubsystemAdvTest.h"
+#include "Online/OnlineSessionNames.h"
+
+//////////////////////////////////////////////////////////////////////////
+// FOnlineSessionInfoAdvTest
+
+FOnlineSessionInfoAdvTest::FOnlineSessionInfoAdvTest(const FString& InSessionId)
+	: SessionId(FUniqueNetIdString::Create(InSessionId, ADVTEST_SUBSYSTEM))
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FOnlineSessionAdvTest
+
+FOnlineSessionAdvTest::FOnlineSessionAdvTest(FOnlineSubsystemAdvTest* InSubsystem)
+	: Subsystem(InSubsystem)
+{
+}
+
+FOnlineSessionSearchResult FOnlineSessionAdvTest::MakeSearchResult(int32 Index)
+{
+	FOnlineSessionSearchResult Result;
+
+	// Spread over a range wide enough that sorting by ping has real work to do
+	Result.PingInMs = 20 + (Index * 37) % 250;
+
+	FOnlineSession& Session = Result.Session;
+	Session.OwningUserId = FOnlineSubsystemAdvTest::MakeUserId(100000 + Index);
+	Session.OwningUserName = FString::Printf(TEXT("Host %04d"), Index);
+	Session.SessionInfo = MakeShared<FOnlineSessionInfoAdvTest>(FString::Printf(TEXT("AdvTestSession_%d"), Index));
+
+	FOnlineSessionSettings& Settings = Session.SessionSettings;
+	Settings.NumPublicConnections = 16;
+	Settings.NumPrivateConnections = 0;
+	Settings.bShouldAdvertise = true;
+	Settings.bAllowJoinInProgress = true;
+	Settings.bUsesPresence = (Index % 2) == 0;
+	Settings.bIsDedicated = !Settings.bUsesPresence;
+	Settings.Set(SETTING_MAPNAME, FString::Printf(TEXT("Map_%d"), Index % 8), EOnlineDataAdvertisementType::ViaOnlineService);
+	Settings.Set(SETTING_GAMEMODE, (Index % 3) == 0 ? FString(TEXT("Deathmatch")) : FString(TEXT("Coop")), EOnlineDataAdvertisementType::ViaOnlineService);
+
+	Session.NumOpenPublicConnections = Index % 17;
+	Session.NumOpenPrivateConnections = 0;
+	return Result;
+}
+
+FUniqueNetIdPtr FOnlineSessionAdvTest::CreateSessionIdFromString(const FString& SessionIdStr)
+{
+	return FUniqueNetIdString::Create(SessionIdStr, ADVTEST_SUBSYSTEM);
+}
+
+FNamedOnlineSession* FOnlineSessionAdvTest::GetNamedSession(FName SessionName)
+{
+	for (FNamedOnlineSession& Session : Sessions)
+	{
+		if (Session.SessionName == SessionName)
+			return &Session;
+	}
+	return nullptr;
+}
+
+void FOnlineSessionAdvTest::RemoveNamedSession(FName SessionName)
+{
+	Sessions.RemoveAll([SessionName](const FNamedOnlineSession& Session) { return Session.SessionName == SessionName; });
+}
+
+bool FOnlineSessionAdvTest::HasPresenceSession()
+{
+	return Sessions.ContainsByPredicate([](const FNamedOnlineSession& Session) { return Session.SessionSettings.bUsesPresence; });
+}
+
+EOnlineSessionState::Type FOnlineSessionAdvTest::GetSessionState(FName SessionName) const
+{
+	for (const FNamedOnlineSession& Session : Sessions)
+	{
+		if (Session.SessionName == SessionName)
+			return Session.SessionState;
+	}
+	return EOnlineSessionState::NoSession;
+}
+
+bool FOnlineSessionAdvTest::CreateSession(int32 HostingPlayerNum, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
+{
+	return CreateSession(*FOnlineSubsystemAdvTest::MakeUserId(HostingPlayerNum), SessionName, NewSessionSettings);
+}
+
+bool FOnlineSessionAdvTest::CreateSession(const FUniqueNetId& HostingPlayerId, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
+{
+	if (GetNamedSession(SessionName))
+	{
+		TriggerOnCreateSessionCompleteDelegates(SessionName, false);
+		return false;
+	}
+
+	FNamedOnlineSession* Session = AddNamedSession(SessionName, NewSessionSettings);
+	Session->OwningUserId = HostingPlayerId.AsShared();
+	Session->SessionSettings.BuildUniqueId = GetBuildUniqueId();
+
+	// Named after the instance as well, so hosts on separate instances in one process have separate sessions
+	Session->SessionInfo = MakeShared<FOnlineSessionInfoAdvTest>(FString::Printf(TEXT("AdvTestHosted_%s_%s"), *Subsystem->GetInstanceName().ToString(), *SessionName.ToString()));
+	Session->SessionState = EOnlineSessionState::Creating;
+
+	Subsystem->QueueRequest([this, SessionName]()
+	{
+		FNamedOnlineSession* Created = GetNamedSession(SessionName);
+		const bool bSuccess = Created && !Subsystem->GetTestSettings().bFailRequests;
+		if (Created)
+		{
+			Created->SessionState = bSuccess ? EOnlineSessionState::Pending : EOnlineSessionState::NoSession;
+		}
+		if (!bSuccess)
+		{
+			RemoveNamedSession(SessionName);
+		}
+		TriggerOnCreateSessionCompleteDelegates(SessionName, bSuccess);
+	});
+	return true;
+}
+
+bool FOnlineSessionAdvTest::StartSession(FName SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session)
+	{
+		Session->SessionState = EOnlineSessionState::InProgress;
+	}
+	TriggerOnStartSessionCompleteDelegates(SessionName, Session != nullptr);
+	return Session != nullptr;
+}
+
+bool FOnlineSessionAdvTest::UpdateSession(FName SessionName, FOnlineSessionSettings& UpdatedSessionSettings, bool bShouldRefreshOnlineData)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (!Session)
+	{
+		TriggerOnUpdateSessionCompleteDelegates(SessionName, false);
+		return false;
+	}
+
+	NumUpdateSessionCalls++;
+	Session->SessionSettings = UpdatedSessionSettings;
+
+	Subsystem->QueueRequest([this, SessionName]()
+	{
+		TriggerOnUpdateSessionCompleteDelegates(SessionName, GetNamedSession(SessionName) && !Subsystem->GetTestSettings().bFailRequests);
+	});
+	return true;
+}
+
+bool FOnlineSessionAdvTest::EndSession(FName SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session)
+	{
+		Session->SessionState = EOnlineSessionState::Ended;
+	}
+	TriggerOnEndSessionCompleteDelegates(SessionName, Session != nullptr);
+	return Session != nullptr;
+}
+
+bool FOnlineSessionAdvTest::DestroySession(FName SessionName, const FOnDestroySessionCompleteDelegate& CompletionDelegate)
+{
+	const bool bFound = GetNamedSession(SessionName) != nullptr;
+	RemoveNamedSession(SessionName);
+	CompletionDelegate.ExecuteIfBound(SessionName, bFound);
+	TriggerOnDestroySessionCompleteDelegates(SessionName, bFound);
+	return bFound;
+}
+
+bool FOnlineSessionAdvTest::IsPlayerInSession(FName SessionName, const FUniqueNetId& UniqueId)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	return Session && Session->RegisteredPlayers.ContainsByPredicate([&UniqueId](const FUniqueNetIdRef& Player) { return *Player == UniqueId; });
+}
+
+bool FOnlineSessionAdvTest::StartMatchmaking(const TArray<FUniqueNetIdRef>& LocalPlayers, FName SessionName, const FOnlineSessionSettings& NewSessionSettings, TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	TriggerOnMatchmakingCompleteDelegates(SessionName, false);
+	return false;
+}
+
+bool FOnlineSessionAdvTest::CancelMatchmaking(int32 SearchingPlayerNum, FName SessionName)
+{
+	TriggerOnCancelMatchmakingCompleteDelegates(SessionName, false);
+	return false;
+}
+
+bool FOnlineSessionAdvTest::CancelMatchmaking(const FUniqueNetId& SearchingPlayerId, FName SessionName)
+{
+	TriggerOnCancelMatchmakingCompleteDelegates(SessionName, false);
+	return false;
+}
+
+bool FOnlineSessionAdvTest::FindSessions(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	return FindSessions(*FOnlineSubsystemAdvTest::MakeUserId(SearchingPlayerNum), SearchSettings);
+}
+
+bool FOnlineSessionAdvTest::FindSessions(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	// Several searches may run at once, unlike Steam, so a query's second search is never dropped
+	SearchSettings->SearchResults.Reset();
+	SearchSettings->SearchState = EOnlineAsyncTaskState::InProgress;
+	RunningSearches.Add(SearchSettings);
+
+	Subsystem->QueueRequest([this, SearchSettings]()
+	{
+		// Cancelled in the meantime
+		if (RunningSearches.Remove(SearchSettings) == 0)
+			return;
+
+		const FAdvTestOnlineSettings& TestSettings = Subsystem->GetTestSettings();
+		if (TestSettings.bFailRequests)
+		{
+			SearchSettings->SearchState = EOnlineAsyncTaskState::Failed;
+			TriggerOnFindSessionsCompleteDelegates(false);
+			return;
+		}
+
+		const int32 NumResults = SearchSettings->MaxSearchResults > 0 ? FMath::Min(TestSettings.NumSessions, SearchSettings->MaxSearchResults) : TestSettings.NumSessions;
+		SearchSettings->SearchResults.Reserve(NumResults);
+		for (int32 Index = 0; Index < NumResults; Index++)
+		{
+			SearchSettings->SearchResults.Add(MakeSearchResult(Index));
+		}
+
+		SearchSettings->SearchState = EOnlineAsyncTaskState::Done;
+		TriggerOnFindSessionsCompleteDelegates(true);
+	});
+	return true;
+}
+
+bool FOnlineSessionAdvTest::FindSessionById(const FUniqueNetId& SearchingUserId, const FUniqueNetId& SessionId, const FUniqueNetId& FriendId, const FOnSingleSessionResultCompleteDelegate& CompletionDelegate)
+{
+	CompletionDelegate.ExecuteIfBound(0, false, FOnlineSessionSearchResult());
+	return false;
+}
+
+bool FOnlineSessionAdvTest::CancelFindSessions()
+{
+	if (RunningSearches.Num() == 0)
+	{
+		TriggerOnCancelFindSessionsCompleteDelegates(false);
+		return false;
+	}
+
+	// Their queued completions find them gone and do nothing
+	for (const TSharedRef<FOnlineSessionSearch>& Search : RunningSearches)
+	{
+		Search->SearchState = EOnlineAsyncTaskState::Failed;
+	}
+	RunningSearches.Reset();
+
+	TriggerOnCancelFindSessionsCompleteDelegates(true);
+	return true;
+}
+
+bool FOnlineSessionAdvTest::PingSearchResults(const FOnlineSessionSearchResult& SearchResult)
+{
+	return false;
+}
+
+bool FOnlineSessionAdvTest::JoinSession(int32 LocalUserNum, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
+{
+	return JoinSession(*FOnlineSubsystemAdvTest::MakeUserId(LocalUserNum), SessionName, DesiredSession);
+}
+
+bool FOnlineSessionAdvTest::JoinSession(const FUniqueNetId& LocalUserId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
+{
+	if (GetNamedSession(SessionName))
+	{
+		TriggerOnJoinSessionCompleteDelegates(SessionName, EOnJoinSessionCompleteResult::AlreadyInSession);
+		return false;
+	}
+
+	FNamedOnlineSession* Session = AddNamedSession(SessionName, DesiredSession.Session);
+	Session->SessionState = EOnlineSessionState::Pending;
+	TriggerOnJoinSessionCompleteDelegates(SessionName, EOnJoinSessionCompleteResult::Success);
+	return true;
+}
+
+bool FOnlineSessionAdvTest::FindFriendSession(int32 LocalUserNum, const FUniqueNetId& Friend)
+{
+	TriggerOnFindFriendSessionCompleteDelegates(LocalUserNum, false, TArray<FOnlineSessionSearchResult>());
+	return false;
+}
+
+bool FOnlineSessionAdvTest::FindFriendSession(const FUniqueNetId& LocalUserId, const FUniqueNetId& Friend)
+{
+	TriggerOnFindFriendSessionCompleteDelegates(0, false, TArray<FOnlineSessionSearchResult>());
+	return false;
+}
+
+bool FOnlineSessionAdvTest::FindFriendSession(const FUniqueNetId& LocalUserId, const TArray<FUniqueNetIdRef>& FriendList)
+{
+	TriggerOnFindFriendSessionCompleteDelegates(0, false, TArray<FOnlineSessionSearchResult>());
+	return false;
+}
+
+bool FOnlineSessionAdvTest::SendSessionInviteToFriend(int32 LocalUserNum, FName SessionName, const FUniqueNetId& Friend)
+{
+	return false;
+}
+
+bool FOnlineSessionAdvTest::SendSessionInviteToFriend(const FUniqueNetId& LocalUserId, FName SessionName, const FUniqueNetId& Friend)
+{
+	return false;
+}
+
+bool FOnlineSessionAdvTest::SendSessionInviteToFriends(int32 LocalUserNum, FName SessionName, const TArray<FUniqueNetIdRef>& Friends)
+{
+	return false;
+}
+
+bool FOnlineSessionAdvTest::SendSessionInviteToFriends(const FUniqueNetId& LocalUserId, FName SessionName, const TArray<FUniqueNetIdRef>& Friends)
+{
+	return false;
+}
+
+bool FOnlineSessionAdvTest::GetResolvedConnectString(FName SessionName, FString& ConnectInfo, FName PortType)
+{
+	// No host behind these sessions
+	return false;
+}
+
+bool FOnlineSessionAdvTest::GetResolvedConnectString(const FOnlineSessionSearchResult& SearchResult, FName PortType, FString& ConnectInfo)
+{
+	// Every synthetic session is hosted at the same address, if the test gave one
+	const FString& HostAddress = Subsystem->GetTestSettings().HostAddress;
+	if (HostAddress.IsEmpty() || !SearchResult.IsValid())
+		return false;
+
+	ConnectInfo = HostAddress;
+	return true;
+}
+
+FOnlineSessionSettings* FOnlineSessionAdvTest::GetSessionSettings(FName SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	return Session ? &Session->SessionSettings : nullptr;
+}
+
+bool FOnlineSessionAdvTest::RegisterPlayer(FName SessionName, const FUniqueNetId& PlayerId, bool bWasInvited)
+{
+	TArray<FUniqueNetIdRef> Players;
+	Players.Add(PlayerId.AsShared());
+	return RegisterPlayers(SessionName, Players, bWasInvited);
+}
+
+bool FOnlineSessionAdvTest::RegisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players, bool bWasInvited)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session)
+	{
+		for (const FUniqueNetIdRef& Player : Players)
+		{
+			if (!IsPlayerInSession(SessionName, *Player))
+				Session->RegisteredPlayers.Add(Player);
+		}
+	}
+	TriggerOnRegisterPlayersCompleteDelegates(SessionName, Players, Session != nullptr);
+	return Session != nullptr;
+}
+
+bool FOnlineSessionAdvTest::UnregisterPlayer(FName SessionName, const FUniqueNetId& PlayerId)
+{
+	TArray<FUniqueNetIdRef> Players;
+	Players.Add(PlayerId.AsShared());
+	return UnregisterPlayers(SessionName, Players);
+}
+
+bool FOnlineSessionAdvTest::UnregisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session)
+	{
+		for (const FUniqueNetIdRef& Player : Players)
+		{
+			Session->RegisteredPlayers.RemoveAll([&Player](const FUniqueNetIdRef& Registered) { return *Registered == *Player; });
+		}
+	}
+	TriggerOnUnregisterPlayersCompleteDelegates(SessionName, Players, Session != nullptr);
+	return Session != nullptr;
+}
+
+void FOnlineSessionAdvTest::RegisterLocalPlayer(const FUniqueNetId& PlayerId, FName SessionName, const FOnRegisterLocalPlayerCompleteDelegate& Delegate)
+{
+	Delegate.ExecuteIfBound(PlayerId, EOnJoinSessionCompleteResult::Success);
+}
+
+void FOnlineSessionAdvTest::UnregisterLocalPlayer(const FUniqueNetId& PlayerId, FName SessionName, const FOnUnregisterLocalPlayerCompleteDelegate& Delegate)
+{
+	Delegate.ExecuteIfBound(PlayerId, true);
+}
+
+void FOnlineSessionAdvTest::RemovePlayerFromSession(int32 LocalUserNum, FName SessionName, const FUniqueNetId& TargetPlayerId)
+{
+	UnregisterPlayer(SessionName, TargetPlayerId);
+}
+
+int32 FOnlineSessionAdvTest::GetNumSessions()
+{
+	return Sessions.Num();
+}
+
+void FOnlineSessionAdvTest::DumpSessionState()
+{
+	for (const FNamedOnlineSession& Session : Sessions)
+	{
+		UE_LOG(LogOnline, Display, TEXT("ADVTEST session %s: state %s, %d registered players"), *Session.SessionName.ToString(),
+			EOnlineSessionState::ToString(Session.SessionState), Session.RegisteredPlayers.Num());
+	}
+}
+
+FNamedOnlineSession* FOnlineSessionAdvTest::AddNamedSession(FName SessionName, const FOnlineSessionSettings& SessionSettings)
+{
+	return new (Sessions) FNamedOnlineSession(SessionName, SessionSettings);
+}
+
+FNamedOnlineSession* FOnlineSessionAdvTest::AddNamedSession(FName SessionName, const FOnlineSession& Session)
+{
+	return new (Sessions) FNamedOnlineSession(SessionName, Session);
+}
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OnlineSubsystemAdvTest.h"
+#include "OnlineSessionAdvTest.h"
+#include "OnlineFriendsAdvTest.h"
+#include "OnlineVoiceAdvTest.h"
+#include "Misc/ConfigCacheIni.h"
+
+#define LOCTEXT_NAMESPACE "OnlineSubsystemAdvTest"
+
+//////////////////////////////////////////////////////////////////////////
+// FOnlineSubsystemAdvTest
+
+FOnlineSubsystemAdvTest::FOnlineSubsystemAdvTest(FName InInstanceName)
+	: FOnlineSubsystemImpl(ADVTEST_SUBSYSTEM, InInstanceName)
+{
+}
+
+IOnlineSessionPtr FOnlineSubsystemAdvTest::GetSessionInterface() const
+{
+	return SessionInterface;
+}
+
+IOnlineFriendsPtr FOnlineSubsystemAdvTest::GetFriendsInterface() const
+{
+	return FriendsInterface;
+}
+
+IOnlineVoicePtr FOnlineSubsystemAdvTest::GetVoiceInterface() const
+{
+	return VoiceInterface;
+}
+
+bool FOnlineSubsystemAdvTest::Init()
+{
+	const TCHAR* Section = TEXT("OnlineSubsystemAdvTest");
+	GConfig->GetInt(Section, TEXT("NumSessions"), TestSettings.NumSessions, GEngineIni);
+	GConfig->GetInt(Section, TEXT("NumFriends"), TestSettings.NumFriends, GEngineIni);
+	GConfig->GetInt(Section, TEXT("NumRecentPlayers"), TestSettings.NumRecentPlayers, GEngineIni);
+	GConfig->GetFloat(Section, TEXT("Latency"), TestSettings.Latency, GEngineIni);
+	GConfig->GetBool(Section, TEXT("bFailRequests"), TestSettings.bFailRequests, GEngineIni);
+	GConfig->GetString(Section, TEXT("HostAddress"), TestSettings.HostAddress, GEngineIni);
+
+	SessionInterface = MakeShared<FOnlineSessionAdvTest, ESPMode::ThreadSafe>(this);
+	FriendsInterface = MakeShared<FOnlineFriendsAdvTest, ESPMode::ThreadSafe>(this);
+	VoiceInterface = MakeShared<FOnlineVoiceAdvTest, ESPMode::ThreadSafe>();
+	VoiceInterface->Init();
+	return true;
+}
+
+bool FOnlineSubsystemAdvTest::Shutdown()
+{
+	// The requests point into the interfaces, drop them first
+	PendingRequests.Reset();
+
+	SessionInterface.Reset();
+	FriendsInterface.Reset();
+	VoiceInterface.Reset();
+	return FOnlineSubsystemImpl::Shutdown();
+}
+
+FText FOnlineSubsystemAdvTest::GetOnlineServiceName() const
+{
+	return LOCTEXT("OnlineServiceName", "AdvancedSessions Test");
+}
+
+bool FOnlineSubsystemAdvTest::Tick(float DeltaTime)
+{
+	if (!FOnlineSubsystemImpl::Tick(DeltaTime))
+		return false;
+
+	// Completions may queue more requests, those wait for a later tick
+	const double Now = FPlatformTime::Seconds();
+	int32 NumDue = 0;
+	while (NumDue < PendingRequests.Num() && PendingRequests[NumDue].DueTime <= Now)
+	{
+		NumDue++;
+	}
+
+	if (NumDue > 0)
+	{
+		TArray<FPendingRequest> Due(PendingRequests.GetData(), NumDue);
+		PendingRequests.RemoveAt(0, NumDue, EAllowShrinking::No);
+		for (FPendingRequest& Request : Due)
+		{
+			Request.Complete();
+		}
+	}
+	return true;
+}
+
+void FOnlineSubsystemAdvTest::QueueRequest(TFunction<void()>&& Complete)
+{
+	// Latency is the same for every request, so appending keeps the queue sorted by due time
+	PendingRequests.Add({ FPlatformTime::Seconds() + TestSettings.Latency, MoveTemp(Complete) });
+}
+
+void FOnlineSubsystemAdvTest::CompletePendingRequests()
+{
+	while (PendingRequests.Num() > 0)
+	{
+		FPendingRequest Request = MoveTemp(PendingRequests[0]);
+		PendingRequests.RemoveAt(0, 1, EAllowShrinking::No);
+		Request.Complete();
+	}
+}
+
+FUniqueNetIdRef FOnlineSubsystemAdvTest::MakeUserId(int32 Index)
+{
+	return FUniqueNetIdString::Create(FString::Printf(TEXT("AdvTestUser_%d"), Index), ADVTEST_SUBSYSTEM);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OnlineSubsystemAdvTestModule.h"
+#include "OnlineSubsystemAdvTest.h"
+#include "OnlineSubsystemModule.h"
+
+IMPLEMENT_MODULE(FOnlineSubsystemAdvTestModule, OnlineSubsystemAdvTest);
+
+// Creates ADVTEST instances for the online subsystem module, which owns them once created
+class FOnlineFactoryAdvTest : public IOnlineFactory
+{
+public:
+
+	virtual IOnlineSubsystemPtr CreateSubsystem(FName InstanceName) override
+	{
+		FOnlineSubsystemAdvTestPtr OnlineSub = MakeShared<FOnlineSubsystemAdvTest, ESPMode::ThreadSafe>(InstanceName);
+		if (!OnlineSub->Init())
+		{
+			UE_LOG(LogOnline, Warning, TEXT("ADVTEST API failed to initialize!"));
+			OnlineSub->Shutdown();
+			return nullptr;
+		}
+		return OnlineSub;
+	}
+};
+
+void FOnlineSubsystemAdvTestModule::StartupModule()
+{
+	Factory = new FOnlineFactoryAdvTest();
+
+	FOnlineSubsystemModule& OSS = FModuleManager::GetModuleChecked<FOnlineSubsystemModule>("OnlineSubsystem");
+	OSS.RegisterPlatformService(ADVTEST_SUBSYSTEM, Factory);
+}
+
+void FOnlineSubsystemAdvTestModule::ShutdownModule()
+{
+	FOnlineSubsystemModule& OSS = FModuleManager::GetModuleChecked<FOnlineSubsystemModule>("OnlineSubsystem");
+	OSS.UnregisterPlatformService(ADVTEST_SUBSYSTEM);
+
+	delete Factory;
+	Factory = nullptr;
+}
@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OnlineVoiceAdvTest.h"
+
+bool FOnlineVoiceAdvTest::Init()
+{
+	return true;
+}
+
+void FOnlineVoiceAdvTest::StartNetworkedVoice(uint8 LocalUserNum)
+{
+	if (LocalUserNum < MAX_LOCAL_PLAYERS)
+	{
+		LocalTalkers[LocalUserNum].bIsNetworked = true;
+	}
+}
+
+void FOnlineVoiceAdvTest::StopNetworkedVoice(uint8 LocalUserNum)
+{
+	if (LocalUserNum < MAX_LOCAL_PLAYERS)
+	{
+		LocalTalkers[LocalUserNum].bIsNetworked = false;
+	}
+}
+
+bool FOnlineVoiceAdvTest::RegisterLocalTalker(uint32 LocalUserNum)
+{
+	if (LocalUserNum >= MAX_LOCAL_PLAYERS)
+		return false;
+
+	LocalTalkers[LocalUserNum].bIsRegistered = true;
+	return true;
+}
+
+void FOnlineVoiceAdvTest::RegisterLocalTalkers()
+{
+	for (uint32 LocalUserNum = 0; LocalUserNum < MAX_LOCAL_PLAYERS; LocalUserNum++)
+	{
+		RegisterLocalTalker(LocalUserNum);
+	}
+}
+
+bool FOnlineVoiceAdvTest::UnregisterLocalTalker(uint32 LocalUserNum)
+{
+	if (LocalUserNum >= MAX_LOCAL_PLAYERS || !LocalTalkers[LocalUserNum].bIsRegistered)
+		return false;
+
+	LocalTalkers[LocalUserNum] = FLocalTalker();
+	return true;
+}
+
+void FOnlineVoiceAdvTest::UnregisterLocalTalkers()
+{
+	for (uint32 LocalUserNum = 0; LocalUserNum < MAX_LOCAL_PLAYERS; LocalUserNum++)
+	{
+		UnregisterLocalTalker(LocalUserNum);
+	}
+}
+
+bool FOnlineVoiceAdvTest::RegisterRemoteTalker(const FUniqueNetId& UniqueId)
+{
+	const FUniqueNetIdRef UniqueIdRef = UniqueId.AsShared();
+	RemoteTalkers.FindOrAdd(FUniqueNetIdWrapper(UniqueIdRef), { UniqueIdRef, false });
+	return true;
+}
+
+bool FOnlineVoiceAdvTest::UnregisterRemoteTalker(const FUniqueNetId& UniqueId)
+{
+	return RemoteTalkers.Remove(FUniqueNetIdWrapper(UniqueId.AsShared())) > 0;
+}
+
+void FOnlineVoiceAdvTest::RemoveAllRemoteTalkers()
+{
+	RemoteTalkers.Reset();
+}
+
+bool FOnlineVoiceAdvTest::IsHeadsetPresent(uint32 LocalUserNum)
+{
+	return LocalUserNum < MAX_LOCAL_PLAYERS && LocalTalkers[LocalUserNum].bIsRegistered;
+}
+
+bool FOnlineVoiceAdvTest::IsLocalPlayerTalking(uint32 LocalUserNum)
+{
+	// Nothing is captured, a local player is talking whenever its voice is on the network
+	return LocalUserNum < MAX_LOCAL_PLAYERS && LocalTalkers[LocalUserNum].bIsRegistered && LocalTalkers[LocalUserNum].bIsNetworked;
+}
+
+bool FOnlineVoiceAdvTest::IsRemotePlayerTalking(const FUniqueNetId& UniqueId)
+{
+	const FRemoteTalker* Talker = RemoteTalkers.Find(FUniqueNetIdWrapper(UniqueId.AsShared()));
+	return Talker && Talker->bIsTalking;
+}
+
+bool FOnlineVoiceAdvTest::IsMuted(uint32 LocalUserNum, const FUniqueNetId& UniqueId) const
+{
+	return LocalUserNum < MAX_LOCAL_PLAYERS && MutedTalkers[LocalUserNum].Contains(FUniqueNetIdWrapper(UniqueId.AsShared()));
+}
+
+bool FOnlineVoiceAdvTest::MuteRemoteTalker(uint8 LocalUserNum, const FUniqueNetId& PlayerId, bool bIsSystemWide)
+{
+	if (LocalUserNum >= MAX_LOCAL_PLAYERS)
+		return false;
+
+	const FUniqueNetIdWrapper Key(PlayerId.AsShared());
+	for (uint32 UserNum = 0; UserNum < MAX_LOCAL_PLAYERS; UserNum++)
+	{
+		if (bIsSystemWide || UserNum == LocalUserNum)
+		{
+			MutedTalkers[UserNum].Add(Key);
+		}
+	}
+	return true;
+}
+
+bool FOnlineVoiceAdvTest::UnmuteRemoteTalker(uint8 LocalUserNum, const FUniqueNetId& PlayerId, bool bIsSystemWide)
+{
+	if (LocalUserNum >= MAX_LOCAL_PLAYERS)
+		return false;
+
+	const FUniqueNetIdWrapper Key(PlayerId.AsShared());
+	for (uint32 UserNum = 0; UserNum < MAX_LOCAL_PLAYERS; UserNum++)
+	{
+		if (bIsSystemWide || UserNum == LocalUserNum)
+		{
+			MutedTalkers[UserNum].Remove(Key);
+		}
+	}
+	return true;
+}
+
+int32 FOnlineVoiceAdvTest::GetNumLocalTalkers()
+{
+	int32 NumLocalTalkers = 0;
+	for (const FLocalTalker& Talker : LocalTalkers)
+	{
+		NumLocalTalkers += Talker.bIsRegistered ? 1 : 0;
+	}
+	return NumLocalTalkers;
+}
+
+FString FOnlineVoiceAdvTest::GetVoiceDebugState() const
+{
+	return FString::Printf(TEXT("ADVTEST voice: %d remote talkers"), RemoteTalkers.Num());
+}
+
+void FOnlineVoiceAdvTest::SetRemoteTalking(const FUniqueNetId& UniqueId, bool bIsTalking)
+{
+	FRemoteTalker* Talker = RemoteTalkers.Find(FUniqueNetIdWrapper(UniqueId.AsShared()));
+	if (Talker && Talker->bIsTalking != bIsTalking)
+	{
+		Talker->bIsTalking = bIsTalking;
+		TriggerOnPlayerTalkingStateChangedDelegates(Talker->UniqueId, bIsTalking);
+	}
+}
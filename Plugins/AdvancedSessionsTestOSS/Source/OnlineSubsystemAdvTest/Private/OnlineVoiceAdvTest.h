@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Interfaces/VoiceInterface.h"
+#include "OnlineSubsystemTypes.h"
+
+// Voice interface of the ADVTEST subsystem. Talkers are registered, muted and queried like on a real backend, but no
+// audio is captured or sent, so a remote talker is only talking once a test says so through SetRemoteTalking.
+class FOnlineVoiceAdvTest : public IOnlineVoice
+{
+public:
+
+	FOnlineVoiceAdvTest() = default;
+	virtual ~FOnlineVoiceAdvTest() = default;
+
+	// IOnlineVoice, Init is public so the subsystem can call it
+	virtual bool Init() override;
+	virtual void StartNetworkedVoice(uint8 LocalUserNum) override;
+	virtual void StopNetworkedVoice(uint8 LocalUserNum) override;
+	virtual bool RegisterLocalTalker(uint32 LocalUserNum) override;
+	virtual void RegisterLocalTalkers() override;
+	virtual bool UnregisterLocalTalker(uint32 LocalUserNum) override;
+	virtual void UnregisterLocalTalkers() override;
+	virtual bool RegisterRemoteTalker(const FUniqueNetId& UniqueId) override;
+	virtual bool UnregisterRemoteTalker(const FUniqueNetId& UniqueId) override;
+	virtual void RemoveAllRemoteTalkers() override;
+	virtual bool IsHeadsetPresent(uint32 LocalUserNum) override;
+	virtual bool IsLocalPlayerTalking(uint32 LocalUserNum) override;
+	virtual bool IsRemotePlayerTalking(const FUniqueNetId& UniqueId) override;
+	virtual bool IsMuted(uint32 LocalUserNum, const FUniqueNetId& UniqueId) const override;
+	virtual bool MuteRemoteTalker(uint8 LocalUserNum, const FUniqueNetId& PlayerId, bool bIsSystemWide) override;
+	virtual bool UnmuteRemoteTalker(uint8 LocalUserNum, const FUniqueNetId& PlayerId, bool bIsSystemWide) override;
+	virtual TSharedPtr<class FVoicePacket> SerializeRemotePacket(FArchive& Ar) override { return nullptr; }
+	virtual TSharedPtr<class FVoicePacket> GetLocalPacket(uint32 LocalUserNum) override { return nullptr; }
+	virtual int32 GetNumLocalTalkers() override;
+	virtual void ClearVoicePackets() override {}
+	virtual void Tick(float DeltaTime) override {}
+	virtual FString GetVoiceDebugState() const override;
+
+	// What a backend would learn from the talker's voice packets, fires OnPlayerTalkingStateChanged when it changes
+	void SetRemoteTalking(const FUniqueNetId& UniqueId, bool bIsTalking);
+
+	int32 GetNumRemoteTalkers() const { return RemoteTalkers.Num(); }
+
+protected:
+
+	virtual void ProcessMuteChangeNotification() override {}
+
+private:
+
+	struct FLocalTalker
+	{
+		bool bIsRegistered = false;
+		bool bIsNetworked = false;
+	};
+
+	struct FRemoteTalker
+	{
+		FUniqueNetIdRef UniqueId;
+		bool bIsTalking = false;
+	};
+
+	FLocalTalker LocalTalkers[MAX_LOCAL_PLAYERS];
+
+	// Keyed by the id itself, the library looks talkers up once per player per frame
+	TMap<FUniqueNetIdWrapper, FRemoteTalker> RemoteTalkers;
+
+	// Who each local player muted, muting system wide mutes for all of them
+	TSet<FUniqueNetIdWrapper> MutedTalkers[MAX_LOCAL_PLAYERS];
+};
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "BlueprintDataDefinitions.h"
+#include "FindSessionsCallbackProxy.h"
+#include "AdvTestProxyListener.generated.h"
+
+// Binds to a callback proxy's dynamic delegates and records what they were called with, for the automation tests
+UCLASS(Transient)
+class UAdvTestProxyListener : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UFUNCTION()
+	void OnSessionsSuccess(const TArray<FBlueprintSessionResult>& Results) { NumSuccess++; SessionResults = Results; }
+
+	UFUNCTION()
+	void OnSessionsFailure(const TArray<FBlueprintSessionResult>& Results) { NumFailure++; SessionResults = Results; }
+
+	UFUNCTION()
+	void OnFriendsSuccess(const TArray<FBPFriendInfo>& Results) { NumSuccess++; Friends = Results; }
+
+	UFUNCTION()
+	void OnFriendsFailure(const TArray<FBPFriendInfo>& Results) { NumFailure++; Friends = Results; }
+
+	UFUNCTION()
+	void OnRecentPlayersSuccess(const TArray<FBPOnlineRecentPlayer>& Results) { NumSuccess++; RecentPlayers = Results; }
+
+	UFUNCTION()
+	void OnRecentPlayersFailure(const TArray<FBPOnlineRecentPlayer>& Results) { NumFailure++; RecentPlayers = Results; }
+
+	UFUNCTION()
+	void OnPingUpdated(int32 ResultIndex, int32 PingInMs) { PingUpdates.Emplace(ResultIndex, PingInMs); }
+
+	UFUNCTION()
+	void OnSuccess() { NumSuccess++; }
+
+	UFUNCTION()
+	void OnFailure() { NumFailure++; }
+
+	int32 NumSuccess = 0;
+	int32 NumFailure = 0;
+
+	TArray<FBlueprintSessionResult> SessionResults;
+	TArray<FBPFriendInfo> Friends;
+	TArray<FBPOnlineRecentPlayer> RecentPlayers;
+
+	// Result index and ping, in the order they were reported
+	TArray<TPair<int32, int32>> PingUpdates;
+};
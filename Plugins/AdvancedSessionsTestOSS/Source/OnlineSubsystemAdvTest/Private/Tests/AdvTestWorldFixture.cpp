@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvTestWorldFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OnlineSubsystemAdvTest.h"
+#include "OnlineSessionAdvTest.h"
+#include "AdvancedOnlineInterfaceCache.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+FAdvTestWorldFixture::~FAdvTestWorldFixture()
+{
+	if (OnlineSub)
+	{
+		// Nothing may complete into a proxy after its world is gone
+		OnlineSub->CompletePendingRequests();
+	}
+
+	if (World)
+	{
+		FAdvancedOnlineInterfaceCache::SetDefaultSubsystemOverride(World, NAME_None);
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+}
+
+bool FAdvTestWorldFixture::Init(FAutomationTestBase& Test)
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+	Context.SetCurrentWorld(World);
+
+	// The proxies and libraries look their subsystem up without a name, point those lookups at ADVTEST by name
+	FAdvancedOnlineInterfaceCache::SetDefaultSubsystemOverride(World, ADVTEST_SUBSYSTEM);
+	IOnlineSubsystem* Subsystem = FAdvancedOnlineInterfaceCache::GetSubsystem(World);
+	if (!Subsystem || Subsystem->GetSubsystemName() != ADVTEST_SUBSYSTEM)
+	{
+		Test.AddError(TEXT("Could not create the ADVTEST online subsystem, is the AdvancedSessionsTestOSS plugin enabled?"));
+		return false;
+	}
+	OnlineSub = static_cast<FOnlineSubsystemAdvTest*>(Subsystem);
+
+	// Requests from an earlier test must not complete into this one
+	OnlineSub->CompletePendingRequests();
+
+	PlayerController = World->SpawnActor<APlayerController>();
+	APlayerState* PlayerState = World->SpawnActor<APlayerState>();
+	PlayerState->SetUniqueId(FUniqueNetIdRepl(FOnlineSubsystemAdvTest::MakeUserId(999999)));
+	PlayerController->PlayerState = PlayerState;
+
+	// GetAndStoreFriendsList reads the controller id off the local player
+	PlayerController->Player = NewObject<ULocalPlayer>(GEngine);
+	return true;
+}
+
+FOnlineSessionAdvTest* FAdvTestWorldFixture::GetSessions() const
+{
+	return OnlineSub ? static_cast<FOnlineSessionAdvTest*>(OnlineSub->GetSessionInterface().Get()) : nullptr;
+}
+
+#endif
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class FAutomationTestBase;
+class FOnlineSubsystemAdvTest;
+class FOnlineSessionAdvTest;
+class APlayerController;
+class UWorld;
+
+// A game world with one player controller whose player state carries an ADVTEST user id, which is what the
+// callback proxies need to get past FOnlineSubsystemBPCallHelperAdvanced. The world's online lookups resolve to
+// ADVTEST whatever the default platform service is. Torn down when it goes out of scope.
+struct FAdvTestWorldFixture
+{
+	~FAdvTestWorldFixture();
+
+	// Adds an error and returns false when the ADVTEST subsystem cannot be created, the test should then fail
+	bool Init(FAutomationTestBase& Test);
+
+	FOnlineSessionAdvTest* GetSessions() const;
+
+	UWorld* World = nullptr;
+	APlayerController* PlayerController = nullptr;
+	FOnlineSubsystemAdvTest* OnlineSub = nullptr;
+};
+
+#endif
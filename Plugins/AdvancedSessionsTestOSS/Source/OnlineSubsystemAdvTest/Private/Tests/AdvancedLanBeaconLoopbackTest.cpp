@@ -0,0 +1,374 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OnlineSubsystemAdvTest.h"
+#include "AdvancedLanBeaconSubsystem.h"
+#include "AdvancedOnlineInterfaceCache.h"
+#include "Common/UdpSocketBuilder.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Online/OnlineSessionNames.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AdvTestLanBeaconLoopback
+{
+	constexpr int32 NumHosts = 3;
+	constexpr float Window = 0.5f;
+	constexpr double PhaseDeadlineSeconds = 10.0;
+
+	// A game instance of its own, as a second copy of the game on this machine would be. Its online lookups resolve to
+	// an ADVTEST instance of its own, so every host has its own game session. The test spans frames, so the game
+	// instance is held against garbage collection.
+	struct FInstance
+	{
+		TStrongObjectPtr<UGameInstance> GameInstance;
+		FName SubsystemName;
+
+		~FInstance()
+		{
+			if (!GameInstance)
+				return;
+
+			UWorld* World = GameInstance->GetWorld();
+			GameInstance->Shutdown();
+			if (World)
+			{
+				GEngine->DestroyWorldContext(World);
+				World->DestroyWorld(false);
+			}
+			GameInstance.Reset();
+			IOnlineSubsystem::Destroy(SubsystemName);
+			FAdvancedOnlineInterfaceCache::InvalidateAll();
+		}
+
+		bool Init(const FString& Name)
+		{
+			GameInstance.Reset(NewObject<UGameInstance>(GEngine));
+			GameInstance->InitializeStandalone(*Name);
+
+			SubsystemName = FName(*FString::Printf(TEXT("%s:%s"), *ADVTEST_SUBSYSTEM.ToString(), *Name));
+			FAdvancedOnlineInterfaceCache::SetDefaultSubsystemOverride(GameInstance->GetWorld(), SubsystemName);
+			return GetOnlineSub() != nullptr && GetBeacon() != nullptr;
+		}
+
+		FOnlineSubsystemAdvTest* GetOnlineSub() const
+		{
+			IOnlineSubsystem* Subsystem = FAdvancedOnlineInterfaceCache::GetSubsystem(GameInstance->GetWorld());
+			return Subsystem && Subsystem->GetSubsystemName() == ADVTEST_SUBSYSTEM ? static_cast<FOnlineSubsystemAdvTest*>(Subsystem) : nullptr;
+		}
+
+		UAdvancedLanBeaconSubsystem* GetBeacon() const
+		{
+			return GameInstance->GetSubsystem<UAdvancedLanBeaconSubsystem>();
+		}
+
+		FString GetSessionId() const
+		{
+			const FNamedOnlineSession* Session = GetOnlineSub()->GetSessionInterface()->GetNamedSession(NAME_GameSession);
+			return Session && Session->SessionInfo.IsValid() ? Session->SessionInfo->GetSessionId().ToString() : FString();
+		}
+
+		// A LAN game session, created at once instead of after the subsystem's latency
+		bool HostSession(int32 Index)
+		{
+			FOnlineSessionSettings Settings;
+			Settings.bIsLANMatch = true;
+			Settings.bShouldAdvertise = true;
+			Settings.NumPublicConnections = 4;
+			Settings.Set(SETTING_MAPNAME, FString::Printf(TEXT("Map_%d"), Index), EOnlineDataAdvertisementType::ViaOnlineService);
+
+			FOnlineSubsystemAdvTest* OnlineSub = GetOnlineSub();
+			if (!OnlineSub->GetSessionInterface()->CreateSession(0, NAME_GameSession, Settings))
+				return false;
+
+			OnlineSub->CompletePendingRequests();
+			return !GetSessionId().IsEmpty();
+		}
+	};
+
+	// What a query reported, filled in on the game thread by the ticker
+	struct FQueryResult
+	{
+		bool bDone = false;
+		bool bSuccess = false;
+		TArray<FOnlineSessionSearchResult> Results;
+	};
+
+	// Hosts NumHosts LAN sessions on separate instances and queries them from another one. Then checks that malformed
+	// probes go unanswered, that one address gets at most MaxRepliesPerSource replies a second, and that a host whose
+	// session is destroyed stops answering. The beacon runs on the core ticker, so this is a latent command.
+	class FLoopbackCommand : public IAutomationLatentCommand
+	{
+	public:
+
+		explicit FLoopbackCommand(FAutomationTestBase& InTest)
+			: Test(InTest)
+		{
+		}
+
+		virtual ~FLoopbackCommand()
+		{
+			if (RawSocket)
+			{
+				ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(RawSocket);
+			}
+		}
+
+		virtual bool Update() override
+		{
+			switch (Phase)
+			{
+			case EPhase::Start:
+				return Start();
+
+			case EPhase::FirstQuery:
+				if (!Query->bDone)
+					return IsPastDeadline();
+
+				CheckFirstQuery();
+				Phase = EPhase::WaitForBudget;
+				PhaseStartTime = FPlatformTime::Seconds();
+				return false;
+
+			case EPhase::WaitForBudget:
+				// The query's own probes came from this machine too, let their reply window roll over
+				if (FPlatformTime::Seconds() - PhaseStartTime < 1.1)
+					return false;
+
+				SendRawProbes();
+				Phase = EPhase::CountReplies;
+				return false;
+
+			case EPhase::CountReplies:
+				// Several frames, so the hosts' ticks have read every probe
+				ReceiveRawReplies();
+				if (FPlatformTime::Seconds() - PhaseStartTime < 0.5)
+					return false;
+
+				CheckRawReplies();
+				StopOneHost();
+				Phase = EPhase::SecondQuery;
+				return false;
+
+			case EPhase::SecondQuery:
+				if (!Query->bDone)
+					return IsPastDeadline();
+
+				CheckSecondQuery();
+				return true;
+			}
+			return true;
+		}
+
+	private:
+
+		enum class EPhase
+		{
+			Start,
+			FirstQuery,
+			WaitForBudget,
+			CountReplies,
+			SecondQuery
+		};
+
+		bool Start()
+		{
+			for (int32 Index = 0; Index <= NumHosts; Index++)
+			{
+				TUniquePtr<FInstance>& Instance = (Index < NumHosts) ? Hosts.AddDefaulted_GetRef() : Client;
+				Instance = MakeUnique<FInstance>();
+				const FString Name = (Index < NumHosts) ? FString::Printf(TEXT("LanBeaconHost%d"), Index) : FString(TEXT("LanBeaconClient"));
+				if (!Instance->Init(Name))
+				{
+					Test.AddError(FString::Printf(TEXT("%s has no ADVTEST subsystem or LAN beacon"), *Name));
+					return true;
+				}
+			}
+
+			TSet<int32> Ports;
+			for (int32 Index = 0; Index < NumHosts; Index++)
+			{
+				FInstance& Host = *Hosts[Index];
+				if (!Test.TestTrue(TEXT("Host creates its LAN session"), Host.HostSession(Index)) ||
+					!Test.TestTrue(TEXT("Host binds a beacon port"), Host.GetBeacon()->StartLanBeacon()))
+				{
+					Test.AddError(FString::Printf(TEXT("Beacon ports %d to %d may be held by other instances"), UAdvancedLanBeaconSubsystem::BasePort,
+						UAdvancedLanBeaconSubsystem::BasePort + UAdvancedLanBeaconSubsystem::NumPorts - 1));
+					return true;
+				}
+				Ports.Add(Host.GetBeacon()->GetAdvertisedPort());
+			}
+			Test.TestEqual(TEXT("Every host on this machine has a port of its own"), Ports.Num(), NumHosts);
+
+			StartQuery();
+			Phase = EPhase::FirstQuery;
+			return false;
+		}
+
+		void StartQuery()
+		{
+			Query = MakeShared<FQueryResult>();
+			TSharedRef<FQueryResult> Result = Query.ToSharedRef();
+			Client->GetBeacon()->QueryLanBeacons(Window, [Result](bool bSuccess, TArray<FOnlineSessionSearchResult>&& Results)
+			{
+				Result->bDone = true;
+				Result->bSuccess = bSuccess;
+				Result->Results = MoveTemp(Results);
+			});
+			PhaseStartTime = FPlatformTime::Seconds();
+		}
+
+		bool IsPastDeadline()
+		{
+			if (FPlatformTime::Seconds() - PhaseStartTime < PhaseDeadlineSeconds)
+				return false;
+
+			Test.AddError(TEXT("The LAN beacon query did not complete"));
+			return true;
+		}
+
+		// Other machines on the LAN running this build may answer as well, only our own hosts are checked
+		const FOnlineSessionSearchResult* FindResult(const FInstance& Host) const
+		{
+			const FString SessionId = Host.GetSessionId();
+			return Query->Results.FindByPredicate([&SessionId](const FOnlineSessionSearchResult& Result) { return Result.GetSessionIdStr() == SessionId; });
+		}
+
+		void CheckFirstQuery()
+		{
+			Test.TestTrue(TEXT("The query sends its probes"), Query->bSuccess);
+			for (int32 Index = 0; Index < NumHosts; Index++)
+			{
+				const FOnlineSessionSearchResult* Result = FindResult(*Hosts[Index]);
+				if (!Test.TestNotNull(FString::Printf(TEXT("Host %d is found over loopback"), Index), Result))
+					continue;
+
+				FBlueprintSessionResult BPResult;
+				BPResult.OnlineResult = *Result;
+				FString ConnectString;
+				Test.TestTrue(TEXT("A beacon result is told apart from a subsystem result"), UAdvancedLanBeaconSubsystem::IsLanBeaconResult(BPResult));
+				Test.TestTrue(TEXT("A beacon result resolves to its host's game address"), UAdvancedLanBeaconSubsystem::GetLanBeaconConnectString(BPResult, ConnectString));
+				const int32 URLPort = Hosts[Index]->GameInstance->GetWorld()->URL.Port;
+				const int32 GamePort = URLPort > 0 ? URLPort : FURL::UrlConfig.DefaultPort;
+				Test.TestTrue(TEXT("The connect string carries the game port"), ConnectString.EndsWith(FString::Printf(TEXT(":%d"), GamePort)));
+
+				FString MapName;
+				Result->Session.SessionSettings.Get(SETTING_MAPNAME, MapName);
+				Test.TestEqual(TEXT("Advertised settings come along"), MapName, FString::Printf(TEXT("Map_%d"), Index));
+			}
+		}
+
+		// Host 0 gets a probe one byte too long, host 1 a flood of valid ones
+		void SendRawProbes()
+		{
+			RawSocket = FUdpSocketBuilder(TEXT("AdvTestLanBeaconRaw")).AsNonBlocking().Build();
+			if (!RawSocket)
+			{
+				Test.AddError(TEXT("Could not open a socket to probe the hosts"));
+				return;
+			}
+
+			// The probe as AdvancedLanBeaconSubsystem.cpp lays it out: magic, version, type, nonce
+			TArray<uint8> Probe;
+			const uint32 Magic = 0x424C4556;
+			Probe.Append(reinterpret_cast<const uint8*>(&Magic), sizeof(Magic));
+			Probe.Add(1);
+			Probe.Add(1);
+			const uint64 Nonce = 0x0123456789ABCDEFull;
+			Probe.Append(reinterpret_cast<const uint8*>(&Nonce), sizeof(Nonce));
+			Test.TestEqual(TEXT("The hand built probe is the size the beacon expects"), Probe.Num(), UAdvancedLanBeaconSubsystem::ProbeSize);
+
+			TArray<uint8> Oversized = Probe;
+			Oversized.Add(0);
+
+			ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+			TSharedRef<FInternetAddr> Malformed = SocketSubsystem->CreateInternetAddr();
+			Malformed->SetLoopbackAddress();
+			Malformed->SetPort(Hosts[0]->GetBeacon()->GetAdvertisedPort());
+			TSharedRef<FInternetAddr> Flooded = SocketSubsystem->CreateInternetAddr();
+			Flooded->SetLoopbackAddress();
+			Flooded->SetPort(Hosts[1]->GetBeacon()->GetAdvertisedPort());
+
+			int32 BytesSent = 0;
+			RawSocket->SendTo(Oversized.GetData(), Oversized.Num(), BytesSent, *Malformed);
+			RawSocket->SendTo(Probe.GetData(), Probe.Num() - 1, BytesSent, *Malformed);
+			for (int32 Index = 0; Index < 3 * UAdvancedLanBeaconSubsystem::MaxRepliesPerSource; Index++)
+			{
+				RawSocket->SendTo(Probe.GetData(), Probe.Num(), BytesSent, *Flooded);
+			}
+			PhaseStartTime = FPlatformTime::Seconds();
+		}
+
+		void ReceiveRawReplies()
+		{
+			if (!RawSocket)
+				return;
+
+			TSharedRef<FInternetAddr> From = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+			uint8 Buffer[UAdvancedLanBeaconSubsystem::MaxPacketSize];
+			int32 BytesRead = 0;
+			while (RawSocket->RecvFrom(Buffer, sizeof(Buffer), BytesRead, *From))
+			{
+				if (From->GetPort() == Hosts[0]->GetBeacon()->GetAdvertisedPort())
+					NumMalformedReplies++;
+				else if (From->GetPort() == Hosts[1]->GetBeacon()->GetAdvertisedPort())
+					NumFloodReplies++;
+			}
+		}
+
+		void CheckRawReplies()
+		{
+			Test.TestEqual(TEXT("Probes of the wrong size go unanswered"), NumMalformedReplies, 0);
+			Test.TestEqual(TEXT("One address gets at most MaxRepliesPerSource replies a second"), NumFloodReplies, UAdvancedLanBeaconSubsystem::MaxRepliesPerSource);
+		}
+
+		void StopOneHost()
+		{
+			FInstance& Host = *Hosts[NumHosts - 1];
+			StoppedSessionId = Host.GetSessionId();
+			Host.GetOnlineSub()->GetSessionInterface()->DestroySession(NAME_GameSession);
+			Test.TestFalse(TEXT("Destroying the game session stops the beacon"), Host.GetBeacon()->IsAdvertising());
+
+			StartQuery();
+			Phase = EPhase::SecondQuery;
+		}
+
+		void CheckSecondQuery()
+		{
+			for (int32 Index = 0; Index < NumHosts - 1; Index++)
+			{
+				Test.TestNotNull(FString::Printf(TEXT("Host %d is still found"), Index), FindResult(*Hosts[Index]));
+			}
+			Test.TestFalse(TEXT("A host without a session is no longer found"),
+				Query->Results.ContainsByPredicate([this](const FOnlineSessionSearchResult& Result) { return Result.GetSessionIdStr() == StoppedSessionId; }));
+		}
+
+		FAutomationTestBase& Test;
+		TArray<TUniquePtr<FInstance>> Hosts;
+		TUniquePtr<FInstance> Client;
+		TSharedPtr<FQueryResult> Query;
+
+		FSocket* RawSocket = nullptr;
+		int32 NumMalformedReplies = 0;
+		int32 NumFloodReplies = 0;
+		FString StoppedSessionId;
+
+		EPhase Phase = EPhase::Start;
+		double PhaseStartTime = 0.0;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAdvancedLanBeaconLoopbackTest, "AdvancedSessions.TestOSS.LanBeacon.Loopback",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAdvancedLanBeaconLoopbackTest::RunTest(const FString& Parameters)
+{
+	ADD_LATENT_AUTOMATION_COMMAND(AdvTestLanBeaconLoopback::FLoopbackCommand(*this));
+	return true;
+}
+
+#endif
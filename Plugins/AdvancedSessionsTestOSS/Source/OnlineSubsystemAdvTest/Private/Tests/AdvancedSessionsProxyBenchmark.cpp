@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvTestWorldFixture.h"
+#include "AdvTestProxyListener.h"
+#include "OnlineSubsystemAdvTest.h"
+#include "OnlineSessionAdvTest.h"
+#include "FindSessionsCallbackProxyAdvanced.h"
+#include "GetFriendsCallbackProxy.h"
+#include "GetRecentPlayersCallbackProxy.h"
+#include "Online/OnlineSessionNames.h"
+#include "Misc/AutomationTest.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAdvancedSessionsProxyBenchmark, "AdvancedSessions.TestOSS.ProxyCosts.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FAdvancedSessionsProxyBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumRuns = 10;
+	constexpr int32 NumSessions = 1000;
+	constexpr int32 NumFriends = 5000;
+	constexpr int32 NumRecentPlayers = 5000;
+
+	FAdvTestWorldFixture Fixture;
+	if (!Fixture.Init(*this))
+		return false;
+
+	FAdvTestOnlineSettings Settings;
+	Settings.Latency = 0.0f;
+	Settings.NumSessions = NumSessions;
+	Settings.NumFriends = NumFriends;
+	Settings.NumRecentPlayers = NumRecentPlayers;
+	Fixture.OnlineSub->SetTestSettings(Settings);
+
+	const FUniqueNetIdRef UserId = Fixture.PlayerController->PlayerState->GetUniqueId().GetUniqueNetId().ToSharedRef();
+	FBPUniqueNetId BPUserId;
+	BPUserId.SetUniqueNetId(UserId);
+
+	// Every proxy cost is what the proxy adds on top of the same request made straight to the interface,
+	// which is mostly ADVTEST building its synthetic results
+	IOnlineSessionPtr Sessions = Fixture.OnlineSub->GetSessionInterface();
+	IOnlineFriendsPtr Friends = Fixture.OnlineSub->GetFriendsInterface();
+
+	double RawSearchSeconds = 0.0;
+	double ProxySearchSeconds = 0.0;
+	double RawFriendsSeconds = 0.0;
+	double ProxyFriendsSeconds = 0.0;
+	double RawRecentSeconds = 0.0;
+	double ProxyRecentSeconds = 0.0;
+	TArray<FBlueprintSessionResult> SessionResults;
+
+	for (int32 Run = 0; Run < NumRuns; Run++)
+	{
+		// Merge: both searches of an AllServers query, deduped into one list
+		TSharedRef<FOnlineSessionSearch> PresenceSearch = MakeShared<FOnlineSessionSearch>();
+		TSharedRef<FOnlineSessionSearch> DedicatedSearch = MakeShared<FOnlineSessionSearch>();
+		PresenceSearch->MaxSearchResults = NumSessions;
+		DedicatedSearch->MaxSearchResults = NumSessions;
+
+		double Start = FPlatformTime::Seconds();
+		Sessions->FindSessions(*UserId, PresenceSearch);
+		Sessions->FindSessions(*UserId, DedicatedSearch);
+		Fixture.OnlineSub->CompletePendingRequests();
+		RawSearchSeconds += FPlatformTime::Seconds() - Start;
+
+		UAdvTestProxyListener* SearchListener = NewObject<UAdvTestProxyListener>();
+		UFindSessionsCallbackProxyAdvanced* SearchProxy = UFindSessionsCallbackProxyAdvanced::FindSessionsAdvanced(Fixture.World, Fixture.PlayerController, NumSessions, false,
+			EBPServerPresenceSearchType::AllServers, TArray<FSessionsSearchSetting>(), false, false, false, true, 0, 0.0f);
+		SearchProxy->OnSuccess.AddDynamic(SearchListener, &UAdvTestProxyListener::OnSessionsSuccess);
+		Start = FPlatformTime::Seconds();
+		SearchProxy->Activate();
+		Fixture.OnlineSub->CompletePendingRequests();
+		ProxySearchSeconds += FPlatformTime::Seconds() - Start;
+		SessionResults = MoveTemp(SearchListener->SessionResults);
+
+		// Convert: FOnlineFriend and FOnlineRecentPlayer into their Blueprint structs
+		Start = FPlatformTime::Seconds();
+		Friends->ReadFriendsList(0, EFriendsLists::ToString(EFriendsLists::Default));
+		Fixture.OnlineSub->CompletePendingRequests();
+		RawFriendsSeconds += FPlatformTime::Seconds() - Start;
+
+		UAdvTestProxyListener* FriendsListener = NewObject<UAdvTestProxyListener>();
+		UGetFriendsCallbackProxy* FriendsProxy = UGetFriendsCallbackProxy::GetAndStoreFriendsList(Fixture.World, Fixture.PlayerController);
+		FriendsProxy->OnSuccess.AddDynamic(FriendsListener, &UAdvTestProxyListener::OnFriendsSuccess);
+		Start = FPlatformTime::Seconds();
+		FriendsProxy->Activate();
+		Fixture.OnlineSub->CompletePendingRequests();
+		ProxyFriendsSeconds += FPlatformTime::Seconds() - Start;
+		TestEqual(TEXT("Every friend is converted"), FriendsListener->Friends.Num(), NumFriends);
+
+		Start = FPlatformTime::Seconds();
+		Friends->QueryRecentPlayers(*UserId, FString());
+		Fixture.OnlineSub->CompletePendingRequests();
+		RawRecentSeconds += FPlatformTime::Seconds() - Start;
+
+		UAdvTestProxyListener* RecentListener = NewObject<UAdvTestProxyListener>();
+		UGetRecentPlayersCallbackProxy* RecentProxy = UGetRecentPlayersCallbackProxy::GetAndStoreRecentPlayersList(Fixture.World, BPUserId);
+		RecentProxy->OnSuccess.AddDynamic(RecentListener, &UAdvTestProxyListener::OnRecentPlayersSuccess);
+		Start = FPlatformTime::Seconds();
+		RecentProxy->Activate();
+		Fixture.OnlineSub->CompletePendingRequests();
+		ProxyRecentSeconds += FPlatformTime::Seconds() - Start;
+		TestEqual(TEXT("Every recent player is converted"), RecentListener->RecentPlayers.Num(), NumRecentPlayers);
+	}
+
+	TestEqual(TEXT("Every session is merged once"), SessionResults.Num(), NumSessions);
+
+	// Filter: two string filters, then the 50 lowest pings
+	TArray<FSessionsSearchSetting> Filters;
+	FSessionsSearchSetting& GameMode = Filters.AddDefaulted_GetRef();
+	GameMode.ComparisonOp = EOnlineComparisonOpRedux::NotEquals;
+	GameMode.PropertyKeyPair.Key = SETTING_GAMEMODE;
+	GameMode.PropertyKeyPair.Data.SetValue(FString(TEXT("deathmatch")));
+
+	FSessionsSearchSetting& MapName = Filters.AddDefaulted_GetRef();
+	MapName.ComparisonOp = EOnlineComparisonOpRedux::NotEquals;
+	MapName.PropertyKeyPair.Key = SETTING_MAPNAME;
+	MapName.PropertyKeyPair.Data.SetValue(FString(TEXT("Map_0")));
+
+	int32 NumFiltered = 0;
+	double Start = FPlatformTime::Seconds();
+	for (int32 Run = 0; Run < NumRuns * 10; Run++)
+	{
+		TArray<FBlueprintSessionResult> Filtered;
+		UFindSessionsCallbackProxyAdvanced::FilterSessionResults(SessionResults, Filters, Filtered, EBPSessionResultSort::LowestPing, 50);
+		NumFiltered = Filtered.Num();
+	}
+	const double FilterSeconds = (FPlatformTime::Seconds() - Start) / (NumRuns * 10);
+	TestEqual(TEXT("TopK keeps 50 of the filtered sessions"), NumFiltered, 50);
+
+	auto PerItemNs = [](double ProxySeconds, double RawSeconds, int32 NumItems)
+	{
+		return FMath::Max(ProxySeconds - RawSeconds, 0.0) * 1e9 / (NumRuns * NumItems);
+	};
+
+	AddInfo(FString::Printf(TEXT("Merge: %d sessions from two searches, %.1f ns per result on top of the searches themselves"),
+		NumSessions, PerItemNs(ProxySearchSeconds, RawSearchSeconds, 2 * NumSessions)));
+	AddInfo(FString::Printf(TEXT("Filter: %d sessions through 2 filters and a top 50 ping sort, %.3f ms, %.1f ns per session"),
+		NumSessions, FilterSeconds * 1e3, FilterSeconds * 1e9 / NumSessions));
+	AddInfo(FString::Printf(TEXT("Convert: %d friends, %.1f ns per friend on top of the read"),
+		NumFriends, PerItemNs(ProxyFriendsSeconds, RawFriendsSeconds, NumFriends)));
+	AddInfo(FString::Printf(TEXT("Convert: %d recent players, %.1f ns per player on top of the query"),
+		NumRecentPlayers, PerItemNs(ProxyRecentSeconds, RawRecentSeconds, NumRecentPlayers)));
+	return true;
+}
+
+#endif
@@ -0,0 +1,264 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvTestWorldFixture.h"
+#include "AdvTestProxyListener.h"
+#include "OnlineSubsystemAdvTest.h"
+#include "OnlineSessionAdvTest.h"
+#include "FindSessionsCallbackProxyAdvanced.h"
+#include "GetFriendsCallbackProxy.h"
+#include "GetRecentPlayersCallbackProxy.h"
+#include "UpdateSessionCallbackProxyAdvanced.h"
+#include "Online/OnlineSessionNames.h"
+#include "Misc/AutomationTest.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAdvancedSessionsFindSessionsTest, "AdvancedSessions.TestOSS.FindSessionsAdvanced",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAdvancedSessionsFindSessionsTest::RunTest(const FString& Parameters)
+{
+	FAdvTestWorldFixture Fixture;
+	if (!Fixture.Init(*this))
+		return false;
+
+	FAdvTestOnlineSettings Settings;
+	Settings.NumSessions = 30;
+	Fixture.OnlineSub->SetTestSettings(Settings);
+
+	UAdvTestProxyListener* Listener = NewObject<UAdvTestProxyListener>();
+	UAdvTestProxyListener* PartialListener = NewObject<UAdvTestProxyListener>();
+
+	// AllServers runs the presence and dedicated searches side by side, and ADVTEST returns the same sessions to both
+	UFindSessionsCallbackProxyAdvanced* Proxy = UFindSessionsCallbackProxyAdvanced::FindSessionsAdvanced(Fixture.World, Fixture.PlayerController, 100, false,
+		EBPServerPresenceSearchType::AllServers, TArray<FSessionsSearchSetting>(), false, false, false, true, 0, 0.0f);
+	Proxy->OnSuccess.AddDynamic(Listener, &UAdvTestProxyListener::OnSessionsSuccess);
+	Proxy->OnFailure.AddDynamic(Listener, &UAdvTestProxyListener::OnSessionsFailure);
+	Proxy->OnPartialResults.AddDynamic(PartialListener, &UAdvTestProxyListener::OnSessionsSuccess);
+	Proxy->Activate();
+
+	TestEqual(TEXT("Both searches are in flight at once"), Fixture.OnlineSub->GetNumPendingRequests(), 2);
+	TestEqual(TEXT("Nothing is reported before the searches complete"), Listener->NumSuccess + Listener->NumFailure, 0);
+
+	Fixture.OnlineSub->CompletePendingRequests();
+
+	TestEqual(TEXT("The first search to finish is reported as partial results"), PartialListener->NumSuccess, 1);
+	TestEqual(TEXT("Partial results hold the first search's sessions"), PartialListener->SessionResults.Num(), 30);
+	TestEqual(TEXT("OnSuccess fires once"), Listener->NumSuccess, 1);
+	TestEqual(TEXT("OnFailure does not fire"), Listener->NumFailure, 0);
+	TestEqual(TEXT("Sessions both searches found are listed once"), Listener->SessionResults.Num(), 30);
+
+	TSet<FString> SessionIds;
+	for (const FBlueprintSessionResult& Result : Listener->SessionResults)
+	{
+		SessionIds.Add(Result.OnlineResult.GetSessionIdStr());
+	}
+	TestEqual(TEXT("Every result is a different session"), SessionIds.Num(), Listener->SessionResults.Num());
+
+	// String filters ignore case, like the backends do
+	FSessionsSearchSetting Filter;
+	Filter.ComparisonOp = EOnlineComparisonOpRedux::Equals;
+	Filter.PropertyKeyPair.Key = SETTING_GAMEMODE;
+	Filter.PropertyKeyPair.Data.SetValue(FString(TEXT("deathmatch")));
+
+	TArray<FBlueprintSessionResult> Filtered;
+	UFindSessionsCallbackProxyAdvanced::FilterSessionResults(Listener->SessionResults, { Filter }, Filtered);
+	TestEqual(TEXT("Every third session runs Deathmatch"), Filtered.Num(), 10);
+
+	TArray<FBlueprintSessionResult> Closest;
+	UFindSessionsCallbackProxyAdvanced::FilterSessionResults(Listener->SessionResults, TArray<FSessionsSearchSetting>(), Closest, EBPSessionResultSort::LowestPing, 5);
+	TestEqual(TEXT("TopK keeps that many results"), Closest.Num(), 5);
+	for (int32 i = 1; i < Closest.Num(); i++)
+	{
+		TestTrue(TEXT("Results are ordered by ping"), Closest[i - 1].OnlineResult.PingInMs <= Closest[i].OnlineResult.PingInMs);
+	}
+
+	// A backend that fails both searches fails the query
+	Settings.bFailRequests = true;
+	Fixture.OnlineSub->SetTestSettings(Settings);
+
+	UAdvTestProxyListener* FailListener = NewObject<UAdvTestProxyListener>();
+	UFindSessionsCallbackProxyAdvanced* FailProxy = UFindSessionsCallbackProxyAdvanced::FindSessionsAdvanced(Fixture.World, Fixture.PlayerController, 100, false,
+		EBPServerPresenceSearchType::AllServers, TArray<FSessionsSearchSetting>(), false, false, false, true, 0, 0.0f);
+	FailProxy->OnSuccess.AddDynamic(FailListener, &UAdvTestProxyListener::OnSessionsSuccess);
+	FailProxy->OnFailure.AddDynamic(FailListener, &UAdvTestProxyListener::OnSessionsFailure);
+	FailProxy->Activate();
+	Fixture.OnlineSub->CompletePendingRequests();
+
+	TestEqual(TEXT("A failed query calls OnFailure once"), FailListener->NumFailure, 1);
+	TestEqual(TEXT("A failed query does not call OnSuccess"), FailListener->NumSuccess, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAdvancedSessionsGetFriendsTest, "AdvancedSessions.TestOSS.GetFriends",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAdvancedSessionsGetFriendsTest::RunTest(const FString& Parameters)
+{
+	FAdvTestWorldFixture Fixture;
+	if (!Fixture.Init(*this))
+		return false;
+
+	FAdvTestOnlineSettings Settings;
+	Settings.NumFriends = 25;
+	Fixture.OnlineSub->SetTestSettings(Settings);
+
+	UAdvTestProxyListener* Listener = NewObject<UAdvTestProxyListener>();
+	UGetFriendsCallbackProxy* Proxy = UGetFriendsCallbackProxy::GetAndStoreFriendsList(Fixture.World, Fixture.PlayerController);
+	Proxy->OnSuccess.AddDynamic(Listener, &UAdvTestProxyListener::OnFriendsSuccess);
+	Proxy->OnFailure.AddDynamic(Listener, &UAdvTestProxyListener::OnFriendsFailure);
+	Proxy->Activate();
+
+	TestEqual(TEXT("Nothing is reported before the read completes"), Listener->NumSuccess + Listener->NumFailure, 0);
+	Fixture.OnlineSub->CompletePendingRequests();
+
+	TestEqual(TEXT("OnSuccess fires once"), Listener->NumSuccess, 1);
+	TestEqual(TEXT("OnFailure does not fire"), Listener->NumFailure, 0);
+	TestEqual(TEXT("Every friend is listed"), Listener->Friends.Num(), 25);
+
+	for (int32 Index = 0; Index < Listener->Friends.Num(); Index++)
+	{
+		const FBPFriendInfo& Friend = Listener->Friends[Index];
+		TestEqual(TEXT("Friends keep the order the subsystem listed them in"), Friend.DisplayName, FString::Printf(TEXT("Friend %04d"), Index));
+		TestEqual(TEXT("Presence is copied"), Friend.PresenceInfo.bIsOnline, (Index % 3) != 0);
+		TestTrue(TEXT("Every friend has a unique net id"), Friend.UniqueNetId.IsValid());
+	}
+
+	Settings.bFailRequests = true;
+	Fixture.OnlineSub->SetTestSettings(Settings);
+
+	UAdvTestProxyListener* FailListener = NewObject<UAdvTestProxyListener>();
+	UGetFriendsCallbackProxy* FailProxy = UGetFriendsCallbackProxy::GetAndStoreFriendsList(Fixture.World, Fixture.PlayerController);
+	FailProxy->OnSuccess.AddDynamic(FailListener, &UAdvTestProxyListener::OnFriendsSuccess);
+	FailProxy->OnFailure.AddDynamic(FailListener, &UAdvTestProxyListener::OnFriendsFailure);
+	FailProxy->Activate();
+	Fixture.OnlineSub->CompletePendingRequests();
+
+	TestEqual(TEXT("A failed read calls OnFailure once"), FailListener->NumFailure, 1);
+	TestEqual(TEXT("A failed read does not call OnSuccess"), FailListener->NumSuccess, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAdvancedSessionsGetRecentPlayersTest, "AdvancedSessions.TestOSS.GetRecentPlayers",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAdvancedSessionsGetRecentPlayersTest::RunTest(const FString& Parameters)
+{
+	FAdvTestWorldFixture Fixture;
+	if (!Fixture.Init(*this))
+		return false;
+
+	FAdvTestOnlineSettings Settings;
+	Settings.NumRecentPlayers = 12;
+	Fixture.OnlineSub->SetTestSettings(Settings);
+
+	FBPUniqueNetId UserId;
+	UserId.SetUniqueNetId(Fixture.PlayerController->PlayerState->GetUniqueId().GetUniqueNetId());
+
+	UAdvTestProxyListener* Listener = NewObject<UAdvTestProxyListener>();
+	UGetRecentPlayersCallbackProxy* Proxy = UGetRecentPlayersCallbackProxy::GetAndStoreRecentPlayersList(Fixture.World, UserId);
+	Proxy->OnSuccess.AddDynamic(Listener, &UAdvTestProxyListener::OnRecentPlayersSuccess);
+	Proxy->OnFailure.AddDynamic(Listener, &UAdvTestProxyListener::OnRecentPlayersFailure);
+	Proxy->Activate();
+	Fixture.OnlineSub->CompletePendingRequests();
+
+	TestEqual(TEXT("OnSuccess fires once"), Listener->NumSuccess, 1);
+	TestEqual(TEXT("OnFailure does not fire"), Listener->NumFailure, 0);
+	TestEqual(TEXT("Every recent player is listed"), Listener->RecentPlayers.Num(), 12);
+	if (Listener->RecentPlayers.Num() > 0)
+	{
+		TestEqual(TEXT("Display names are copied"), Listener->RecentPlayers[0].DisplayName, FString(TEXT("Recent 0000")));
+	}
+
+	// The proxy removes its delegate when it completes, a second query must not reach the first proxy
+	UAdvTestProxyListener* SecondListener = NewObject<UAdvTestProxyListener>();
+	UGetRecentPlayersCallbackProxy* SecondProxy = UGetRecentPlayersCallbackProxy::GetAndStoreRecentPlayersList(Fixture.World, UserId);
+	SecondProxy->OnSuccess.AddDynamic(SecondListener, &UAdvTestProxyListener::OnRecentPlayersSuccess);
+	SecondProxy->OnFailure.AddDynamic(SecondListener, &UAdvTestProxyListener::OnRecentPlayersFailure);
+	SecondProxy->Activate();
+	Fixture.OnlineSub->CompletePendingRequests();
+
+	TestEqual(TEXT("The second query completes its own proxy"), SecondListener->NumSuccess, 1);
+	TestEqual(TEXT("The first proxy is not called again"), Listener->NumSuccess, 1);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAdvancedSessionsUpdateSessionTest, "AdvancedSessions.TestOSS.UpdateSessionAdvanced",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAdvancedSessionsUpdateSessionTest::RunTest(const FString& Parameters)
+{
+	FAdvTestWorldFixture Fixture;
+	if (!Fixture.Init(*this))
+		return false;
+
+	FAdvTestOnlineSettings Settings;
+	Fixture.OnlineSub->SetTestSettings(Settings);
+
+	FOnlineSessionAdvTest* Sessions = Fixture.GetSessions();
+	Sessions->DestroySession(NAME_GameSession);
+
+	FOnlineSessionSettings HostSettings;
+	HostSettings.NumPublicConnections = 8;
+	HostSettings.bShouldAdvertise = true;
+	Sessions->CreateSession(*Fixture.PlayerController->PlayerState->GetUniqueId().GetUniqueNetId(), NAME_GameSession, HostSettings);
+	Fixture.OnlineSub->CompletePendingRequests();
+	if (!TestNotNull(TEXT("The game session was created"), Sessions->GetSessionSettings(NAME_GameSession)))
+		return false;
+
+	auto RunUpdate = [&Fixture](int32 PublicConnections, const TArray<FSessionPropertyKeyPair>& ExtraSettings, bool bRefreshOnlineData)
+	{
+		UAdvTestProxyListener* Listener = NewObject<UAdvTestProxyListener>();
+		UUpdateSessionCallbackProxyAdvanced* Proxy = UUpdateSessionCallbackProxyAdvanced::UpdateSession(Fixture.World, ExtraSettings, PublicConnections, 0, false, false, false, bRefreshOnlineData, false, true);
+		Proxy->OnSuccess.AddDynamic(Listener, &UAdvTestProxyListener::OnSuccess);
+		Proxy->OnFailure.AddDynamic(Listener, &UAdvTestProxyListener::OnFailure);
+		Proxy->Activate();
+		Fixture.OnlineSub->CompletePendingRequests();
+		return Listener;
+	};
+
+	FSessionPropertyKeyPair MapName;
+	MapName.Key = SETTING_MAPNAME;
+	MapName.Data.SetValue(FString(TEXT("Map_A")));
+
+	int32 NumCalls = Sessions->GetNumUpdateSessionCalls();
+	UAdvTestProxyListener* Listener = RunUpdate(16, { MapName }, false);
+	TestEqual(TEXT("A changed session updates successfully"), Listener->NumSuccess, 1);
+	TestEqual(TEXT("A changed session is sent to the backend"), Sessions->GetNumUpdateSessionCalls(), NumCalls + 1);
+	TestEqual(TEXT("The new connection count is kept"), Sessions->GetSessionSettings(NAME_GameSession)->NumPublicConnections, 16);
+
+	// Nothing differs and no refresh was asked for, the backend is left alone
+	NumCalls = Sessions->GetNumUpdateSessionCalls();
+	Listener = RunUpdate(16, { MapName }, false);
+	TestEqual(TEXT("An unchanged update still succeeds"), Listener->NumSuccess, 1);
+	TestEqual(TEXT("An unchanged update without a refresh is not sent"), Sessions->GetNumUpdateSessionCalls(), NumCalls);
+
+	// A refresh is always sent
+	NumCalls = Sessions->GetNumUpdateSessionCalls();
+	Listener = RunUpdate(16, { MapName }, true);
+	TestEqual(TEXT("A refresh succeeds"), Listener->NumSuccess, 1);
+	TestEqual(TEXT("A refresh is sent even when nothing changed"), Sessions->GetNumUpdateSessionCalls(), NumCalls + 1);
+
+	// A failed update leaves the settings as the backend still advertises them
+	Settings.bFailRequests = true;
+	Fixture.OnlineSub->SetTestSettings(Settings);
+
+	FSessionPropertyKeyPair OtherMap = MapName;
+	OtherMap.Data.SetValue(FString(TEXT("Map_B")));
+	Listener = RunUpdate(4, { OtherMap }, false);
+	TestEqual(TEXT("A failed update calls OnFailure once"), Listener->NumFailure, 1);
+	TestEqual(TEXT("A failed update does not call OnSuccess"), Listener->NumSuccess, 0);
+
+	const FOnlineSessionSettings* Restored = Sessions->GetSessionSettings(NAME_GameSession);
+	TestEqual(TEXT("A failed update restores the connection count"), Restored->NumPublicConnections, 16);
+
+	FString RestoredMap;
+	Restored->Get(SETTING_MAPNAME, RestoredMap);
+	TestEqual(TEXT("A failed update restores the extra settings"), RestoredMap, FString(TEXT("Map_A")));
+
+	Sessions->DestroySession(NAME_GameSession);
+	return true;
+}
+
+#endif
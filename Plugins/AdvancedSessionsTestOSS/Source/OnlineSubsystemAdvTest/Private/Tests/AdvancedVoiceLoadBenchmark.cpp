@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvTestWorldFixture.h"
+#include "OnlineSubsystemAdvTest.h"
+#include "OnlineVoiceAdvTest.h"
+#include "AdvancedVoiceLibrary.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAdvancedVoiceLoadBenchmark, "AdvancedSessions.TestOSS.VoiceLoad.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FAdvancedVoiceLoadBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumTalkers = 64;
+	constexpr int32 NumFrames = 1000;
+
+	FAdvTestWorldFixture Fixture;
+	if (!Fixture.Init(*this))
+		return false;
+
+	TSharedPtr<FOnlineVoiceAdvTest, ESPMode::ThreadSafe> Voice = StaticCastSharedPtr<FOnlineVoiceAdvTest>(Fixture.OnlineSub->GetVoiceInterface());
+	if (!TestTrue(TEXT("ADVTEST has a voice interface"), Voice.IsValid()))
+		return false;
+
+	TArray<FBPUniqueNetId> Talkers;
+	for (int32 Index = 0; Index < NumTalkers; Index++)
+	{
+		FBPUniqueNetId& Talker = Talkers.AddDefaulted_GetRef();
+		Talker.SetUniqueNetId(FOnlineSubsystemAdvTest::MakeUserId(Index));
+	}
+
+	// A full lobby joining at once, then every third player talking and every fourth muted by the local player
+	double Start = FPlatformTime::Seconds();
+	int32 NumRegistered = 0;
+	for (const FBPUniqueNetId& Talker : Talkers)
+	{
+		NumRegistered += UAdvancedVoiceLibrary::RegisterRemoteTalker(Fixture.World, Talker) ? 1 : 0;
+	}
+	const double RegisterSeconds = FPlatformTime::Seconds() - Start;
+	TestEqual(TEXT("Every talker is registered"), NumRegistered, NumTalkers);
+	TestEqual(TEXT("The interface holds every talker"), Voice->GetNumRemoteTalkers(), NumTalkers);
+
+	for (int32 Index = 0; Index < NumTalkers; Index++)
+	{
+		Voice->SetRemoteTalking(*Talkers[Index].GetUniqueNetId(), Index % 3 == 0);
+		if (Index % 4 == 0)
+		{
+			UAdvancedVoiceLibrary::MuteRemoteTalker(Fixture.World, 0, Talkers[Index]);
+		}
+	}
+
+	// What a voice HUD does each frame, ask whether every player is talking and whether they are muted. The same
+	// questions straight to the interface show what the library adds on top.
+	int32 NumTalking = 0;
+	int32 NumMuted = 0;
+	Start = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		NumTalking = 0;
+		NumMuted = 0;
+		for (const FBPUniqueNetId& Talker : Talkers)
+		{
+			NumTalking += UAdvancedVoiceLibrary::IsRemotePlayerTalking(Fixture.World, Talker) ? 1 : 0;
+			NumMuted += UAdvancedVoiceLibrary::IsPlayerMuted(Fixture.World, 0, Talker) ? 1 : 0;
+		}
+	}
+	const double LibrarySeconds = FPlatformTime::Seconds() - Start;
+	TestEqual(TEXT("Every third talker is talking"), NumTalking, (NumTalkers + 2) / 3);
+	TestEqual(TEXT("Every fourth talker is muted"), NumMuted, (NumTalkers + 3) / 4);
+
+	Start = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		NumTalking = 0;
+		NumMuted = 0;
+		for (const FBPUniqueNetId& Talker : Talkers)
+		{
+			NumTalking += Voice->IsRemotePlayerTalking(*Talker.GetUniqueNetId()) ? 1 : 0;
+			NumMuted += Voice->IsMuted(0, *Talker.GetUniqueNetId()) ? 1 : 0;
+		}
+	}
+	const double RawSeconds = FPlatformTime::Seconds() - Start;
+	TestEqual(TEXT("The interface agrees on who is talking"), NumTalking, (NumTalkers + 2) / 3);
+	TestEqual(TEXT("The interface agrees on who is muted"), NumMuted, (NumTalkers + 3) / 4);
+
+	// The whole lobby leaving
+	Start = FPlatformTime::Seconds();
+	for (const FBPUniqueNetId& Talker : Talkers)
+	{
+		UAdvancedVoiceLibrary::UnRegisterRemoteTalker(Fixture.World, Talker);
+	}
+	const double UnregisterSeconds = FPlatformTime::Seconds() - Start;
+	TestEqual(TEXT("Every talker is unregistered"), Voice->GetNumRemoteTalkers(), 0);
+	TestFalse(TEXT("An unregistered talker is not talking"), UAdvancedVoiceLibrary::IsRemotePlayerTalking(Fixture.World, Talkers[0]));
+
+	const int32 NumQueries = 2 * NumTalkers * NumFrames;
+	AddInfo(FString::Printf(TEXT("%d talkers: register %.1f ns, unregister %.1f ns per talker"),
+		NumTalkers, RegisterSeconds * 1e9 / NumTalkers, UnregisterSeconds * 1e9 / NumTalkers));
+	AddInfo(FString::Printf(TEXT("%d frames of talking and muted state for %d talkers: %.1f ns per query through the library, %.1f ns straight to the interface, %.3f ms per frame"),
+		NumFrames, NumTalkers, LibrarySeconds * 1e9 / NumQueries, RawSeconds * 1e9 / NumQueries, LibrarySeconds * 1e3 / NumFrames));
+	return true;
+}
+
+#endif
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvTestWorldFixture.h"
+#include "AdvTestProxyListener.h"
+#include "OnlineSubsystemAdvTest.h"
+#include "OnlineSessionAdvTest.h"
+#include "FindSessionsCallbackProxyAdvanced.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFindSessionsDedupeBenchmark, "AdvancedSessions.TestOSS.FindSessionsDedupe.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FFindSessionsDedupeBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 MaxSessions = 1000;
+
+	FAdvTestWorldFixture Fixture;
+	if (!Fixture.Init(*this))
+		return false;
+
+	// Both searches of an AllServers query return the same sessions, so half of everything merged is a duplicate
+	TArray<FOnlineSessionSearchResult> Generated;
+	Generated.Reserve(MaxSessions);
+	for (int32 Index = 0; Index < MaxSessions; Index++)
+	{
+		Generated.Add(FOnlineSessionAdvTest::MakeSearchResult(Index));
+	}
+
+	// What OnCompleted did before, AddUnique compares against every result collected so far
+	TArray<FBlueprintSessionResult> AddUniqueResults;
+	double Start = FPlatformTime::Seconds();
+	for (int32 Search = 0; Search < 2; Search++)
+	{
+		for (const FOnlineSessionSearchResult& Result : Generated)
+		{
+			FBlueprintSessionResult BPResult;
+			BPResult.OnlineResult = Result;
+			AddUniqueResults.AddUnique(BPResult);
+		}
+	}
+	const double AddUniqueSeconds = FPlatformTime::Seconds() - Start;
+	TestEqual(TEXT("AddUnique keeps one result per session"), AddUniqueResults.Num(), MaxSessions);
+
+	FAdvTestOnlineSettings Settings;
+	Settings.Latency = 0.0f;
+
+	// The whole query through the proxy at growing sizes, the time per result should stay flat
+	double PerResultAtSmallest = 0.0;
+	double PerResultAtLargest = 0.0;
+	for (int32 NumSessions = MaxSessions / 4; NumSessions <= MaxSessions; NumSessions *= 2)
+	{
+		Settings.NumSessions = NumSessions;
+		Fixture.OnlineSub->SetTestSettings(Settings);
+
+		UAdvTestProxyListener* Listener = NewObject<UAdvTestProxyListener>();
+		UFindSessionsCallbackProxyAdvanced* Proxy = UFindSessionsCallbackProxyAdvanced::FindSessionsAdvanced(Fixture.World, Fixture.PlayerController, NumSessions, false,
+			EBPServerPresenceSearchType::AllServers, TArray<FSessionsSearchSetting>(), false, false, false, true, 0, 0.0f);
+		Proxy->OnSuccess.AddDynamic(Listener, &UAdvTestProxyListener::OnSessionsSuccess);
+		Proxy->OnFailure.AddDynamic(Listener, &UAdvTestProxyListener::OnSessionsFailure);
+
+		Start = FPlatformTime::Seconds();
+		Proxy->Activate();
+		Fixture.OnlineSub->CompletePendingRequests();
+		const double QuerySeconds = FPlatformTime::Seconds() - Start;
+
+		TestEqual(FString::Printf(TEXT("%d sessions found by both searches are listed once"), NumSessions), Listener->SessionResults.Num(), NumSessions);
+
+		const double PerResult = QuerySeconds / (2 * NumSessions);
+		if (NumSessions == MaxSessions / 4)
+			PerResultAtSmallest = PerResult;
+		PerResultAtLargest = PerResult;
+
+		AddInfo(FString::Printf(TEXT("%d sessions, %d results merged: %.3f ms, %.1f ns per result (includes generating the results)"),
+			NumSessions, 2 * NumSessions, QuerySeconds * 1e3, PerResult * 1e9));
+	}
+
+	AddInfo(FString::Printf(TEXT("%d results merged with AddUnique: %.3f ms, %.1f ns per result"),
+		2 * MaxSessions, AddUniqueSeconds * 1e3, AddUniqueSeconds * 1e9 / (2 * MaxSessions)));
+	AddInfo(FString::Printf(TEXT("Per result cost from %d to %d sessions grew %.2fx, quadratic merging would grow about 4x"),
+		MaxSessions / 4, MaxSessions, PerResultAtSmallest > 0.0 ? PerResultAtLargest / PerResultAtSmallest : 0.0));
+	return true;
+}
+
+#endif
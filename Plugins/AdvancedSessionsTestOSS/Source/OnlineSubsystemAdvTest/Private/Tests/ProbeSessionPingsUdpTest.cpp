@@ -0,0 +1,229 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "AdvTestWorldFixture.h"
+#include "AdvTestProxyListener.h"
+#include "OnlineSubsystemAdvTest.h"
+#include "OnlineSessionAdvTest.h"
+#include "ProbeSessionPingsCallbackProxy.h"
+#include "Common/UdpSocketBuilder.h"
+#include "Interfaces/IPv4/IPv4Address.h"
+#include "Misc/AutomationTest.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AdvTestProbeSessionPings
+{
+	constexpr int32 NumResults = 4;
+	constexpr float Timeout = 0.5f;
+
+	// Above the timeout, so a ping that was measured can be told apart from one the search reported
+	constexpr int32 SearchPingInMs = 5000;
+
+	// Gives up on a phase that never completes, rather than hanging the automation run
+	constexpr double PhaseDeadlineSeconds = 10.0;
+
+	// Sends every datagram on a loopback port straight back, the responder a UDP probe needs on the host
+	struct FEchoResponder
+	{
+		FSocket* Socket = nullptr;
+		int32 NumEchoed = 0;
+
+		~FEchoResponder()
+		{
+			Close();
+		}
+
+		bool Init()
+		{
+			Socket = FUdpSocketBuilder(TEXT("AdvTestEchoResponder"))
+				.AsNonBlocking()
+				.BoundToAddress(FIPv4Address(127, 0, 0, 1))
+				.BoundToPort(0)
+				.Build();
+			return Socket != nullptr;
+		}
+
+		int32 GetPort() const
+		{
+			return Socket ? Socket->GetPortNo() : 0;
+		}
+
+		void Poll()
+		{
+			if (!Socket)
+				return;
+
+			ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+			TSharedRef<FInternetAddr> Sender = SocketSubsystem->CreateInternetAddr();
+			uint8 Buffer[1024];
+			int32 BytesRead = 0;
+			while (Socket->RecvFrom(Buffer, sizeof(Buffer), BytesRead, *Sender))
+			{
+				int32 BytesSent = 0;
+				if (Socket->SendTo(Buffer, BytesRead, BytesSent, *Sender))
+				{
+					NumEchoed++;
+				}
+			}
+		}
+
+		void Close()
+		{
+			if (Socket)
+			{
+				ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+				Socket = nullptr;
+			}
+		}
+	};
+
+	// Probes NumResults sessions hosted at the responder's port, answers them from the game thread every frame, then
+	// probes them again with the responder closed. The probes run on the Icmp module's worker threads and report
+	// back through the core ticker, so this has to be a latent command rather than a loop.
+	class FProbeCommand : public IAutomationLatentCommand
+	{
+	public:
+
+		explicit FProbeCommand(FAutomationTestBase& InTest)
+			: Test(InTest)
+		{
+		}
+
+		virtual bool Update() override
+		{
+			switch (Phase)
+			{
+			case EPhase::Start:
+				return Start();
+
+			case EPhase::WithResponder:
+				Echo.Poll();
+				if (!IsProbeDone())
+					return IsPastDeadline();
+
+				CheckMeasured();
+				Echo.Close();
+				StartProbe();
+				Phase = EPhase::WithoutResponder;
+				return false;
+
+			case EPhase::WithoutResponder:
+				if (!IsProbeDone())
+					return IsPastDeadline();
+
+				CheckKept();
+				return true;
+			}
+			return true;
+		}
+
+	private:
+
+		enum class EPhase
+		{
+			Start,
+			WithResponder,
+			WithoutResponder
+		};
+
+		bool Start()
+		{
+			if (!Fixture.Init(Test))
+				return true;
+
+			if (!Echo.Init())
+			{
+				Test.AddError(TEXT("Could not bind a UDP echo responder on the loopback address"));
+				return true;
+			}
+
+			FAdvTestOnlineSettings Settings;
+			Settings.Latency = 0.0f;
+			Settings.HostAddress = FString::Printf(TEXT("127.0.0.1:%d"), Echo.GetPort());
+			Fixture.OnlineSub->SetTestSettings(Settings);
+
+			for (int32 Index = 0; Index < NumResults; Index++)
+			{
+				FBlueprintSessionResult& Result = Results.AddDefaulted_GetRef();
+				Result.OnlineResult = FOnlineSessionAdvTest::MakeSearchResult(Index);
+				Result.OnlineResult.PingInMs = SearchPingInMs;
+			}
+
+			StartProbe();
+			Phase = EPhase::WithResponder;
+			return false;
+		}
+
+		void StartProbe()
+		{
+			Listener.Reset(NewObject<UAdvTestProxyListener>());
+			Proxy.Reset(UProbeSessionPingsCallbackProxy::ProbeSessionPings(Fixture.World, Results, EBPSessionPingProbe::Udp, 2, Timeout));
+			Proxy->OnPingUpdated.AddDynamic(Listener.Get(), &UAdvTestProxyListener::OnPingUpdated);
+			Proxy->OnCompleted.AddDynamic(Listener.Get(), &UAdvTestProxyListener::OnSessionsSuccess);
+			Proxy->Activate();
+			PhaseStartTime = FPlatformTime::Seconds();
+		}
+
+		bool IsProbeDone() const
+		{
+			return Listener->NumSuccess > 0;
+		}
+
+		bool IsPastDeadline()
+		{
+			if (FPlatformTime::Seconds() - PhaseStartTime < PhaseDeadlineSeconds)
+				return false;
+
+			Test.AddError(TEXT("The UDP probes did not complete"));
+			return true;
+		}
+
+		void CheckMeasured()
+		{
+			Test.TestEqual(TEXT("Every host reports one ping"), Listener->PingUpdates.Num(), NumResults);
+			Test.TestTrue(TEXT("The responder answered every probe"), Echo.NumEchoed >= NumResults);
+			Test.TestEqual(TEXT("OnCompleted fires once"), Listener->NumSuccess, 1);
+			Test.TestEqual(TEXT("OnCompleted hands back every result"), Listener->SessionResults.Num(), NumResults);
+			for (const FBlueprintSessionResult& Result : Listener->SessionResults)
+			{
+				const int32 PingInMs = Result.OnlineResult.PingInMs;
+				Test.TestTrue(FString::Printf(TEXT("A host with a responder is measured (%d ms)"), PingInMs), PingInMs >= 1 && PingInMs <= Timeout * 1000.0f);
+			}
+		}
+
+		void CheckKept()
+		{
+			Test.TestEqual(TEXT("Every host without a responder still reports"), Listener->PingUpdates.Num(), NumResults);
+			Test.TestEqual(TEXT("OnCompleted fires once without a responder"), Listener->NumSuccess, 1);
+			for (const FBlueprintSessionResult& Result : Listener->SessionResults)
+			{
+				Test.TestEqual(TEXT("A host without a responder keeps the ping the search reported"), Result.OnlineResult.PingInMs, SearchPingInMs);
+			}
+		}
+
+		FAutomationTestBase& Test;
+		FAdvTestWorldFixture Fixture;
+		FEchoResponder Echo;
+		TArray<FBlueprintSessionResult> Results;
+
+		// Nothing else references them between frames
+		TStrongObjectPtr<UAdvTestProxyListener> Listener;
+		TStrongObjectPtr<UProbeSessionPingsCallbackProxy> Proxy;
+
+		EPhase Phase = EPhase::Start;
+		double PhaseStartTime = 0.0;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProbeSessionPingsUdpTest, "AdvancedSessions.TestOSS.ProbeSessionPings.Udp",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FProbeSessionPingsUdpTest::RunTest(const FString& Parameters)
+{
+	ADD_LATENT_AUTOMATION_COMMAND(AdvTestProbeSessionPings::FProbeCommand(*this));
+	return true;
+}
+
+#endif
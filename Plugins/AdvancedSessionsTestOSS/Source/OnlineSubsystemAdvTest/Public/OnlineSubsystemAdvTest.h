@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "OnlineSubsystemImpl.h"
+
+#define ADVTEST_SUBSYSTEM FName(TEXT("ADVTEST"))
+
+class FOnlineSessionAdvTest;
+class FOnlineFriendsAdvTest;
+class FOnlineVoiceAdvTest;
+
+typedef TSharedPtr<FOnlineSessionAdvTest, ESPMode::ThreadSafe> FOnlineSessionAdvTestPtr;
+typedef TSharedPtr<FOnlineFriendsAdvTest, ESPMode::ThreadSafe> FOnlineFriendsAdvTestPtr;
+typedef TSharedPtr<FOnlineVoiceAdvTest, ESPMode::ThreadSafe> FOnlineVoiceAdvTestPtr;
+
+// What the fake backend hands out. Read from [OnlineSubsystemAdvTest] in the engine ini, tests set it directly.
+struct FAdvTestOnlineSettings
+{
+	// Sessions every search finds, capped by the search's MaxSearchResults
+	int32 NumSessions = 50;
+	int32 NumFriends = 50;
+	int32 NumRecentPlayers = 20;
+
+	// Seconds before a request completes while the subsystem ticks normally
+	float Latency = 0.1f;
+
+	// Every search, list read and session update completes unsuccessfully
+	bool bFailRequests = false;
+
+	// ip:port every search result's connect string resolves to, empty means the sessions have no host to reach
+	FString HostAddress;
+};
+
+// A test-only online subsystem with no backend. Session searches return NumSessions synthetic sessions, friends and
+// recent players lists are generated at the configured sizes, and every request completes Latency seconds later from
+// the subsystem's tick, or at once through CompletePendingRequests. The voice interface tracks talkers and mutes but
+// carries no audio. Select it with -ini:Engine:[OnlineSubsystem]:DefaultPlatformService=ADVTEST, it is never meant to ship.
+class ONLINESUBSYSTEMADVTEST_API FOnlineSubsystemAdvTest : public FOnlineSubsystemImpl
+{
+public:
+
+	explicit FOnlineSubsystemAdvTest(FName InInstanceName);
+	virtual ~FOnlineSubsystemAdvTest() = default;
+
+	// IOnlineSubsystem
+	virtual IOnlineSessionPtr GetSessionInterface() const override;
+	virtual IOnlineFriendsPtr GetFriendsInterface() const override;
+	virtual IOnlinePartyPtr GetPartyInterface() const override { return nullptr; }
+	virtual IOnlineGroupsPtr GetGroupsInterface() const override { return nullptr; }
+	virtual IOnlineSharedCloudPtr GetSharedCloudInterface() const override { return nullptr; }
+	virtual IOnlineUserCloudPtr GetUserCloudInterface() const override { return nullptr; }
+	virtual IOnlineEntitlementsPtr GetEntitlementsInterface() const override { return nullptr; }
+	virtual IOnlineLeaderboardsPtr GetLeaderboardsInterface() const override { return nullptr; }
+	virtual IOnlineVoicePtr GetVoiceInterface() const override;
+	virtual IOnlineExternalUIPtr GetExternalUIInterface() const override { return nullptr; }
+	virtual IOnlineTimePtr GetTimeInterface() const override { return nullptr; }
+	virtual IOnlineIdentityPtr GetIdentityInterface() const override { return nullptr; }
+	virtual IOnlineTitleFilePtr GetTitleFileInterface() const override { return nullptr; }
+	virtual IOnlineStoreV2Ptr GetStoreV2Interface() const override { return nullptr; }
+	virtual IOnlinePurchasePtr GetPurchaseInterface() const override { return nullptr; }
+	virtual IOnlineEventsPtr GetEventsInterface() const override { return nullptr; }
+	virtual IOnlineAchievementsPtr GetAchievementsInterface() const override { return nullptr; }
+	virtual IOnlineSharingPtr GetSharingInterface() const override { return nullptr; }
+	virtual IOnlineUserPtr GetUserInterface() const override { return nullptr; }
+	virtual IOnlineMessagePtr GetMessageInterface() const override { return nullptr; }
+	virtual IOnlinePresencePtr GetPresenceInterface() const override { return nullptr; }
+	virtual IOnlineChatPtr GetChatInterface() const override { return nullptr; }
+	virtual IOnlineStatsPtr GetStatsInterface() const override { return nullptr; }
+	virtual IOnlineTurnBasedPtr GetTurnBasedInterface() const override { return nullptr; }
+	virtual IOnlineTournamentPtr GetTournamentInterface() const override { return nullptr; }
+
+	virtual bool Init() override;
+	virtual bool Shutdown() override;
+	virtual FString GetAppId() const override { return TEXT("AdvTest"); }
+	virtual FText GetOnlineServiceName() const override;
+	virtual bool IsEnabled() const override { return true; }
+
+	// FTSTickerObjectBase
+	virtual bool Tick(float DeltaTime) override;
+
+	const FAdvTestOnlineSettings& GetTestSettings() const { return TestSettings; }
+	void SetTestSettings(const FAdvTestOnlineSettings& InSettings) { TestSettings = InSettings; }
+
+	// Runs Complete once Latency seconds have passed, requests complete in the order they were made
+	void QueueRequest(TFunction<void()>&& Complete);
+
+	// Completes every queued request now, including ones queued by those completions
+	void CompletePendingRequests();
+
+	int32 GetNumPendingRequests() const { return PendingRequests.Num(); }
+
+	// The same id every time for the same index, so results from repeated reads line up
+	static FUniqueNetIdRef MakeUserId(int32 Index);
+
+private:
+
+	struct FPendingRequest
+	{
+		double DueTime;
+		TFunction<void()> Complete;
+	};
+
+	TArray<FPendingRequest> PendingRequests;
+	FAdvTestOnlineSettings TestSettings;
+
+	FOnlineSessionAdvTestPtr SessionInterface;
+	FOnlineFriendsAdvTestPtr FriendsInterface;
+	FOnlineVoiceAdvTestPtr VoiceInterface;
+};
+
+typedef TSharedPtr<FOnlineSubsystemAdvTest, ESPMode::ThreadSafe> FOnlineSubsystemAdvTestPtr;
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+ 
+#include "Modules/ModuleManager.h"
+
+class FOnlineFactoryAdvTest;
+
+// Registers the ADVTEST online subsystem with the online subsystem module
+class FOnlineSubsystemAdvTestModule : public IModuleInterface
+{
+public:
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+
+	virtual bool SupportsDynamicReloading() override { return false; }
+
+private:
+	FOnlineFactoryAdvTest* Factory = nullptr;
+};
@@ -221,6 +221,7 @@ public:
 		bBanned = false;
 		bAcceptedForUse = false;
 		bTagsTruncated = false;
+		TimeUpdated = 0;
 	}
 
 #if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
@@ -241,6 +242,8 @@ public:
 		bTagsTruncated = hUGCDetails.m_bTagsTruncated;
 
 		CreatorSteamID = FString::Printf(TEXT("%llu"), hUGCDetails.m_ulSteamIDOwner);
+		WorkshopID = FBPSteamWorkshopID(hUGCDetails.m_nPublishedFileId);
+		TimeUpdated = (int64)hUGCDetails.m_rtimeUpdated;
 	}
 
 	FBPSteamWorkshopItemDetails(const SteamUGCDetails_t &hUGCDetails)
@@ -260,6 +263,8 @@ public:
 		bTagsTruncated = hUGCDetails.m_bTagsTruncated;
 
 		CreatorSteamID = FString::Printf(TEXT("%llu"), hUGCDetails.m_ulSteamIDOwner);
+		WorkshopID = FBPSteamWorkshopID(hUGCDetails.m_nPublishedFileId);
+		TimeUpdated = (int64)hUGCDetails.m_rtimeUpdated;
 	}
 #endif
 
@@ -315,6 +320,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop")
 	FString CreatorSteamID;
 
+	// The item these details are for
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop")
+	FBPSteamWorkshopID WorkshopID;
+
+	// Unix time the item was last updated
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop")
+	int64 TimeUpdated;
+
 	/*
 	PublishedFileId_t m_nPublishedFileId;
 	uint32 m_rtimeCreated;											// time when the published file was created
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "AdvancedSteamFriendsLibrary.h"
+#include "SteamAvatarCacheSubsystem.generated.h"
+
+class UTexture2D;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnSteamAvatarLoaded, const FBPUniqueNetId&, UniqueNetId, SteamAvatarSize, AvatarSize, UTexture2D*, Avatar);
+
+// Caches Steam avatar textures by SteamID and size, so asking for the same avatar again costs a map lookup.
+// Avatars Steam has not downloaded yet are filled in when AvatarImageLoaded_t arrives, and OnSteamAvatarLoaded fires.
+// Past MaxCachedAvatars the least recently asked for avatars are evicted. Every avatar gets its own texture, which
+// Blueprint may still hold after eviction, so the cache only lets go of it and leaves the rest to GC.
+UCLASS()
+class ADVANCEDSTEAMSESSIONS_API USteamAvatarCacheSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintAssignable, Category = "SteamEvents")
+	FOnSteamAvatarLoaded OnSteamAvatarLoaded;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Returns the cached avatar, or null with bIsLoading set while Steam is still downloading it
+	UTexture2D* GetAvatar(const FBPUniqueNetId& UniqueNetId, SteamAvatarSize AvatarSize, bool& bIsLoading);
+
+	// Drops every cached size of this user's avatar, the next request fetches it again
+	void InvalidateAvatar(uint64 SteamId);
+
+	// Called on the game thread once Steam has an avatar image for this user
+	void OnAvatarImageAvailable(uint64 SteamId);
+
+	// Avatars still downloading are never evicted, so the cache can briefly hold more
+	static constexpr int32 MaxCachedAvatars = 256;
+
+private:
+
+	struct FAvatarKey
+	{
+		uint64 SteamId;
+		SteamAvatarSize Size;
+
+		bool operator==(const FAvatarKey& Other) const { return SteamId == Other.SteamId && Size == Other.Size; }
+		friend uint32 GetTypeHash(const FAvatarKey& Key) { return HashCombine(GetTypeHash(Key.SteamId), (uint32)Key.Size); }
+	};
+
+	//Cached avatars form an intrusive LRU list through Slots, most recently used at the head
+	struct FCachedAvatar
+	{
+		FAvatarKey Key = {};
+		UTexture2D* Texture = nullptr;
+		FBPUniqueNetId UniqueNetId;
+		bool bLoading = false;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+	};
+
+	// Copies the avatar out of Steam into the entry's texture, false while it is still loading or when there is none
+	bool LoadAvatar(FCachedAvatar& Avatar);
+
+	UTexture2D* CreateTexture(uint32 Width, uint32 Height);
+	void ReleaseTexture(UTexture2D* Texture);
+
+	int32 AddAvatar(const FAvatarKey& Key);
+	void RemoveAvatar(int32 Slot);
+	void EvictLeastRecentlyUsed();
+	void Unlink(int32 Slot);
+	void LinkAtHead(int32 Slot);
+
+	TMap<FAvatarKey, int32> Avatars;
+	TArray<FCachedAvatar> Slots;
+	TArray<int32> FreeSlots;
+	int32 Head = INDEX_NONE;
+	int32 Tail = INDEX_NONE;
+
+	// Keeps the textures of cached avatars alive, never reused for another avatar once released
+	UPROPERTY(Transient)
+	TSet<TObjectPtr<UTexture2D>> AvatarTextures;
+
+	// AvatarImageLoaded_t and PersonaStateChange_t, through the callback dispatcher
+	FDelegateHandle AvatarImageLoadedHandle;
+	FDelegateHandle PersonaStateChangeHandle;
+};
@@ -0,0 +1,282 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Containers/Ticker.h"
+#include "AdvancedSteamWorkshopLibrary.h"
+#include <atomic>
+#include "SteamCallbackDispatcher.generated.h"
+
+class FSteamCallbackQueue;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSteamCallbackDispatched, int32, CallbackId);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSteamGameOverlayActivated, bool, bOverlayActive);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSteamWorkshopItemInstalled, FBPSteamWorkshopID, WorkshopID);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSteamWorkshopItemDownloaded, FBPSteamWorkshopID, WorkshopID, bool, bSuccess);
+
+// Native subscribers get the raw payload, Subscribe casts it back to the callback struct
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnRawSteamCallback, const void*);
+
+USTRUCT(BlueprintType)
+struct FSteamCallbackStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "SteamEvents")
+	int32 CallbackId = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SteamEvents")
+	FString Name;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SteamEvents")
+	int32 Count = 0;
+
+	// From Steam running the callback on the online thread to the game thread dispatching it
+	UPROPERTY(BlueprintReadOnly, Category = "SteamEvents")
+	float AverageLatencyMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SteamEvents")
+	float MaxLatencyMs = 0.0f;
+};
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+
+class USteamCallbackDispatcher;
+
+// Owns the Steam side of one registration, the dispatcher keeps it alive until it is no longer needed
+class FSteamCallbackForwarder
+{
+public:
+	virtual ~FSteamCallbackForwarder() {}
+};
+
+template<typename CallbackType>
+class TSteamCallbackForwarder : public FSteamCallbackForwarder
+{
+public:
+	TSteamCallbackForwarder(USteamCallbackDispatcher* InDispatcher) :
+		Dispatcher(InDispatcher),
+		Callback(this, &TSteamCallbackForwarder::OnCallback)
+	{
+	}
+
+private:
+	void OnCallback(CallbackType* Data);
+
+	USteamCallbackDispatcher* Dispatcher;
+	CCallback<TSteamCallbackForwarder, CallbackType, false> Callback;
+};
+
+// A call result runs once and its handler waits for it, so one that finds the queue full is kept here instead of being
+// dropped, until the game thread picks it up
+class FSteamCallResultForwarder : public FSteamCallbackForwarder
+{
+public:
+	bool IsHeld() const { return bHeld.load(std::memory_order_acquire); }
+	bool WasHeldIOFailure() const { return bHeldIOFailure; }
+	virtual const void* GetHeldPayload() const = 0;
+
+protected:
+	std::atomic<bool> bHeld{ false };
+	bool bHeldIOFailure = false;
+};
+
+template<typename ResultType>
+class TSteamCallResultForwarder : public FSteamCallResultForwarder
+{
+public:
+	TSteamCallResultForwarder(USteamCallbackDispatcher* InDispatcher, SteamAPICall_t InCall) :
+		Dispatcher(InDispatcher),
+		Call(InCall)
+	{
+		CallResult.Set(Call, this, &TSteamCallResultForwarder::OnResult);
+	}
+
+	virtual const void* GetHeldPayload() const override { return HeldPayload; }
+
+private:
+	void OnResult(ResultType* Data, bool bIOFailure);
+
+	USteamCallbackDispatcher* Dispatcher;
+	SteamAPICall_t Call;
+	CCallResult<TSteamCallResultForwarder, ResultType> CallResult;
+	alignas(16) uint8 HeldPayload[sizeof(ResultType)];
+};
+
+#endif
+
+// Registers Steam callbacks and call results once and fans them out on the game thread.
+// Steam runs callbacks on the online thread, where the payload is only copied into a lock-free queue. The queue is
+// drained every frame on the game thread, where native subscribers and the Blueprint events below are called.
+// Latency from Steam to the game thread and the queue depth are tracked per callback, see AdvancedSteam.CallbackStats.
+UCLASS()
+class ADVANCEDSTEAMSESSIONS_API USteamCallbackDispatcher : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Called for every dispatched callback with its k_iCallback ID
+	UPROPERTY(BlueprintAssignable, Category = "SteamEvents")
+	FOnSteamCallbackDispatched OnSteamCallback;
+
+	UPROPERTY(BlueprintAssignable, Category = "SteamEvents")
+	FOnSteamGameOverlayActivated OnGameOverlayActivated;
+
+	UPROPERTY(BlueprintAssignable, Category = "SteamEvents")
+	FOnSteamWorkshopItemInstalled OnWorkshopItemInstalled;
+
+	UPROPERTY(BlueprintAssignable, Category = "SteamEvents")
+	FOnSteamWorkshopItemDownloaded OnWorkshopItemDownloaded;
+
+	UFUNCTION(BlueprintCallable, Category = "SteamEvents")
+	void GetCallbackStats(TArray<FSteamCallbackStats>& OutStats) const;
+
+	// Most callbacks that were waiting at once since the stats were last reset
+	UFUNCTION(BlueprintPure, Category = "SteamEvents")
+	int32 GetMaxQueueDepth() const { return MaxQueueDepth; }
+
+	// Callbacks lost because the game thread fell too far behind
+	UFUNCTION(BlueprintPure, Category = "SteamEvents")
+	int32 GetNumDropped() const { return NumDropped; }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamEvents")
+	void ResetCallbackStats();
+
+	void DumpCallbackStats(FOutputDevice& Ar) const;
+
+	void Unsubscribe(int32 CallbackId, FDelegateHandle Handle);
+
+	// Largest callback struct the queue can carry
+	static constexpr int32 MaxPayloadSize = 512;
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+
+	// Calls Handler on the game thread for every CallbackType Steam sends, until unsubscribed
+	template<typename CallbackType>
+	FDelegateHandle Subscribe(TFunction<void(const CallbackType&)> Handler, const TCHAR* Name = nullptr)
+	{
+		FRegisteredCallback& Registered = Register<CallbackType>(Name);
+		return Registered.Handlers.AddLambda([Handler = MoveTemp(Handler)](const void* Data)
+		{
+			Handler(*static_cast<const CallbackType*>(Data));
+		});
+	}
+
+	// Calls Handler on the game thread once Call completes
+	template<typename ResultType>
+	void WatchCallResult(SteamAPICall_t Call, TFunction<void(const ResultType&, bool bIOFailure)> Handler)
+	{
+		static_assert(sizeof(ResultType) <= MaxPayloadSize, "Call result is too large for the callback queue");
+
+		FPendingCallResult& Pending = PendingCallResults.Add(Call);
+		Pending.Handler = [Handler = MoveTemp(Handler)](const void* Data, bool bIOFailure)
+		{
+			Handler(*static_cast<const ResultType*>(Data), bIOFailure);
+		};
+		Pending.Forwarder = MakeUnique<TSteamCallResultForwarder<ResultType>>(this, Call);
+	}
+
+	// Copies a payload into the queue, called on whichever thread Steam runs callbacks on. False when the queue is full.
+	bool Enqueue(int32 CallbackId, const void* Data, int32 Size, uint64 Call = 0, bool bIOFailure = false);
+
+	// A call result forwarder kept its result because the queue was full, the next tick delivers it
+	void NotifyCallResultHeld() { NumHeldCallResults.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+
+	struct FRegisteredCallback
+	{
+		FString Name;
+		TUniquePtr<FSteamCallbackForwarder> Forwarder;
+		FOnRawSteamCallback Handlers;
+	};
+
+	template<typename CallbackType>
+	FRegisteredCallback& Register(const TCHAR* Name)
+	{
+		static_assert(sizeof(CallbackType) <= MaxPayloadSize, "Callback is too large for the callback queue");
+
+		TUniquePtr<FRegisteredCallback>& Slot = Callbacks.FindOrAdd(CallbackType::k_iCallback);
+		if (!Slot.IsValid())
+		{
+			Slot = MakeUnique<FRegisteredCallback>();
+		}
+
+		FRegisteredCallback& Registered = *Slot;
+		if (!Registered.Forwarder.IsValid())
+		{
+			Registered.Name = Name ? FString(Name) : FString::Printf(TEXT("Callback %d"), CallbackType::k_iCallback);
+			Registered.Forwarder = MakeUnique<TSteamCallbackForwarder<CallbackType>>(this);
+		}
+		return Registered;
+	}
+
+	struct FPendingCallResult
+	{
+		TUniquePtr<FSteamCallResultForwarder> Forwarder;
+		TFunction<void(const void*, bool)> Handler;
+	};
+
+	// Runs and forgets the handler watching Call, if there still is one
+	void DispatchCallResult(uint64 Call, const void* Payload, bool bIOFailure);
+
+	// Delivers the results forwarders kept while the queue was full
+	void DispatchHeldCallResults();
+
+	TMap<uint64, FPendingCallResult> PendingCallResults;
+	std::atomic<int32> NumHeldCallResults{ 0 };
+
+#else
+
+private:
+
+#endif
+
+	bool Tick(float DeltaTime);
+
+	struct FLatencyStats
+	{
+		int32 Count = 0;
+		double TotalLatency = 0.0;
+		double MaxLatency = 0.0;
+	};
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	// Boxed so a handler subscribing during a broadcast does not move the one being broadcast
+	TMap<int32, TUniquePtr<FRegisteredCallback>> Callbacks;
+#endif
+	TMap<int32, FLatencyStats> Stats;
+
+	TSharedPtr<FSteamCallbackQueue> Queue;
+	FTSTicker::FDelegateHandle TickHandle;
+	int32 MaxQueueDepth = 0;
+	int32 NumDropped = 0;
+};
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+
+template<typename CallbackType>
+void TSteamCallbackForwarder<CallbackType>::OnCallback(CallbackType* Data)
+{
+	Dispatcher->Enqueue(CallbackType::k_iCallback, Data, sizeof(CallbackType));
+}
+
+template<typename ResultType>
+void TSteamCallResultForwarder<ResultType>::OnResult(ResultType* Data, bool bIOFailure)
+{
+	if (!Dispatcher->Enqueue(ResultType::k_iCallback, Data, sizeof(ResultType), Call, bIOFailure))
+	{
+		FMemory::Memcpy(HeldPayload, Data, sizeof(ResultType));
+		bHeldIOFailure = bIOFailure;
+		bHeld.store(true, std::memory_order_release);
+		Dispatcher->NotifyCallResultHeld();
+	}
+}
+
+#endif
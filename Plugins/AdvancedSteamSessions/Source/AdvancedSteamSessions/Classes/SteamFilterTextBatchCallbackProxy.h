@@ -0,0 +1,39 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AdvancedSteamFriendsLibrary.h"
+#include "Net/OnlineBlueprintCallProxyBase.h"
+#include "SteamFilterTextBatchCallbackProxy.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FBlueprintFilteredTextDelegate, const TArray<FString>&, FilteredTexts);
+
+UCLASS(MinimalAPI)
+class USteamFilterTextBatchCallbackProxy : public UOnlineBlueprintCallProxyBase
+{
+	GENERATED_UCLASS_BODY()
+
+	// Called with the filtered texts, in the same order as the texts passed in
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintFilteredTextDelegate OnSuccess;
+
+	// Called with the texts unchanged when Steam is not available
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintFilteredTextDelegate OnFailure;
+
+	// Filters many texts from the same source at once, off the game thread.
+	// Repeated texts are only filtered once, and texts filtered before are answered from the cache.
+	// Requires that InitTextFiltering be called first!!
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "Online|SteamAPI|TextFiltering")
+	static USteamFilterTextBatchCallbackProxy* FilterTextBatch(UObject* WorldContextObject, const TArray<FString>& TextsToFilter, EBPTextFilteringContext Context, const FBPUniqueNetId TextSourceID);
+
+	// UOnlineBlueprintCallProxyBase interface
+	virtual void Activate() override;
+	// End of UOnlineBlueprintCallProxyBase interface
+
+private:
+
+	TArray<FString> TextsToFilter;
+	EBPTextFilteringContext Context;
+	uint64 SourceSteamId;
+};
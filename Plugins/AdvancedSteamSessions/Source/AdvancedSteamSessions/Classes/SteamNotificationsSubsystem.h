@@ -4,12 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
-
-#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
-
-#include <steam/steam_api.h>
-
-#endif
+#include "Engine/Engine.h"
+#include "SteamCallbackDispatcher.h"
 
 #include "SteamNotificationsSubsystem.generated.h"
 
@@ -31,57 +27,30 @@ public:
 
 	}
 
-	class cSteamEventsStore
-	{
-	public:
-		USteamNotificationsSubsystem* ParentSubsystem = nullptr;
-		void Initialize(USteamNotificationsSubsystem* MyParent)
-		{
-			ParentSubsystem = MyParent;
-		}
-
-#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
-		cSteamEventsStore() :
-		OnExternalUITriggeredCallback(this, &cSteamEventsStore::OnExternalUITriggered)
-		{
-
-		}
-#else
-		//cSteamEventsStore()
-		//{
-
-		//}
-#endif
-
-		//~cSteamEventsStore(){}
-
-	private:
-#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
-		STEAM_CALLBACK(cSteamEventsStore, OnExternalUITriggered, GameOverlayActivated_t, OnExternalUITriggeredCallback);
-#endif
-	};
-
-	cSteamEventsStore MyEvents;
-
 	/** Implement this for initialization of instances of the system */
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override
 	{
-		MyEvents.Initialize(this);
+		// The dispatcher owns the Steam registration and calls us on the game thread
+		if (USteamCallbackDispatcher* Dispatcher = GEngine->GetEngineSubsystem<USteamCallbackDispatcher>())
+		{
+			Dispatcher->OnGameOverlayActivated.AddDynamic(this, &USteamNotificationsSubsystem::OnExternalUITriggered);
+		}
 	}
 
 	/** Implement this for deinitialization of instances of the system */
 	virtual void Deinitialize() override
 	{
-
+		if (USteamCallbackDispatcher* Dispatcher = GEngine ? GEngine->GetEngineSubsystem<USteamCallbackDispatcher>() : nullptr)
+		{
+			Dispatcher->OnGameOverlayActivated.RemoveAll(this);
+		}
 	}
-};
 
-#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
-void USteamNotificationsSubsystem::cSteamEventsStore::OnExternalUITriggered(GameOverlayActivated_t* CallbackData)
-{
-	if (ParentSubsystem)
+private:
+
+	UFUNCTION()
+	void OnExternalUITriggered(bool bOverlayState)
 	{
-		ParentSubsystem->OnSteamOverlayActivated_Bind.Broadcast((bool)CallbackData->m_bActive);
+		OnSteamOverlayActivated_Bind.Broadcast(bOverlayState);
 	}
-}
-#endif
\ No newline at end of file
+};
@@ -0,0 +1,63 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SteamWSRequestUGCDetailsCallbackProxy.h"
+#include "SteamWSRequestUGCDetailsBatchCallbackProxy.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FBlueprintWorkshopDetailsArrayDelegate, const TArray<FBPSteamWorkshopItemDetails>&, WorkShopDetails);
+
+UCLASS(MinimalAPI)
+class USteamWSRequestUGCDetailsBatchCallbackProxy : public UOnlineBlueprintCallProxyBase
+{
+	GENERATED_UCLASS_BODY()
+
+	// Called with the details of every item that could be found, in the order they were asked for
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintWorkshopDetailsArrayDelegate OnSuccess;
+
+	// Called when no details could be found at all
+	UPROPERTY(BlueprintAssignable)
+	FBlueprintWorkshopDetailsArrayDelegate OnFailure;
+
+	// Gets the details of many workshop items, asking Steam for a full page of items per request instead of one request per item.
+	// With bUseCache, items whose cached details are still current are answered from disk without asking Steam at all.
+	UFUNCTION(BlueprintCallable, meta=(BlueprintInternalUseOnly = "true", WorldContext="WorldContextObject"), Category = "Online|AdvancedSteamWorkshop")
+	static USteamWSRequestUGCDetailsBatchCallbackProxy* GetWorkshopItemsDetails(UObject* WorldContextObject, const TArray<FBPSteamWorkshopID>& WorkShopIDs, bool bUseCache = true);
+
+	// UOnlineBlueprintCallProxyBase interface
+	virtual void Activate() override;
+	// End of UOnlineBlueprintCallProxyBase interface
+
+private:
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	struct FPageQuery;
+
+	// Internal callback when a page completes, calls out to the public callbacks once every page is in
+	void OnUGCRequestUGCDetails(FPageQuery& Page, SteamUGCQueryCompleted_t *pResult, bool bIOFailure);
+
+	// Each page is the target of its own call result, so a completion always knows its page, even on an IO failure
+	struct FPageQuery
+	{
+		USteamWSRequestUGCDetailsBatchCallbackProxy* Owner = nullptr;
+		UGCQueryHandle_t Handle = k_UGCQueryHandleInvalid;
+		CCallResult<FPageQuery, SteamUGCQueryCompleted_t> CallResult;
+
+		void OnCompleted(SteamUGCQueryCompleted_t *pResult, bool bIOFailure)
+		{
+			Owner->OnUGCRequestUGCDetails(*this, pResult, bIOFailure);
+		}
+	};
+
+	TArray<TUniquePtr<FPageQuery>> PageQueries;
+#endif
+
+	void Finish();
+
+	TArray<FBPSteamWorkshopID> WorkShopIDs;
+	bool bUseCache;
+
+	TMap<uint64, FBPSteamWorkshopItemDetails> FoundDetails;
+	int32 PagesInFlight;
+};
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "AdvancedSteamWorkshopLibrary.h"
+#include "SteamWorkshopModSubsystem.generated.h"
+
+UENUM(BlueprintType)
+enum class ESteamWorkshopModState : uint8
+{
+	Downloading,
+	Verifying,
+	Ready,
+	Failed
+};
+
+USTRUCT(BlueprintType)
+struct FSteamWorkshopMod
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop|Mods")
+	FBPSteamWorkshopID WorkshopID;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop|Mods")
+	ESteamWorkshopModState State = ESteamWorkshopModState::Downloading;
+
+	// Where Steam installed the item, set once it is downloaded
+	UPROPERTY(BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop|Mods")
+	FString InstallFolder;
+
+	// The Mod.json inside the install folder, set once the folder checked out
+	UPROPERTY(BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop|Mods")
+	FString ManifestPath;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop|Mods")
+	int64 BytesDownloaded = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop|Mods")
+	int64 BytesTotal = 0;
+
+	// Why the item failed, empty otherwise
+	UPROPERTY(BlueprintReadOnly, Category = "Online|AdvancedSteamWorkshop|Mods")
+	FString Error;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSteamWorkshopModEvent, const FSteamWorkshopMod&, Mod);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnSteamWorkshopModsProcessed);
+
+// Turns the player's workshop subscriptions into mods the mod loader can mount.
+// Every subscribed item is downloaded if it is missing or out of date, its install folder is checked for a Mod.json
+// whose addonPaths all exist, and OnModReady hands it to the mod loader. Enumerating, starting downloads and checking
+// folders all happen on background tasks, so nothing here holds up startup while Steam is busy.
+UCLASS()
+class ADVANCEDSTEAMSESSIONS_API USteamWorkshopModSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// Download progress of an item, at most once per poll
+	UPROPERTY(BlueprintAssignable, Category = "Online|AdvancedSteamWorkshop|Mods")
+	FOnSteamWorkshopModEvent OnModProgress;
+
+	// An item is installed and its folder checked out, ManifestPath is ready to load
+	UPROPERTY(BlueprintAssignable, Category = "Online|AdvancedSteamWorkshop|Mods")
+	FOnSteamWorkshopModEvent OnModReady;
+
+	UPROPERTY(BlueprintAssignable, Category = "Online|AdvancedSteamWorkshop|Mods")
+	FOnSteamWorkshopModEvent OnModFailed;
+
+	// Every subscribed item is either ready or failed
+	UPROPERTY(BlueprintAssignable, Category = "Online|AdvancedSteamWorkshop|Mods")
+	FOnSteamWorkshopModsProcessed OnAllModsProcessed;
+
+	// Runs the pipeline over the current subscriptions, does nothing while it is already running.
+	// bHighPriority moves our downloads to the front of the Steam download queue.
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSteamWorkshop|Mods")
+	void StartPipeline(bool bHighPriority = true);
+
+	UFUNCTION(BlueprintPure, Category = "Online|AdvancedSteamWorkshop|Mods")
+	bool IsPipelineRunning() const { return bRunning; }
+
+	UFUNCTION(BlueprintCallable, Category = "Online|AdvancedSteamWorkshop|Mods")
+	void GetMods(TArray<FSteamWorkshopMod>& OutMods) const { OutMods = Mods; }
+
+	// Called on the game thread when Steam reports a download of ours finished
+	void OnDownloadResult(uint64 WorkshopID, bool bSuccess, int32 SteamResult);
+
+	// How often download progress is polled
+	static constexpr float PollInterval = 0.25f;
+
+private:
+
+	void OnItemsEnumerated(uint32 Serial, TArray<FSteamWorkshopMod>&& EnumeratedMods);
+	void PollDownloads();
+	void BeginVerify(FSteamWorkshopMod& Mod);
+	void OnVerified(uint32 Serial, uint64 WorkshopID, const FString& ManifestPath, const FString& Error);
+	void FailMod(FSteamWorkshopMod& Mod, const FString& Error);
+	void CheckFinished();
+
+	// Checks a downloaded item on disk, returns an empty string when it can be mounted
+	static FString VerifyInstallFolder(const FString& InstallFolder, FString& OutManifestPath);
+
+	FSteamWorkshopMod* FindMod(uint64 WorkshopID);
+
+	TArray<FSteamWorkshopMod> Mods;
+	TMap<uint64, int32> ModIndices;
+
+	// Bumped every run, so background work from an earlier run is ignored when it comes back
+	uint32 PipelineSerial = 0;
+	bool bRunning = false;
+	FTimerHandle PollHandle;
+
+	// DownloadItemResult_t, through the callback dispatcher
+	FDelegateHandle DownloadResultHandle;
+};
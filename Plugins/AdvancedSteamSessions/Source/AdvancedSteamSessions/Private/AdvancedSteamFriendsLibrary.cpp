@@ -1,5 +1,7 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include "AdvancedSteamFriendsLibrary.h"
+#include "SteamAvatarCacheSubsystem.h"
+#include "SteamTextFilterCache.h"
 #include "OnlineSubSystemHeader.h"
 
 //General Log
@@ -285,86 +287,23 @@ UTexture2D * UAdvancedSteamFriendsLibrary::GetSteamFriendAvatar(const FBPUniqueN
 		return nullptr;
 	}
 
-	uint32 Width = 0;
-	uint32 Height = 0;
-
-	if (SteamAPI_Init())
+	// Textures are cached and reused, rows that ask every refresh only pay for a map lookup
+	if (USteamAvatarCacheSubsystem* AvatarCache = GEngine ? GEngine->GetEngineSubsystem<USteamAvatarCacheSubsystem>() : nullptr)
 	{
-		//Getting the PictureID from the SteamAPI and getting the Size with the ID
-		//virtual bool RequestUserInformation( CSteamID steamIDUser, bool bRequireNameOnly ) = 0;
-
-		
-		uint64 id = *((uint64*)UniqueNetId.UniqueNetId->GetBytes());
-		int Picture = 0;
-		
-		switch(AvatarSize)
+		bool bIsLoading = false;
+		UTexture2D* Avatar = AvatarCache->GetAvatar(UniqueNetId, AvatarSize, bIsLoading);
+		if (Avatar && !bIsLoading)
 		{
-		case SteamAvatarSize::SteamAvatar_Small: Picture = SteamFriends()->GetSmallFriendAvatar(id); break;
-		case SteamAvatarSize::SteamAvatar_Medium: Picture = SteamFriends()->GetMediumFriendAvatar(id); break;
-		case SteamAvatarSize::SteamAvatar_Large: Picture = SteamFriends()->GetLargeFriendAvatar(id); break;
-		default: break;
+			Result = EBlueprintAsyncResultSwitch::OnSuccess;
+			return Avatar;
 		}
 
-		if (Picture == -1)
+		if (bIsLoading)
 		{
 			Result = EBlueprintAsyncResultSwitch::AsyncLoading;
 			return NULL;
 		}
 
-		SteamUtils()->GetImageSize(Picture, &Width, &Height);
-
-		// STOLEN FROM ANSWERHUB :p, then fixed because answerhub wasn't releasing the memory O.o
-		// Also fixed image pixel format and switched to a memcpy instead of manual iteration.
-		// At some point I should probably reply to that answerhub post with these fixes to prevent people killing their games.....
-
-		if (Width > 0 && Height > 0)
-		{
-			//Creating the buffer "oAvatarRGBA" and then filling it with the RGBA Stream from the Steam Avatar
-			uint8 *oAvatarRGBA = new uint8[Width * Height * 4];
-
-
-			//Filling the buffer with the RGBA Stream from the Steam Avatar and creating a UTextur2D to parse the RGBA Steam in
-			SteamUtils()->GetImageRGBA(Picture, (uint8*)oAvatarRGBA, 4 * Height * Width * sizeof(char));
-
-
-			// Removed as I changed the image bit code to be RGB, I think the original author was unaware that there were different pixel formats
-			/*
-			//Swap R and B channels because for some reason the games whack
-			for (uint32 i = 0; i < (Width * Height * 4); i += 4)
-			{
-				uint8 Temp = oAvatarRGBA[i + 0];
-				oAvatarRGBA[i + 0] = oAvatarRGBA[i + 2];
-				oAvatarRGBA[i + 2] = Temp;
-			}*/
-
-			UTexture2D* Avatar = UTexture2D::CreateTransient(Width, Height, PF_R8G8B8A8);
-			// Switched to a Memcpy instead of byte by byte transer
-
-			if (FTexturePlatformData* PlatformData = Avatar->GetPlatformData())
-			{
-				uint8* MipData = (uint8*)PlatformData->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
-				FMemory::Memcpy(MipData, (void*)oAvatarRGBA, Height * Width * 4);
-				PlatformData->Mips[0].BulkData.Unlock();
-
-				//Setting some Parameters for the Texture and finally returning it
-				PlatformData->SetNumSlices(1);
-				Avatar->NeverStream = true;
-				//Avatar->CompressionSettings = TC_EditorIcon;
-			}
-
-			// Free RGBA buffer regardless of whether it was used or not
-			delete[] oAvatarRGBA;
-
-			Avatar->UpdateResource();
-
-			Result = EBlueprintAsyncResultSwitch::OnSuccess;
-			return Avatar;
-		}
-		else
-		{
-			UE_LOG(AdvancedSteamFriendsLog, Warning, TEXT("Bad Height / Width with steam avatar!"));
-		}
-
 		Result = EBlueprintAsyncResultSwitch::OnFailure;
 		return nullptr;
 	}
@@ -381,6 +320,7 @@ bool UAdvancedSteamFriendsLibrary::InitTextFiltering()
 
 	if (SteamAPI_Init())
 	{
+		FSteamTextFilterCache::Get().Reset();
 		return SteamUtils()->InitFilterText();
 	}
 
@@ -391,36 +331,25 @@ bool UAdvancedSteamFriendsLibrary::InitTextFiltering()
 
 bool UAdvancedSteamFriendsLibrary::FilterText(FString TextToFilter, EBPTextFilteringContext Context, const FBPUniqueNetId TextSourceID, FString& FilteredText)
 {
-#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
-
-	if (SteamAPI_Init())
+	FSteamTextFilterCache::FKey Key;
+	Key.Text = TextToFilter;
+	Key.Context = (uint8)Context;
+	if (TextSourceID.IsValid())
 	{
-		uint32 BufferLen = TextToFilter.Len() + 10; // Docs say 1 byte excess min, going with 10
-		char* OutText = new char[BufferLen];
-		
-		uint64 id = 0;
-
-		if (TextSourceID.IsValid())
-		{
-			id = *((uint64*)TextSourceID.UniqueNetId->GetBytes());
-		}
-		
-		int FilterCount = SteamUtils()->FilterText((ETextFilteringContext)Context, id, TCHAR_TO_ANSI(*TextToFilter), OutText, BufferLen);
-
-		if (FilterCount > 0)
-		{
-			FilteredText = FString(UTF8_TO_TCHAR(OutText));
-			delete[] OutText;
-			return true;
-		}
-
-		delete[] OutText;
+		Key.SourceSteamId = *((uint64*)TextSourceID.UniqueNetId->GetBytes());
 	}
 
-#endif
+	FSteamTextFilterCache& Cache = FSteamTextFilterCache::Get();
+	if (const FString* Cached = Cache.Find(Key))
+	{
+		FilteredText = *Cached;
+	}
+	else if (FSteamTextFilterCache::Filter(Key, FilteredText))
+	{
+		Cache.Add(Key, FilteredText);
+	}
 
-	FilteredText = TextToFilter;
-	return false;
+	return !FilteredText.Equals(TextToFilter, ESearchCase::CaseSensitive);
 }
 
 bool UAdvancedSteamFriendsLibrary::IsSteamInBigPictureMode()
@@ -0,0 +1,269 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SteamAvatarCacheSubsystem.h"
+#include "SteamCallbackDispatcher.h"
+#include "Engine/Engine.h"
+#include "Engine/Texture2D.h"
+
+void USteamAvatarCacheSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	if (USteamCallbackDispatcher* Dispatcher = Collection.InitializeDependency<USteamCallbackDispatcher>())
+	{
+		AvatarImageLoadedHandle = Dispatcher->Subscribe<AvatarImageLoaded_t>([this](const AvatarImageLoaded_t& Data)
+		{
+			OnAvatarImageAvailable(Data.m_steamID.ConvertToUint64());
+		}, TEXT("AvatarImageLoaded"));
+
+		PersonaStateChangeHandle = Dispatcher->Subscribe<PersonaStateChange_t>([this](const PersonaStateChange_t& Data)
+		{
+			if (Data.m_nChangeFlags & k_EPersonaChangeAvatar)
+			{
+				InvalidateAvatar(Data.m_ulSteamID);
+			}
+		}, TEXT("PersonaStateChange"));
+	}
+#else
+	Collection.InitializeDependency<USteamCallbackDispatcher>();
+#endif
+}
+
+void USteamAvatarCacheSubsystem::Deinitialize()
+{
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	if (USteamCallbackDispatcher* Dispatcher = GEngine ? GEngine->GetEngineSubsystem<USteamCallbackDispatcher>() : nullptr)
+	{
+		Dispatcher->Unsubscribe(AvatarImageLoaded_t::k_iCallback, AvatarImageLoadedHandle);
+		Dispatcher->Unsubscribe(PersonaStateChange_t::k_iCallback, PersonaStateChangeHandle);
+	}
+#endif
+	Avatars.Empty();
+	Slots.Empty();
+	FreeSlots.Empty();
+	Head = INDEX_NONE;
+	Tail = INDEX_NONE;
+	AvatarTextures.Empty();
+
+	Super::Deinitialize();
+}
+
+UTexture2D* USteamAvatarCacheSubsystem::GetAvatar(const FBPUniqueNetId& UniqueNetId, SteamAvatarSize AvatarSize, bool& bIsLoading)
+{
+	bIsLoading = false;
+	if (!UniqueNetId.IsValid() || !UniqueNetId.UniqueNetId.IsValid())
+		return nullptr;
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	if (!SteamFriends() || !SteamUtils())
+	{
+		UE_LOG(AdvancedSteamFriendsLog, Warning, TEXT("STEAM Couldn't be verified as initialized"));
+		return nullptr;
+	}
+
+	const FAvatarKey Key{ *((uint64*)UniqueNetId.UniqueNetId->GetBytes()), AvatarSize };
+
+	if (const int32* Cached = Avatars.Find(Key))
+	{
+		Unlink(*Cached);
+		LinkAtHead(*Cached);
+		bIsLoading = Slots[*Cached].bLoading;
+		return Slots[*Cached].Texture;
+	}
+
+	EvictLeastRecentlyUsed();
+
+	const int32 Slot = AddAvatar(Key);
+	FCachedAvatar& Avatar = Slots[Slot];
+	Avatar.UniqueNetId = UniqueNetId;
+
+	if (!LoadAvatar(Avatar) && !Avatar.bLoading)
+	{
+		// No avatar at all, not cached so a later request can try again
+		RemoveAvatar(Slot);
+		return nullptr;
+	}
+
+	bIsLoading = Avatar.bLoading;
+	return Avatar.Texture;
+#else
+	return nullptr;
+#endif
+}
+
+void USteamAvatarCacheSubsystem::InvalidateAvatar(uint64 SteamId)
+{
+	for (SteamAvatarSize Size : { SteamAvatarSize::SteamAvatar_Small, SteamAvatarSize::SteamAvatar_Medium, SteamAvatarSize::SteamAvatar_Large })
+	{
+		if (const int32* Slot = Avatars.Find(FAvatarKey{ SteamId, Size }))
+		{
+			RemoveAvatar(*Slot);
+		}
+	}
+}
+
+void USteamAvatarCacheSubsystem::OnAvatarImageAvailable(uint64 SteamId)
+{
+	// The callback does not say which size finished, so retry every size that is waiting
+	for (SteamAvatarSize Size : { SteamAvatarSize::SteamAvatar_Small, SteamAvatarSize::SteamAvatar_Medium, SteamAvatarSize::SteamAvatar_Large })
+	{
+		const int32* Slot = Avatars.Find(FAvatarKey{ SteamId, Size });
+		if (!Slot || !Slots[*Slot].bLoading)
+			continue;
+
+		// Copied, a handler may ask for more avatars and grow Slots
+		const int32 Loaded = *Slot;
+		if (LoadAvatar(Slots[Loaded]))
+		{
+			const FBPUniqueNetId UniqueNetId = Slots[Loaded].UniqueNetId;
+			OnSteamAvatarLoaded.Broadcast(UniqueNetId, Size, Slots[Loaded].Texture);
+		}
+		else if (!Slots[Loaded].bLoading)
+		{
+			RemoveAvatar(Loaded);
+		}
+	}
+}
+
+bool USteamAvatarCacheSubsystem::LoadAvatar(FCachedAvatar& Avatar)
+{
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	const FAvatarKey& Key = Avatar.Key;
+	int Picture = 0;
+	switch (Key.Size)
+	{
+	case SteamAvatarSize::SteamAvatar_Small: Picture = SteamFriends()->GetSmallFriendAvatar(Key.SteamId); break;
+	case SteamAvatarSize::SteamAvatar_Medium: Picture = SteamFriends()->GetMediumFriendAvatar(Key.SteamId); break;
+	case SteamAvatarSize::SteamAvatar_Large: Picture = SteamFriends()->GetLargeFriendAvatar(Key.SteamId); break;
+	default: break;
+	}
+
+	// -1 means Steam is downloading it and will send AvatarImageLoaded_t
+	Avatar.bLoading = Picture == -1;
+	if (Picture <= 0)
+		return false;
+
+	uint32 Width = 0;
+	uint32 Height = 0;
+	if (!SteamUtils()->GetImageSize(Picture, &Width, &Height) || Width == 0 || Height == 0)
+	{
+		UE_LOG(AdvancedSteamFriendsLog, Warning, TEXT("Bad Height / Width with steam avatar!"));
+		return false;
+	}
+
+	// The render thread frees the pixels once they are uploaded
+	const uint32 NumBytes = Width * Height * 4;
+	uint8* Pixels = (uint8*)FMemory::Malloc(NumBytes);
+	if (!SteamUtils()->GetImageRGBA(Picture, Pixels, NumBytes))
+	{
+		FMemory::Free(Pixels);
+		return false;
+	}
+
+	if (!Avatar.Texture || Avatar.Texture->GetSizeX() != (int32)Width || Avatar.Texture->GetSizeY() != (int32)Height)
+	{
+		ReleaseTexture(Avatar.Texture);
+		Avatar.Texture = CreateTexture(Width, Height);
+	}
+
+	FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(0, 0, 0, 0, Width, Height);
+	Avatar.Texture->UpdateTextureRegions(0, 1, Region, Width * 4, 4, Pixels, [](uint8* SrcData, const FUpdateTextureRegion2D* Regions)
+	{
+		FMemory::Free(SrcData);
+		delete Regions;
+	});
+	return true;
+#else
+	return false;
+#endif
+}
+
+UTexture2D* USteamAvatarCacheSubsystem::CreateTexture(uint32 Width, uint32 Height)
+{
+	UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, PF_R8G8B8A8);
+	Texture->NeverStream = true;
+	Texture->UpdateResource();
+	AvatarTextures.Add(Texture);
+	return Texture;
+}
+
+void USteamAvatarCacheSubsystem::ReleaseTexture(UTexture2D* Texture)
+{
+	// Widgets and Blueprint variables may still show it, writing another avatar into it would swap their picture
+	if (Texture)
+	{
+		AvatarTextures.Remove(Texture);
+	}
+}
+
+int32 USteamAvatarCacheSubsystem::AddAvatar(const FAvatarKey& Key)
+{
+	const int32 Slot = FreeSlots.Num() > 0 ? FreeSlots.Pop(EAllowShrinking::No) : Slots.AddDefaulted();
+	Slots[Slot].Key = Key;
+	Avatars.Add(Key, Slot);
+	LinkAtHead(Slot);
+	return Slot;
+}
+
+void USteamAvatarCacheSubsystem::RemoveAvatar(int32 Slot)
+{
+	ReleaseTexture(Slots[Slot].Texture);
+	Avatars.Remove(Slots[Slot].Key);
+	Unlink(Slot);
+	Slots[Slot] = FCachedAvatar();
+	FreeSlots.Add(Slot);
+}
+
+void USteamAvatarCacheSubsystem::EvictLeastRecentlyUsed()
+{
+	// Walk from the least recently used end until there is room for one more, skipping avatars still downloading so
+	// their OnSteamAvatarLoaded is not lost
+	int32 Slot = Tail;
+	while (Avatars.Num() >= MaxCachedAvatars && Slot != INDEX_NONE)
+	{
+		const int32 Prev = Slots[Slot].Prev;
+		if (!Slots[Slot].bLoading)
+		{
+			RemoveAvatar(Slot);
+		}
+		Slot = Prev;
+	}
+}
+
+void USteamAvatarCacheSubsystem::Unlink(int32 Slot)
+{
+	FCachedAvatar& Node = Slots[Slot];
+	if (Node.Prev != INDEX_NONE)
+	{
+		Slots[Node.Prev].Next = Node.Next;
+	}
+	else
+	{
+		Head = Node.Next;
+	}
+
+	if (Node.Next != INDEX_NONE)
+	{
+		Slots[Node.Next].Prev = Node.Prev;
+	}
+	else
+	{
+		Tail = Node.Prev;
+	}
+	Node.Prev = INDEX_NONE;
+	Node.Next = INDEX_NONE;
+}
+
+void USteamAvatarCacheSubsystem::LinkAtHead(int32 Slot)
+{
+	Slots[Slot].Next = Head;
+	if (Head != INDEX_NONE)
+	{
+		Slots[Head].Prev = Slot;
+	}
+	Head = Slot;
+	if (Tail == INDEX_NONE)
+	{
+		Tail = Slot;
+	}
+}
@@ -0,0 +1,201 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SteamCallbackDispatcher.h"
+#include "SteamCallbackQueue.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommandWithOutputDevice GSteamCallbackStatsCommand(
+	TEXT("AdvancedSteam.CallbackStats"),
+	TEXT("Prints how many of each Steam callback were dispatched, how long they waited for the game thread and how deep the queue got."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		USteamCallbackDispatcher* Dispatcher = GEngine ? GEngine->GetEngineSubsystem<USteamCallbackDispatcher>() : nullptr;
+		if (Dispatcher)
+		{
+			Dispatcher->DumpCallbackStats(Ar);
+		}
+	}));
+
+void USteamCallbackDispatcher::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Queue = MakeShared<FSteamCallbackQueue>();
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::Tick));
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	// The callbacks behind the Blueprint events, anything else registers itself on first Subscribe
+	Subscribe<GameOverlayActivated_t>([this](const GameOverlayActivated_t& Data)
+	{
+		OnGameOverlayActivated.Broadcast((bool)Data.m_bActive);
+	}, TEXT("GameOverlayActivated"));
+
+	Subscribe<ItemInstalled_t>([this](const ItemInstalled_t& Data)
+	{
+		if (SteamUtils() && Data.m_unAppID == SteamUtils()->GetAppID())
+		{
+			OnWorkshopItemInstalled.Broadcast(FBPSteamWorkshopID(Data.m_nPublishedFileId));
+		}
+	}, TEXT("ItemInstalled"));
+
+	Subscribe<DownloadItemResult_t>([this](const DownloadItemResult_t& Data)
+	{
+		if (SteamUtils() && Data.m_unAppID == SteamUtils()->GetAppID())
+		{
+			OnWorkshopItemDownloaded.Broadcast(FBPSteamWorkshopID(Data.m_nPublishedFileId), Data.m_eResult == k_EResultOK);
+		}
+	}, TEXT("DownloadItemResult"));
+#endif
+}
+
+void USteamCallbackDispatcher::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+
+	// Unregisters everything from Steam first, so nothing pushes into the queue once it is gone
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	PendingCallResults.Empty();
+	Callbacks.Empty();
+	NumHeldCallResults.store(0, std::memory_order_relaxed);
+#endif
+	Queue.Reset();
+
+	Super::Deinitialize();
+}
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+bool USteamCallbackDispatcher::Enqueue(int32 CallbackId, const void* Data, int32 Size, uint64 Call, bool bIOFailure)
+{
+	checkSlow(Size <= MaxPayloadSize);
+	return Queue->Push(CallbackId, Data, Size, Call, bIOFailure);
+}
+
+void USteamCallbackDispatcher::DispatchCallResult(uint64 Call, const void* Payload, bool bIOFailure)
+{
+	// One shot, Steam is done with the registration once the result has run
+	if (FPendingCallResult* Found = PendingCallResults.Find(Call))
+	{
+		FPendingCallResult Pending = MoveTemp(*Found);
+		PendingCallResults.Remove(Call);
+		if (Pending.Handler)
+		{
+			Pending.Handler(Payload, bIOFailure);
+		}
+	}
+}
+
+void USteamCallbackDispatcher::DispatchHeldCallResults()
+{
+	if (NumHeldCallResults.exchange(0, std::memory_order_relaxed) == 0)
+		return;
+
+	// Handlers may watch new calls, so the held ones are collected before any of them runs
+	TArray<uint64, TInlineAllocator<8>> HeldCalls;
+	for (const TPair<uint64, FPendingCallResult>& Pair : PendingCallResults)
+	{
+		if (Pair.Value.Forwarder && Pair.Value.Forwarder->IsHeld())
+		{
+			HeldCalls.Add(Pair.Key);
+		}
+	}
+
+	for (uint64 Call : HeldCalls)
+	{
+		// Kept alive until the handler has run, the payload lives in the forwarder
+		FPendingCallResult Pending = MoveTemp(PendingCallResults.FindChecked(Call));
+		PendingCallResults.Remove(Call);
+		if (Pending.Handler)
+		{
+			Pending.Handler(Pending.Forwarder->GetHeldPayload(), Pending.Forwarder->WasHeldIOFailure());
+		}
+	}
+}
+#endif
+
+void USteamCallbackDispatcher::Unsubscribe(int32 CallbackId, FDelegateHandle Handle)
+{
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	// The Steam registration stays, it costs nothing while no one listens
+	if (TUniquePtr<FRegisteredCallback>* Registered = Callbacks.Find(CallbackId))
+	{
+		(*Registered)->Handlers.Remove(Handle);
+	}
+#endif
+}
+
+bool USteamCallbackDispatcher::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SteamCallbackDispatcher_Tick);
+
+	MaxQueueDepth = FMath::Max(MaxQueueDepth, Queue->NumQueued());
+	NumDropped += (int32)Queue->TakeDropped();
+
+	Queue->Drain([this](const FSteamCallbackQueue::FEntry& Entry)
+	{
+		const double Latency = FPlatformTime::Seconds() - Entry.EnqueueTime;
+		FLatencyStats& Latencies = Stats.FindOrAdd(Entry.CallbackId);
+		Latencies.Count++;
+		Latencies.TotalLatency += Latency;
+		Latencies.MaxLatency = FMath::Max(Latencies.MaxLatency, Latency);
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+		if (Entry.Call != 0)
+		{
+			DispatchCallResult(Entry.Call, Entry.Payload, Entry.bIOFailure);
+		}
+		else if (TUniquePtr<FRegisteredCallback>* Registered = Callbacks.Find(Entry.CallbackId))
+		{
+			(*Registered)->Handlers.Broadcast(Entry.Payload);
+		}
+#endif
+
+		OnSteamCallback.Broadcast(Entry.CallbackId);
+	});
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	DispatchHeldCallResults();
+#endif
+
+	return true;
+}
+
+void USteamCallbackDispatcher::GetCallbackStats(TArray<FSteamCallbackStats>& OutStats) const
+{
+	OutStats.Reset(Stats.Num());
+	for (const TPair<int32, FLatencyStats>& Pair : Stats)
+	{
+		FSteamCallbackStats& Out = OutStats.AddDefaulted_GetRef();
+		Out.CallbackId = Pair.Key;
+		Out.Count = Pair.Value.Count;
+		Out.AverageLatencyMs = Pair.Value.Count > 0 ? (float)(Pair.Value.TotalLatency / Pair.Value.Count * 1000.0) : 0.0f;
+		Out.MaxLatencyMs = (float)(Pair.Value.MaxLatency * 1000.0);
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+		const TUniquePtr<FRegisteredCallback>* Registered = Callbacks.Find(Pair.Key);
+		Out.Name = Registered ? (*Registered)->Name : FString::Printf(TEXT("Call result %d"), Pair.Key);
+#else
+		Out.Name = FString::Printf(TEXT("Callback %d"), Pair.Key);
+#endif
+	}
+
+	OutStats.Sort([](const FSteamCallbackStats& A, const FSteamCallbackStats& B) { return A.Count > B.Count; });
+}
+
+void USteamCallbackDispatcher::ResetCallbackStats()
+{
+	Stats.Reset();
+	MaxQueueDepth = 0;
+	NumDropped = 0;
+}
+
+void USteamCallbackDispatcher::DumpCallbackStats(FOutputDevice& Ar) const
+{
+	TArray<FSteamCallbackStats> AllStats;
+	GetCallbackStats(AllStats);
+
+	Ar.Logf(TEXT("Steam callbacks: max queue depth %d of %d, %d dropped"), MaxQueueDepth, (int32)FSteamCallbackQueue::Capacity, NumDropped);
+	for (const FSteamCallbackStats& Entry : AllStats)
+	{
+		Ar.Logf(TEXT("  %-24s (%d) count %6d  avg %7.2f ms  max %7.2f ms"), *Entry.Name, Entry.CallbackId, Entry.Count, Entry.AverageLatencyMs, Entry.MaxLatencyMs);
+	}
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AdvancedMpscRing.h"
+#include "SteamCallbackDispatcher.h"
+
+/**
+ * Bounded lock-free queue that carries Steam callback payloads from the online thread to the game thread.
+ * Push never allocates or blocks. A full queue drops a callback and counts it, but refuses a call result so its
+ * forwarder can keep it, see TSteamCallResultForwarder.
+ * Any number of threads may push, only one thread may drain.
+ */
+class FSteamCallbackQueue
+{
+public:
+
+	static constexpr uint32 Capacity = 256;
+
+	struct FEntry
+	{
+		int32 CallbackId = 0;
+		int32 Size = 0;
+		//Set for call results, 0 for callbacks
+		uint64 Call = 0;
+		bool bIOFailure = false;
+		double EnqueueTime = 0.0;
+		alignas(16) uint8 Payload[USteamCallbackDispatcher::MaxPayloadSize];
+	};
+
+	//False when the queue is full
+	bool Push(int32 CallbackId, const void* Data, int32 Size, uint64 Call, bool bIOFailure)
+	{
+		auto Fill = [=](FEntry& Entry)
+		{
+			Entry.CallbackId = CallbackId;
+			Entry.Size = FMath::Min(Size, USteamCallbackDispatcher::MaxPayloadSize);
+			Entry.Call = Call;
+			Entry.bIOFailure = bIOFailure;
+			Entry.EnqueueTime = FPlatformTime::Seconds();
+			FMemory::Memcpy(Entry.Payload, Data, Entry.Size);
+		};
+		return Call != 0 ? Ring.TryPush(Fill) : Ring.Push(Fill);
+	}
+
+	//Calls Visitor for every queued entry in order, on the calling thread
+	template<typename VisitorType>
+	void Drain(VisitorType&& Visitor)
+	{
+		Ring.Drain(Forward<VisitorType>(Visitor));
+	}
+
+	int32 NumQueued() const { return Ring.NumQueued(); }
+
+	//Number of callbacks lost to a full queue since the last call, call results are never lost
+	uint32 TakeDropped() { return Ring.TakeDropped(); }
+
+private:
+
+	TAdvancedMpscRing<FEntry, Capacity> Ring;
+};
@@ -0,0 +1,112 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#include "SteamFilterTextBatchCallbackProxy.h"
+#include "SteamTextFilterCache.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
+
+//////////////////////////////////////////////////////////////////////////
+// USteamFilterTextBatchCallbackProxy
+
+USteamFilterTextBatchCallbackProxy::USteamFilterTextBatchCallbackProxy(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, Context(EBPTextFilteringContext::FContext_Unknown)
+	, SourceSteamId(0)
+{
+}
+
+USteamFilterTextBatchCallbackProxy* USteamFilterTextBatchCallbackProxy::FilterTextBatch(UObject* WorldContextObject, const TArray<FString>& TextsToFilter, EBPTextFilteringContext Context, const FBPUniqueNetId TextSourceID)
+{
+	USteamFilterTextBatchCallbackProxy* Proxy = NewObject<USteamFilterTextBatchCallbackProxy>();
+
+	Proxy->TextsToFilter = TextsToFilter;
+	Proxy->Context = Context;
+	if (TextSourceID.IsValid())
+	{
+		Proxy->SourceSteamId = *((uint64*)TextSourceID.UniqueNetId->GetBytes());
+	}
+	return Proxy;
+}
+
+void USteamFilterTextBatchCallbackProxy::Activate()
+{
+	FSteamTextFilterCache& Cache = FSteamTextFilterCache::Get();
+
+	TArray<FString> Results;
+	Results.SetNum(TextsToFilter.Num());
+
+	// Each distinct text that is not cached is filtered once, Targets remembers every slot it fills
+	TArray<FSteamTextFilterCache::FKey> Misses;
+	TArray<TArray<int32, TInlineAllocator<1>>> Targets;
+	// Keyed like the cache, FString's own map keys ignore case and "Hello" and "HELLO" can filter differently
+	TMap<FSteamTextFilterCache::FKey, int32> MissIndices;
+
+	for (int32 i = 0; i < TextsToFilter.Num(); i++)
+	{
+		FSteamTextFilterCache::FKey Key;
+		Key.Text = TextsToFilter[i];
+		Key.SourceSteamId = SourceSteamId;
+		Key.Context = (uint8)Context;
+
+		if (const FString* Cached = Cache.Find(Key))
+		{
+			Results[i] = *Cached;
+			continue;
+		}
+
+		if (const int32* MissIndex = MissIndices.Find(Key))
+		{
+			Targets[*MissIndex].Add(i);
+			continue;
+		}
+
+		MissIndices.Add(Key, Misses.Num());
+		Misses.Add(MoveTemp(Key));
+		Targets.AddDefaulted_GetRef().Add(i);
+	}
+
+	if (Misses.Num() == 0)
+	{
+		OnSuccess.Broadcast(Results);
+		return;
+	}
+
+	TWeakObjectPtr<USteamFilterTextBatchCallbackProxy> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Misses = MoveTemp(Misses), Targets = MoveTemp(Targets), Results = MoveTemp(Results)]() mutable
+	{
+		TArray<FString> Filtered;
+		Filtered.SetNum(Misses.Num());
+
+		bool bSuccess = true;
+		for (int32 i = 0; i < Misses.Num(); i++)
+		{
+			bSuccess &= FSteamTextFilterCache::Filter(Misses[i], Filtered[i]);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bSuccess, Misses = MoveTemp(Misses), Targets = MoveTemp(Targets), Results = MoveTemp(Results), Filtered = MoveTemp(Filtered)]() mutable
+		{
+			USteamFilterTextBatchCallbackProxy* Proxy = WeakThis.Get();
+			if (!Proxy)
+				return;
+
+			FSteamTextFilterCache& Cache = FSteamTextFilterCache::Get();
+			for (int32 i = 0; i < Misses.Num(); i++)
+			{
+				if (bSuccess)
+				{
+					Cache.Add(Misses[i], Filtered[i]);
+				}
+
+				for (int32 Target : Targets[i])
+				{
+					Results[Target] = Filtered[i];
+				}
+			}
+
+			if (bSuccess)
+				Proxy->OnSuccess.Broadcast(Results);
+			else
+				Proxy->OnFailure.Broadcast(Results);
+		});
+	});
+}
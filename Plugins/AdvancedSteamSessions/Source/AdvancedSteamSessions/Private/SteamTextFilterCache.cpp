@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SteamTextFilterCache.h"
+#include "AdvancedSteamFriendsLibrary.h"
+
+FSteamTextFilterCache& FSteamTextFilterCache::Get()
+{
+	static FSteamTextFilterCache Cache;
+	return Cache;
+}
+
+FSteamTextFilterCache::FSteamTextFilterCache()
+	: Results(MaxEntries)
+{
+}
+
+const FString* FSteamTextFilterCache::Find(const FKey& Key)
+{
+	check(IsInGameThread());
+	return Results.FindAndTouch(Key);
+}
+
+void FSteamTextFilterCache::Add(const FKey& Key, const FString& Filtered)
+{
+	check(IsInGameThread());
+	Results.Add(Key, Filtered);
+}
+
+void FSteamTextFilterCache::Reset()
+{
+	check(IsInGameThread());
+	Results.Empty(MaxEntries);
+}
+
+bool FSteamTextFilterCache::Filter(const FKey& Key, FString& OutFiltered)
+{
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+
+	if (SteamUtils())
+	{
+		// Steam wants UTF-8 in and out, with at least one byte to spare
+		const FTCHARToUTF8 Utf8Text(*Key.Text);
+		TArray<ANSICHAR, TInlineAllocator<256>> OutText;
+		OutText.SetNumUninitialized(Utf8Text.Length() + 10);
+
+		const int FilterCount = SteamUtils()->FilterText((ETextFilteringContext)Key.Context, CSteamID(Key.SourceSteamId), Utf8Text.Get(), OutText.GetData(), OutText.Num());
+		OutFiltered = FilterCount > 0 ? FString(UTF8_TO_TCHAR(OutText.GetData())) : Key.Text;
+		return true;
+	}
+
+#endif
+
+	OutFiltered = Key.Text;
+	return false;
+}
@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+
+// Remembers what Steam made of a string, per text source and filtering context, so labels and chat lines that are
+// filtered again and again only go through Steam once. The least recently used results are dropped past MaxEntries.
+// The cache itself is game thread only, Filter may run on any thread.
+class FSteamTextFilterCache
+{
+public:
+
+	static FSteamTextFilterCache& Get();
+
+	struct FKey
+	{
+		FString Text;
+		uint64 SourceSteamId = 0;
+		uint8 Context = 0;
+
+		bool operator==(const FKey& Other) const { return SourceSteamId == Other.SourceSteamId && Context == Other.Context && Text.Equals(Other.Text, ESearchCase::CaseSensitive); }
+		friend uint32 GetTypeHash(const FKey& Key) { return HashCombine(HashCombine(GetTypeHash(Key.Text), GetTypeHash(Key.SourceSteamId)), (uint32)Key.Context); }
+	};
+
+	const FString* Find(const FKey& Key);
+	void Add(const FKey& Key, const FString& Filtered);
+
+	// Filtering settings changed, nothing cached still holds
+	void Reset();
+
+	// Asks Steam directly, false when Steam is not available. Safe to call off the game thread.
+	static bool Filter(const FKey& Key, FString& OutFiltered);
+
+	static constexpr int32 MaxEntries = 4096;
+
+private:
+
+	FSteamTextFilterCache();
+
+	TLruCache<FKey, FString> Results;
+};
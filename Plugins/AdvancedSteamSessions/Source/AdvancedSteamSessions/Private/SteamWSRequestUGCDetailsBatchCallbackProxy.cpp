@@ -0,0 +1,148 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#include "SteamWSRequestUGCDetailsBatchCallbackProxy.h"
+#include "SteamWorkshopDetailsCache.h"
+#include "OnlineSubSystemHeader.h"
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+#include "steam/isteamugc.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// USteamWSRequestUGCDetailsBatchCallbackProxy
+
+USteamWSRequestUGCDetailsBatchCallbackProxy::USteamWSRequestUGCDetailsBatchCallbackProxy(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, bUseCache(true)
+	, PagesInFlight(0)
+{
+}
+
+USteamWSRequestUGCDetailsBatchCallbackProxy* USteamWSRequestUGCDetailsBatchCallbackProxy::GetWorkshopItemsDetails(UObject* WorldContextObject, const TArray<FBPSteamWorkshopID>& WorkShopIDs, bool bUseCache)
+{
+	USteamWSRequestUGCDetailsBatchCallbackProxy* Proxy = NewObject<USteamWSRequestUGCDetailsBatchCallbackProxy>();
+
+	Proxy->WorkShopIDs = WorkShopIDs;
+	Proxy->bUseCache = bUseCache;
+	return Proxy;
+}
+
+void USteamWSRequestUGCDetailsBatchCallbackProxy::Activate()
+{
+	FoundDetails.Reset();
+	PagesInFlight = 0;
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	if (SteamAPI_Init())
+	{
+		FSteamWorkshopDetailsCache& Cache = FSteamWorkshopDetailsCache::Get();
+
+		// Only ask Steam about items the cache can't answer
+		TArray<PublishedFileId_t> ToQuery;
+		ToQuery.Reserve(WorkShopIDs.Num());
+		for (const FBPSteamWorkshopID& ID : WorkShopIDs)
+		{
+			if (bUseCache)
+			{
+				uint64 SizeOnDisk = 0;
+				uint32 InstalledTimeStamp = 0;
+				SteamUGC()->GetItemInstallInfo(ID.SteamWorkshopID, &SizeOnDisk, nullptr, 0, &InstalledTimeStamp);
+				const bool bNeedsUpdate = (SteamUGC()->GetItemState(ID.SteamWorkshopID) & k_EItemStateNeedsUpdate) != 0;
+
+				if (const FBPSteamWorkshopItemDetails* Cached = Cache.Find(ID.SteamWorkshopID, InstalledTimeStamp, bNeedsUpdate))
+				{
+					FoundDetails.Add(ID.SteamWorkshopID, *Cached);
+					continue;
+				}
+			}
+
+			ToQuery.AddUnique(ID.SteamWorkshopID);
+		}
+
+		// One request per page, the pages run at the same time
+		for (int32 First = 0; First < ToQuery.Num(); First += kNumUGCResultsPerPage)
+		{
+			const int32 Count = FMath::Min<int32>(kNumUGCResultsPerPage, ToQuery.Num() - First);
+
+			UGCQueryHandle_t hQueryHandle = SteamUGC()->CreateQueryUGCDetailsRequest(ToQuery.GetData() + First, Count);
+			if (hQueryHandle == k_UGCQueryHandleInvalid)
+				continue;
+
+			SteamAPICall_t hSteamAPICall = SteamUGC()->SendQueryUGCRequest(hQueryHandle);
+			if (hSteamAPICall == k_uAPICallInvalid)
+			{
+				SteamUGC()->ReleaseQueryUGCRequest(hQueryHandle);
+				continue;
+			}
+
+			// The handle is released once its results have been read
+			TUniquePtr<FPageQuery>& Page = PageQueries.Add_GetRef(MakeUnique<FPageQuery>());
+			Page->Owner = this;
+			Page->Handle = hQueryHandle;
+			Page->CallResult.Set(hSteamAPICall, Page.Get(), &FPageQuery::OnCompleted);
+			PagesInFlight++;
+		}
+
+		if (PagesInFlight == 0)
+		{
+			Finish();
+		}
+		return;
+	}
+#endif
+	OnFailure.Broadcast(TArray<FBPSteamWorkshopItemDetails>());
+}
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+void USteamWSRequestUGCDetailsBatchCallbackProxy::OnUGCRequestUGCDetails(FPageQuery& Page, SteamUGCQueryCompleted_t *pResult, bool bIOFailure)
+{
+	PagesInFlight--;
+
+	if (!bIOFailure && pResult && SteamAPI_Init())
+	{
+		FSteamWorkshopDetailsCache& Cache = FSteamWorkshopDetailsCache::Get();
+		for (uint32 i = 0; i < pResult->m_unNumResultsReturned; i++)
+		{
+			SteamUGCDetails_t Details;
+			if (SteamUGC()->GetQueryUGCResult(Page.Handle, i, &Details) && Details.m_eResult == k_EResultOK)
+			{
+				FBPSteamWorkshopItemDetails& Found = FoundDetails.Add(Details.m_nPublishedFileId, FBPSteamWorkshopItemDetails(Details));
+				Cache.Add(Found);
+			}
+		}
+	}
+
+	if (SteamUGC())
+	{
+		SteamUGC()->ReleaseQueryUGCRequest(Page.Handle);
+	}
+	Page.Handle = k_UGCQueryHandleInvalid;
+
+	if (PagesInFlight == 0)
+	{
+		Finish();
+	}
+}
+#endif
+
+void USteamWSRequestUGCDetailsBatchCallbackProxy::Finish()
+{
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	PageQueries.Reset();
+#endif
+	FSteamWorkshopDetailsCache::Get().Save();
+
+	TArray<FBPSteamWorkshopItemDetails> Results;
+	Results.Reserve(WorkShopIDs.Num());
+	for (const FBPSteamWorkshopID& ID : WorkShopIDs)
+	{
+		if (const FBPSteamWorkshopItemDetails* Details = FoundDetails.Find(ID.SteamWorkshopID))
+		{
+			Results.Add(*Details);
+		}
+	}
+
+	if (Results.Num() > 0 || WorkShopIDs.Num() == 0)
+		OnSuccess.Broadcast(Results);
+	else
+		OnFailure.Broadcast(Results);
+}
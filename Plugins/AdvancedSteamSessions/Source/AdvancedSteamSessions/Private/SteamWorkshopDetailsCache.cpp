@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SteamWorkshopDetailsCache.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// Details are stored untagged, bump this whenever FBPSteamWorkshopItemDetails changes
+static constexpr int32 CacheVersion = 1;
+
+FSteamWorkshopDetailsCache& FSteamWorkshopDetailsCache::Get()
+{
+	static FSteamWorkshopDetailsCache Cache;
+	return Cache;
+}
+
+FSteamWorkshopDetailsCache::FSteamWorkshopDetailsCache()
+{
+	Load();
+}
+
+const FBPSteamWorkshopItemDetails* FSteamWorkshopDetailsCache::Find(uint64 WorkshopID, uint32 InstalledTimeStamp, bool bNeedsUpdate) const
+{
+	const FEntry* Entry = Entries.Find(WorkshopID);
+	if (!Entry || bNeedsUpdate)
+		return nullptr;
+
+	// A newer download means the item was updated after we cached it
+	if (InstalledTimeStamp != 0 && Entry->Details.TimeUpdated < (int64)InstalledTimeStamp)
+		return nullptr;
+
+	// Votes, tags and descriptions change without a new version, so installed items go stale as well
+	const int64 Now = FDateTime::UtcNow().ToUnixTimestamp();
+	return (Now - Entry->CachedAt) <= MaxAgeSeconds ? &Entry->Details : nullptr;
+}
+
+void FSteamWorkshopDetailsCache::Add(const FBPSteamWorkshopItemDetails& Details)
+{
+	FEntry& Entry = Entries.FindOrAdd(Details.WorkshopID.SteamWorkshopID);
+	Entry.Details = Details;
+	Entry.CachedAt = FDateTime::UtcNow().ToUnixTimestamp();
+	bDirty = true;
+}
+
+void FSteamWorkshopDetailsCache::Save()
+{
+	if (!bDirty)
+		return;
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	int32 Version = CacheVersion;
+	int32 NumEntries = Entries.Num();
+	Writer << Version;
+	Writer << NumEntries;
+	for (TPair<uint64, FEntry>& Pair : Entries)
+	{
+		Writer << Pair.Key;
+		Writer << Pair.Value.CachedAt;
+		FBPSteamWorkshopItemDetails::StaticStruct()->SerializeBin(Writer, &Pair.Value.Details);
+	}
+
+	if (FFileHelper::SaveArrayToFile(Data, *GetCachePath()))
+	{
+		bDirty = false;
+	}
+}
+
+void FSteamWorkshopDetailsCache::Load()
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *GetCachePath(), FILEREAD_Silent))
+		return;
+
+	FMemoryReader Reader(Data);
+
+	int32 Version = 0;
+	int32 NumEntries = 0;
+	Reader << Version;
+	Reader << NumEntries;
+	if (Version != CacheVersion || NumEntries < 0)
+		return;
+
+	Entries.Reserve(NumEntries);
+	for (int32 i = 0; i < NumEntries && !Reader.IsError(); i++)
+	{
+		uint64 WorkshopID = 0;
+		FEntry Entry;
+		Reader << WorkshopID;
+		Reader << Entry.CachedAt;
+		FBPSteamWorkshopItemDetails::StaticStruct()->SerializeBin(Reader, &Entry.Details);
+
+		// WorkshopID is a property, but the uint64 inside FBPSteamWorkshopID is not, so SerializeBin leaves it unset
+		Entry.Details.WorkshopID = FBPSteamWorkshopID(WorkshopID);
+		Entries.Add(WorkshopID, MoveTemp(Entry));
+	}
+
+	// A truncated file is worth nothing, start over
+	if (Reader.IsError())
+	{
+		Entries.Reset();
+	}
+}
+
+FString FSteamWorkshopDetailsCache::GetCachePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("SteamWorkshop") / TEXT("UGCDetailsCache.bin");
+}
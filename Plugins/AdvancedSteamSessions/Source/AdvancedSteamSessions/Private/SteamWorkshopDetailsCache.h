@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AdvancedSteamWorkshopLibrary.h"
+
+// Workshop item details kept on disk between runs, so items that have not changed are not queried again at startup.
+// Game thread only.
+class FSteamWorkshopDetailsCache
+{
+public:
+
+	static FSteamWorkshopDetailsCache& Get();
+
+	// Cached details no older than MaxAgeSeconds, and not older than the installed copy of the item (InstalledTimeStamp,
+	// 0 when not installed). Nothing is returned for an item Steam has a newer version of (bNeedsUpdate, from
+	// k_EItemStateNeedsUpdate), whatever its age.
+	const FBPSteamWorkshopItemDetails* Find(uint64 WorkshopID, uint32 InstalledTimeStamp, bool bNeedsUpdate) const;
+
+	void Add(const FBPSteamWorkshopItemDetails& Details);
+
+	// Writes the cache out if anything was added since the last save
+	void Save();
+
+	static constexpr int64 MaxAgeSeconds = 24 * 60 * 60;
+
+private:
+
+	FSteamWorkshopDetailsCache();
+
+	void Load();
+	static FString GetCachePath();
+
+	struct FEntry
+	{
+		FBPSteamWorkshopItemDetails Details;
+		int64 CachedAt = 0;
+	};
+
+	TMap<uint64, FEntry> Entries;
+	bool bDirty = false;
+};
@@ -0,0 +1,353 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "SteamWorkshopModSubsystem.h"
+#include "SteamCallbackDispatcher.h"
+#include "Async/Async.h"
+#include "Engine/Engine.h"
+#include "Tasks/Task.h"
+#include "Engine/GameInstance.h"
+#include "TimerManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+#include "steam/isteamugc.h"
+#endif
+
+void USteamWorkshopModSubsystem::Deinitialize()
+{
+	if (UGameInstance* GameInstance = GetGameInstance())
+	{
+		GameInstance->GetTimerManager().ClearTimer(PollHandle);
+	}
+
+	// Anything still running in the background finds a stale serial or no subsystem
+	PipelineSerial++;
+	bRunning = false;
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	if (USteamCallbackDispatcher* Dispatcher = GEngine ? GEngine->GetEngineSubsystem<USteamCallbackDispatcher>() : nullptr)
+	{
+		Dispatcher->Unsubscribe(DownloadItemResult_t::k_iCallback, DownloadResultHandle);
+	}
+	DownloadResultHandle.Reset();
+#endif
+	Mods.Empty();
+	ModIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+void USteamWorkshopModSubsystem::StartPipeline(bool bHighPriority)
+{
+	if (bRunning)
+		return;
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	if (!SteamAPI_Init())
+	{
+		UE_LOG(AdvancedSteamWorkshopLog, Warning, TEXT("Error in StartPipeline : SteamAPI is not Inited!"));
+		return;
+	}
+
+	USteamCallbackDispatcher* Dispatcher = GEngine->GetEngineSubsystem<USteamCallbackDispatcher>();
+	if (Dispatcher && !DownloadResultHandle.IsValid())
+	{
+		DownloadResultHandle = Dispatcher->Subscribe<DownloadItemResult_t>([this](const DownloadItemResult_t& Data)
+		{
+			// Downloads of other apps running through the same client
+			if (SteamUtils() && Data.m_unAppID == SteamUtils()->GetAppID())
+			{
+				OnDownloadResult(Data.m_nPublishedFileId, Data.m_eResult == k_EResultOK, (int32)Data.m_eResult);
+			}
+		}, TEXT("DownloadItemResult"));
+	}
+
+	bRunning = true;
+	const uint32 Serial = ++PipelineSerial;
+
+	// Asking for the state of a few hundred items and queueing their downloads goes through the Steam client, keep it off the game thread
+	TWeakObjectPtr<USteamWorkshopModSubsystem> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Serial, bHighPriority]()
+	{
+		TArray<FSteamWorkshopMod> EnumeratedMods;
+
+		const uint32 NumItems = SteamUGC()->GetNumSubscribedItems();
+		TArray<PublishedFileId_t> FileIds;
+		FileIds.SetNumUninitialized(NumItems);
+		const uint32 NumFound = NumItems > 0 ? SteamUGC()->GetSubscribedItems(FileIds.GetData(), NumItems) : 0;
+
+		EnumeratedMods.Reserve(NumFound);
+		for (uint32 i = 0; i < NumFound; i++)
+		{
+			FSteamWorkshopMod& Mod = EnumeratedMods.AddDefaulted_GetRef();
+			Mod.WorkshopID = FBPSteamWorkshopID(FileIds[i]);
+
+			const uint32 State = SteamUGC()->GetItemState(FileIds[i]);
+			if ((State & k_EItemStateInstalled) && !(State & (k_EItemStateNeedsUpdate | k_EItemStateDownloading | k_EItemStateDownloadPending)))
+			{
+				Mod.State = ESteamWorkshopModState::Verifying;
+				continue;
+			}
+
+			// Already queued downloads are bumped to our priority as well
+			if (!SteamUGC()->DownloadItem(FileIds[i], bHighPriority))
+			{
+				Mod.State = ESteamWorkshopModState::Failed;
+				Mod.Error = TEXT("Steam refused to download the item");
+			}
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, EnumeratedMods = MoveTemp(EnumeratedMods)]() mutable
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnItemsEnumerated(Serial, MoveTemp(EnumeratedMods));
+			}
+		});
+	});
+	return;
+#endif
+
+	UE_LOG(AdvancedSteamWorkshopLog, Warning, TEXT("Error in StartPipeline : Called on an incompatible platform"));
+}
+
+void USteamWorkshopModSubsystem::OnItemsEnumerated(uint32 Serial, TArray<FSteamWorkshopMod>&& EnumeratedMods)
+{
+	if (Serial != PipelineSerial)
+		return;
+
+	Mods = MoveTemp(EnumeratedMods);
+	ModIndices.Reset();
+	ModIndices.Reserve(Mods.Num());
+
+	bool bAnyDownloading = false;
+	for (int32 i = 0; i < Mods.Num(); i++)
+	{
+		ModIndices.Add(Mods[i].WorkshopID.SteamWorkshopID, i);
+	}
+
+	// Indices are settled, so handlers may look mods up from here on
+	for (FSteamWorkshopMod& Mod : Mods)
+	{
+		switch (Mod.State)
+		{
+		case ESteamWorkshopModState::Verifying:
+			BeginVerify(Mod);
+			break;
+		case ESteamWorkshopModState::Failed:
+			FailMod(Mod, Mod.Error);
+			break;
+		case ESteamWorkshopModState::Downloading:
+			bAnyDownloading = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (bAnyDownloading)
+	{
+		GetGameInstance()->GetTimerManager().SetTimer(PollHandle, FTimerDelegate::CreateUObject(this, &ThisClass::PollDownloads), PollInterval, true);
+	}
+
+	CheckFinished();
+}
+
+void USteamWorkshopModSubsystem::PollDownloads()
+{
+	bool bAnyDownloading = false;
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	if (SteamAPI_Init())
+	{
+		for (FSteamWorkshopMod& Mod : Mods)
+		{
+			if (Mod.State != ESteamWorkshopModState::Downloading)
+				continue;
+
+			// Both are reads of state the client already has, they do not wait on the network
+			uint64 BytesDownloaded = 0;
+			uint64 BytesTotal = 0;
+			if (SteamUGC()->GetItemDownloadInfo(Mod.WorkshopID.SteamWorkshopID, &BytesDownloaded, &BytesTotal) &&
+				((int64)BytesDownloaded != Mod.BytesDownloaded || (int64)BytesTotal != Mod.BytesTotal))
+			{
+				Mod.BytesDownloaded = (int64)BytesDownloaded;
+				Mod.BytesTotal = (int64)BytesTotal;
+				OnModProgress.Broadcast(Mod);
+			}
+
+			// DownloadItemResult_t is the normal way out, this catches items that finished before we asked
+			const uint32 State = SteamUGC()->GetItemState(Mod.WorkshopID.SteamWorkshopID);
+			if ((State & k_EItemStateInstalled) && !(State & (k_EItemStateNeedsUpdate | k_EItemStateDownloading | k_EItemStateDownloadPending)))
+			{
+				BeginVerify(Mod);
+				continue;
+			}
+
+			bAnyDownloading = true;
+		}
+	}
+#endif
+
+	if (!bAnyDownloading)
+	{
+		GetGameInstance()->GetTimerManager().ClearTimer(PollHandle);
+		CheckFinished();
+	}
+}
+
+void USteamWorkshopModSubsystem::OnDownloadResult(uint64 WorkshopID, bool bSuccess, int32 SteamResult)
+{
+	FSteamWorkshopMod* Mod = FindMod(WorkshopID);
+	if (!Mod || Mod->State != ESteamWorkshopModState::Downloading)
+		return;
+
+	if (bSuccess)
+	{
+		BeginVerify(*Mod);
+	}
+	else
+	{
+		FailMod(*Mod, FString::Printf(TEXT("Download failed with result %d"), SteamResult));
+	}
+
+	CheckFinished();
+}
+
+void USteamWorkshopModSubsystem::BeginVerify(FSteamWorkshopMod& Mod)
+{
+	Mod.State = ESteamWorkshopModState::Verifying;
+
+#if STEAM_SDK_INSTALLED && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX)
+	uint64 SizeOnDisk = 0;
+	uint32 TimeStamp = 0;
+	ANSICHAR Folder[1024];
+	if (!SteamAPI_Init() || !SteamUGC()->GetItemInstallInfo(Mod.WorkshopID.SteamWorkshopID, &SizeOnDisk, Folder, sizeof(Folder), &TimeStamp))
+	{
+		FailMod(Mod, TEXT("Steam has no install folder for the item"));
+		return;
+	}
+
+	Mod.InstallFolder = UTF8_TO_TCHAR(Folder);
+	FPaths::NormalizeDirectoryName(Mod.InstallFolder);
+
+	const uint32 Serial = PipelineSerial;
+	const uint64 WorkshopID = Mod.WorkshopID.SteamWorkshopID;
+	TWeakObjectPtr<USteamWorkshopModSubsystem> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Serial, WorkshopID, InstallFolder = Mod.InstallFolder]()
+	{
+		FString ManifestPath;
+		FString Error = VerifyInstallFolder(InstallFolder, ManifestPath);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, WorkshopID, ManifestPath = MoveTemp(ManifestPath), Error = MoveTemp(Error)]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnVerified(Serial, WorkshopID, ManifestPath, Error);
+			}
+		});
+	});
+#else
+	FailMod(Mod, TEXT("Called on an incompatible platform"));
+#endif
+}
+
+FString USteamWorkshopModSubsystem::VerifyInstallFolder(const FString& InstallFolder, FString& OutManifestPath)
+{
+	if (!FPaths::DirectoryExists(InstallFolder))
+		return TEXT("Install folder is missing");
+
+	OutManifestPath = InstallFolder / TEXT("Mod.json");
+
+	FString ManifestText;
+	if (!FFileHelper::LoadFileToString(ManifestText, *OutManifestPath))
+		return TEXT("Mod.json is missing");
+
+	TSharedPtr<FJsonObject> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ManifestText);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+		return TEXT("Mod.json is not valid JSON");
+
+	const TSharedPtr<FJsonObject>* ModObject = nullptr;
+	if (!Root->TryGetObjectField(TEXT("Mod"), ModObject))
+		return TEXT("Mod.json has no Mod object");
+
+	// A mod without addons is odd but harmless, a missing addon would fail later inside the mod loader
+	const TArray<TSharedPtr<FJsonValue>>* AddonPaths = nullptr;
+	if ((*ModObject)->TryGetArrayField(TEXT("addonPaths"), AddonPaths))
+	{
+		const FString FolderWithSlash = InstallFolder + TEXT("/");
+		for (const TSharedPtr<FJsonValue>& AddonPath : *AddonPaths)
+		{
+			FString RelativePath;
+			if (!AddonPath.IsValid() || !AddonPath->TryGetString(RelativePath))
+				return TEXT("addonPaths holds something that is not a path");
+
+			// Addons have to stay inside the item, no "../" out of it
+			FString FullPath = InstallFolder / RelativePath;
+			FPaths::NormalizeFilename(FullPath);
+			if (!FPaths::CollapseRelativeDirectories(FullPath) || !FullPath.StartsWith(FolderWithSlash))
+				return FString::Printf(TEXT("Addon %s points outside the install folder"), *RelativePath);
+
+			if (!FPaths::FileExists(FullPath))
+				return FString::Printf(TEXT("Addon %s is missing"), *RelativePath);
+		}
+	}
+
+	return FString();
+}
+
+void USteamWorkshopModSubsystem::OnVerified(uint32 Serial, uint64 WorkshopID, const FString& ManifestPath, const FString& Error)
+{
+	if (Serial != PipelineSerial)
+		return;
+
+	FSteamWorkshopMod* Mod = FindMod(WorkshopID);
+	if (!Mod || Mod->State != ESteamWorkshopModState::Verifying)
+		return;
+
+	if (!Error.IsEmpty())
+	{
+		FailMod(*Mod, Error);
+	}
+	else
+	{
+		Mod->State = ESteamWorkshopModState::Ready;
+		Mod->ManifestPath = ManifestPath;
+		Mod->Error.Empty();
+		OnModReady.Broadcast(*Mod);
+	}
+
+	CheckFinished();
+}
+
+void USteamWorkshopModSubsystem::FailMod(FSteamWorkshopMod& Mod, const FString& Error)
+{
+	Mod.State = ESteamWorkshopModState::Failed;
+	Mod.Error = Error;
+	UE_LOG(AdvancedSteamWorkshopLog, Warning, TEXT("Workshop item %llu failed : %s"), Mod.WorkshopID.SteamWorkshopID, *Error);
+	OnModFailed.Broadcast(Mod);
+}
+
+void USteamWorkshopModSubsystem::CheckFinished()
+{
+	if (!bRunning)
+		return;
+
+	for (const FSteamWorkshopMod& Mod : Mods)
+	{
+		if (Mod.State == ESteamWorkshopModState::Downloading || Mod.State == ESteamWorkshopModState::Verifying)
+			return;
+	}
+
+	bRunning = false;
+	GetGameInstance()->GetTimerManager().ClearTimer(PollHandle);
+	OnAllModsProcessed.Broadcast();
+}
+
+FSteamWorkshopMod* USteamWorkshopModSubsystem::FindMod(uint64 WorkshopID)
+{
+	const int32* Index = ModIndices.Find(WorkshopID);
+	return Index ? &Mods[*Index] : nullptr;
+}
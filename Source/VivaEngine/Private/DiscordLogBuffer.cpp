@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DiscordLogBuffer.h"
+#include "discord.h"
+
+void FDiscordLogBuffer::Push(discord::LogLevel Level, const char* Message)
+{
+	// Full when the game thread has not drained for a while, the line is counted as dropped
+	Ring.Push([Level, Message](FEntry& Entry)
+	{
+		Entry.Level = Level;
+		Entry.Time = FPlatformTime::Seconds();
+		FCStringAnsi::Strncpy(Entry.Message, Message ? Message : "", MaxMessageLength);
+	});
+}
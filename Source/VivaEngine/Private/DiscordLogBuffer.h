@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AdvancedMpscRing.h"
+
+namespace discord { enum class LogLevel; }
+
+/**
+ * Bounded lock-free queue that carries Discord SDK log lines from whichever thread the SDK logs on to the game thread.
+ * Push never allocates or blocks, a full buffer drops the line and counts it instead.
+ * Any number of threads may push, only one thread may drain.
+ */
+class FDiscordLogBuffer
+{
+public:
+
+	static constexpr uint32 Capacity = 256;
+	static constexpr int32 MaxMessageLength = 512;
+
+	struct FEntry
+	{
+		discord::LogLevel Level;
+		double Time = 0.0;
+		//UTF-8, truncated to fit
+		ANSICHAR Message[MaxMessageLength];
+	};
+
+	void Push(discord::LogLevel Level, const char* Message);
+
+	//Calls Visitor for every queued entry in order, on the calling thread
+	template<typename VisitorType>
+	void Drain(VisitorType&& Visitor)
+	{
+		Ring.Drain(Forward<VisitorType>(Visitor));
+	}
+
+	//Number of lines lost to a full buffer since the last call
+	uint32 TakeDropped() { return Ring.TakeDropped(); }
+
+private:
+
+	TAdvancedMpscRing<FEntry, Capacity> Ring;
+};
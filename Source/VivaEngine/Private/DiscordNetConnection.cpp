@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DiscordNetConnection.h"
+#include "DiscordNetDriver.h"
+#include "PacketHandler.h"
+#include "SocketSubsystemDiscord.h"
+
+void UDiscordNetConnection::LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits)
+{
+	UDiscordNetDriver* DiscordDriver = Cast<UDiscordNetDriver>(Driver);
+	FSocketDiscord* DiscordSocket = DiscordDriver ? DiscordDriver->GetDiscordSocket() : nullptr;
+	if (!DiscordSocket)
+	{
+		Super::LowLevelSend(Data, CountBits, Traits);
+		return;
+	}
+
+	// Handshake packets go reliable, a lost one stalls the connect until a resend.
+	// After that UE does its own reliability, and the unreliable channel avoids head of line blocking.
+	const bool bHandshaking = Handler.IsValid() && !Handler->IsFullyInitialized();
+	const bool bWasReliable = DiscordSocket->SetSendReliable(bHandshaking);
+
+	Super::LowLevelSend(Data, CountBits, Traits);
+
+	DiscordSocket->SetSendReliable(bWasReliable);
+}
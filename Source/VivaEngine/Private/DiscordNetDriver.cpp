@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DiscordNetDriver.h"
+#include "SocketSubsystemDiscord.h"
+#include "VE_Discord_Subsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Kismet/GameplayStatics.h"
+#include "discord.h"
+
+ISocketSubsystem* UDiscordNetDriver::GetSocketSubsystem()
+{
+	if (bIsPassthrough)
+	{
+		return ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	}
+
+	if (!DiscordSockets.IsValid())
+	{
+		TWeakObjectPtr<UDiscordNetDriver> WeakThis(this);
+		DiscordSockets = MakeShared<FSocketSubsystemDiscord>([WeakThis]() -> discord::Core*
+		{
+			return WeakThis.IsValid() ? WeakThis->GetDiscordCore() : nullptr;
+		});
+	}
+	return DiscordSockets.Get();
+}
+
+bool UDiscordNetDriver::InitConnect(FNetworkNotify* InNotify, const FURL& ConnectURL, FString& Error)
+{
+	int64 LobbyId = 0;
+	int64 UserId = 0;
+	bIsPassthrough = !FInternetAddrDiscord::Parse(ConnectURL.Host, LobbyId, UserId);
+	if (!bIsPassthrough && !GetDiscordCore())
+	{
+		Error = TEXT("Discord is not running");
+		return false;
+	}
+
+	return Super::InitConnect(InNotify, ConnectURL, Error);
+}
+
+bool UDiscordNetDriver::InitListen(FNetworkNotify* InNotify, FURL& LocalURL, bool bReuseAddressAndPort, FString& Error)
+{
+	const TCHAR* LobbyOption = LocalURL.GetOption(TEXT("DiscordLobby="), nullptr);
+	bIsPassthrough = LobbyOption == nullptr;
+	if (!bIsPassthrough && !GetDiscordCore())
+	{
+		Error = TEXT("Discord is not running");
+		return false;
+	}
+
+	if (!Super::InitListen(InNotify, LocalURL, bReuseAddressAndPort, Error))
+	{
+		return false;
+	}
+
+	// Clients send to the lobby owner, so the host has to be on the lobby's network before anyone connects
+	if (!bIsPassthrough && !GetDiscordSocket()->JoinLobby(FCString::Atoi64(LobbyOption)))
+	{
+		Error = FString::Printf(TEXT("Could not connect to the network of Discord lobby %s"), LobbyOption);
+		return false;
+	}
+	return true;
+}
+
+void UDiscordNetDriver::TickFlush(float DeltaSeconds)
+{
+	Super::TickFlush(DeltaSeconds);
+
+	// Connections only queued their packets, hand the whole frame to Discord at once
+	if (!bIsPassthrough)
+	{
+		if (discord::Core* Core = GetDiscordCore())
+		{
+			Core->LobbyManager().FlushNetwork();
+		}
+	}
+}
+
+void UDiscordNetDriver::LowLevelSend(TSharedPtr<const FInternetAddr> Address, void* Data, int32 CountBits, FOutPacketTraits& Traits)
+{
+	// Connectionless packets are the stateless handshake, losing one stalls the connect until a resend
+	FSocketDiscord* DiscordSocket = GetDiscordSocket();
+	const bool bWasReliable = DiscordSocket && DiscordSocket->SetSendReliable(true);
+
+	Super::LowLevelSend(Address, Data, CountBits, Traits);
+
+	if (DiscordSocket)
+	{
+		DiscordSocket->SetSendReliable(bWasReliable);
+	}
+}
+
+FSocketDiscord* UDiscordNetDriver::GetDiscordSocket()
+{
+	return bIsPassthrough ? nullptr : static_cast<FSocketDiscord*>(GetSocket());
+}
+
+FString UDiscordNetDriver::GetDiscordLobbyTravelURL(UObject* WorldContextObject, int64 LobbyId)
+{
+	UVE_Discord_Subsystem* Discord = UGameInstance::GetSubsystem<UVE_Discord_Subsystem>(UGameplayStatics::GetGameInstance(WorldContextObject));
+	discord::Core* Core = Discord ? Discord->GetCore() : nullptr;
+
+	discord::Lobby Lobby;
+	if (!Core || Core->LobbyManager().GetLobby(LobbyId, &Lobby) != discord::Result::Ok)
+	{
+		return FString();
+	}
+	return FInternetAddrDiscord(LobbyId, Lobby.GetOwnerId()).ToString(false);
+}
+
+bool UDiscordNetDriver::SetGameNetDriverToDiscord(bool bUseDiscord)
+{
+	if (!GEngine)
+	{
+		return false;
+	}
+
+	static const FName DiscordNetDriverName(TEXT("DiscordNetDriver"));
+	FNetDriverDefinition* GameDefinition = GEngine->NetDriverDefinitions.FindByPredicate([](const FNetDriverDefinition& Definition)
+	{
+		return Definition.DefName == NAME_GameNetDriver;
+	});
+	const FNetDriverDefinition* DiscordDefinition = GEngine->NetDriverDefinitions.FindByPredicate([](const FNetDriverDefinition& Definition)
+	{
+		return Definition.DefName == DiscordNetDriverName;
+	});
+	if (!GameDefinition || !DiscordDefinition)
+	{
+		return false;
+	}
+
+	// The configured game driver is remembered the first time, so switching back restores it
+	static TOptional<FNetDriverDefinition> ConfiguredGameDefinition;
+	if (!ConfiguredGameDefinition.IsSet())
+	{
+		ConfiguredGameDefinition = *GameDefinition;
+	}
+
+	const FNetDriverDefinition& Source = bUseDiscord ? *DiscordDefinition : ConfiguredGameDefinition.GetValue();
+	GameDefinition->DriverClassName = Source.DriverClassName;
+	GameDefinition->DriverClassNameFallback = Source.DriverClassNameFallback;
+	return true;
+}
+
+discord::Core* UDiscordNetDriver::GetDiscordCore() const
+{
+	// While connecting there is no world yet, the pending net game's world context knows the game instance
+	UWorld* World = GetWorld();
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	if (!GameInstance && GEngine)
+	{
+		if (FWorldContext* Context = GEngine->GetWorldContextFromPendingNetGameNetDriver(this))
+		{
+			GameInstance = Context->OwningGameInstance;
+		}
+	}
+
+	UVE_Discord_Subsystem* Discord = UGameInstance::GetSubsystem<UVE_Discord_Subsystem>(GameInstance);
+	return Discord ? Discord->GetCore() : nullptr;
+}
@@ -1,22 +1,30 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "DiscordWrapper.h"
+#include "VE_Discord_Subsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
 #include "discord.h"
 
-discord::Core* core{};
+// The core is owned by the game instance so every component shares it
+static discord::Core* GetDiscordCore(const UActorComponent* Component)
+{
+	UWorld* World = Component->GetWorld();
+	UVE_Discord_Subsystem* Discord = UGameInstance::GetSubsystem<UVE_Discord_Subsystem>(World ? World->GetGameInstance() : nullptr);
+	return Discord ? Discord->GetCore() : nullptr;
+}
 
 // Sets default values for this component's properties
 UDiscordWrapper::UDiscordWrapper()
 {
-	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bCanEverTick = false;
 }
 
 void UDiscordWrapper::SetDiscordActivity(FString State, FString Details, FString LargeImageName)
 {
-	// Make sure Discord is not required
-	// We will need to hide this Token ID in something later
-	auto result = discord::Core::Create(1030046546768711720, DiscordCreateFlags_NoRequireDiscord, &core);
-
+	discord::Core* core = GetDiscordCore(this);
+	if (!core)
+		return;
 
 	discord::Activity activity{};
 
@@ -34,17 +42,16 @@ void UDiscordWrapper::SetDiscordActivity(FString State, FString Details, FString
 	core->ActivityManager().UpdateActivity(activity, [](discord::Result result)
 		{
 			if (result != discord::Result::Ok) {
-#if UE_BUILD_DEBUG
-				if (GEngine)
-					GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Red, FString::Printf(TEXT("Error with Discord Activity Manager")));
-#endif
+				UE_LOG(LogDiscord, Warning, TEXT("UpdateActivity failed with result %d"), static_cast<int32>(result));
 			}
 		});
 }
 
 void UDiscordWrapper::ClearDiscordActivity()
 {
-	auto result = discord::Core::Create(1030046546768711720, DiscordCreateFlags_NoRequireDiscord, &core);
+	discord::Core* core = GetDiscordCore(this);
+	if (!core)
+		return;
 
 	core->ActivityManager().ClearActivity([](discord::Result result)
 		{
@@ -65,7 +72,6 @@ void UDiscordWrapper::TickComponent(float DeltaTime, ELevelTick TickType, FActor
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	// Required every tick (Per Discord SDK Docs)
-	::core->RunCallbacks();
+	// Discord callbacks are run by UVE_Discord_Subsystem
 }
 
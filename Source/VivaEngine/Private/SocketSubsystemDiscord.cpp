@@ -0,0 +1,354 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SocketSubsystemDiscord.h"
+#include "discord.h"
+
+bool FInternetAddrDiscord::Parse(const FString& Address, int64& OutLobbyId, int64& OutUserId)
+{
+	static const FString Prefix = TEXT("discord.");
+	if (!Address.StartsWith(Prefix))
+	{
+		return false;
+	}
+
+	// Drop a trailing ":port"
+	FString Members = Address.Mid(Prefix.Len());
+	Members.Split(TEXT(":"), &Members, nullptr);
+
+	FString Lobby;
+	FString User;
+	if (!Members.Split(TEXT("."), &Lobby, &User) || !Lobby.IsNumeric() || !User.IsNumeric())
+	{
+		return false;
+	}
+
+	OutLobbyId = FCString::Atoi64(*Lobby);
+	OutUserId = FCString::Atoi64(*User);
+	return true;
+}
+
+void FInternetAddrDiscord::SetIp(const TCHAR* InAddr, bool& bIsValid)
+{
+	bIsValid = Parse(InAddr, LobbyId, UserId);
+}
+
+void FInternetAddrDiscord::SetRawIp(const TArray<uint8>& RawAddr)
+{
+	if (RawAddr.Num() == sizeof(LobbyId) + sizeof(UserId))
+	{
+		FMemory::Memcpy(&LobbyId, RawAddr.GetData(), sizeof(LobbyId));
+		FMemory::Memcpy(&UserId, RawAddr.GetData() + sizeof(LobbyId), sizeof(UserId));
+	}
+}
+
+TArray<uint8> FInternetAddrDiscord::GetRawIp() const
+{
+	TArray<uint8> RawAddr;
+	RawAddr.Append((const uint8*)&LobbyId, sizeof(LobbyId));
+	RawAddr.Append((const uint8*)&UserId, sizeof(UserId));
+	return RawAddr;
+}
+
+FString FInternetAddrDiscord::ToString(bool bAppendPort) const
+{
+	if (bAppendPort)
+	{
+		return FString::Printf(TEXT("discord.%lld.%lld:%d"), LobbyId, UserId, Port);
+	}
+	return FString::Printf(TEXT("discord.%lld.%lld"), LobbyId, UserId);
+}
+
+bool FInternetAddrDiscord::operator==(const FInternetAddr& Other) const
+{
+	if (Other.GetProtocolType() != DISCORD_SOCKETSUBSYSTEM)
+	{
+		return false;
+	}
+
+	const FInternetAddrDiscord& DiscordOther = static_cast<const FInternetAddrDiscord&>(Other);
+	return LobbyId == DiscordOther.LobbyId && UserId == DiscordOther.UserId;
+}
+
+uint32 FInternetAddrDiscord::GetTypeHash() const
+{
+	return HashCombine(::GetTypeHash(LobbyId), ::GetTypeHash(UserId));
+}
+
+TSharedRef<FInternetAddr> FInternetAddrDiscord::Clone() const
+{
+	return MakeShared<FInternetAddrDiscord>(*this);
+}
+
+FSocketDiscord::FSocketDiscord(FSocketSubsystemDiscord& InSubsystem, const FString& InSocketDescription)
+	: FSocket(SOCKTYPE_Datagram, InSocketDescription, DISCORD_SOCKETSUBSYSTEM)
+	, Subsystem(InSubsystem)
+{
+}
+
+FSocketDiscord::~FSocketDiscord()
+{
+	Close();
+}
+
+bool FSocketDiscord::JoinLobby(int64 LobbyId)
+{
+	if (JoinedLobbies.Contains(LobbyId))
+	{
+		return true;
+	}
+
+	discord::Core* Core = Subsystem.GetCore();
+	if (!Core || LobbyId == 0)
+	{
+		return false;
+	}
+
+	discord::LobbyManager& Lobbies = Core->LobbyManager();
+	if (Lobbies.ConnectNetwork(LobbyId) != discord::Result::Ok
+		|| Lobbies.OpenNetworkChannel(LobbyId, ReliableChannel, true) != discord::Result::Ok
+		|| Lobbies.OpenNetworkChannel(LobbyId, UnreliableChannel, false) != discord::Result::Ok)
+	{
+		Lobbies.DisconnectNetwork(LobbyId);
+		return false;
+	}
+
+	if (SubscribedCore != Core)
+	{
+		Unsubscribe();
+		SubscribedCore = Core;
+		MessageToken = Lobbies.OnNetworkMessage.Connect([this](int64 InLobbyId, int64 UserId, uint8 ChannelId, uint8* Data, uint32 DataLength)
+		{
+			OnNetworkMessage(InLobbyId, UserId, ChannelId, Data, DataLength);
+		});
+	}
+
+	JoinedLobbies.Add(LobbyId);
+	return true;
+}
+
+bool FSocketDiscord::SetSendReliable(bool bReliable)
+{
+	const bool bWasReliable = bSendReliable;
+	bSendReliable = bReliable;
+	return bWasReliable;
+}
+
+bool FSocketDiscord::Close()
+{
+	discord::Core* Core = Subsystem.GetCore();
+	if (Core && Core == SubscribedCore)
+	{
+		for (int64 LobbyId : JoinedLobbies)
+		{
+			Core->LobbyManager().DisconnectNetwork(LobbyId);
+		}
+	}
+	Unsubscribe();
+
+	JoinedLobbies.Empty();
+	Incoming.Empty();
+	NextIncoming = 0;
+	return true;
+}
+
+bool FSocketDiscord::Bind(const FInternetAddr& Addr)
+{
+	LocalPort = Addr.GetPort();
+	if (Addr.GetProtocolType() == DISCORD_SOCKETSUBSYSTEM)
+	{
+		const int64 LobbyId = static_cast<const FInternetAddrDiscord&>(Addr).GetLobbyId();
+		return LobbyId == 0 || JoinLobby(LobbyId);
+	}
+	return true;
+}
+
+bool FSocketDiscord::HasPendingData(uint32& PendingDataSize)
+{
+	if (NextIncoming < Incoming.Num())
+	{
+		PendingDataSize = Incoming[NextIncoming].Data.Num();
+		return true;
+	}
+	PendingDataSize = 0;
+	return false;
+}
+
+bool FSocketDiscord::SendTo(const uint8* Data, int32 Count, int32& BytesSent, const FInternetAddr& Destination)
+{
+	BytesSent = 0;
+	if (Destination.GetProtocolType() != DISCORD_SOCKETSUBSYSTEM)
+	{
+		Subsystem.SetLastError(SE_EAFNOSUPPORT);
+		return false;
+	}
+
+	const FInternetAddrDiscord& To = static_cast<const FInternetAddrDiscord&>(Destination);
+	discord::Core* Core = Subsystem.GetCore();
+	if (!Core || !JoinLobby(To.GetLobbyId()))
+	{
+		Subsystem.SetLastError(SE_ENETUNREACH);
+		return false;
+	}
+
+	const uint8 Channel = bSendReliable ? ReliableChannel : UnreliableChannel;
+	if (Core->LobbyManager().SendNetworkMessage(To.GetLobbyId(), To.GetUserId(), Channel, const_cast<uint8*>(Data), Count) != discord::Result::Ok)
+	{
+		Subsystem.SetLastError(SE_EHOSTUNREACH);
+		return false;
+	}
+
+	BytesSent = Count;
+	return true;
+}
+
+bool FSocketDiscord::RecvFrom(uint8* Data, int32 BufferSize, int32& BytesRead, FInternetAddr& Source, ESocketReceiveFlags::Type Flags)
+{
+	if (NextIncoming >= Incoming.Num())
+	{
+		// Drained, keep the allocation for the next frame's packets
+		Incoming.Reset();
+		NextIncoming = 0;
+		BytesRead = 0;
+		Subsystem.SetLastError(SE_EWOULDBLOCK);
+		return false;
+	}
+
+	const FPacket& Packet = Incoming[NextIncoming];
+	BytesRead = FMath::Min(BufferSize, Packet.Data.Num());
+	FMemory::Memcpy(Data, Packet.Data.GetData(), BytesRead);
+	if (Source.GetProtocolType() == DISCORD_SOCKETSUBSYSTEM)
+	{
+		static_cast<FInternetAddrDiscord&>(Source).SetMember(Packet.LobbyId, Packet.UserId);
+	}
+
+	if (Flags != ESocketReceiveFlags::Peek)
+	{
+		++NextIncoming;
+	}
+	Subsystem.SetLastError(SE_NO_ERROR);
+	return true;
+}
+
+void FSocketDiscord::GetAddress(FInternetAddr& OutAddr)
+{
+	if (OutAddr.GetProtocolType() == DISCORD_SOCKETSUBSYSTEM)
+	{
+		const int64 LobbyId = JoinedLobbies.Num() > 0 ? *JoinedLobbies.CreateConstIterator() : 0;
+		static_cast<FInternetAddrDiscord&>(OutAddr).SetMember(LobbyId, Subsystem.GetLocalUserId());
+	}
+	OutAddr.SetPort(LocalPort);
+}
+
+void FSocketDiscord::OnNetworkMessage(int64 LobbyId, int64 UserId, uint8 ChannelId, uint8* Data, uint32 DataLength)
+{
+	if (!JoinedLobbies.Contains(LobbyId))
+	{
+		return;
+	}
+
+	FPacket& Packet = Incoming.AddDefaulted_GetRef();
+	Packet.LobbyId = LobbyId;
+	Packet.UserId = UserId;
+	Packet.Data.Append(Data, DataLength);
+}
+
+void FSocketDiscord::Unsubscribe()
+{
+	discord::Core* Core = Subsystem.GetCore();
+	if (Core && Core == SubscribedCore && MessageToken != -1)
+	{
+		Core->LobbyManager().OnNetworkMessage.Disconnect(MessageToken);
+	}
+	SubscribedCore = nullptr;
+	MessageToken = -1;
+}
+
+int64 FSocketSubsystemDiscord::GetLocalUserId() const
+{
+	discord::Core* Core = GetCore();
+	discord::User User;
+	if (Core && Core->UserManager().GetCurrentUser(&User) == discord::Result::Ok)
+	{
+		return User.GetId();
+	}
+	return 0;
+}
+
+FSocket* FSocketSubsystemDiscord::CreateSocket(const FName& SocketType, const FString& SocketDescription, const FName& ProtocolName)
+{
+	if (SocketType != NAME_DGram)
+	{
+		SetLastError(SE_ESOCKTNOSUPPORT);
+		return nullptr;
+	}
+	return new FSocketDiscord(*this, SocketDescription);
+}
+
+void FSocketSubsystemDiscord::DestroySocket(FSocket* Socket)
+{
+	delete Socket;
+}
+
+FAddressInfoResult FSocketSubsystemDiscord::GetAddressInfo(const TCHAR* HostName, const TCHAR* ServiceName, EAddressInfoFlags QueryFlags, const FName ProtocolTypeName, ESocketType SocketType)
+{
+	FAddressInfoResult Result(HostName, ServiceName);
+
+	int64 LobbyId = 0;
+	int64 UserId = 0;
+	if (!HostName || !FInternetAddrDiscord::Parse(HostName, LobbyId, UserId))
+	{
+		Result.ReturnCode = SE_HOST_NOT_FOUND;
+		return Result;
+	}
+
+	TSharedRef<FInternetAddrDiscord> Addr = MakeShared<FInternetAddrDiscord>(LobbyId, UserId);
+	if (ServiceName)
+	{
+		Addr->SetPort(FCString::Atoi(ServiceName));
+	}
+	Result.ReturnCode = SE_NO_ERROR;
+	Result.Results.Emplace(Addr, sizeof(LobbyId) + sizeof(UserId), DISCORD_SOCKETSUBSYSTEM, SOCKTYPE_Datagram);
+	return Result;
+}
+
+TSharedPtr<FInternetAddr> FSocketSubsystemDiscord::GetAddressFromString(const FString& InAddress)
+{
+	int64 LobbyId = 0;
+	int64 UserId = 0;
+	if (!FInternetAddrDiscord::Parse(InAddress, LobbyId, UserId))
+	{
+		return nullptr;
+	}
+	return MakeShared<FInternetAddrDiscord>(LobbyId, UserId);
+}
+
+bool FSocketSubsystemDiscord::GetHostName(FString& HostName)
+{
+	const int64 UserId = GetLocalUserId();
+	if (UserId == 0)
+	{
+		return false;
+	}
+	HostName = FString::Printf(TEXT("%lld"), UserId);
+	return true;
+}
+
+bool FSocketSubsystemDiscord::GetLocalAdapterAddresses(TArray<TSharedPtr<FInternetAddr>>& OutAddresses)
+{
+	OutAddresses.Add(MakeShared<FInternetAddrDiscord>(0, GetLocalUserId()));
+	return true;
+}
+
+TArray<TSharedRef<FInternetAddr>> FSocketSubsystemDiscord::GetLocalBindAddresses()
+{
+	TArray<TSharedRef<FInternetAddr>> Addresses;
+	Addresses.Add(MakeShared<FInternetAddrDiscord>(0, GetLocalUserId()));
+	return Addresses;
+}
+
+TSharedRef<FInternetAddr> FSocketSubsystemDiscord::GetLocalHostAddr(FOutputDevice& Out, bool& bCanBindAll)
+{
+	bCanBindAll = false;
+	return MakeShared<FInternetAddrDiscord>(0, GetLocalUserId());
+}
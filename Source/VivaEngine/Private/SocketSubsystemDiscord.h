@@ -0,0 +1,181 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IPAddress.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+namespace discord { class Core; }
+
+#define DISCORD_SOCKETSUBSYSTEM FName(TEXT("Discord"))
+
+/**
+ * A member of a Discord lobby, written as "discord.<LobbyId>.<UserId>".
+ * The port only exists so the address survives a round trip through FURL, it is ignored when comparing.
+ */
+class FInternetAddrDiscord : public FInternetAddr
+{
+public:
+
+	FInternetAddrDiscord() = default;
+	FInternetAddrDiscord(int64 InLobbyId, int64 InUserId)
+		: LobbyId(InLobbyId)
+		, UserId(InUserId)
+	{
+	}
+
+	static bool Parse(const FString& Address, int64& OutLobbyId, int64& OutUserId);
+
+	int64 GetLobbyId() const { return LobbyId; }
+	int64 GetUserId() const { return UserId; }
+	void SetMember(int64 InLobbyId, int64 InUserId) { LobbyId = InLobbyId; UserId = InUserId; }
+
+	virtual void SetIp(uint32 InAddr) override {}
+	virtual void SetIp(const TCHAR* InAddr, bool& bIsValid) override;
+	virtual void GetIp(uint32& OutAddr) const override { OutAddr = 0; }
+	virtual void SetPort(int32 InPort) override { Port = InPort; }
+	virtual int32 GetPort() const override { return Port; }
+	virtual void SetRawIp(const TArray<uint8>& RawAddr) override;
+	virtual TArray<uint8> GetRawIp() const override;
+	virtual void SetAnyAddress() override { LobbyId = 0; UserId = 0; }
+	virtual void SetBroadcastAddress() override {}
+	virtual void SetLoopbackAddress() override {}
+	virtual FString ToString(bool bAppendPort) const override;
+	virtual bool operator==(const FInternetAddr& Other) const override;
+	virtual uint32 GetTypeHash() const override;
+	virtual bool IsValid() const override { return UserId != 0; }
+	virtual TSharedRef<FInternetAddr> Clone() const override;
+	virtual FName GetProtocolType() const override { return DISCORD_SOCKETSUBSYSTEM; }
+
+private:
+
+	int64 LobbyId = 0;
+	int64 UserId = 0;
+	int32 Port = 0;
+};
+
+class FSocketSubsystemDiscord;
+
+/**
+ * Datagram socket over Discord lobby networking.
+ * Sends are only queued in the SDK; UDiscordNetDriver flushes them once per frame. Received messages are
+ * buffered from the lobby manager's OnNetworkMessage event until the net driver reads them.
+ */
+class FSocketDiscord : public FSocket
+{
+public:
+
+	static constexpr uint8 ReliableChannel = 0;
+	static constexpr uint8 UnreliableChannel = 1;
+
+	FSocketDiscord(FSocketSubsystemDiscord& InSubsystem, const FString& InSocketDescription);
+	virtual ~FSocketDiscord();
+
+	//Connects to the lobby's network and opens both channels, does nothing when already joined
+	bool JoinLobby(int64 LobbyId);
+
+	//Packets sent while set go on the reliable channel. Returns the previous value.
+	bool SetSendReliable(bool bReliable);
+
+	virtual bool Shutdown(ESocketShutdownMode Mode) override { return true; }
+	virtual bool Close() override;
+	virtual bool Bind(const FInternetAddr& Addr) override;
+	virtual bool Connect(const FInternetAddr& Addr) override { return false; }
+	virtual bool Listen(int32 MaxBacklog) override { return false; }
+	virtual bool WaitForPendingConnection(bool& bHasPendingConnection, const FTimespan& WaitTime) override { return false; }
+	virtual bool HasPendingData(uint32& PendingDataSize) override;
+	virtual FSocket* Accept(const FString& InSocketDescription) override { return nullptr; }
+	virtual FSocket* Accept(FInternetAddr& OutAddr, const FString& InSocketDescription) override { return nullptr; }
+	virtual bool SendTo(const uint8* Data, int32 Count, int32& BytesSent, const FInternetAddr& Destination) override;
+	virtual bool Send(const uint8* Data, int32 Count, int32& BytesSent) override { BytesSent = 0; return false; }
+	virtual bool RecvFrom(uint8* Data, int32 BufferSize, int32& BytesRead, FInternetAddr& Source, ESocketReceiveFlags::Type Flags = ESocketReceiveFlags::None) override;
+	virtual bool Recv(uint8* Data, int32 BufferSize, int32& BytesRead, ESocketReceiveFlags::Type Flags = ESocketReceiveFlags::None) override { BytesRead = 0; return false; }
+	virtual bool Wait(ESocketWaitConditions::Type Condition, FTimespan WaitTime) override { return false; }
+	virtual ESocketConnectionState GetConnectionState() override { return SCS_Connected; }
+	virtual void GetAddress(FInternetAddr& OutAddr) override;
+	virtual bool GetPeerAddress(FInternetAddr& OutAddr) override { return false; }
+	virtual bool SetNonBlocking(bool bIsNonBlocking = true) override { return true; }
+	virtual bool SetBroadcast(bool bAllowBroadcast = true) override { return true; }
+	virtual bool SetNoDelay(bool bIsNoDelay = true) override { return true; }
+	virtual bool JoinMulticastGroup(const FInternetAddr& GroupAddress) override { return false; }
+	virtual bool JoinMulticastGroup(const FInternetAddr& GroupAddress, const FInternetAddr& InterfaceAddress) override { return false; }
+	virtual bool LeaveMulticastGroup(const FInternetAddr& GroupAddress) override { return false; }
+	virtual bool LeaveMulticastGroup(const FInternetAddr& GroupAddress, const FInternetAddr& InterfaceAddress) override { return false; }
+	virtual bool SetMulticastLoopback(bool bLoopback) override { return false; }
+	virtual bool SetMulticastTtl(uint8 TimeToLive) override { return false; }
+	virtual bool SetMulticastInterface(const FInternetAddr& InterfaceAddress) override { return false; }
+	virtual bool SetReuseAddr(bool bAllowReuse = true) override { return true; }
+	virtual bool SetLinger(bool bShouldLinger = true, int32 Timeout = 0) override { return true; }
+	virtual bool SetRecvErr(bool bUseErrorQueue = true) override { return true; }
+	virtual bool SetSendBufferSize(int32 Size, int32& NewSize) override { NewSize = Size; return true; }
+	virtual bool SetReceiveBufferSize(int32 Size, int32& NewSize) override { NewSize = Size; return true; }
+	virtual int32 GetPortNo() override { return LocalPort; }
+
+private:
+
+	struct FPacket
+	{
+		int64 LobbyId;
+		int64 UserId;
+		TArray<uint8> Data;
+	};
+
+	void OnNetworkMessage(int64 LobbyId, int64 UserId, uint8 ChannelId, uint8* Data, uint32 DataLength);
+	void Unsubscribe();
+
+	FSocketSubsystemDiscord& Subsystem;
+
+	//Core the message handler was connected to, so it is not disconnected from a core that has since been replaced
+	discord::Core* SubscribedCore = nullptr;
+	int32 MessageToken = -1;
+
+	TSet<int64> JoinedLobbies;
+	TArray<FPacket> Incoming;
+	int32 NextIncoming = 0;
+	int32 LocalPort = 0;
+	bool bSendReliable = false;
+};
+
+/**
+ * Socket subsystem handed to UIpNetDriver by UDiscordNetDriver so the stock handshake and packet handling run over Discord.
+ */
+class FSocketSubsystemDiscord : public ISocketSubsystem
+{
+public:
+
+	explicit FSocketSubsystemDiscord(TFunction<discord::Core*()> InGetCore)
+		: GetCoreFunc(MoveTemp(InGetCore))
+	{
+	}
+
+	//Null while Discord is not running
+	discord::Core* GetCore() const { return GetCoreFunc(); }
+	int64 GetLocalUserId() const;
+	void SetLastError(ESocketErrors Error) { LastError = Error; }
+
+	virtual bool Init(FString& Error) override { return true; }
+	virtual void Shutdown() override {}
+	virtual FSocket* CreateSocket(const FName& SocketType, const FString& SocketDescription, const FName& ProtocolName) override;
+	virtual void DestroySocket(FSocket* Socket) override;
+	virtual FAddressInfoResult GetAddressInfo(const TCHAR* HostName, const TCHAR* ServiceName = nullptr, EAddressInfoFlags QueryFlags = EAddressInfoFlags::Default, const FName ProtocolTypeName = NAME_None, ESocketType SocketType = ESocketType::SOCKTYPE_Unknown) override;
+	virtual TSharedPtr<FInternetAddr> GetAddressFromString(const FString& InAddress) override;
+	virtual bool RequiresChatDataBeSeparate() override { return false; }
+	virtual bool RequiresEncryptedPackets() override { return false; }
+	virtual bool GetHostName(FString& HostName) override;
+	virtual TSharedRef<FInternetAddr> CreateInternetAddr() override { return MakeShared<FInternetAddrDiscord>(); }
+	virtual bool HasNetworkDevice() override { return GetCore() != nullptr; }
+	virtual const TCHAR* GetSocketAPIName() const override { return TEXT("DiscordLobbyNetworking"); }
+	virtual ESocketErrors GetLastErrorCode() override { return LastError; }
+	virtual ESocketErrors TranslateErrorCode(int32 Code) override { return (ESocketErrors)Code; }
+	virtual bool GetLocalAdapterAddresses(TArray<TSharedPtr<FInternetAddr>>& OutAddresses) override;
+	virtual TArray<TSharedRef<FInternetAddr>> GetLocalBindAddresses() override;
+	virtual TSharedRef<FInternetAddr> GetLocalHostAddr(FOutputDevice& Out, bool& bCanBindAll) override;
+	virtual bool IsSocketWaitSupported() const override { return false; }
+
+private:
+
+	TFunction<discord::Core*()> GetCoreFunc;
+	ESocketErrors LastError = SE_NO_ERROR;
+};
@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "callback_pool.h"
+#include "discord.h"
+#include "mock_ffi.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace VEDiscordCallbackPoolStress
+{
+	using FDataCallback = void(DISCORD_API*)(void* CallbackData, EDiscordResult Result, uint8_t* Data, uint32_t DataLength);
+	using FReadCallback = std::function<void(discord::Result, std::uint8_t*, std::uint32_t)>;
+
+	// A storage manager vtable that parks every read and completes it on Flush, like the SDK does on RunCallbacks
+	struct FMockStorage
+	{
+		IDiscordStorageManager Iface{};
+		std::vector<std::pair<void*, FDataCallback>> Pending;
+
+		FMockStorage()
+		{
+			Iface.read_async = &ReadAsync;
+		}
+
+		static void DISCORD_API ReadAsync(IDiscordStorageManager* Manager, const char* Name, void* CallbackData, FDataCallback Callback)
+		{
+			reinterpret_cast<FMockStorage*>(Manager)->Pending.emplace_back(CallbackData, Callback);
+		}
+
+		void Flush()
+		{
+			// Callbacks may queue follow-up reads, those complete on the next flush
+			std::vector<std::pair<void*, FDataCallback>> Due;
+			Due.swap(Pending);
+			for (const std::pair<void*, FDataCallback>& Read : Due)
+			{
+				Read.second(Read.first, DiscordResult_Ok, nullptr, 0);
+			}
+		}
+	};
+
+	// How StorageManager::ReadAsync stored its callback before the pool, one heap std::function per request
+	struct FHeapScheme
+	{
+		static void DISCORD_API Wrapper(void* CallbackData, EDiscordResult Result, uint8_t* Data, uint32_t DataLength)
+		{
+			std::unique_ptr<FReadCallback> Callback(static_cast<FReadCallback*>(CallbackData));
+			if (Callback && *Callback)
+			{
+				(*Callback)(static_cast<discord::Result>(Result), Data, DataLength);
+			}
+		}
+
+		static void Read(IDiscordStorageManager* Manager, FReadCallback Callback)
+		{
+			Manager->read_async(Manager, "stress", new FReadCallback(std::move(Callback)), &Wrapper);
+		}
+	};
+
+	struct FPoolScheme
+	{
+		using FPool = discord::CallbackPool<void(discord::Result, std::uint8_t*, std::uint32_t)>;
+
+		static void DISCORD_API Wrapper(void* CallbackData, EDiscordResult Result, uint8_t* Data, uint32_t DataLength)
+		{
+			FPool::Dispatch(CallbackData, static_cast<discord::Result>(Result), Data, DataLength);
+		}
+
+		static void Read(IDiscordStorageManager* Manager, FPool::Callback Callback)
+		{
+			Manager->read_async(Manager, "stress", FPool::Acquire(std::move(Callback)).ToCallbackData(), &Wrapper);
+		}
+	};
+
+	struct FStressResult
+	{
+		double Seconds = 0.0;
+		int64 Completed = 0;
+		int64 FollowUps = 0;
+	};
+
+	// NumRequests reads in batches of BatchSize outstanding at a time. Every tenth callback issues a follow-up read
+	// from inside the callback, the case the pool must not recycle a node too early for.
+	template <typename Scheme>
+	FStressResult Run(int32 NumRequests, int32 BatchSize)
+	{
+		FMockStorage Storage;
+		FStressResult Result;
+		int64* CompletedPtr = &Result.Completed;
+		int64* FollowUpsPtr = &Result.FollowUps;
+		IDiscordStorageManager* Manager = &Storage.Iface;
+
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Issued = 0; Issued < NumRequests; )
+		{
+			for (int32 Batch = 0; Batch < BatchSize && Issued < NumRequests; ++Batch, ++Issued)
+			{
+				Scheme::Read(Manager, [CompletedPtr, FollowUpsPtr, Manager, Issued](discord::Result, std::uint8_t*, std::uint32_t)
+				{
+					++*CompletedPtr;
+					if (Issued % 10 == 0)
+					{
+						Scheme::Read(Manager, [FollowUpsPtr](discord::Result, std::uint8_t*, std::uint32_t) { ++*FollowUpsPtr; });
+					}
+				});
+			}
+			Storage.Flush();
+		}
+		while (!Storage.Pending.empty())
+		{
+			Storage.Flush();
+		}
+		Result.Seconds = FPlatformTime::Seconds() - Start;
+		return Result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVE_DiscordCallbackPoolStress, "VivaEngine.Discord.CallbackPoolStress",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVE_DiscordCallbackPoolStress::RunTest(const FString& Parameters)
+{
+	using namespace VEDiscordCallbackPoolStress;
+
+	constexpr int32 NumRequests = 100000;
+	constexpr int32 BatchSize = 256;
+	constexpr int64 NumFollowUps = NumRequests / 10;
+
+	// Warm the pool to its high-water mark, as a running game would have
+	Run<FPoolScheme>(BatchSize * 4, BatchSize);
+
+	const FStressResult Heap = Run<FHeapScheme>(NumRequests, BatchSize);
+	const FStressResult Pool = Run<FPoolScheme>(NumRequests, BatchSize);
+
+	TestEqual(TEXT("Heap scheme completes every request"), Heap.Completed, (int64)NumRequests);
+	TestEqual(TEXT("Pool completes every request"), Pool.Completed, (int64)NumRequests);
+	TestEqual(TEXT("Pool completes reads issued from callbacks"), Pool.FollowUps, NumFollowUps);
+
+	AddInfo(FString::Printf(TEXT("%d callbacks: heap std::function %.1f ns each, pool %.1f ns each (%.2fx)"), NumRequests,
+		Heap.Seconds * 1e9 / NumRequests, Pool.Seconds * 1e9 / NumRequests, Pool.Seconds > 0.0 ? Heap.Seconds / Pool.Seconds : 0.0));
+
+#if DISCORD_MOCK_FFI
+	// The same volume end to end through the wrappers and the in-process fake SDK
+	discord::mock::Reset();
+	discord::Core* Core = nullptr;
+	if (!TestEqual(TEXT("Mock core is created"), (int32)discord::Core::Create(1, DiscordCreateFlags_Default, &Core), (int32)discord::Result::Ok))
+	{
+		return false;
+	}
+
+	int64 Completed = 0;
+	const double Start = FPlatformTime::Seconds();
+	for (int32 Issued = 0; Issued < NumRequests; )
+	{
+		for (int32 Batch = 0; Batch < BatchSize && Issued < NumRequests; ++Batch, ++Issued)
+		{
+			Core->StorageManager().ReadAsync("stress", [&Completed](discord::Result, std::uint8_t*, std::uint32_t) { ++Completed; });
+		}
+		Core->RunCallbacks();
+	}
+	const double Seconds = FPlatformTime::Seconds() - Start;
+	delete Core;
+	discord::mock::Reset();
+
+	TestEqual(TEXT("Mock SDK completes every request"), Completed, (int64)NumRequests);
+	AddInfo(FString::Printf(TEXT("%d callbacks through StorageManager and the mock SDK: %.1f ns each"), NumRequests, Seconds * 1e9 / NumRequests));
+#endif
+
+	return true;
+}
+
+#endif
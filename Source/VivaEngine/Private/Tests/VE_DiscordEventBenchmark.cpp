@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "event.h"
+
+#include <functional>
+#include <vector>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace VEDiscordEventBenchmark
+{
+	// discord::Event as the SDK shipped it, one std::function per handler, kept as the baseline
+	template <typename... Args>
+	class FLegacyEvent
+	{
+	public:
+		using Token = int;
+
+		FLegacyEvent() { Slots.reserve(4); }
+
+		template <typename EventHandler>
+		Token Connect(EventHandler Slot)
+		{
+			Slots.emplace_back(FSlot{ NextToken, std::move(Slot) });
+			return NextToken++;
+		}
+
+		void Disconnect(Token InToken)
+		{
+			for (FSlot& Slot : Slots)
+			{
+				if (Slot.SlotToken == InToken)
+				{
+					Slot = Slots.back();
+					Slots.pop_back();
+					break;
+				}
+			}
+		}
+
+		void operator()(Args... InArgs)
+		{
+			for (const FSlot& Slot : Slots)
+			{
+				Slot.Fn(std::forward<Args>(InArgs)...);
+			}
+		}
+
+	private:
+		struct FSlot
+		{
+			Token SlotToken;
+			std::function<void(Args...)> Fn;
+		};
+
+		Token NextToken = 0;
+		std::vector<FSlot> Slots;
+	};
+
+	struct FTimings
+	{
+		double DispatchSeconds = 0.0;
+		double ChurnSeconds = 0.0;
+		int64 Calls = 0;
+		//Returned so the handlers' work cannot be optimized away
+		int64 Checksum = 0;
+	};
+
+	// Handlers capture a pointer and a value, like the subsystem's [this, Id] lambdas
+	template <typename EventType>
+	FTimings Run(int32 NumHandlers, int32 NumDispatches, int32 NumChurn)
+	{
+		FTimings Timings;
+		int64 Calls = 0;
+		int64 Checksum = 0;
+		EventType Event;
+
+		for (int32 Index = 0; Index < NumHandlers; ++Index)
+		{
+			int64* CallsPtr = &Calls;
+			int64* ChecksumPtr = &Checksum;
+			Event.Connect([CallsPtr, ChecksumPtr, Index](int64 Value, int32 Count)
+			{
+				++*CallsPtr;
+				*ChecksumPtr += Value + Count + Index;
+			});
+		}
+
+		double Start = FPlatformTime::Seconds();
+		for (int32 Dispatch = 0; Dispatch < NumDispatches; ++Dispatch)
+		{
+			Event((int64)Dispatch, Dispatch & 7);
+		}
+		Timings.DispatchSeconds = FPlatformTime::Seconds() - Start;
+
+		// Connect and disconnect one handler while the others stay, as activity and lobby listeners do
+		Start = FPlatformTime::Seconds();
+		for (int32 Churn = 0; Churn < NumChurn; ++Churn)
+		{
+			const auto Token = Event.Connect([&Checksum](int64 Value, int32 Count) { Checksum -= Value + Count; });
+			Event.Disconnect(Token);
+		}
+		Timings.ChurnSeconds = FPlatformTime::Seconds() - Start;
+
+		Timings.Calls = Calls;
+		Timings.Checksum = Checksum;
+		return Timings;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVE_DiscordEventBenchmark, "VivaEngine.Discord.EventBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVE_DiscordEventBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace VEDiscordEventBenchmark;
+
+	constexpr int32 NumHandlers = 8;
+	constexpr int32 NumDispatches = 200000;
+	constexpr int32 NumChurn = 200000;
+
+	// One untimed pass each so neither side pays for first touch of the allocator
+	Run<FLegacyEvent<int64, int32>>(NumHandlers, 1000, 1000);
+	Run<discord::Event<int64, int32>>(NumHandlers, 1000, 1000);
+
+	const FTimings Legacy = Run<FLegacyEvent<int64, int32>>(NumHandlers, NumDispatches, NumChurn);
+	const FTimings Inline = Run<discord::Event<int64, int32>>(NumHandlers, NumDispatches, NumChurn);
+
+	TestEqual(TEXT("Legacy event calls every handler on every dispatch"), Legacy.Calls, (int64)NumHandlers * NumDispatches);
+	TestEqual(TEXT("Inline event calls every handler on every dispatch"), Inline.Calls, (int64)NumHandlers * NumDispatches);
+	TestEqual(TEXT("Both events pass the same arguments"), Inline.Checksum, Legacy.Checksum);
+
+	const auto Report = [this](const TCHAR* Stage, double LegacySeconds, double InlineSeconds, int64 NumOps)
+	{
+		AddInfo(FString::Printf(TEXT("%s: std::function %.1f ns/op, inline %.1f ns/op (%.2fx)"), Stage,
+			LegacySeconds * 1e9 / NumOps, InlineSeconds * 1e9 / NumOps, InlineSeconds > 0.0 ? LegacySeconds / InlineSeconds : 0.0));
+	};
+	Report(TEXT("Dispatch"), Legacy.DispatchSeconds, Inline.DispatchSeconds, (int64)NumHandlers * NumDispatches);
+	Report(TEXT("Connect and disconnect"), Legacy.ChurnSeconds, Inline.ChurnSeconds, NumChurn);
+	return true;
+}
+
+#endif
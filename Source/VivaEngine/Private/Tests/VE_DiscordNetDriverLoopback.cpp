@@ -0,0 +1,257 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+#include "DiscordNetDriver.h"
+#include "SocketSubsystemDiscord.h"
+#include "VE_Discord_Subsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetConnection.h"
+#include "Engine/World.h"
+#include "PacketHandler.h"
+#include "discord.h"
+#include "mock_ffi.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && DISCORD_MOCK_FFI
+
+namespace VEDiscordNetDriverLoopback
+{
+	// Accepts every connection and channel, the drivers only need to get through the stateless handshake
+	class FAcceptAll : public FNetworkNotify
+	{
+	public:
+		virtual EAcceptConnection::Type NotifyAcceptingConnection() override { return EAcceptConnection::Accept; }
+		virtual void NotifyAcceptedConnection(UNetConnection* Connection) override {}
+		virtual bool NotifyAcceptingChannel(UChannel* Channel) override { return true; }
+		virtual void NotifyControlMessage(UNetConnection* Connection, uint8 MessageType, FInBunch& Bunch) override {}
+	};
+
+	// A game instance, whose Discord subsystem gets its own mock core and so its own Discord user, and a net driver in its world
+	struct FPeer
+	{
+		UGameInstance* GameInstance = nullptr;
+		UDiscordNetDriver* Driver = nullptr;
+
+		~FPeer()
+		{
+			if (Driver)
+			{
+				Driver->SetWorld(nullptr);
+				Driver->Shutdown();
+				Driver->MarkAsGarbage();
+			}
+			if (GameInstance)
+			{
+				UWorld* World = GameInstance->GetWorld();
+				GameInstance->Shutdown();
+				if (World)
+				{
+					GEngine->DestroyWorldContext(World);
+					World->DestroyWorld(false);
+				}
+			}
+		}
+
+		bool Init(const TCHAR* Name)
+		{
+			GameInstance = NewObject<UGameInstance>(GEngine);
+			GameInstance->InitializeStandalone(Name);
+
+			Driver = NewObject<UDiscordNetDriver>(GetTransientPackage());
+			Driver->SetNetDriverName(Name);
+			Driver->SetWorld(GameInstance->GetWorld());
+			return GetCore() != nullptr;
+		}
+
+		discord::Core* GetCore() const
+		{
+			UVE_Discord_Subsystem* Discord = GameInstance ? GameInstance->GetSubsystem<UVE_Discord_Subsystem>() : nullptr;
+			return Discord ? Discord->GetCore() : nullptr;
+		}
+
+		int64 GetUserId() const
+		{
+			discord::User User;
+			return GetCore()->UserManager().GetCurrentUser(&User) == discord::Result::Ok ? User.GetId() : 0;
+		}
+	};
+
+	// One frame for both drivers: send what is queued, let the mock deliver it, then read it
+	void Tick(FPeer& Host, FPeer& Client)
+	{
+		Host.Driver->TickFlush(0.0f);
+		Client.Driver->TickFlush(0.0f);
+		Host.GetCore()->RunCallbacks();
+		Client.GetCore()->RunCallbacks();
+		Host.Driver->TickDispatch(0.0f);
+		Client.Driver->TickDispatch(0.0f);
+	}
+
+	// Sends one payload on each channel. Only the socket's outbox is flushed, the drivers are not ticked, so they do not read the packets first.
+	void SendBoth(FPeer& From, FPeer& To, int64 LobbyId, const TArray<uint8>& Reliable, const TArray<uint8>& Unreliable)
+	{
+		FSocketDiscord* Socket = From.Driver->GetDiscordSocket();
+		const FInternetAddrDiscord Destination(LobbyId, To.GetUserId());
+		int32 BytesSent = 0;
+
+		const bool bWasReliable = Socket->SetSendReliable(true);
+		Socket->SendTo(Reliable.GetData(), Reliable.Num(), BytesSent, Destination);
+		Socket->SetSendReliable(false);
+		Socket->SendTo(Unreliable.GetData(), Unreliable.Num(), BytesSent, Destination);
+		Socket->SetSendReliable(bWasReliable);
+
+		From.GetCore()->LobbyManager().FlushNetwork();
+		To.GetCore()->RunCallbacks();
+	}
+
+	// Everything waiting on the socket that came from Sender. Driver traffic from earlier frames may be mixed in.
+	TArray<TArray<uint8>> ReceiveFrom(FPeer& Receiver, int64 Sender)
+	{
+		FSocketDiscord* Socket = Receiver.Driver->GetDiscordSocket();
+		FInternetAddrDiscord Source;
+		TArray<TArray<uint8>> Packets;
+		uint8 Buffer[2048];
+		int32 BytesRead = 0;
+		while (Socket->RecvFrom(Buffer, sizeof(Buffer), BytesRead, Source))
+		{
+			if (Source.GetUserId() == Sender)
+			{
+				Packets.Emplace(Buffer, BytesRead);
+			}
+		}
+		return Packets;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVE_DiscordNetDriverLoopback, "VivaEngine.Discord.NetDriverLoopback",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVE_DiscordNetDriverLoopback::RunTest(const FString& Parameters)
+{
+	using namespace VEDiscordNetDriverLoopback;
+
+	const discord::mock::Config SavedConfig = discord::mock::GetConfig();
+	discord::mock::Config Config = SavedConfig;
+	Config.latencyTicks = 0;
+	Config.failureRate = 0.f;
+	Config.unreliableDropRate = 0.f;
+	Config.userId = 0;
+	discord::mock::SetConfig(Config);
+	ON_SCOPE_EXIT
+	{
+		discord::mock::SetConfig(SavedConfig);
+	};
+
+	FAcceptAll Notify;
+	FPeer Host;
+	FPeer Client;
+	if (!TestTrue(TEXT("Host has a mock Discord core"), Host.Init(TEXT("DiscordLoopbackHost"))) ||
+		!TestTrue(TEXT("Client has a mock Discord core"), Client.Init(TEXT("DiscordLoopbackClient"))))
+	{
+		return false;
+	}
+
+	// The host owns a lobby the client has joined, as it would after accepting an invite
+	discord::LobbyTransaction Transaction;
+	Host.GetCore()->LobbyManager().GetLobbyCreateTransaction(&Transaction);
+	Transaction.SetCapacity(2);
+	Transaction.SetType(discord::LobbyType::Private);
+
+	int64 LobbyId = 0;
+	FString Secret;
+	Host.GetCore()->LobbyManager().CreateLobby(Transaction, [&LobbyId, &Secret](discord::Result Result, const discord::Lobby& Lobby)
+	{
+		if (Result == discord::Result::Ok)
+		{
+			LobbyId = Lobby.GetId();
+			Secret = UTF8_TO_TCHAR(Lobby.GetSecret());
+		}
+	});
+	Host.GetCore()->RunCallbacks();
+	if (!TestNotEqual(TEXT("Lobby is created"), LobbyId, (int64)0))
+	{
+		return false;
+	}
+
+	discord::Result JoinResult = discord::Result::InternalError;
+	Client.GetCore()->LobbyManager().ConnectLobby(LobbyId, TCHAR_TO_UTF8(*Secret), [&JoinResult](discord::Result Result, const discord::Lobby& Lobby)
+	{
+		JoinResult = Result;
+	});
+	Client.GetCore()->RunCallbacks();
+	if (!TestEqual(TEXT("Client joins the lobby"), (int32)JoinResult, (int32)discord::Result::Ok))
+	{
+		return false;
+	}
+
+	FString Error;
+	FURL ListenURL;
+	ListenURL.AddOption(*FString::Printf(TEXT("DiscordLobby=%lld"), LobbyId));
+	if (!TestTrue(TEXT("Host listens on the lobby"), Host.Driver->InitListen(&Notify, ListenURL, false, Error)))
+	{
+		AddError(Error);
+		return false;
+	}
+
+	// What GetDiscordLobbyTravelURL hands to ClientTravel
+	FURL ConnectURL;
+	ConnectURL.Host = FInternetAddrDiscord(LobbyId, Host.GetUserId()).ToString(false);
+	ConnectURL.Port = ListenURL.Port;
+	if (!TestTrue(TEXT("Client connects to the lobby owner"), Client.Driver->InitConnect(&Notify, ConnectURL, Error)))
+	{
+		AddError(Error);
+		return false;
+	}
+
+	TestNotNull(TEXT("Host driver runs over Discord"), Host.Driver->GetDiscordSocket());
+	TestNotNull(TEXT("Client driver runs over Discord"), Client.Driver->GetDiscordSocket());
+	if (!Host.Driver->GetDiscordSocket() || !Client.Driver->GetDiscordSocket())
+	{
+		return false;
+	}
+
+	// The stateless handshake, every packet of it goes over the reliable channel
+	auto IsConnected = [&Host, &Client]()
+	{
+		UNetConnection* ServerConnection = Client.Driver->ServerConnection;
+		return Host.Driver->ClientConnections.Num() == 1 && ServerConnection && ServerConnection->Handler.IsValid() && ServerConnection->Handler->IsFullyInitialized();
+	};
+	for (int32 Frame = 0; Frame < 100 && !IsConnected(); Frame++)
+	{
+		Tick(Host, Client);
+	}
+	if (!TestTrue(TEXT("Drivers complete the handshake over the mock lobby"), IsConnected()))
+	{
+		return false;
+	}
+
+	const int64 HostUserId = Host.GetUserId();
+	const int64 ClientUserId = Client.GetUserId();
+	const TArray<uint8> Reliable = { 'r', 'e', 'l', 'i', 'a', 'b', 'l', 'e' };
+	const TArray<uint8> Unreliable = { 'u', 'n', 'r', 'e', 'l', 'i', 'a', 'b', 'l', 'e' };
+
+	SendBoth(Client, Host, LobbyId, Reliable, Unreliable);
+	TArray<TArray<uint8>> AtHost = ReceiveFrom(Host, ClientUserId);
+	TestTrue(TEXT("Host receives the client's reliable packet"), AtHost.Contains(Reliable));
+	TestTrue(TEXT("Host receives the client's unreliable packet"), AtHost.Contains(Unreliable));
+
+	SendBoth(Host, Client, LobbyId, Reliable, Unreliable);
+	TArray<TArray<uint8>> AtClient = ReceiveFrom(Client, HostUserId);
+	TestTrue(TEXT("Client receives the host's reliable packet"), AtClient.Contains(Reliable));
+	TestTrue(TEXT("Client receives the host's unreliable packet"), AtClient.Contains(Unreliable));
+
+	// With every unreliable message dropped, only the packet sent as reliable may arrive, which shows each went on its own channel
+	Config.unreliableDropRate = 1.f;
+	discord::mock::SetConfig(Config);
+	SendBoth(Client, Host, LobbyId, Reliable, Unreliable);
+	AtHost = ReceiveFrom(Host, ClientUserId);
+	TestTrue(TEXT("Reliable channel survives a lossy network"), AtHost.Contains(Reliable));
+	TestFalse(TEXT("Unreliable packet went on the unreliable channel"), AtHost.Contains(Unreliable));
+
+	return true;
+}
+
+#endif
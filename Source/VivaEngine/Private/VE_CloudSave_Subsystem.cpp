@@ -0,0 +1,735 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VE_CloudSave_Subsystem.h"
+#include "VE_Discord_Subsystem.h"
+#include "Async/Async.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/SaveGame.h"
+#include "Hash/xxhash.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/Compression.h"
+#include "Misc/Parse.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Tasks/Task.h"
+#include "discord.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVECloudSave, Log, All);
+
+static constexpr uint32 CloudSaveManifestMagic = 0x56435356;
+static constexpr int32 CloudSaveManifestVersion = 1;
+
+struct FVE_CloudSaveJob
+{
+	FVE_CloudSaveJob(const FString& InSlotName, TSharedRef<const TArray<uint8>> InBytes)
+		: SlotName(InSlotName)
+		, Bytes(InBytes)
+	{
+	}
+
+	FString SlotName;
+	TSharedRef<const TArray<uint8>> Bytes;
+	TArray<TFunction<void(bool)>> Callbacks;
+};
+
+struct FVE_CloudSaveUpload
+{
+	FVE_CloudSaveManifest Manifest;
+	//Chunks that are not in storage yet, keyed by hash
+	TArray<TPair<uint64, TArray<uint8>>> NewChunks;
+	TArray<uint8> ManifestBytes;
+	int32 NextChunk = 0;
+	int32 InFlight = 0;
+	bool bFailed = false;
+	bool bCommitting = false;
+};
+
+struct FVE_CloudReadJob
+{
+	FString SlotName;
+	FVE_CloudSaveManifest Manifest;
+	int64 Offset = 0;
+	int64 Length = 0;
+	int32 FirstChunk = 0;
+	int32 EndChunk = 0;
+	int32 NextChunk = 0;
+	int32 InFlight = 0;
+	bool bFailed = false;
+	bool bDone = false;
+	//Stored bytes of each chunk in [FirstChunk, EndChunk), or just the wanted slice when Partial is set
+	TArray<TArray<uint8>> Fetched;
+	TArray<bool> Partial;
+	TFunction<void(bool, TArray<uint8>&&)> OnRead;
+};
+
+static FString ManifestFileName(const FString& SlotName)
+{
+	return SlotName + TEXT(".manifest");
+}
+
+static FString ChunkFileName(const FString& SlotName, uint64 Hash)
+{
+	return FString::Printf(TEXT("%s.%016llx.chunk"), *SlotName, Hash);
+}
+
+static bool ParseChunkFileName(const FString& FileName, const FString& Prefix, uint64& OutHash)
+{
+	static const FString Extension = TEXT(".chunk");
+	if (!FileName.StartsWith(Prefix, ESearchCase::CaseSensitive) || !FileName.EndsWith(Extension, ESearchCase::CaseSensitive))
+	{
+		return false;
+	}
+
+	const FString Hex = FileName.Mid(Prefix.Len(), FileName.Len() - Prefix.Len() - Extension.Len());
+	if (Hex.Len() != 16)
+	{
+		return false;
+	}
+	OutHash = FParse::HexNumber64(*Hex);
+	return true;
+}
+
+static bool SerializeManifest(FArchive& Ar, FVE_CloudSaveManifest& Manifest)
+{
+	uint32 Magic = CloudSaveManifestMagic;
+	int32 Version = CloudSaveManifestVersion;
+	Ar << Magic << Version;
+	if (Magic != CloudSaveManifestMagic || Version != CloudSaveManifestVersion)
+	{
+		return false;
+	}
+
+	Ar << Manifest.ChunkSize << Manifest.TotalSize;
+
+	int32 NumChunks = Manifest.Chunks.Num();
+	Ar << NumChunks;
+	if (Ar.IsLoading())
+	{
+		// Each chunk entry is 16 bytes, anything claiming more than the archive holds is corrupt
+		if (Ar.IsError() || NumChunks < 0 || NumChunks > (Ar.TotalSize() - Ar.Tell()) / 16)
+		{
+			return false;
+		}
+		Manifest.Chunks.SetNum(NumChunks);
+	}
+
+	for (FVE_CloudSaveChunk& Chunk : Manifest.Chunks)
+	{
+		Ar << Chunk.Hash << Chunk.RawSize << Chunk.StoredSize;
+	}
+	return !Ar.IsError();
+}
+
+// Moves the callbacks out first, so a job is never reported twice
+static void RunSaveCallbacks(FVE_CloudSaveJob& Job, bool bSuccess)
+{
+	TArray<TFunction<void(bool)>> Callbacks = MoveTemp(Job.Callbacks);
+	for (TFunction<void(bool)>& OnDone : Callbacks)
+	{
+		OnDone(bSuccess);
+	}
+}
+
+static bool IsValidManifest(const FVE_CloudSaveManifest& Manifest)
+{
+	if (Manifest.ChunkSize <= 0)
+	{
+		return false;
+	}
+
+	int64 Total = 0;
+	for (int32 Index = 0; Index < Manifest.Chunks.Num(); ++Index)
+	{
+		const FVE_CloudSaveChunk& Chunk = Manifest.Chunks[Index];
+		const bool bLast = Index == Manifest.Chunks.Num() - 1;
+		if (Chunk.RawSize <= 0 || Chunk.RawSize > Manifest.ChunkSize || (!bLast && Chunk.RawSize != Manifest.ChunkSize))
+		{
+			return false;
+		}
+		if (Chunk.StoredSize <= 0 || Chunk.StoredSize > Chunk.RawSize)
+		{
+			return false;
+		}
+		Total += Chunk.RawSize;
+	}
+	return Total == Manifest.TotalSize;
+}
+
+// Runs on a worker thread. Hashes every chunk and compresses the ones storage does not have yet.
+static void BuildUpload(const TArray<uint8>& Bytes, const TMap<uint64, int32>& StoredChunks, FVE_CloudSaveUpload& Upload)
+{
+	const int32 ChunkSize = UVE_CloudSave_Subsystem::ChunkSize;
+
+	FVE_CloudSaveManifest& Manifest = Upload.Manifest;
+	Manifest.ChunkSize = ChunkSize;
+	Manifest.TotalSize = Bytes.Num();
+	Manifest.Chunks.Reserve(FMath::DivideAndRoundUp(Bytes.Num(), ChunkSize));
+
+	TMap<uint64, int32> QueuedChunks;
+	TArray<uint8> Compressed;
+	for (int64 Offset = 0; Offset < Bytes.Num(); Offset += ChunkSize)
+	{
+		const int32 RawSize = (int32)FMath::Min<int64>(ChunkSize, Bytes.Num() - Offset);
+		const uint8* Raw = Bytes.GetData() + Offset;
+
+		FVE_CloudSaveChunk& Chunk = Manifest.Chunks.AddDefaulted_GetRef();
+		Chunk.Hash = FXxHash64::HashBuffer(Raw, RawSize).Hash;
+		Chunk.RawSize = RawSize;
+
+		const int32* Existing = StoredChunks.Find(Chunk.Hash);
+		if (!Existing)
+		{
+			Existing = QueuedChunks.Find(Chunk.Hash);
+		}
+		if (Existing)
+		{
+			Chunk.StoredSize = *Existing;
+			continue;
+		}
+
+		TPair<uint64, TArray<uint8>>& NewChunk = Upload.NewChunks.AddDefaulted_GetRef();
+		NewChunk.Key = Chunk.Hash;
+
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, RawSize);
+		Compressed.SetNumUninitialized(CompressedSize, EAllowShrinking::No);
+		if (FCompression::CompressMemory(NAME_Oodle, Compressed.GetData(), CompressedSize, Raw, RawSize) && CompressedSize < RawSize)
+		{
+			NewChunk.Value = TArray<uint8>(Compressed.GetData(), CompressedSize);
+		}
+		else
+		{
+			// Already dense data is kept as is, which also lets range reads fetch only part of it
+			NewChunk.Value = TArray<uint8>(Raw, RawSize);
+		}
+
+		Chunk.StoredSize = NewChunk.Value.Num();
+		QueuedChunks.Add(Chunk.Hash, Chunk.StoredSize);
+	}
+
+	FMemoryWriter Writer(Upload.ManifestBytes);
+	SerializeManifest(Writer, Manifest);
+}
+
+// Runs on a worker thread. Decompresses and verifies the fetched chunks and cuts out the requested range.
+static bool DecodeRange(const FVE_CloudReadJob& Job, TArray<uint8>& OutData)
+{
+	OutData.Reserve(Job.Length);
+
+	TArray<uint8> Raw;
+	for (int32 Index = Job.FirstChunk; Index < Job.EndChunk; ++Index)
+	{
+		const FVE_CloudSaveChunk& Chunk = Job.Manifest.Chunks[Index];
+		const TArray<uint8>& Stored = Job.Fetched[Index - Job.FirstChunk];
+		const int64 ChunkOffset = (int64)Index * Job.Manifest.ChunkSize;
+		const int64 SliceStart = FMath::Max(Job.Offset, ChunkOffset) - ChunkOffset;
+		const int64 SliceEnd = FMath::Min(Job.Offset + Job.Length, ChunkOffset + Chunk.RawSize) - ChunkOffset;
+
+		if (Job.Partial[Index - Job.FirstChunk])
+		{
+			if (Stored.Num() != SliceEnd - SliceStart)
+			{
+				return false;
+			}
+			OutData.Append(Stored);
+			continue;
+		}
+
+		if (Stored.Num() != Chunk.StoredSize)
+		{
+			return false;
+		}
+
+		const uint8* Data = Stored.GetData();
+		if (Chunk.StoredSize != Chunk.RawSize)
+		{
+			Raw.SetNumUninitialized(Chunk.RawSize, EAllowShrinking::No);
+			if (!FCompression::UncompressMemory(NAME_Oodle, Raw.GetData(), Chunk.RawSize, Stored.GetData(), Stored.Num()))
+			{
+				return false;
+			}
+			Data = Raw.GetData();
+		}
+
+		if (FXxHash64::HashBuffer(Data, Chunk.RawSize).Hash != Chunk.Hash)
+		{
+			return false;
+		}
+		OutData.Append(Data + SliceStart, SliceEnd - SliceStart);
+	}
+	return true;
+}
+
+void UVE_CloudSave_Subsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UVE_Discord_Subsystem>();
+}
+
+discord::Core* UVE_CloudSave_Subsystem::GetDiscordCore() const
+{
+	UVE_Discord_Subsystem* Discord = GetGameInstance()->GetSubsystem<UVE_Discord_Subsystem>();
+	return Discord ? Discord->GetCore() : nullptr;
+}
+
+void UVE_CloudSave_Subsystem::SaveToSlot(USaveGame* SaveGameObject, const FString& SlotName, int32 UserIndex, FVE_OnCloudSaved OnSaved)
+{
+	TSharedRef<TArray<uint8>> Bytes = MakeShared<TArray<uint8>>();
+	if (!SaveGameObject || !UGameplayStatics::SaveGameToMemory(SaveGameObject, *Bytes))
+	{
+		OnSaved.ExecuteIfBound(SlotName, false);
+		return;
+	}
+
+	const bool bLocal = Backend != EVE_SaveBackend::DiscordStorage;
+	bool bDiscord = Backend != EVE_SaveBackend::LocalSlot;
+	if (bDiscord && bLocal && !GetDiscordCore())
+	{
+		// The mirror is best effort, a missing Discord client does not fail a local save
+		UE_LOG(LogVECloudSave, Verbose, TEXT("Discord is not running, %s is only saved locally"), *SlotName);
+		bDiscord = false;
+	}
+
+	// Reports once every backend has finished, both complete on the game thread
+	TSharedRef<TPair<int32, bool>> Result = MakeShared<TPair<int32, bool>>((int32)bLocal + (int32)bDiscord, true);
+	TFunction<void(bool)> OnDone = [Result, SlotName, OnSaved](bool bSuccess)
+	{
+		Result->Value &= bSuccess;
+		if (--Result->Key == 0)
+		{
+			OnSaved.ExecuteIfBound(SlotName, Result->Value);
+		}
+	};
+
+	if (bLocal)
+	{
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [Bytes, SlotName, UserIndex, OnDone]() mutable
+		{
+			const bool bSuccess = UGameplayStatics::SaveDataToSlot(*Bytes, SlotName, UserIndex);
+			AsyncTask(ENamedThreads::GameThread, [OnDone = MoveTemp(OnDone), bSuccess]()
+			{
+				OnDone(bSuccess);
+			});
+		});
+	}
+
+	if (bDiscord)
+	{
+		SaveToDiscord(SlotName, Bytes, OnDone);
+	}
+}
+
+void UVE_CloudSave_Subsystem::LoadFromSlot(const FString& SlotName, int32 UserIndex, FVE_OnCloudLoaded OnLoaded)
+{
+	if (Backend == EVE_SaveBackend::DiscordStorage)
+	{
+		LoadFromDiscord(SlotName, OnLoaded);
+		return;
+	}
+
+	TWeakObjectPtr<UVE_CloudSave_Subsystem> WeakThis(this);
+	const bool bFallBackToDiscord = Backend == EVE_SaveBackend::LocalAndDiscord;
+	UGameplayStatics::AsyncLoadGameFromSlot(SlotName, UserIndex, FAsyncLoadGameFromSlotDelegate::CreateLambda(
+		[WeakThis, bFallBackToDiscord, OnLoaded](const FString& LoadedSlotName, const int32 LoadedUserIndex, USaveGame* Loaded)
+		{
+			UVE_CloudSave_Subsystem* This = WeakThis.Get();
+			if (!Loaded && bFallBackToDiscord && This)
+			{
+				This->LoadFromDiscord(LoadedSlotName, OnLoaded);
+				return;
+			}
+			OnLoaded.ExecuteIfBound(LoadedSlotName, Loaded, Loaded != nullptr);
+		}));
+}
+
+TArray<FString> UVE_CloudSave_Subsystem::GetDiscordSlotNames() const
+{
+	TArray<FString> SlotNames;
+	discord::Core* Core = GetDiscordCore();
+	if (!Core)
+	{
+		return SlotNames;
+	}
+
+	static const FString Extension = TEXT(".manifest");
+	int32_t Count = 0;
+	Core->StorageManager().Count(&Count);
+	for (int32_t Index = 0; Index < Count; ++Index)
+	{
+		discord::FileStat Stat;
+		if (Core->StorageManager().StatAt(Index, &Stat) != discord::Result::Ok)
+		{
+			continue;
+		}
+
+		FString FileName = UTF8_TO_TCHAR(Stat.GetFilename());
+		if (FileName.RemoveFromEnd(Extension, ESearchCase::CaseSensitive))
+		{
+			SlotNames.Add(MoveTemp(FileName));
+		}
+	}
+	return SlotNames;
+}
+
+void UVE_CloudSave_Subsystem::SaveToDiscord(const FString& SlotName, TSharedRef<const TArray<uint8>> Bytes, TFunction<void(bool)> OnDone)
+{
+	if (!ActiveSaves.Contains(SlotName))
+	{
+		TSharedRef<FVE_CloudSaveJob> Job = MakeShared<FVE_CloudSaveJob>(SlotName, Bytes);
+		Job->Callbacks.Add(MoveTemp(OnDone));
+		StartDiscordSave(Job);
+		return;
+	}
+
+	// Only the newest save of a slot matters, so saves made during an upload collapse into one
+	if (TSharedRef<FVE_CloudSaveJob>* Pending = PendingSaves.Find(SlotName))
+	{
+		(*Pending)->Bytes = Bytes;
+		(*Pending)->Callbacks.Add(MoveTemp(OnDone));
+		return;
+	}
+
+	TSharedRef<FVE_CloudSaveJob> Job = MakeShared<FVE_CloudSaveJob>(SlotName, Bytes);
+	Job->Callbacks.Add(MoveTemp(OnDone));
+	PendingSaves.Add(SlotName, Job);
+}
+
+void UVE_CloudSave_Subsystem::StartDiscordSave(TSharedRef<FVE_CloudSaveJob> Job)
+{
+	ActiveSaves.Add(Job->SlotName);
+	if (!GetDiscordCore())
+	{
+		FinishDiscordSave(Job, false);
+		return;
+	}
+
+	TMap<uint64, int32> StoredChunks = ListStoredChunks(Job->SlotName);
+	TWeakObjectPtr<UVE_CloudSave_Subsystem> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Job, StoredChunks = MoveTemp(StoredChunks)]()
+	{
+		TSharedRef<FVE_CloudSaveUpload> Upload = MakeShared<FVE_CloudSaveUpload>();
+		BuildUpload(*Job->Bytes, StoredChunks, *Upload);
+
+		// The SDK is only called from the game thread, where its callbacks run
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Job, Upload]()
+		{
+			if (UVE_CloudSave_Subsystem* This = WeakThis.Get())
+			{
+				This->PumpUpload(Job, Upload);
+			}
+			else
+			{
+				RunSaveCallbacks(*Job, false);
+			}
+		});
+	});
+}
+
+void UVE_CloudSave_Subsystem::PumpUpload(TSharedRef<FVE_CloudSaveJob> Job, TSharedRef<FVE_CloudSaveUpload> Upload)
+{
+	discord::Core* Core = GetDiscordCore();
+	if (!Core)
+	{
+		Upload->bFailed = true;
+	}
+
+	TWeakObjectPtr<UVE_CloudSave_Subsystem> WeakThis(this);
+	while (!Upload->bFailed && Upload->InFlight < MaxInFlightRequests && Upload->NextChunk < Upload->NewChunks.Num())
+	{
+		TPair<uint64, TArray<uint8>>& Chunk = Upload->NewChunks[Upload->NextChunk++];
+		++Upload->InFlight;
+		Core->StorageManager().WriteAsync(TCHAR_TO_UTF8(*ChunkFileName(Job->SlotName, Chunk.Key)), Chunk.Value.GetData(), Chunk.Value.Num(),
+			[WeakThis, Job, Upload](discord::Result Result)
+			{
+				--Upload->InFlight;
+				if (Result != discord::Result::Ok && !Upload->bFailed)
+				{
+					UE_LOG(LogVECloudSave, Warning, TEXT("Uploading a chunk of %s failed (%d)"), *Job->SlotName, (int32)Result);
+					Upload->bFailed = true;
+				}
+				if (UVE_CloudSave_Subsystem* This = WeakThis.Get())
+				{
+					This->PumpUpload(Job, Upload);
+				}
+				else if (Upload->InFlight == 0)
+				{
+					// Nothing pumps the upload anymore, the last chunk to come back reports it failed
+					RunSaveCallbacks(*Job, false);
+				}
+			});
+	}
+
+	if (Upload->InFlight > 0 || Upload->bCommitting)
+	{
+		return;
+	}
+	if (Upload->bFailed)
+	{
+		FinishDiscordSave(Job, false);
+		return;
+	}
+
+	// Every chunk is in storage, writing the manifest makes the new save visible
+	Upload->bCommitting = true;
+	Core->StorageManager().WriteAsync(TCHAR_TO_UTF8(*ManifestFileName(Job->SlotName)), Upload->ManifestBytes.GetData(), Upload->ManifestBytes.Num(),
+		[WeakThis, Job, Upload](discord::Result Result)
+		{
+			UVE_CloudSave_Subsystem* This = WeakThis.Get();
+			if (!This)
+			{
+				RunSaveCallbacks(*Job, Result == discord::Result::Ok);
+				return;
+			}
+			if (Result == discord::Result::Ok)
+			{
+				// The chunks the old manifest used are deleted once nothing reads them anymore
+				This->PendingCleanups.Add(Job->SlotName, Upload->Manifest);
+			}
+			else
+			{
+				UE_LOG(LogVECloudSave, Warning, TEXT("Writing the manifest of %s failed (%d)"), *Job->SlotName, (int32)Result);
+			}
+			This->FinishDiscordSave(Job, Result == discord::Result::Ok);
+		});
+}
+
+void UVE_CloudSave_Subsystem::FinishDiscordSave(TSharedRef<FVE_CloudSaveJob> Job, bool bSuccess)
+{
+	ActiveSaves.Remove(Job->SlotName);
+	RunSaveCallbacks(*Job, bSuccess);
+
+	if (TSharedRef<FVE_CloudSaveJob>* Pending = PendingSaves.Find(Job->SlotName))
+	{
+		TSharedRef<FVE_CloudSaveJob> Next = *Pending;
+		PendingSaves.Remove(Job->SlotName);
+		StartDiscordSave(Next);
+		return;
+	}
+	TryDeleteUnreferencedChunks(Job->SlotName);
+}
+
+void UVE_CloudSave_Subsystem::TryDeleteUnreferencedChunks(const FString& SlotName)
+{
+	// A save in flight may reuse chunks the committed manifest dropped, and a read in flight may still be fetching
+	// chunks of the manifest it read before the commit
+	if (ActiveSaves.Contains(SlotName) || ActiveReads.Contains(SlotName))
+	{
+		return;
+	}
+
+	FVE_CloudSaveManifest Manifest;
+	if (PendingCleanups.RemoveAndCopyValue(SlotName, Manifest))
+	{
+		DeleteUnreferencedChunks(SlotName, Manifest);
+	}
+}
+
+void UVE_CloudSave_Subsystem::EndRead(const FString& SlotName)
+{
+	int32& NumReads = ActiveReads.FindChecked(SlotName);
+	if (--NumReads == 0)
+	{
+		ActiveReads.Remove(SlotName);
+		TryDeleteUnreferencedChunks(SlotName);
+	}
+}
+
+void UVE_CloudSave_Subsystem::DeleteUnreferencedChunks(const FString& SlotName, const FVE_CloudSaveManifest& Manifest)
+{
+	discord::Core* Core = GetDiscordCore();
+	if (!Core)
+	{
+		return;
+	}
+
+	TSet<uint64> Referenced;
+	for (const FVE_CloudSaveChunk& Chunk : Manifest.Chunks)
+	{
+		Referenced.Add(Chunk.Hash);
+	}
+
+	for (const TPair<uint64, int32>& Stored : ListStoredChunks(SlotName))
+	{
+		if (!Referenced.Contains(Stored.Key))
+		{
+			Core->StorageManager().Delete(TCHAR_TO_UTF8(*ChunkFileName(SlotName, Stored.Key)));
+		}
+	}
+}
+
+TMap<uint64, int32> UVE_CloudSave_Subsystem::ListStoredChunks(const FString& SlotName) const
+{
+	TMap<uint64, int32> Chunks;
+	discord::Core* Core = GetDiscordCore();
+	if (!Core)
+	{
+		return Chunks;
+	}
+
+	const FString Prefix = SlotName + TEXT(".");
+	int32_t Count = 0;
+	Core->StorageManager().Count(&Count);
+	for (int32_t Index = 0; Index < Count; ++Index)
+	{
+		discord::FileStat Stat;
+		uint64 Hash = 0;
+		if (Core->StorageManager().StatAt(Index, &Stat) == discord::Result::Ok && ParseChunkFileName(UTF8_TO_TCHAR(Stat.GetFilename()), Prefix, Hash))
+		{
+			Chunks.Add(Hash, (int32)Stat.GetSize());
+		}
+	}
+	return Chunks;
+}
+
+void UVE_CloudSave_Subsystem::LoadFromDiscord(const FString& SlotName, FVE_OnCloudLoaded OnLoaded)
+{
+	ReadDiscordRange(SlotName, 0, MAX_int64, [SlotName, OnLoaded](bool bSuccess, TArray<uint8>&& Data)
+	{
+		USaveGame* Loaded = bSuccess ? UGameplayStatics::LoadGameFromMemory(Data) : nullptr;
+		OnLoaded.ExecuteIfBound(SlotName, Loaded, Loaded != nullptr);
+	});
+}
+
+void UVE_CloudSave_Subsystem::ReadDiscordRange(const FString& SlotName, int64 Offset, int64 Length, TFunction<void(bool bSuccess, TArray<uint8>&& Data)> InOnRead)
+{
+	discord::Core* Core = GetDiscordCore();
+	if (!Core)
+	{
+		InOnRead(false, TArray<uint8>());
+		return;
+	}
+
+	// Counted until it reports, so a save committing meanwhile keeps the chunks this read may still fetch
+	ActiveReads.FindOrAdd(SlotName)++;
+	TWeakObjectPtr<UVE_CloudSave_Subsystem> WeakThis(this);
+	TFunction<void(bool, TArray<uint8>&&)> OnRead = [WeakThis, SlotName, InOnRead](bool bSuccess, TArray<uint8>&& Data)
+	{
+		if (UVE_CloudSave_Subsystem* This = WeakThis.Get())
+		{
+			This->EndRead(SlotName);
+		}
+		InOnRead(bSuccess, MoveTemp(Data));
+	};
+
+	// Everything the manifest callback needs rides in the job, the pool's callbacks only have room for a few pointers
+	TSharedRef<FVE_CloudReadJob> Job = MakeShared<FVE_CloudReadJob>();
+	Job->SlotName = SlotName;
+	Job->Offset = Offset;
+	Job->Length = Length;
+	Job->OnRead = MoveTemp(OnRead);
+
+	Core->StorageManager().ReadAsync(TCHAR_TO_UTF8(*ManifestFileName(SlotName)),
+		[WeakThis, Job](discord::Result Result, uint8_t* Data, uint32_t DataLength)
+		{
+			UVE_CloudSave_Subsystem* This = WeakThis.Get();
+			if (!This)
+			{
+				Job->OnRead(false, TArray<uint8>());
+				return;
+			}
+
+			TArray<uint8> ManifestBytes(Data, DataLength);
+			FMemoryReader Reader(ManifestBytes);
+			if (Result != discord::Result::Ok || !SerializeManifest(Reader, Job->Manifest) || !IsValidManifest(Job->Manifest))
+			{
+				Job->OnRead(false, TArray<uint8>());
+				return;
+			}
+
+			const int64 TotalSize = Job->Manifest.TotalSize;
+			Job->Offset = FMath::Clamp<int64>(Job->Offset, 0, TotalSize);
+			Job->Length = FMath::Clamp<int64>(Job->Length, 0, TotalSize - Job->Offset);
+			if (Job->Length == 0)
+			{
+				Job->OnRead(true, TArray<uint8>());
+				return;
+			}
+
+			Job->FirstChunk = (int32)(Job->Offset / Job->Manifest.ChunkSize);
+			Job->EndChunk = (int32)((Job->Offset + Job->Length - 1) / Job->Manifest.ChunkSize) + 1;
+			Job->NextChunk = Job->FirstChunk;
+			Job->Fetched.SetNum(Job->EndChunk - Job->FirstChunk);
+			Job->Partial.SetNumZeroed(Job->EndChunk - Job->FirstChunk);
+			This->PumpRead(Job);
+		});
+}
+
+void UVE_CloudSave_Subsystem::PumpRead(TSharedRef<FVE_CloudReadJob> Job)
+{
+	discord::Core* Core = GetDiscordCore();
+	if (!Core)
+	{
+		Job->bFailed = true;
+	}
+
+	TWeakObjectPtr<UVE_CloudSave_Subsystem> WeakThis(this);
+	while (!Job->bFailed && Job->InFlight < MaxInFlightRequests && Job->NextChunk < Job->EndChunk)
+	{
+		const int32 Index = Job->NextChunk++;
+		const FVE_CloudSaveChunk& Chunk = Job->Manifest.Chunks[Index];
+		const int64 ChunkOffset = (int64)Index * Job->Manifest.ChunkSize;
+		const int64 SliceStart = FMath::Max(Job->Offset, ChunkOffset) - ChunkOffset;
+		const int64 SliceEnd = FMath::Min(Job->Offset + Job->Length, ChunkOffset + Chunk.RawSize) - ChunkOffset;
+
+		// Uncompressed chunks can be read partially, compressed ones are needed whole
+		const bool bPartial = Chunk.StoredSize == Chunk.RawSize && (SliceStart > 0 || SliceEnd < Chunk.RawSize);
+		Job->Partial[Index - Job->FirstChunk] = bPartial;
+
+		auto OnChunk = [WeakThis, Job, Index](discord::Result Result, uint8_t* Data, uint32_t DataLength)
+		{
+			--Job->InFlight;
+			if (Result == discord::Result::Ok)
+			{
+				Job->Fetched[Index - Job->FirstChunk] = TArray<uint8>(Data, DataLength);
+			}
+			else
+			{
+				Job->bFailed = true;
+			}
+			if (UVE_CloudSave_Subsystem* This = WeakThis.Get())
+			{
+				This->PumpRead(Job);
+			}
+			else if (Job->InFlight == 0 && !Job->bDone)
+			{
+				Job->bDone = true;
+				Job->OnRead(false, TArray<uint8>());
+			}
+		};
+
+		++Job->InFlight;
+		const FTCHARToUTF8 FileName(*ChunkFileName(Job->SlotName, Chunk.Hash));
+		if (bPartial)
+		{
+			Core->StorageManager().ReadAsyncPartial(FileName.Get(), SliceStart, SliceEnd - SliceStart, OnChunk);
+		}
+		else
+		{
+			Core->StorageManager().ReadAsync(FileName.Get(), OnChunk);
+		}
+	}
+
+	if (Job->InFlight > 0 || Job->bDone)
+	{
+		return;
+	}
+	Job->bDone = true;
+
+	if (Job->bFailed)
+	{
+		UE_LOG(LogVECloudSave, Warning, TEXT("Reading %s from Discord storage failed"), *Job->SlotName);
+		Job->OnRead(false, TArray<uint8>());
+		return;
+	}
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [Job]()
+	{
+		TArray<uint8> Data;
+		const bool bSuccess = DecodeRange(*Job, Data);
+		AsyncTask(ENamedThreads::GameThread, [Job, bSuccess, Data = MoveTemp(Data)]() mutable
+		{
+			Job->OnRead(bSuccess, bSuccess ? MoveTemp(Data) : TArray<uint8>());
+		});
+	});
+}
@@ -0,0 +1,324 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VE_DiscordAvatar_Subsystem.h"
+#include "VE_Discord_Subsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Texture2D.h"
+#include "RenderingThread.h"
+#include "discord.h"
+
+static constexpr int32 TileBytes = UVE_DiscordAvatar_Subsystem::TileSize * UVE_DiscordAvatar_Subsystem::TileSize * 4;
+
+void UVE_DiscordAvatar_Subsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Collection.InitializeDependency<UVE_Discord_Subsystem>();
+	Super::Initialize(Collection);
+
+	Atlas = UTexture2D::CreateTransient(AtlasSize, AtlasSize, PF_B8G8R8A8, TEXT("DiscordAvatarAtlas"));
+	Atlas->SRGB = true;
+	Atlas->NeverStream = true;
+	Atlas->UpdateResource();
+
+	// Everything an upload touches is sized once here, so fetching avatars never allocates
+	Staging.SetNumZeroed(NumTiles * TileBytes);
+	Regions.SetNum(NumTiles);
+	PendingUploads.SetNum(NumTiles);
+	Tiles.SetNum(NumTiles);
+	for (int32 Tile = 0; Tile < NumTiles; Tile++)
+	{
+		const int32 X = (Tile % TilesPerRow) * TileSize;
+		const int32 Y = (Tile / TilesPerRow) * TileSize;
+		Regions[Tile] = FUpdateTextureRegion2D(X, Y, 0, 0, TileSize, TileSize);
+		LinkAtTail(Tile);
+	}
+	Entries.Reserve(NumTiles);
+}
+
+void UVE_DiscordAvatar_Subsystem::Deinitialize()
+{
+	// Queued uploads still read from Staging
+	FlushRenderingCommands();
+
+	Entries.Empty();
+	Atlas = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UVE_DiscordAvatar_Subsystem::RequestAvatar(int64 UserId, FVE_OnAvatarReady OnReady)
+{
+	FAvatarEntry& Entry = Entries.FindOrAdd(UserId);
+	Entry.Refs++;
+
+	if (Entry.Tile != INDEX_NONE)
+	{
+		Unlink(Entry.Tile);
+		LinkAtHead(Entry.Tile);
+		OnReady.ExecuteIfBound(UserId, MakeTile(Entry.Tile), true);
+		return;
+	}
+
+	Entry.Waiters.Add(OnReady);
+	if (Entry.bFetching)
+	{
+		return;
+	}
+
+	discord::Core* Core = GetDiscordCore();
+	if (!Core)
+	{
+		OnFetched(UserId, discord::Result::NotRunning, discord::ImageHandle());
+		return;
+	}
+
+	Entry.bFetching = true;
+
+	discord::ImageHandle Handle;
+	Handle.SetType(discord::ImageType::User);
+	Handle.SetId(UserId);
+	Handle.SetSize(TileSize);
+
+	TWeakObjectPtr<UVE_DiscordAvatar_Subsystem> WeakThis(this);
+	Core->ImageManager().Fetch(Handle, false, [WeakThis, UserId](discord::Result Result, discord::ImageHandle Fetched)
+	{
+		if (WeakThis.IsValid())
+		{
+			WeakThis->OnFetched(UserId, Result, Fetched);
+		}
+	});
+}
+
+void UVE_DiscordAvatar_Subsystem::ReleaseAvatar(int64 UserId)
+{
+	FAvatarEntry* Entry = Entries.Find(UserId);
+	if (!Entry || Entry->Refs == 0)
+	{
+		return;
+	}
+
+	// The tile stays cached, it is only handed out again once it reaches the end of the LRU list
+	Entry->Refs--;
+	if (Entry->Refs == 0 && Entry->Tile == INDEX_NONE && !Entry->bFetching)
+	{
+		Entries.Remove(UserId);
+	}
+}
+
+bool UVE_DiscordAvatar_Subsystem::FindAvatar(int64 UserId, FVE_AvatarTile& Tile)
+{
+	const FAvatarEntry* Entry = Entries.Find(UserId);
+	if (!Entry || Entry->Tile == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Unlink(Entry->Tile);
+	LinkAtHead(Entry->Tile);
+	Tile = MakeTile(Entry->Tile);
+	return true;
+}
+
+FSlateBrush UVE_DiscordAvatar_Subsystem::MakeAvatarBrush(const FVE_AvatarTile& Tile, FVector2D ImageSize)
+{
+	FSlateBrush Brush;
+	Brush.SetResourceObject(Tile.Atlas);
+	Brush.ImageSize = ImageSize;
+	Brush.SetUVRegion(FBox2f(FVector2f(Tile.UVMin), FVector2f(Tile.UVMax)));
+	return Brush;
+}
+
+discord::Core* UVE_DiscordAvatar_Subsystem::GetDiscordCore() const
+{
+	UVE_Discord_Subsystem* Discord = GetGameInstance()->GetSubsystem<UVE_Discord_Subsystem>();
+	return Discord ? Discord->GetCore() : nullptr;
+}
+
+void UVE_DiscordAvatar_Subsystem::OnFetched(int64 UserId, discord::Result Result, const discord::ImageHandle& Handle)
+{
+	// Acquiring a tile can evict other entries, so the entry is looked up again afterwards
+	int32 Tile = INDEX_NONE;
+	discord::Core* Core = GetDiscordCore();
+	if (Result == discord::Result::Ok && Core && Entries.Contains(UserId))
+	{
+		Tile = AcquireTile(UserId);
+		if (Tile != INDEX_NONE && !CopyIntoTile(Core, Handle, Tile))
+		{
+			FreeTile(Tile);
+			Tile = INDEX_NONE;
+		}
+	}
+
+	FAvatarEntry* Entry = Entries.Find(UserId);
+	if (!Entry)
+	{
+		return;
+	}
+
+	TArray<FVE_OnAvatarReady, TInlineAllocator<1>> Waiters = MoveTemp(Entry->Waiters);
+	Entry->bFetching = false;
+	Entry->Tile = Tile;
+
+	const bool bSuccess = Tile != INDEX_NONE;
+	const FVE_AvatarTile AvatarTile = bSuccess ? MakeTile(Tile) : FVE_AvatarTile();
+	if (!bSuccess)
+	{
+		// A failed fetch is not cached, the next request tries again.
+		// Callers still release, which is a no-op for the removed entry.
+		Entries.Remove(UserId);
+	}
+
+	for (const FVE_OnAvatarReady& Waiter : Waiters)
+	{
+		Waiter.ExecuteIfBound(UserId, AvatarTile, bSuccess);
+	}
+}
+
+bool UVE_DiscordAvatar_Subsystem::CopyIntoTile(discord::Core* Core, const discord::ImageHandle& Handle, int32 Tile)
+{
+	discord::ImageDimensions Dimensions;
+	if (Core->ImageManager().GetDimensions(Handle, &Dimensions) != discord::Result::Ok)
+	{
+		return false;
+	}
+
+	const uint32 Width = Dimensions.GetWidth();
+	const uint32 Height = Dimensions.GetHeight();
+	if (Width == 0 || Height == 0)
+	{
+		return false;
+	}
+
+	// Scratch only grows, and Discord hands out avatars at the size we asked for
+	Scratch.SetNumUninitialized(Width * Height * 4, EAllowShrinking::No);
+	if (Core->ImageManager().GetData(Handle, Scratch.GetData(), Scratch.Num()) != discord::Result::Ok)
+	{
+		return false;
+	}
+
+	// RGBA to BGRA, nearest sampled in case the size did not match
+	uint8* Dest = Staging.GetData() + Tile * TileBytes;
+	for (int32 Y = 0; Y < TileSize; Y++)
+	{
+		const uint8* SrcRow = Scratch.GetData() + (Y * Height / TileSize) * Width * 4;
+		for (int32 X = 0; X < TileSize; X++)
+		{
+			const uint8* Src = SrcRow + (X * Width / TileSize) * 4;
+			Dest[0] = Src[2];
+			Dest[1] = Src[1];
+			Dest[2] = Src[0];
+			Dest[3] = Src[3];
+			Dest += 4;
+		}
+	}
+
+	FThreadSafeCounter* Pending = &PendingUploads[Tile];
+	Pending->Increment();
+	Atlas->UpdateTextureRegions(0, 1, &Regions[Tile], TileSize * 4, 4, Staging.GetData() + Tile * TileBytes,
+		[Pending](uint8* SrcData, const FUpdateTextureRegion2D* Region)
+		{
+			Pending->Decrement();
+		});
+	return true;
+}
+
+int32 UVE_DiscordAvatar_Subsystem::AcquireTile(int64 UserId)
+{
+	// Walk from the least recently used end for a tile that is neither referenced nor still uploading
+	for (int32 Tile = Tail; Tile != INDEX_NONE; Tile = Tiles[Tile].Prev)
+	{
+		if (PendingUploads[Tile].GetValue() != 0)
+		{
+			continue;
+		}
+
+		const int64 OldUserId = Tiles[Tile].UserId;
+		if (OldUserId != 0)
+		{
+			const FAvatarEntry* Old = Entries.Find(OldUserId);
+			if (Old && Old->Refs > 0)
+			{
+				continue;
+			}
+			Entries.Remove(OldUserId);
+		}
+
+		Tiles[Tile].UserId = UserId;
+		Unlink(Tile);
+		LinkAtHead(Tile);
+		return Tile;
+	}
+	return INDEX_NONE;
+}
+
+void UVE_DiscordAvatar_Subsystem::FreeTile(int32 Tile)
+{
+	Tiles[Tile].UserId = 0;
+	Unlink(Tile);
+	LinkAtTail(Tile);
+}
+
+void UVE_DiscordAvatar_Subsystem::Unlink(int32 Tile)
+{
+	FTile& Node = Tiles[Tile];
+	if (Node.Prev != INDEX_NONE)
+	{
+		Tiles[Node.Prev].Next = Node.Next;
+	}
+	else
+	{
+		Head = Node.Next;
+	}
+
+	if (Node.Next != INDEX_NONE)
+	{
+		Tiles[Node.Next].Prev = Node.Prev;
+	}
+	else
+	{
+		Tail = Node.Prev;
+	}
+	Node.Prev = INDEX_NONE;
+	Node.Next = INDEX_NONE;
+}
+
+void UVE_DiscordAvatar_Subsystem::LinkAtHead(int32 Tile)
+{
+	Tiles[Tile].Next = Head;
+	if (Head != INDEX_NONE)
+	{
+		Tiles[Head].Prev = Tile;
+	}
+	Head = Tile;
+	if (Tail == INDEX_NONE)
+	{
+		Tail = Tile;
+	}
+}
+
+void UVE_DiscordAvatar_Subsystem::LinkAtTail(int32 Tile)
+{
+	Tiles[Tile].Prev = Tail;
+	if (Tail != INDEX_NONE)
+	{
+		Tiles[Tail].Next = Tile;
+	}
+	Tail = Tile;
+	if (Head == INDEX_NONE)
+	{
+		Head = Tile;
+	}
+}
+
+FVE_AvatarTile UVE_DiscordAvatar_Subsystem::MakeTile(int32 Tile) const
+{
+	// Inset by half a texel so bilinear filtering does not bleed in the neighbouring avatars
+	const double TexelSize = 1.0 / AtlasSize;
+	const FVector2D Origin((Tile % TilesPerRow) * TileSize * TexelSize, (Tile / TilesPerRow) * TileSize * TexelSize);
+
+	FVE_AvatarTile Result;
+	Result.Atlas = Atlas;
+	Result.UVMin = Origin + FVector2D(0.5 * TexelSize);
+	Result.UVMax = Origin + FVector2D((TileSize - 0.5) * TexelSize);
+	return Result;
+}
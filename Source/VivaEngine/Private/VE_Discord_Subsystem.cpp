@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VE_Discord_Subsystem.h"
+#include "DiscordLogBuffer.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "discord.h"
+
+DEFINE_LOG_CATEGORY(LogDiscord);
+
+// We will need to hide this Token ID in something later
+static constexpr discord::ClientId VivaDiscordClientId = 1030046546768711720;
+
+// A Discord client that is struggling can log every frame, keep it from drowning the rest of the log
+static constexpr int32 MaxLogLinesPerSecond = 20;
+static constexpr int32 RecentLogSize = 128;
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DiscordLogCommand(
+	TEXT("Viva.DiscordLog"),
+	TEXT("Prints the most recent Discord SDK log lines, including the ones that were rate limited."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		UVE_Discord_Subsystem* Discord = UGameInstance::GetSubsystem<UVE_Discord_Subsystem>(World ? World->GetGameInstance() : nullptr);
+		if (!Discord)
+		{
+			Ar.Log(TEXT("No game instance with a Discord subsystem"));
+			return;
+		}
+		Discord->DumpRecentLog(Ar);
+	}));
+
+static const TCHAR* LogLevelToString(discord::LogLevel Level)
+{
+	switch (Level)
+	{
+	case discord::LogLevel::Error: return TEXT("Error");
+	case discord::LogLevel::Warn: return TEXT("Warn");
+	case discord::LogLevel::Info: return TEXT("Info");
+	default: return TEXT("Debug");
+	}
+}
+
+UVE_Discord_Subsystem::UVE_Discord_Subsystem() = default;
+
+// Out of line so the header does not need FDiscordLogBuffer
+UVE_Discord_Subsystem::~UVE_Discord_Subsystem() = default;
+
+void UVE_Discord_Subsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Make sure Discord is not required
+	discord::Result Result = discord::Core::Create(VivaDiscordClientId, DiscordCreateFlags_NoRequireDiscord, &Core);
+	if (Result != discord::Result::Ok)
+	{
+		Core = nullptr;
+		return;
+	}
+
+	// The hook may run off the game thread, it only copies into the preallocated buffer
+	LogBuffer = MakeUnique<FDiscordLogBuffer>();
+	RecentLog.SetNum(RecentLogSize);
+	FDiscordLogBuffer* Buffer = LogBuffer.Get();
+	Core->SetLogHook(discord::LogLevel::Debug, [Buffer](discord::LogLevel Level, const char* Message)
+	{
+		Buffer->Push(Level, Message);
+	});
+}
+
+void UVE_Discord_Subsystem::Deinitialize()
+{
+	delete Core;
+	Core = nullptr;
+
+	DrainLog();
+	LogBuffer.Reset();
+
+	Super::Deinitialize();
+}
+
+void UVE_Discord_Subsystem::Tick(float DeltaTime)
+{
+	// Required every tick (Per Discord SDK Docs)
+	if (Core->RunCallbacks() == discord::Result::NotRunning)
+	{
+		// The client was closed under us, so every further call would fail
+		delete Core;
+		Core = nullptr;
+	}
+
+	DrainLog();
+}
+
+void UVE_Discord_Subsystem::DumpRecentLog(FOutputDevice& Ar) const
+{
+	for (int32 Offset = 0; Offset < RecentLog.Num(); Offset++)
+	{
+		const FString& Line = RecentLog[(RecentLogNext + Offset) % RecentLog.Num()];
+		if (!Line.IsEmpty())
+		{
+			Ar.Log(Line);
+		}
+	}
+}
+
+void UVE_Discord_Subsystem::DrainLog()
+{
+	if (!LogBuffer)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LogWindowStart >= 1.0)
+	{
+		if (SuppressedLogLines > 0)
+		{
+			UE_LOG(LogDiscord, Warning, TEXT("%d Discord log lines suppressed, Viva.DiscordLog prints them"), SuppressedLogLines);
+		}
+		LogWindowStart = Now;
+		LogLinesInWindow = 0;
+		SuppressedLogLines = 0;
+	}
+
+	LogBuffer->Drain([this](const FDiscordLogBuffer::FEntry& Entry)
+	{
+		// Every line goes into the history, only the ones within the rate limit are logged
+		FString& Line = RecentLog[RecentLogNext];
+		RecentLogNext = (RecentLogNext + 1) % RecentLog.Num();
+		Line = FString::Printf(TEXT("[%.3f] %s: %s"), Entry.Time, LogLevelToString(Entry.Level), UTF8_TO_TCHAR(Entry.Message));
+
+		if (LogLinesInWindow >= MaxLogLinesPerSecond)
+		{
+			SuppressedLogLines++;
+			return;
+		}
+		LogLinesInWindow++;
+
+		switch (Entry.Level)
+		{
+		case discord::LogLevel::Error:
+			UE_LOG(LogDiscord, Error, TEXT("%s"), UTF8_TO_TCHAR(Entry.Message));
+			break;
+		case discord::LogLevel::Warn:
+			UE_LOG(LogDiscord, Warning, TEXT("%s"), UTF8_TO_TCHAR(Entry.Message));
+			break;
+		case discord::LogLevel::Info:
+			UE_LOG(LogDiscord, Log, TEXT("%s"), UTF8_TO_TCHAR(Entry.Message));
+			break;
+		default:
+			UE_LOG(LogDiscord, Verbose, TEXT("%s"), UTF8_TO_TCHAR(Entry.Message));
+			break;
+		}
+	});
+
+	if (const uint32 Dropped = LogBuffer->TakeDropped())
+	{
+		UE_LOG(LogDiscord, Warning, TEXT("%u Discord log lines dropped, the log buffer was full"), Dropped);
+	}
+}
+
+TStatId UVE_Discord_Subsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVE_Discord_Subsystem, STATGROUP_Tickables);
+}
+
+ETickableTickType UVE_Discord_Subsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
@@ -0,0 +1,517 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VE_ModTextureCache.h"
+#include "Async/MappedFileHandle.h"
+#include "Engine/Texture2D.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Hash/xxhash.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "RHI.h"
+#include "TextureResource.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVEModTextureCache, Log, All);
+
+// On disk a cache file is the header, NumMips mip entries and then the mip data, with offsets from the start of the
+// file. The cache never leaves the machine that wrote it, so the structs are stored as they are in memory.
+struct FModTextureCacheHeader
+{
+	uint32 Magic;
+	int32 Version;
+	int32 Format;
+	int32 NumMips;
+};
+
+struct FModTextureCacheMip
+{
+	int32 SizeX;
+	int32 SizeY;
+	int64 Offset;
+	int64 Size;
+};
+
+static int64 GetMipSize(EPixelFormat Format, int32 SizeX, int32 SizeY)
+{
+	switch (Format)
+	{
+	case PF_DXT1:
+		return (int64)FMath::DivideAndRoundUp(SizeX, 4) * FMath::DivideAndRoundUp(SizeY, 4) * 8;
+	case PF_DXT5:
+		return (int64)FMath::DivideAndRoundUp(SizeX, 4) * FMath::DivideAndRoundUp(SizeY, 4) * 16;
+	case PF_B8G8R8A8:
+		return (int64)SizeX * SizeY * 4;
+	default:
+		return INDEX_NONE;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Mips and block compression
+
+// 2x2 box filter, an odd last row or column is averaged with itself
+static void Downsample(const TArray64<uint8>& Source, int32 SourceX, int32 SourceY, TArray64<uint8>& Dest, int32& OutX, int32& OutY)
+{
+	OutX = FMath::Max(1, SourceX / 2);
+	OutY = FMath::Max(1, SourceY / 2);
+	Dest.SetNumUninitialized((int64)OutX * OutY * 4);
+
+	for (int32 Y = 0; Y < OutY; ++Y)
+	{
+		const int32 Y0 = FMath::Min(Y * 2, SourceY - 1);
+		const int32 Y1 = FMath::Min(Y * 2 + 1, SourceY - 1);
+		for (int32 X = 0; X < OutX; ++X)
+		{
+			const int32 X0 = FMath::Min(X * 2, SourceX - 1);
+			const int32 X1 = FMath::Min(X * 2 + 1, SourceX - 1);
+			const uint8* A = &Source[((int64)Y0 * SourceX + X0) * 4];
+			const uint8* B = &Source[((int64)Y0 * SourceX + X1) * 4];
+			const uint8* C = &Source[((int64)Y1 * SourceX + X0) * 4];
+			const uint8* D = &Source[((int64)Y1 * SourceX + X1) * 4];
+			uint8* Out = &Dest[((int64)Y * OutX + X) * 4];
+			for (int32 Channel = 0; Channel < 4; ++Channel)
+			{
+				Out[Channel] = (uint8)((A[Channel] + B[Channel] + C[Channel] + D[Channel] + 2) / 4);
+			}
+		}
+	}
+}
+
+static uint16 To565(const int32 Color[3])
+{
+	return (uint16)(((Color[0] >> 3) << 11) | ((Color[1] >> 2) << 5) | (Color[2] >> 3));
+}
+
+static void From565(uint16 Packed, int32 OutColor[3])
+{
+	const int32 R = (Packed >> 11) & 31;
+	const int32 G = (Packed >> 5) & 63;
+	const int32 B = Packed & 31;
+	OutColor[0] = (R << 3) | (R >> 2);
+	OutColor[1] = (G << 2) | (G >> 4);
+	OutColor[2] = (B << 3) | (B >> 2);
+}
+
+// Endpoints from the block's color bounding box, pulled in slightly so outliers do not stretch the palette
+static void EncodeColorBlock(const uint8* Block, uint8* Dest)
+{
+	int32 Min[3] = { 255, 255, 255 };
+	int32 Max[3] = { 0, 0, 0 };
+	for (int32 Texel = 0; Texel < 16; ++Texel)
+	{
+		const int32 Color[3] = { Block[Texel * 4 + 2], Block[Texel * 4 + 1], Block[Texel * 4 + 0] };
+		for (int32 Channel = 0; Channel < 3; ++Channel)
+		{
+			Min[Channel] = FMath::Min(Min[Channel], Color[Channel]);
+			Max[Channel] = FMath::Max(Max[Channel], Color[Channel]);
+		}
+	}
+	for (int32 Channel = 0; Channel < 3; ++Channel)
+	{
+		const int32 Inset = (Max[Channel] - Min[Channel]) >> 4;
+		Min[Channel] += Inset;
+		Max[Channel] -= Inset;
+	}
+
+	uint16 Color0 = To565(Max);
+	uint16 Color1 = To565(Min);
+	if (Color0 < Color1)
+	{
+		Swap(Color0, Color1);
+	}
+
+	// Color0 > Color1 selects the four color mode, equal endpoints need no indices at all
+	uint32 Indices = 0;
+	if (Color0 != Color1)
+	{
+		int32 Palette[4][3];
+		From565(Color0, Palette[0]);
+		From565(Color1, Palette[1]);
+		for (int32 Channel = 0; Channel < 3; ++Channel)
+		{
+			Palette[2][Channel] = (2 * Palette[0][Channel] + Palette[1][Channel]) / 3;
+			Palette[3][Channel] = (Palette[0][Channel] + 2 * Palette[1][Channel]) / 3;
+		}
+
+		for (int32 Texel = 0; Texel < 16; ++Texel)
+		{
+			const int32 Color[3] = { Block[Texel * 4 + 2], Block[Texel * 4 + 1], Block[Texel * 4 + 0] };
+			int32 Best = 0;
+			int32 BestDistance = MAX_int32;
+			for (int32 Entry = 0; Entry < 4; ++Entry)
+			{
+				const int32 DR = Color[0] - Palette[Entry][0];
+				const int32 DG = Color[1] - Palette[Entry][1];
+				const int32 DB = Color[2] - Palette[Entry][2];
+				const int32 Distance = DR * DR + DG * DG + DB * DB;
+				if (Distance < BestDistance)
+				{
+					Best = Entry;
+					BestDistance = Distance;
+				}
+			}
+			Indices |= (uint32)Best << (Texel * 2);
+		}
+	}
+
+	Dest[0] = (uint8)(Color0 & 0xFF);
+	Dest[1] = (uint8)(Color0 >> 8);
+	Dest[2] = (uint8)(Color1 & 0xFF);
+	Dest[3] = (uint8)(Color1 >> 8);
+	for (int32 Byte = 0; Byte < 4; ++Byte)
+	{
+		Dest[4 + Byte] = (uint8)(Indices >> (Byte * 8));
+	}
+}
+
+// The BC3 alpha block, eight levels between the block's lowest and highest alpha
+static void EncodeAlphaBlock(const uint8* Block, uint8* Dest)
+{
+	int32 Min = 255;
+	int32 Max = 0;
+	for (int32 Texel = 0; Texel < 16; ++Texel)
+	{
+		Min = FMath::Min(Min, (int32)Block[Texel * 4 + 3]);
+		Max = FMath::Max(Max, (int32)Block[Texel * 4 + 3]);
+	}
+
+	uint64 Indices = 0;
+	if (Max > Min)
+	{
+		int32 Palette[8] = { Max, Min };
+		for (int32 Step = 1; Step < 7; ++Step)
+		{
+			Palette[Step + 1] = ((7 - Step) * Max + Step * Min) / 7;
+		}
+
+		for (int32 Texel = 0; Texel < 16; ++Texel)
+		{
+			const int32 Alpha = Block[Texel * 4 + 3];
+			int32 Best = 0;
+			for (int32 Entry = 1; Entry < 8; ++Entry)
+			{
+				if (FMath::Abs(Alpha - Palette[Entry]) < FMath::Abs(Alpha - Palette[Best]))
+				{
+					Best = Entry;
+				}
+			}
+			Indices |= (uint64)Best << (Texel * 3);
+		}
+	}
+
+	Dest[0] = (uint8)Max;
+	Dest[1] = (uint8)Min;
+	for (int32 Byte = 0; Byte < 6; ++Byte)
+	{
+		Dest[2 + Byte] = (uint8)(Indices >> (Byte * 8));
+	}
+}
+
+// Blocks past the edge of a mip smaller than 4x4 repeat its last row and column
+static void CompressMip(const TArray64<uint8>& Pixels, int32 SizeX, int32 SizeY, bool bAlpha, TArray64<uint8>& Out)
+{
+	const int32 BlocksX = FMath::DivideAndRoundUp(SizeX, 4);
+	const int32 BlocksY = FMath::DivideAndRoundUp(SizeY, 4);
+	const int32 BlockBytes = bAlpha ? 16 : 8;
+
+	int64 Offset = Out.Num();
+	Out.AddUninitialized((int64)BlocksX * BlocksY * BlockBytes);
+
+	uint8 Block[16 * 4];
+	for (int32 BlockY = 0; BlockY < BlocksY; ++BlockY)
+	{
+		for (int32 BlockX = 0; BlockX < BlocksX; ++BlockX)
+		{
+			for (int32 Texel = 0; Texel < 16; ++Texel)
+			{
+				const int32 X = FMath::Min(BlockX * 4 + (Texel & 3), SizeX - 1);
+				const int32 Y = FMath::Min(BlockY * 4 + (Texel >> 2), SizeY - 1);
+				FMemory::Memcpy(&Block[Texel * 4], &Pixels[((int64)Y * SizeX + X) * 4], 4);
+			}
+
+			uint8* Dest = Out.GetData() + Offset;
+			if (bAlpha)
+			{
+				EncodeAlphaBlock(Block, Dest);
+				Dest += 8;
+			}
+			EncodeColorBlock(Block, Dest);
+			Offset += BlockBytes;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FVE_CachedTexture
+
+FVE_CachedTexture::FVE_CachedTexture() = default;
+FVE_CachedTexture::FVE_CachedTexture(FVE_CachedTexture&&) = default;
+FVE_CachedTexture& FVE_CachedTexture::operator=(FVE_CachedTexture&&) = default;
+FVE_CachedTexture::~FVE_CachedTexture() = default;
+
+const uint8* FVE_CachedTexture::GetMipData(int32 MipIndex) const
+{
+	const uint8* Base = MappedRegion.IsValid() ? MappedRegion->GetMappedPtr() : Data.GetData();
+	return Base + Mips[MipIndex].Offset;
+}
+
+void FVE_CachedTexture::Reset()
+{
+	// The region has to go before the file it maps
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	Data.Empty();
+	Mips.Reset();
+	Format = PF_Unknown;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FVE_ModTextureCache
+
+FString FVE_ModTextureCache::GetCacheDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ModTextureCache"));
+}
+
+bool FVE_ModTextureCache::Load(IImageWrapperModule& ImageWrapperModule, const FString& ImagePath, bool bNormalMap, FVE_CachedTexture& Out)
+{
+	TArray<uint8> Compressed;
+	if (!FFileHelper::LoadFileToArray(Compressed, *ImagePath))
+	{
+		return false;
+	}
+
+	// Whether block compression is used is part of the key, so a machine without BC support never reads a BC file
+	const bool bBlockCompress = !bNormalMap && GPixelFormats[PF_DXT1].Supported && GPixelFormats[PF_DXT5].Supported;
+	const uint64 Hash = FXxHash64::HashBuffer(Compressed.GetData(), Compressed.Num()).Hash;
+	const FString CachePath = FPaths::Combine(GetCacheDirectory(), FString::Printf(TEXT("%016llx_%s.vtex"), Hash, bBlockCompress ? TEXT("bc") : TEXT("raw")));
+
+	if (ReadCacheFile(CachePath, Out))
+	{
+		return true;
+	}
+
+	Out.Reset();
+	if (!Build(ImageWrapperModule, Compressed, bBlockCompress, Out))
+	{
+		return false;
+	}
+
+	if (!WriteCacheFile(CachePath, Out))
+	{
+		UE_LOG(LogVEModTextureCache, Warning, TEXT("Could not write %s, %s will be decoded again next launch"), *CachePath, *ImagePath);
+	}
+	return true;
+}
+
+bool FVE_ModTextureCache::Build(IImageWrapperModule& ImageWrapperModule, const TArray<uint8>& Compressed, bool bBlockCompress, FVE_CachedTexture& Out)
+{
+	const EImageFormat ImageFormat = ImageWrapperModule.DetectImageFormat(Compressed.GetData(), Compressed.Num());
+	if (ImageFormat == EImageFormat::Invalid)
+	{
+		return false;
+	}
+
+	TSharedPtr<IImageWrapper> Wrapper = ImageWrapperModule.CreateImageWrapper(ImageFormat);
+	TArray64<uint8> Level;
+	if (!Wrapper.IsValid() || !Wrapper->SetCompressed(Compressed.GetData(), Compressed.Num()) || !Wrapper->GetRaw(ERGBFormat::BGRA, 8, Level))
+	{
+		return false;
+	}
+
+	int32 SizeX = (int32)Wrapper->GetWidth();
+	int32 SizeY = (int32)Wrapper->GetHeight();
+	if (SizeX <= 0 || SizeY <= 0 || Level.Num() != (int64)SizeX * SizeY * 4)
+	{
+		return false;
+	}
+
+	// The top mip has to be whole blocks, anything else stays BGRA8
+	Out.Format = PF_B8G8R8A8;
+	if (bBlockCompress && SizeX % 4 == 0 && SizeY % 4 == 0)
+	{
+		bool bOpaque = true;
+		for (int64 Alpha = 3; Alpha < Level.Num() && bOpaque; Alpha += 4)
+		{
+			bOpaque = Level[Alpha] == 255;
+		}
+		Out.Format = bOpaque ? PF_DXT1 : PF_DXT5;
+	}
+
+	Out.Data.Reserve(GetMipSize(Out.Format, SizeX, SizeY) * 4 / 3 + 64);
+
+	TArray64<uint8> NextLevel;
+	for (;;)
+	{
+		FVE_ModTextureMip& Mip = Out.Mips.AddDefaulted_GetRef();
+		Mip.SizeX = SizeX;
+		Mip.SizeY = SizeY;
+		Mip.Offset = Out.Data.Num();
+
+		if (Out.Format == PF_B8G8R8A8)
+		{
+			Out.Data.Append(Level);
+		}
+		else
+		{
+			CompressMip(Level, SizeX, SizeY, Out.Format == PF_DXT5, Out.Data);
+		}
+		Mip.Size = Out.Data.Num() - Mip.Offset;
+
+		if (SizeX == 1 && SizeY == 1)
+		{
+			break;
+		}
+
+		Downsample(Level, SizeX, SizeY, NextLevel, SizeX, SizeY);
+		Swap(Level, NextLevel);
+	}
+
+	return true;
+}
+
+bool FVE_ModTextureCache::WriteCacheFile(const FString& CachePath, const FVE_CachedTexture& Texture)
+{
+	FModTextureCacheHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.Format = (int32)Texture.Format;
+	Header.NumMips = Texture.Mips.Num();
+
+	const int64 DataStart = sizeof(FModTextureCacheHeader) + sizeof(FModTextureCacheMip) * Texture.Mips.Num();
+	TArray<FModTextureCacheMip> Mips;
+	for (const FVE_ModTextureMip& Mip : Texture.Mips)
+	{
+		Mips.Add({ Mip.SizeX, Mip.SizeY, DataStart + Mip.Offset, Mip.Size });
+	}
+
+	// Written under a unique name and moved into place, so a reader never maps half a file and two mods sharing
+	// an image can both write it
+	const FString TempPath = CachePath + TEXT(".") + FGuid::NewGuid().ToString() + TEXT(".tmp");
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath));
+	if (!Writer.IsValid())
+	{
+		return false;
+	}
+
+	Writer->Serialize(&Header, sizeof(Header));
+	Writer->Serialize(Mips.GetData(), sizeof(FModTextureCacheMip) * Mips.Num());
+	Writer->Serialize(const_cast<uint8*>(Texture.Data.GetData()), Texture.Data.Num());
+	const bool bWritten = Writer->Close() && !Writer->IsError();
+	Writer.Reset();
+
+	if (!bWritten || !IFileManager::Get().Move(*CachePath, *TempPath, true))
+	{
+		IFileManager::Get().Delete(*TempPath);
+		return false;
+	}
+	return true;
+}
+
+bool FVE_ModTextureCache::ReadCacheFile(const FString& CachePath, FVE_CachedTexture& Out)
+{
+	if (!FPaths::FileExists(CachePath))
+	{
+		return false;
+	}
+
+	// Mapped where the platform can, the texture is then filled straight from the page cache
+	const uint8* File = nullptr;
+	int64 FileSize = 0;
+	Out.MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*CachePath));
+	if (Out.MappedFile.IsValid())
+	{
+		Out.MappedRegion.Reset(Out.MappedFile->MapRegion(0, Out.MappedFile->GetFileSize()));
+	}
+	if (Out.MappedRegion.IsValid())
+	{
+		File = Out.MappedRegion->GetMappedPtr();
+		FileSize = Out.MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		Out.MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(Out.Data, *CachePath))
+		{
+			return false;
+		}
+		File = Out.Data.GetData();
+		FileSize = Out.Data.Num();
+	}
+
+	// Anything that does not add up is treated as a miss and rebuilt
+	FModTextureCacheHeader Header;
+	if (FileSize < (int64)sizeof(Header))
+	{
+		Out.Reset();
+		return false;
+	}
+	FMemory::Memcpy(&Header, File, sizeof(Header));
+
+	const EPixelFormat Format = (EPixelFormat)Header.Format;
+	const int64 DataStart = sizeof(FModTextureCacheHeader) + (int64)sizeof(FModTextureCacheMip) * Header.NumMips;
+	if (Header.Magic != Magic || Header.Version != Version || Header.NumMips <= 0 || Header.NumMips > 32 || DataStart > FileSize ||
+		GetMipSize(Format, 1, 1) == INDEX_NONE)
+	{
+		Out.Reset();
+		return false;
+	}
+
+	Out.Format = Format;
+	for (int32 MipIndex = 0; MipIndex < Header.NumMips; ++MipIndex)
+	{
+		FModTextureCacheMip Entry;
+		FMemory::Memcpy(&Entry, File + sizeof(FModTextureCacheHeader) + sizeof(FModTextureCacheMip) * MipIndex, sizeof(Entry));
+		if (Entry.SizeX <= 0 || Entry.SizeY <= 0 || Entry.Size != GetMipSize(Format, Entry.SizeX, Entry.SizeY) ||
+			Entry.Offset < DataStart || Entry.Offset > FileSize - Entry.Size)
+		{
+			Out.Reset();
+			return false;
+		}
+
+		FVE_ModTextureMip& Mip = Out.Mips.AddDefaulted_GetRef();
+		Mip.SizeX = Entry.SizeX;
+		Mip.SizeY = Entry.SizeY;
+		Mip.Offset = Entry.Offset;
+		Mip.Size = Entry.Size;
+	}
+	return true;
+}
+
+UTexture2D* FVE_ModTextureCache::CreateTexture(const FVE_CachedTexture& Cached, bool bSRGB)
+{
+	if (!Cached.IsValid())
+	{
+		return nullptr;
+	}
+
+	FTexturePlatformData* PlatformData = new FTexturePlatformData();
+	PlatformData->SizeX = Cached.Mips[0].SizeX;
+	PlatformData->SizeY = Cached.Mips[0].SizeY;
+	PlatformData->PixelFormat = Cached.Format;
+
+	for (int32 MipIndex = 0; MipIndex < Cached.Mips.Num(); ++MipIndex)
+	{
+		const FVE_ModTextureMip& Source = Cached.Mips[MipIndex];
+		FTexture2DMipMap* Mip = new FTexture2DMipMap();
+		PlatformData->Mips.Add(Mip);
+		Mip->SizeX = Source.SizeX;
+		Mip->SizeY = Source.SizeY;
+		Mip->SizeZ = 1;
+		Mip->BulkData.Lock(LOCK_READ_WRITE);
+		FMemory::Memcpy(Mip->BulkData.Realloc(Source.Size), Cached.GetMipData(MipIndex), Source.Size);
+		Mip->BulkData.Unlock();
+	}
+
+	UTexture2D* Texture = NewObject<UTexture2D>(GetTransientPackage(), NAME_None, RF_Transient);
+	Texture->SetPlatformData(PlatformData);
+	Texture->SRGB = bSRGB;
+	Texture->NeverStream = true;
+	Texture->UpdateResource();
+	return Texture;
+}
@@ -0,0 +1,730 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VE_Mod_Subsystem.h"
+#include "Async/Async.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Texture2D.h"
+#include "HAL/FileManager.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Tasks/Task.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVEMods, Log, All);
+
+static bool LoadJsonObject(const FString& Path, TSharedPtr<FJsonObject>& OutObject)
+{
+	FString Text;
+	if (!FFileHelper::LoadFileToString(Text, *Path))
+	{
+		return false;
+	}
+
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+	return FJsonSerializer::Deserialize(Reader, OutObject) && OutObject.IsValid();
+}
+
+// Mods come from anywhere, so nothing they reference may leave their own folder
+static bool ResolveModPath(const FString& Directory, const FString& Relative, FString& OutPath)
+{
+	if (Relative.IsEmpty())
+	{
+		return false;
+	}
+
+	OutPath = FPaths::Combine(Directory, Relative);
+	FPaths::NormalizeFilename(OutPath);
+	return FPaths::CollapseRelativeDirectories(OutPath) && FPaths::IsUnderDirectory(OutPath, Directory);
+}
+
+static FLinearColor ReadColor(const FJsonObject& Object, const TCHAR* Field, const FLinearColor& Default)
+{
+	const TSharedPtr<FJsonObject>* ColorObject;
+	if (!Object.TryGetObjectField(Field, ColorObject))
+	{
+		return Default;
+	}
+
+	FLinearColor Color = Default;
+	(*ColorObject)->TryGetNumberField(TEXT("r"), Color.R);
+	(*ColorObject)->TryGetNumberField(TEXT("g"), Color.G);
+	(*ColorObject)->TryGetNumberField(TEXT("b"), Color.B);
+	(*ColorObject)->TryGetNumberField(TEXT("a"), Color.A);
+	return Color;
+}
+
+FString UVE_Mod_Subsystem::GetModsDirectory()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectDir(), TEXT("Mods")));
+}
+
+void UVE_Mod_Subsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Workshop items are mods like any other once they are downloaded and checked
+	USteamWorkshopModSubsystem* Workshop = Collection.InitializeDependency<USteamWorkshopModSubsystem>();
+	if (Workshop)
+	{
+		Workshop->OnModReady.AddDynamic(this, &UVE_Mod_Subsystem::OnWorkshopModReady);
+
+		TArray<FSteamWorkshopMod> WorkshopMods;
+		Workshop->GetMods(WorkshopMods);
+		for (const FSteamWorkshopMod& Mod : WorkshopMods)
+		{
+			if (Mod.State == ESteamWorkshopModState::Ready)
+			{
+				AddModDirectory(Mod.InstallFolder);
+			}
+		}
+	}
+}
+
+void UVE_Mod_Subsystem::Deinitialize()
+{
+	if (USteamWorkshopModSubsystem* Workshop = GetGameInstance()->GetSubsystem<USteamWorkshopModSubsystem>())
+	{
+		Workshop->OnModReady.RemoveDynamic(this, &UVE_Mod_Subsystem::OnWorkshopModReady);
+	}
+
+	// Work still out on the task graph comes back to a dead subsystem and is dropped
+	LoadSerial++;
+	StopTicking();
+	DecodedTextures.Empty();
+	QueuedDecodes.Empty();
+	PendingPackets.Empty();
+	UrgentPackets.Empty();
+	ModsByName.Empty();
+	Mods.Empty();
+
+	Super::Deinitialize();
+}
+
+void UVE_Mod_Subsystem::LoadMods()
+{
+	// Modules can only be loaded on the game thread, the decode tasks share this one
+	ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+
+	const uint32 Serial = ++LoadSerial;
+	StopTicking();
+	Mods.Reset();
+	ModsByName.Reset();
+	NumModsIndexed = 0;
+	bScanned = false;
+	PendingPackets.Reset();
+	UrgentPackets.Reset();
+	QueuedDecodes.Reset();
+	NextDecode = 0;
+	DecodesInFlight = 0;
+	DecodedTextures.Reset();
+	bLoading = true;
+
+	TWeakObjectPtr<UVE_Mod_Subsystem> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Serial]()
+	{
+		TArray<FString> ModDirectories;
+		IFileManager::Get().IterateDirectory(*GetModsDirectory(), [&ModDirectories](const TCHAR* Path, bool bIsDirectory)
+		{
+			if (bIsDirectory && FPaths::FileExists(FPaths::Combine(Path, TEXT("Mod.json"))))
+			{
+				ModDirectories.Add(Path);
+			}
+			return true;
+		});
+
+		// Same order on every machine, whatever order the file system lists them in
+		ModDirectories.Sort();
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, ModDirectories = MoveTemp(ModDirectories)]() mutable
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnScanned(Serial, MoveTemp(ModDirectories));
+			}
+		});
+	});
+}
+
+void UVE_Mod_Subsystem::OnScanned(uint32 Serial, TArray<FString>&& ModDirectories)
+{
+	if (Serial != LoadSerial)
+	{
+		return;
+	}
+
+	UE_LOG(LogVEMods, Log, TEXT("Found %d mods in %s"), ModDirectories.Num(), *GetModsDirectory());
+
+	// After the Mods folder, so its mods keep their names when a Workshop item reuses one
+	for (const FString& Directory : ExtraModDirectories)
+	{
+		ModDirectories.AddUnique(Directory);
+	}
+
+	bScanned = true;
+	Mods.SetNum(ModDirectories.Num());
+
+	if (ModDirectories.Num() == 0)
+	{
+		bLoading = false;
+		OnModsLoaded.Broadcast(0);
+		return;
+	}
+
+	// One task per mod, so a mod with many addons does not hold up the others
+	for (int32 ModIndex = 0; ModIndex < ModDirectories.Num(); ++ModIndex)
+	{
+		Mods[ModIndex].Directory = ModDirectories[ModIndex];
+		IndexMod(Serial, ModIndex);
+	}
+}
+
+void UVE_Mod_Subsystem::IndexMod(uint32 Serial, int32 ModIndex)
+{
+	TWeakObjectPtr<UVE_Mod_Subsystem> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Serial, ModIndex, Directory = Mods[ModIndex].Directory]()
+	{
+		FVE_Mod Mod;
+		Mod.Error = ParseModIndex(Directory, Mod);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, ModIndex, Mod = MoveTemp(Mod)]() mutable
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnIndexed(Serial, ModIndex, MoveTemp(Mod));
+			}
+		});
+	});
+}
+
+void UVE_Mod_Subsystem::AddModDirectory(const FString& Directory)
+{
+	FString FullPath = FPaths::ConvertRelativePathToFull(Directory);
+	FPaths::NormalizeDirectoryName(FullPath);
+	if (Directory.IsEmpty() || ExtraModDirectories.Contains(FullPath))
+	{
+		return;
+	}
+
+	ExtraModDirectories.Add(FullPath);
+
+	// Before the scan is back OnScanned picks it up, and with no load yet the next LoadMods does
+	if (!bScanned || Mods.ContainsByPredicate([&FullPath](const FVE_Mod& Mod) { return Mod.Directory == FullPath; }))
+	{
+		return;
+	}
+
+	// Appended, so the indices packets and decodes hold on to stay valid
+	const int32 ModIndex = Mods.AddDefaulted();
+	Mods[ModIndex].Directory = FullPath;
+	bLoading = true;
+	IndexMod(LoadSerial, ModIndex);
+}
+
+void UVE_Mod_Subsystem::OnWorkshopModReady(const FSteamWorkshopMod& Mod)
+{
+	AddModDirectory(Mod.InstallFolder);
+}
+
+FString UVE_Mod_Subsystem::ParseModIndex(const FString& Directory, FVE_Mod& OutMod)
+{
+	OutMod.Directory = Directory;
+
+	TSharedPtr<FJsonObject> Root;
+	if (!LoadJsonObject(FPaths::Combine(Directory, TEXT("Mod.json")), Root))
+	{
+		return TEXT("Mod.json could not be read or is not valid JSON");
+	}
+
+	const TSharedPtr<FJsonObject>* ModObject;
+	if (!Root->TryGetObjectField(TEXT("Mod"), ModObject))
+	{
+		return TEXT("Mod.json has no \"Mod\" object");
+	}
+
+	(*ModObject)->TryGetStringField(TEXT("mod Name"), OutMod.Name);
+	(*ModObject)->TryGetStringField(TEXT("mod Description"), OutMod.Description);
+	(*ModObject)->TryGetStringArrayField(TEXT("mod Dependencies"), OutMod.Dependencies);
+	if (OutMod.Name.IsEmpty())
+	{
+		OutMod.Name = FPaths::GetCleanFilename(Directory);
+	}
+
+	const TSharedPtr<FJsonObject>* VersionObject;
+	if ((*ModObject)->TryGetObjectField(TEXT("mod Version"), VersionObject))
+	{
+		(*VersionObject)->TryGetNumberField(TEXT("x"), OutMod.Version.X);
+		(*VersionObject)->TryGetNumberField(TEXT("y"), OutMod.Version.Y);
+		(*VersionObject)->TryGetNumberField(TEXT("z"), OutMod.Version.Z);
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* AddonPaths;
+	if (!(*ModObject)->TryGetArrayField(TEXT("addonPaths"), AddonPaths))
+	{
+		return FString();
+	}
+
+	for (const TSharedPtr<FJsonValue>& Value : *AddonPaths)
+	{
+		FString Relative;
+		FString AddonPath;
+		TSharedPtr<FJsonObject> Addon;
+		if (!Value->TryGetString(Relative) || !ResolveModPath(Directory, Relative, AddonPath) || !LoadJsonObject(AddonPath, Addon))
+		{
+			UE_LOG(LogVEMods, Warning, TEXT("%s: addon \"%s\" could not be loaded, skipping it"), *OutMod.Name, *Relative);
+			continue;
+		}
+
+		int32 Type = INDEX_NONE;
+		const TSharedPtr<FJsonObject>* PacketObject;
+		if (!Addon->TryGetNumberField(TEXT("Type"), Type) || Type != 0 || !Addon->TryGetObjectField(TEXT("Packet"), PacketObject))
+		{
+			FVE_ModAddon& Other = OutMod.OtherAddons.AddDefaulted_GetRef();
+			Other.Path = AddonPath;
+			Other.Type = Type;
+			continue;
+		}
+
+		// Only what a shop page lists, ParsePacket reads the rest when the packet is wanted
+		FVE_ModPacket& Packet = OutMod.Packets.AddDefaulted_GetRef();
+		Packet.AddonPath = AddonPath;
+		(*PacketObject)->TryGetStringField(TEXT("packetName"), Packet.PacketName);
+
+		FString IconRelative;
+		if ((*PacketObject)->TryGetStringField(TEXT("iconTexturePath"), IconRelative) && !IconRelative.IsEmpty())
+		{
+			ResolveModPath(Directory, IconRelative, Packet.IconTexturePath);
+		}
+	}
+
+	return FString();
+}
+
+void UVE_Mod_Subsystem::OnIndexed(uint32 Serial, int32 ModIndex, FVE_Mod&& Mod)
+{
+	if (Serial != LoadSerial)
+	{
+		return;
+	}
+
+	if (!Mod.Error.IsEmpty())
+	{
+		UE_LOG(LogVEMods, Warning, TEXT("%s: %s"), *Mod.Directory, *Mod.Error);
+	}
+
+	Mod.bLoaded = Mod.Error.IsEmpty();
+	Mods[ModIndex] = MoveTemp(Mod);
+	NumModsIndexed++;
+
+	const bool bAllIndexed = NumModsIndexed == Mods.Num();
+	if (bAllIndexed)
+	{
+		// Names are taken in folder order, so which of two mods with the same name wins does not depend on timing.
+		// Rebuilt from scratch, a mod added by AddModDirectory comes in after the others were named.
+		ModsByName.Reset();
+		for (int32 Index = 0; Index < Mods.Num(); ++Index)
+		{
+			if (!Mods[Index].bLoaded)
+			{
+				continue;
+			}
+			if (ModsByName.Contains(Mods[Index].Name))
+			{
+				UE_LOG(LogVEMods, Warning, TEXT("%s: another mod is already named %s, its packets cannot be found by name"), *Mods[Index].Directory, *Mods[Index].Name);
+				continue;
+			}
+			ModsByName.Add(Mods[Index].Name, Index);
+		}
+
+		for (const FVE_Mod& Indexed : Mods)
+		{
+			for (const FString& Dependency : Indexed.Dependencies)
+			{
+				if (!ModsByName.Contains(Dependency))
+				{
+					UE_LOG(LogVEMods, Warning, TEXT("%s: depends on %s, which is not installed"), *Indexed.Name, *Dependency);
+				}
+			}
+		}
+
+		bLoading = false;
+	}
+
+	// A handler starting a new load empties Mods, so the others get a copy
+	const FVE_Mod Loaded = Mods[ModIndex];
+	OnModLoaded.Broadcast(Loaded);
+
+	if (bAllIndexed && Serial == LoadSerial)
+	{
+		UE_LOG(LogVEMods, Log, TEXT("Indexed %d mods"), NumModsIndexed);
+		OnModsLoaded.Broadcast(NumModsIndexed);
+	}
+}
+
+int32 UVE_Mod_Subsystem::FindMod(const FString& ModName) const
+{
+	const int32* ModIndex = ModsByName.Find(ModName);
+	return ModIndex ? *ModIndex : INDEX_NONE;
+}
+
+bool UVE_Mod_Subsystem::GetPacket(const FString& ModName, const FString& PacketName, FVE_ModPacket& OutPacket)
+{
+	const int32 ModIndex = FindMod(ModName);
+	const int32 PacketIndex = ModIndex != INDEX_NONE
+		? Mods[ModIndex].Packets.IndexOfByPredicate([&PacketName](const FVE_ModPacket& Packet) { return Packet.PacketName == PacketName; })
+		: INDEX_NONE;
+	if (PacketIndex == INDEX_NONE)
+	{
+		if (!bLoading)
+		{
+			UE_LOG(LogVEMods, Warning, TEXT("No packet %s in mod %s"), *PacketName, *ModName);
+		}
+		return false;
+	}
+
+	const FVE_ModPacket& Packet = Mods[ModIndex].Packets[PacketIndex];
+	if (Packet.bLoaded)
+	{
+		OutPacket = Packet;
+		return true;
+	}
+
+	RequestPacket(ModIndex, PacketIndex, true);
+	return false;
+}
+
+void UVE_Mod_Subsystem::PrefetchMods(const TArray<FString>& ModNames)
+{
+	TSet<int32> Visited;
+	for (const FString& ModName : ModNames)
+	{
+		const int32 ModIndex = FindMod(ModName);
+		if (ModIndex != INDEX_NONE)
+		{
+			PrefetchMod(ModIndex, Visited);
+		}
+	}
+}
+
+void UVE_Mod_Subsystem::PrefetchMod(int32 ModIndex, TSet<int32>& Visited)
+{
+	// Visited also stops dependency cycles
+	bool bAlreadyVisited = false;
+	Visited.Add(ModIndex, &bAlreadyVisited);
+	if (bAlreadyVisited)
+	{
+		return;
+	}
+
+	for (int32 PacketIndex = 0; PacketIndex < Mods[ModIndex].Packets.Num(); ++PacketIndex)
+	{
+		RequestPacket(ModIndex, PacketIndex, false);
+	}
+
+	for (const FString& Dependency : Mods[ModIndex].Dependencies)
+	{
+		const int32 DependencyIndex = FindMod(Dependency);
+		if (DependencyIndex != INDEX_NONE)
+		{
+			PrefetchMod(DependencyIndex, Visited);
+		}
+	}
+}
+
+void UVE_Mod_Subsystem::RequestPacket(int32 ModIndex, int32 PacketIndex, bool bUrgent)
+{
+	const FIntPoint Key(ModIndex, PacketIndex);
+	if (Mods[ModIndex].Packets[PacketIndex].bLoaded)
+	{
+		return;
+	}
+
+	if (const int32* Pending = PendingPackets.Find(Key))
+	{
+		if (!bUrgent)
+		{
+			return;
+		}
+
+		if (*Pending == INDEX_NONE)
+		{
+			// Still parsing, its decodes go to the front once it is
+			UrgentPackets.Add(Key);
+			return;
+		}
+
+		// Prefetched earlier, move whatever it has not started decoding ahead of the rest
+		int32 Front = NextDecode;
+		for (int32 Index = NextDecode; Index < QueuedDecodes.Num(); ++Index)
+		{
+			if (QueuedDecodes[Index].Mod == ModIndex && QueuedDecodes[Index].Packet == PacketIndex)
+			{
+				FTextureRequest Request = MoveTemp(QueuedDecodes[Index]);
+				QueuedDecodes.RemoveAt(Index, 1, EAllowShrinking::No);
+				QueuedDecodes.Insert(MoveTemp(Request), Front++);
+			}
+		}
+		return;
+	}
+
+	PendingPackets.Add(Key, INDEX_NONE);
+	if (bUrgent)
+	{
+		UrgentPackets.Add(Key);
+	}
+
+	TWeakObjectPtr<UVE_Mod_Subsystem> WeakThis(this);
+	const uint32 Serial = LoadSerial;
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Serial, ModIndex, PacketIndex, Directory = Mods[ModIndex].Directory, Packet = Mods[ModIndex].Packets[PacketIndex]]() mutable
+	{
+		TArray<FTextureRequest> Textures;
+		const FString Error = ParsePacket(Directory, Packet, Textures);
+		if (!Error.IsEmpty())
+		{
+			UE_LOG(LogVEMods, Warning, TEXT("%s: %s"), *Packet.AddonPath, *Error);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, ModIndex, PacketIndex, Packet = MoveTemp(Packet), Textures = MoveTemp(Textures)]() mutable
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnPacketParsed(Serial, ModIndex, PacketIndex, MoveTemp(Packet), MoveTemp(Textures));
+			}
+		});
+	});
+}
+
+FString UVE_Mod_Subsystem::ParsePacket(const FString& Directory, FVE_ModPacket& Packet, TArray<FTextureRequest>& OutTextures)
+{
+	TSharedPtr<FJsonObject> Addon;
+	const TSharedPtr<FJsonObject>* PacketObject;
+	if (!LoadJsonObject(Packet.AddonPath, Addon) || !Addon->TryGetObjectField(TEXT("Packet"), PacketObject))
+	{
+		return TEXT("the addon could not be read, or changed after the mods were indexed");
+	}
+
+	const FJsonObject& PacketJson = **PacketObject;
+	PacketJson.TryGetNumberField(TEXT("falloff"), Packet.Falloff);
+	PacketJson.TryGetNumberField(TEXT("uV"), Packet.UV);
+	Packet.ChannelColor = ReadColor(PacketJson, TEXT("channelColor"), Packet.ChannelColor);
+	Packet.Extras = ReadColor(PacketJson, TEXT("extras"), Packet.Extras);
+	Packet.PacketLeafColor = ReadColor(PacketJson, TEXT("packetLeafColor"), Packet.PacketLeafColor);
+
+	const TPair<const TCHAR*, ETextureSlot> TextureFields[] = {
+		{ TEXT("colorTexturePath"), ETextureSlot::Color },
+		{ TEXT("normalTexturePath"), ETextureSlot::Normal },
+		{ TEXT("iconTexturePath"), ETextureSlot::Icon }
+	};
+	for (const TPair<const TCHAR*, ETextureSlot>& Field : TextureFields)
+	{
+		FString TextureRelative;
+		FString TexturePath;
+		if (!PacketJson.TryGetStringField(Field.Key, TextureRelative) || TextureRelative.IsEmpty())
+		{
+			continue;
+		}
+		if (!ResolveModPath(Directory, TextureRelative, TexturePath))
+		{
+			UE_LOG(LogVEMods, Warning, TEXT("%s: texture \"%s\" is outside the mod folder, skipping it"), *Packet.AddonPath, *TextureRelative);
+			continue;
+		}
+
+		switch (Field.Value)
+		{
+		case ETextureSlot::Color: Packet.ColorTexturePath = TexturePath; break;
+		case ETextureSlot::Normal: Packet.NormalTexturePath = TexturePath; break;
+		case ETextureSlot::Icon: Packet.IconTexturePath = TexturePath; break;
+		}
+
+		FTextureRequest& Request = OutTextures.AddDefaulted_GetRef();
+		Request.Slot = Field.Value;
+		Request.Path = TexturePath;
+	}
+
+	return FString();
+}
+
+void UVE_Mod_Subsystem::OnPacketParsed(uint32 Serial, int32 ModIndex, int32 PacketIndex, FVE_ModPacket&& Packet, TArray<FTextureRequest>&& Textures)
+{
+	if (Serial != LoadSerial)
+	{
+		return;
+	}
+
+	const FIntPoint Key(ModIndex, PacketIndex);
+	Mods[ModIndex].Packets[PacketIndex] = MoveTemp(Packet);
+	PendingPackets[Key] = Textures.Num();
+
+	if (Textures.Num() == 0)
+	{
+		UrgentPackets.Remove(Key);
+		FinishPacket(ModIndex, PacketIndex);
+		return;
+	}
+
+	int32 Front = NextDecode;
+	const bool bUrgent = UrgentPackets.Remove(Key) > 0;
+	for (FTextureRequest& Request : Textures)
+	{
+		Request.Mod = ModIndex;
+		Request.Packet = PacketIndex;
+		if (bUrgent)
+		{
+			QueuedDecodes.Insert(MoveTemp(Request), Front++);
+		}
+		else
+		{
+			QueuedDecodes.Add(MoveTemp(Request));
+		}
+	}
+
+	EnsureTicking();
+	LaunchDecodes();
+}
+
+void UVE_Mod_Subsystem::LaunchDecodes()
+{
+	TWeakObjectPtr<UVE_Mod_Subsystem> WeakThis(this);
+	const uint32 Serial = LoadSerial;
+	IImageWrapperModule* Module = ImageWrapperModule;
+
+	while (DecodesInFlight < MaxDecodesInFlight && NextDecode < QueuedDecodes.Num())
+	{
+		DecodesInFlight++;
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Serial, Module, Request = MoveTemp(QueuedDecodes[NextDecode++])]() mutable
+		{
+			FDecodedTexture Decoded;
+			Decoded.Request = MoveTemp(Request);
+			if (!FVE_ModTextureCache::Load(*Module, Decoded.Request.Path, Decoded.Request.Slot == ETextureSlot::Normal, Decoded.Texture))
+			{
+				Decoded.Texture.Reset();
+			}
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, Decoded = MoveTemp(Decoded)]() mutable
+			{
+				if (WeakThis.IsValid())
+				{
+					WeakThis->OnDecoded(Serial, MoveTemp(Decoded));
+				}
+			});
+		});
+	}
+
+	if (NextDecode == QueuedDecodes.Num())
+	{
+		QueuedDecodes.Reset();
+		NextDecode = 0;
+	}
+}
+
+void UVE_Mod_Subsystem::OnDecoded(uint32 Serial, FDecodedTexture&& Decoded)
+{
+	if (Serial != LoadSerial)
+	{
+		return;
+	}
+	DecodedTextures.Add(MoveTemp(Decoded));
+}
+
+void UVE_Mod_Subsystem::EnsureTicking()
+{
+	if (!TickHandle.IsValid())
+	{
+		TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::Tick));
+	}
+}
+
+bool UVE_Mod_Subsystem::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_VE_Mod_Subsystem_Tick);
+
+	const uint32 Serial = LoadSerial;
+	const double Deadline = FPlatformTime::Seconds() + UploadBudgetMs / 1000.0;
+
+	int32 NumUploaded = 0;
+	while (NumUploaded < DecodedTextures.Num())
+	{
+		UploadTexture(DecodedTextures[NumUploaded++]);
+
+		// OnPacketLoaded may have started a new load, which already threw these away
+		if (Serial != LoadSerial)
+		{
+			return TickHandle.IsValid();
+		}
+		if (FPlatformTime::Seconds() >= Deadline)
+		{
+			break;
+		}
+	}
+	DecodedTextures.RemoveAt(0, NumUploaded, EAllowShrinking::No);
+
+	// Uploading freed room for more decodes
+	LaunchDecodes();
+
+	// Nothing queued or out on a worker, the next packet request starts ticking again
+	if (DecodesInFlight == 0 && QueuedDecodes.Num() == 0)
+	{
+		TickHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+void UVE_Mod_Subsystem::UploadTexture(FDecodedTexture& Decoded)
+{
+	DecodesInFlight--;
+
+	const FTextureRequest& Request = Decoded.Request;
+	FVE_ModPacket& Packet = Mods[Request.Mod].Packets[Request.Packet];
+
+	// Normal maps hold vectors, not colors
+	UTexture2D* Texture = FVE_ModTextureCache::CreateTexture(Decoded.Texture, Request.Slot != ETextureSlot::Normal);
+	if (Texture)
+	{
+		switch (Request.Slot)
+		{
+		case ETextureSlot::Color: Packet.ColorTexture = Texture; break;
+		case ETextureSlot::Normal: Packet.NormalTexture = Texture; break;
+		case ETextureSlot::Icon: Packet.IconTexture = Texture; break;
+		}
+	}
+	else
+	{
+		UE_LOG(LogVEMods, Warning, TEXT("%s: %s could not be decoded"), *Mods[Request.Mod].Name, *Request.Path);
+	}
+
+	// Done with the mips whether or not they made it into a texture, this also unmaps the cache file
+	Decoded.Texture.Reset();
+
+	int32& Pending = PendingPackets.FindChecked(FIntPoint(Request.Mod, Request.Packet));
+	if (--Pending == 0)
+	{
+		FinishPacket(Request.Mod, Request.Packet);
+	}
+}
+
+void UVE_Mod_Subsystem::FinishPacket(int32 ModIndex, int32 PacketIndex)
+{
+	PendingPackets.Remove(FIntPoint(ModIndex, PacketIndex));
+
+	FVE_ModPacket& Packet = Mods[ModIndex].Packets[PacketIndex];
+	Packet.bLoaded = true;
+
+	// A handler starting a new load empties Mods, so the others get a copy
+	const FString ModName = Mods[ModIndex].Name;
+	const FVE_ModPacket Loaded = Packet;
+	OnPacketLoaded.Broadcast(ModName, Loaded);
+}
+
+void UVE_Mod_Subsystem::StopTicking()
+{
+	if (TickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		TickHandle.Reset();
+	}
+	bLoading = false;
+}
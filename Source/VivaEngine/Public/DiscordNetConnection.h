@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IpConnection.h"
+#include "DiscordNetConnection.generated.h"
+
+/**
+ * Connection used by UDiscordNetDriver. Picks the lobby channel for each packet.
+ */
+UCLASS(transient, config = Engine)
+class VIVAENGINE_API UDiscordNetConnection : public UIpConnection
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits) override;
+};
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IpNetDriver.h"
+#include "DiscordNetDriver.generated.h"
+
+class FSocketDiscord;
+class FSocketSubsystemDiscord;
+namespace discord { class Core; }
+
+/**
+ * Net driver that carries game traffic over Discord lobby networking.
+ * Registered as the "DiscordNetDriver" definition in DefaultEngine.ini, while GameNetDriver stays on Steam. To play over a
+ * Discord lobby, call SetGameNetDriverToDiscord(true), then host with "?listen?DiscordLobby=<LobbyId>" or travel to
+ * GetDiscordLobbyTravelURL. Any other URL passes through to plain IP, so the driver is safe to use as the GameNetDriver.
+ * Packets are queued during the frame and sent with a single FlushNetwork in TickFlush.
+ */
+UCLASS(transient, config = Engine)
+class VIVAENGINE_API UDiscordNetDriver : public UIpNetDriver
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool IsAvailable() const override { return true; }
+	virtual ISocketSubsystem* GetSocketSubsystem() override;
+	virtual bool InitConnect(FNetworkNotify* InNotify, const FURL& ConnectURL, FString& Error) override;
+	virtual bool InitListen(FNetworkNotify* InNotify, FURL& LocalURL, bool bReuseAddressAndPort, FString& Error) override;
+	virtual void TickFlush(float DeltaSeconds) override;
+	virtual void LowLevelSend(TSharedPtr<const FInternetAddr> Address, void* Data, int32 CountBits, FOutPacketTraits& Traits) override;
+
+	//Null when this driver is passing through to IP
+	FSocketDiscord* GetDiscordSocket();
+
+	//Address of the owner of a lobby the local user has joined, to pass to ClientTravel/OpenLevel
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "VivaEngine", meta = (WorldContext = "WorldContextObject"))
+	static FString GetDiscordLobbyTravelURL(UObject* WorldContextObject, int64 LobbyId);
+
+	//Points the GameNetDriver definition at this driver, or back at the configured one, for the next listen or travel.
+	//Drivers that already exist are not affected. False when either definition is missing from the config.
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	static bool SetGameNetDriverToDiscord(bool bUseDiscord);
+
+private:
+
+	discord::Core* GetDiscordCore() const;
+
+	TSharedPtr<FSocketSubsystemDiscord> DiscordSockets;
+	bool bIsPassthrough = true;
+};
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "VE_CloudSave_Subsystem.generated.h"
+
+class USaveGame;
+namespace discord { class Core; }
+
+/**
+ * Where garden saves go. Discord storage is synced to the user's Discord account, so it follows them between machines.
+ */
+UENUM(BlueprintType)
+enum class EVE_SaveBackend : uint8
+{
+	LocalSlot,
+	DiscordStorage,
+	//Writes both, loads the local slot and falls back to Discord when it is missing
+	LocalAndDiscord
+};
+
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FVE_OnCloudSaved, const FString&, SlotName, bool, bSuccess);
+DECLARE_DYNAMIC_DELEGATE_ThreeParams(FVE_OnCloudLoaded, const FString&, SlotName, USaveGame*, SaveGame, bool, bSuccess);
+
+//One chunk of a mirrored save, stored in Discord as "<Slot>.<Hash>.chunk"
+struct FVE_CloudSaveChunk
+{
+	uint64 Hash = 0;
+	int32 RawSize = 0;
+	//Equal to RawSize when the chunk did not compress and is stored as is
+	int32 StoredSize = 0;
+};
+
+//Stored as "<Slot>.manifest" and written last, so a save only becomes visible once all its chunks are uploaded
+struct FVE_CloudSaveManifest
+{
+	int32 ChunkSize = 0;
+	int64 TotalSize = 0;
+	TArray<FVE_CloudSaveChunk> Chunks;
+};
+
+struct FVE_CloudSaveJob;
+struct FVE_CloudSaveUpload;
+struct FVE_CloudReadJob;
+
+/**
+ * Mirrors SaveGame slots to Discord storage.
+ * Saves are split into fixed size chunks which are hashed and compressed off the game thread. Chunks are
+ * content addressed, so chunks that already exist in storage are never uploaded again.
+ */
+UCLASS()
+class VIVAENGINE_API UVE_CloudSave_Subsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static constexpr int32 ChunkSize = 64 * 1024;
+	static constexpr int32 MaxInFlightRequests = 4;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VivaEngine")
+	EVE_SaveBackend Backend = EVE_SaveBackend::LocalSlot;
+
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	void SaveToSlot(USaveGame* SaveGameObject, const FString& SlotName, int32 UserIndex, FVE_OnCloudSaved OnSaved);
+
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	void LoadFromSlot(const FString& SlotName, int32 UserIndex, FVE_OnCloudLoaded OnLoaded);
+
+	//Slots that have a complete save in Discord storage
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "VivaEngine")
+	TArray<FString> GetDiscordSlotNames() const;
+
+	//Reads Length bytes at Offset of a mirrored save. Only the chunks overlapping the range are fetched.
+	void ReadDiscordRange(const FString& SlotName, int64 Offset, int64 Length, TFunction<void(bool bSuccess, TArray<uint8>&& Data)> OnRead);
+
+private:
+
+	discord::Core* GetDiscordCore() const;
+
+	void SaveToDiscord(const FString& SlotName, TSharedRef<const TArray<uint8>> Bytes, TFunction<void(bool)> OnDone);
+	void LoadFromDiscord(const FString& SlotName, FVE_OnCloudLoaded OnLoaded);
+
+	void StartDiscordSave(TSharedRef<FVE_CloudSaveJob> Job);
+	void PumpUpload(TSharedRef<FVE_CloudSaveJob> Job, TSharedRef<FVE_CloudSaveUpload> Upload);
+	void FinishDiscordSave(TSharedRef<FVE_CloudSaveJob> Job, bool bSuccess);
+	void DeleteUnreferencedChunks(const FString& SlotName, const FVE_CloudSaveManifest& Manifest);
+	//Runs the slot's pending cleanup once no save or read of it is in flight
+	void TryDeleteUnreferencedChunks(const FString& SlotName);
+	TMap<uint64, int32> ListStoredChunks(const FString& SlotName) const;
+
+	void PumpRead(TSharedRef<FVE_CloudReadJob> Job);
+	void EndRead(const FString& SlotName);
+
+	//Slots with an upload in flight, and the newest save waiting behind each of them
+	TSet<FString> ActiveSaves;
+	TMap<FString, TSharedRef<FVE_CloudSaveJob>> PendingSaves;
+
+	//Reads in flight per slot, they may still need chunks of the manifest they started with
+	TMap<FString, int32> ActiveReads;
+	//The newest committed manifest of each slot whose dropped chunks are not deleted yet
+	TMap<FString, FVE_CloudSaveManifest> PendingCleanups;
+};
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "RHI.h"
+#include "Styling/SlateBrush.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "VE_DiscordAvatar_Subsystem.generated.h"
+
+class UTexture2D;
+namespace discord { class Core; class ImageHandle; enum class Result; }
+
+//Where an avatar lives in the shared atlas
+USTRUCT(BlueprintType)
+struct FVE_AvatarTile
+{
+	GENERATED_BODY()
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	TObjectPtr<UTexture2D> Atlas = nullptr;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FVector2D UVMin = FVector2D::ZeroVector;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FVector2D UVMax = FVector2D::ZeroVector;
+};
+
+DECLARE_DYNAMIC_DELEGATE_ThreeParams(FVE_OnAvatarReady, int64, UserId, FVE_AvatarTile, Tile, bool, bSuccess);
+
+/**
+ * Fetches Discord avatars and packs them into one shared atlas texture of fixed size tiles.
+ * Every RequestAvatar must be paired with a ReleaseAvatar. Released avatars stay cached until their tile is
+ * needed for another avatar, least recently used first. Concurrent requests for the same user share one fetch.
+ */
+UCLASS()
+class VIVAENGINE_API UVE_DiscordAvatar_Subsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static constexpr int32 AtlasSize = 1024;
+	static constexpr int32 TileSize = 128;
+	static constexpr int32 TilesPerRow = AtlasSize / TileSize;
+	static constexpr int32 NumTiles = TilesPerRow * TilesPerRow;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	void RequestAvatar(int64 UserId, FVE_OnAvatarReady OnReady);
+
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	void ReleaseAvatar(int64 UserId);
+
+	//Returns false when the avatar is not loaded (yet)
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	bool FindAvatar(int64 UserId, FVE_AvatarTile& Tile);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "VivaEngine")
+	static FSlateBrush MakeAvatarBrush(const FVE_AvatarTile& Tile, FVector2D ImageSize);
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "VivaEngine")
+	TObjectPtr<UTexture2D> Atlas = nullptr;
+
+private:
+
+	struct FAvatarEntry
+	{
+		int32 Tile = INDEX_NONE;
+		int32 Refs = 0;
+		bool bFetching = false;
+		TArray<FVE_OnAvatarReady, TInlineAllocator<1>> Waiters;
+	};
+
+	//Tiles form an intrusive LRU list, most recently used at the head
+	struct FTile
+	{
+		int64 UserId = 0;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+	};
+
+	discord::Core* GetDiscordCore() const;
+	void OnFetched(int64 UserId, discord::Result Result, const discord::ImageHandle& Handle);
+	bool CopyIntoTile(discord::Core* Core, const discord::ImageHandle& Handle, int32 Tile);
+	int32 AcquireTile(int64 UserId);
+	void FreeTile(int32 Tile);
+	void Unlink(int32 Tile);
+	void LinkAtHead(int32 Tile);
+	void LinkAtTail(int32 Tile);
+	FVE_AvatarTile MakeTile(int32 Tile) const;
+
+	TMap<int64, FAvatarEntry> Entries;
+	TArray<FTile> Tiles;
+	int32 Head = INDEX_NONE;
+	int32 Tail = INDEX_NONE;
+
+	//One staging area and region per tile, so uploads never allocate. A tile is only rewritten once
+	//the render thread has finished reading its staging area.
+	TArray<uint8> Staging;
+	TArray<FUpdateTextureRegion2D> Regions;
+	TArray<FThreadSafeCounter> PendingUploads;
+	TArray<uint8> Scratch;
+};
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "VE_Discord_Subsystem.generated.h"
+
+class FDiscordLogBuffer;
+namespace discord { class Core; }
+
+DECLARE_LOG_CATEGORY_EXTERN(LogDiscord, Log, All);
+
+/**
+ * Owns the game's single discord::Core and runs its callbacks every frame.
+ * Everything that talks to Discord gets the core from here instead of creating its own.
+ * SDK log output is forwarded to LogDiscord, "Viva.DiscordLog" prints the most recent lines.
+ */
+UCLASS()
+class VIVAENGINE_API UVE_Discord_Subsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVE_Discord_Subsystem();
+	virtual ~UVE_Discord_Subsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override { return Core != nullptr; }
+	virtual bool IsTickableWhenPaused() const override { return true; }
+
+	//Null when Discord is not running
+	discord::Core* GetCore() const { return Core; }
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "VivaEngine")
+	bool IsDiscordAvailable() const { return Core != nullptr; }
+
+	//Oldest first
+	void DumpRecentLog(FOutputDevice& Ar) const;
+
+private:
+
+	void DrainLog();
+
+	discord::Core* Core = nullptr;
+
+	//Filled by the SDK log hook, drained every tick
+	TUniquePtr<FDiscordLogBuffer> LogBuffer;
+	TArray<FString> RecentLog;
+	int32 RecentLogNext = 0;
+	double LogWindowStart = 0.0;
+	int32 LogLinesInWindow = 0;
+	int32 SuppressedLogLines = 0;
+};
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PixelFormat.h"
+
+class IImageWrapperModule;
+class IMappedFileHandle;
+class IMappedFileRegion;
+class UTexture2D;
+
+struct FVE_ModTextureMip
+{
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	//Where the mip starts in the texture's data
+	int64 Offset = 0;
+	int64 Size = 0;
+};
+
+//A mod texture ready to upload. Its mips live either in Data or in a read only mapping of the cache file.
+struct VIVAENGINE_API FVE_CachedTexture
+{
+	FVE_CachedTexture();
+	FVE_CachedTexture(FVE_CachedTexture&&);
+	FVE_CachedTexture& operator=(FVE_CachedTexture&&);
+	~FVE_CachedTexture();
+
+	EPixelFormat Format = PF_Unknown;
+	TArray<FVE_ModTextureMip, TInlineAllocator<14>> Mips;
+
+	TArray64<uint8> Data;
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	bool IsValid() const { return Mips.Num() > 0; }
+	const uint8* GetMipData(int32 MipIndex) const;
+
+	//Unmaps the cache file and frees the mips, once they are in a texture
+	void Reset();
+};
+
+/**
+ * Content addressed disk cache of mod textures, keyed by the hash of the image file.
+ * A miss decodes the image, builds the full mip chain and block compresses it (BC1, or BC3 with alpha) before writing it
+ * to Saved/ModTextureCache. A hit maps the cache file and the texture is created straight from the mapping, so later
+ * launches skip decoding, and the compressed textures take a fraction of the video memory of BGRA8 ones.
+ * Normal maps keep BGRA8 mips, BC1 would visibly band them.
+ */
+class VIVAENGINE_API FVE_ModTextureCache
+{
+public:
+
+	static constexpr uint32 Magic = 0x4354564D;
+	static constexpr int32 Version = 1;
+
+	static FString GetCacheDirectory();
+
+	//Runs on a worker. Fills Out from the cache, or decodes ImagePath and caches the result first.
+	static bool Load(IImageWrapperModule& ImageWrapperModule, const FString& ImagePath, bool bNormalMap, FVE_CachedTexture& Out);
+
+	//Game thread only
+	static UTexture2D* CreateTexture(const FVE_CachedTexture& Cached, bool bSRGB);
+
+private:
+
+	static bool ReadCacheFile(const FString& CachePath, FVE_CachedTexture& Out);
+	static bool WriteCacheFile(const FString& CachePath, const FVE_CachedTexture& Texture);
+	static bool Build(IImageWrapperModule& ImageWrapperModule, const TArray<uint8>& Compressed, bool bBlockCompress, FVE_CachedTexture& Out);
+};
@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "SteamWorkshopModSubsystem.h"
+#include "VE_ModTextureCache.h"
+#include "VE_Mod_Subsystem.generated.h"
+
+class IImageWrapperModule;
+class UTexture2D;
+
+USTRUCT(BlueprintType)
+struct FVE_ModVersion
+{
+	GENERATED_BODY()
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	int32 X = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	int32 Y = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	int32 Z = 0;
+};
+
+//An addon of a type this loader does not know, left to the Blueprint loaders
+USTRUCT(BlueprintType)
+struct FVE_ModAddon
+{
+	GENERATED_BODY()
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FString Path;
+	//INDEX_NONE when the addon has no "Type"
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	int32 Type = INDEX_NONE;
+};
+
+//A grass packet addon, "Type": 0 with a "Packet" object. Texture paths are absolute, empty when the addon has none.
+//PacketName, AddonPath and IconTexturePath come from the index, everything else is filled in once the packet is loaded.
+USTRUCT(BlueprintType)
+struct FVE_ModPacket
+{
+	GENERATED_BODY()
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FString PacketName;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FString AddonPath;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FString ColorTexturePath;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FString NormalTexturePath;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FString IconTexturePath;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	float Falloff = 0.0f;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	float UV = 1.0f;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FLinearColor ChannelColor = FLinearColor::Black;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FLinearColor Extras = FLinearColor::Transparent;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FLinearColor PacketLeafColor = FLinearColor::White;
+
+	//Set once uploaded, stays null when the path is empty or the image could not be decoded
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "VivaEngine")
+	TObjectPtr<UTexture2D> ColorTexture = nullptr;
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "VivaEngine")
+	TObjectPtr<UTexture2D> NormalTexture = nullptr;
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "VivaEngine")
+	TObjectPtr<UTexture2D> IconTexture = nullptr;
+
+	//Addon parsed and every texture uploaded
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	bool bLoaded = false;
+};
+
+USTRUCT(BlueprintType)
+struct FVE_Mod
+{
+	GENERATED_BODY()
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FString Name;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FVE_ModVersion Version;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FString Description;
+	//The folder holding Mod.json, addon and texture paths are relative to it
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FString Directory;
+	//Names of the mods this one needs, from "mod Dependencies"
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	TArray<FString> Dependencies;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	TArray<FVE_ModPacket> Packets;
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	TArray<FVE_ModAddon> OtherAddons;
+	//Mod.json and its addons are indexed, the packets themselves load on demand
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	bool bLoaded = false;
+	//Why Mod.json could not be used, empty otherwise. Broken addons and textures are logged and skipped.
+	UPROPERTY(BlueprintReadOnly, Category = "VivaEngine")
+	FString Error;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FVE_OnModLoaded, const FVE_Mod&, Mod);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FVE_OnModsLoaded, int32, NumMods);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FVE_OnModPacketLoaded, const FString&, ModName, const FVE_ModPacket&, Packet);
+
+/**
+ * Indexes every mod in the project's Mods folder and in the folders given to AddModDirectory without holding up the game
+ * thread, and loads packets on demand. Workshop items are added as USteamWorkshopModSubsystem reports them ready.
+ * The folder is scanned on a worker and each Mod.json and its addon JSON files are indexed on their own task, keeping
+ * only names, types, icon paths and dependencies. A packet's full data and textures load the first time GetPacket asks
+ * for it, or when PrefetchMods is called for its mod. Textures are read through FVE_ModTextureCache on workers with at
+ * most MaxDecodesInFlight waiting at a time, and created on the game thread in batches that stop once UploadBudgetMs is
+ * spent for the frame. Nothing in C++ calls LoadMods, GetPacket or PrefetchMods, the game's Blueprints decide when.
+ */
+UCLASS()
+class VIVAENGINE_API UVE_Mod_Subsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static constexpr int32 MaxDecodesInFlight = 8;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	//Game thread time spent creating textures per frame, at least one is created every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VivaEngine")
+	float UploadBudgetMs = 4.0f;
+
+	//A mod is indexed, or its Mod.json failed
+	UPROPERTY(BlueprintAssignable, Category = "VivaEngine")
+	FVE_OnModLoaded OnModLoaded;
+
+	//Every mod is indexed
+	UPROPERTY(BlueprintAssignable, Category = "VivaEngine")
+	FVE_OnModsLoaded OnModsLoaded;
+
+	//A packet's data and textures are loaded, textures that failed are logged and left null
+	UPROPERTY(BlueprintAssignable, Category = "VivaEngine")
+	FVE_OnModPacketLoaded OnPacketLoaded;
+
+	//Starts over with a new index, anything a previous load is still doing is discarded
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	void LoadMods();
+
+	//A folder holding one mod's Mod.json outside the Mods folder, included by every LoadMods from now on. After the
+	//Mods folder has been scanned it is indexed on its own, OnModLoaded and OnModsLoaded fire again once it is.
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	void AddModDirectory(const FString& Directory);
+
+	//Still indexing
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "VivaEngine")
+	bool IsLoading() const { return bLoading; }
+
+	//True with the packet once it is loaded. Otherwise the first call starts loading it ahead of anything prefetched,
+	//and OnPacketLoaded fires when it is ready. False for a packet the index does not have.
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	bool GetPacket(const FString& ModName, const FString& PacketName, FVE_ModPacket& OutPacket);
+
+	//For a shop page about to open, loads every packet of these mods and of the mods they depend on in the background
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	void PrefetchMods(const TArray<FString>& ModNames);
+
+	UFUNCTION(BlueprintCallable, Category = "VivaEngine")
+	void GetMods(TArray<FVE_Mod>& OutMods) const { OutMods = Mods; }
+
+	static FString GetModsDirectory();
+
+private:
+
+	enum class ETextureSlot : uint8
+	{
+		Color,
+		Normal,
+		Icon
+	};
+
+	struct FTextureRequest
+	{
+		int32 Mod = 0;
+		int32 Packet = 0;
+		ETextureSlot Slot = ETextureSlot::Color;
+		FString Path;
+	};
+
+	struct FDecodedTexture
+	{
+		FTextureRequest Request;
+		//Invalid when the image could not be decoded
+		FVE_CachedTexture Texture;
+	};
+
+	void OnScanned(uint32 Serial, TArray<FString>&& ModDirectories);
+	void IndexMod(uint32 Serial, int32 ModIndex);
+	UFUNCTION()
+	void OnWorkshopModReady(const FSteamWorkshopMod& Mod);
+	void OnIndexed(uint32 Serial, int32 ModIndex, FVE_Mod&& Mod);
+	void OnPacketParsed(uint32 Serial, int32 ModIndex, int32 PacketIndex, FVE_ModPacket&& Packet, TArray<FTextureRequest>&& Textures);
+	void OnDecoded(uint32 Serial, FDecodedTexture&& Decoded);
+
+	//Urgent requests go ahead of every queued decode
+	void RequestPacket(int32 ModIndex, int32 PacketIndex, bool bUrgent);
+	void PrefetchMod(int32 ModIndex, TSet<int32>& Visited);
+	int32 FindMod(const FString& ModName) const;
+
+	bool Tick(float DeltaTime);
+	void EnsureTicking();
+	void LaunchDecodes();
+	void UploadTexture(FDecodedTexture& Decoded);
+	void FinishPacket(int32 ModIndex, int32 PacketIndex);
+	void StopTicking();
+
+	//Run on workers. ParseModIndex reads only what the index keeps, ParsePacket fills the rest of one packet.
+	static FString ParseModIndex(const FString& Directory, FVE_Mod& OutMod);
+	static FString ParsePacket(const FString& Directory, FVE_ModPacket& Packet, TArray<FTextureRequest>& OutTextures);
+
+	UPROPERTY(Transient)
+	TArray<FVE_Mod> Mods;
+
+	TMap<FString, int32> ModsByName;
+	int32 NumModsIndexed = 0;
+
+	//From AddModDirectory, full paths in the order they were added
+	TArray<FString> ExtraModDirectories;
+	//The Mods folder scan of the current load is back, so Mods has a slot for every directory known so far
+	bool bScanned = false;
+
+	//Packets being loaded, keyed by (mod, packet), with the textures each still waits for. INDEX_NONE until parsed.
+	TMap<FIntPoint, int32> PendingPackets;
+	//Asked for by GetPacket while still parsing, their textures skip the queue
+	TSet<FIntPoint> UrgentPackets;
+
+	TArray<FTextureRequest> QueuedDecodes;
+	int32 NextDecode = 0;
+	//Launched and not yet uploaded, bounds the memory held by decoded images
+	int32 DecodesInFlight = 0;
+	TArray<FDecodedTexture> DecodedTextures;
+
+	IImageWrapperModule* ImageWrapperModule = nullptr;
+
+	//Bumped by every LoadMods, so work from an earlier load is ignored when it comes back
+	uint32 LoadSerial = 0;
+	bool bLoading = false;
+	FTSTicker::FDelegateHandle TickHandle;
+};
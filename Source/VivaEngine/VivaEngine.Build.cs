@@ -1,6 +1,7 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 using UnrealBuildTool;
+using System;
 using System.IO;
 
 public class VivaEngine : ModuleRules
@@ -11,16 +12,44 @@ public class VivaEngine : ModuleRules
 	
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "UMG" });
 
-		PrivateDependencyModuleNames.AddRange(new string[] {  });
+		PrivateDependencyModuleNames.AddRange(new string[] { "NetCore", "PacketHandler", "Sockets" });
+
+		// UDiscordNetDriver builds on the IP net driver
+		PublicDependencyModuleNames.Add("OnlineSubsystemUtils");
+
+		// The avatar atlas uploads tile regions and hands out Slate brushes
+		PrivateDependencyModuleNames.AddRange(new string[] { "RenderCore", "RHI", "SlateCore" });
+
+		// UVE_Mod_Subsystem parses mod JSON and decodes their PNGs
+		PrivateDependencyModuleNames.AddRange(new string[] { "ImageWrapper", "Json" });
+
+		// FDiscordLogBuffer shares its lock-free ring with the Steam callback queue
+		PrivateDependencyModuleNames.Add("AdvancedSessions");
+
+		// UVE_Mod_Subsystem mounts Workshop items as USteamWorkshopModSubsystem reports them ready
+		PublicDependencyModuleNames.Add("AdvancedSteamSessions");
 
         // Get the directory path where the Discord files are located
         string DiscordFilesDirectory = Path.Combine(ModuleDirectory, "discord-files");
         PublicIncludePaths.Add(DiscordFilesDirectory);
 
-        // Get the path to the lib file
-        string BinariesDirectory = Path.Combine(ModuleDirectory, "../../Binaries", Target.Platform.ToString());
-        string LibFilePath = Path.Combine(BinariesDirectory, "discord_game_sdk.dll.lib");
-        PublicAdditionalLibraries.Add(LibFilePath);
+        // The SDK import lib only ships for Win64. The in-process fake in discord-files/mock_ffi.cpp is
+        // opt-in: VIVA_DISCORD_MOCK=1 selects it anywhere, and non-Shipping builds without the SDK use it
+        // for testing. A Shipping build without the SDK compiles Discord out, Core::Create reports NotRunning.
+        bool bHasDiscordSdk = Target.Platform == UnrealTargetPlatform.Win64;
+        bool bUseDiscordMock = Environment.GetEnvironmentVariable("VIVA_DISCORD_MOCK") == "1" ||
+            (!bHasDiscordSdk && Target.Configuration != UnrealTargetConfiguration.Shipping);
+        bool bDiscordDisabled = !bHasDiscordSdk && !bUseDiscordMock;
+        PublicDefinitions.Add("DISCORD_MOCK_FFI=" + (bUseDiscordMock ? "1" : "0"));
+        PublicDefinitions.Add("DISCORD_DISABLED=" + (bDiscordDisabled ? "1" : "0"));
+
+        if (!bUseDiscordMock && !bDiscordDisabled)
+        {
+            // Get the path to the lib file
+            string BinariesDirectory = Path.Combine(ModuleDirectory, "../../Binaries", Target.Platform.ToString());
+            string LibFilePath = Path.Combine(BinariesDirectory, "discord_game_sdk.dll.lib");
+            PublicAdditionalLibraries.Add(LibFilePath);
+        }
 
         // Uncomment if you are using Slate UI
         // PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
@@ -4,6 +4,7 @@
 
 #include "achievement_manager.h"
 
+#include "callback_pool.h"
 #include "core.h"
 
 #include <cstring>
@@ -32,35 +33,23 @@ IDiscordAchievementEvents AchievementManager::events_{
 
 void AchievementManager::SetUserAchievement(Snowflake achievementId,
                                             std::uint8_t percentComplete,
-                                            std::function<void(Result)> callback)
+                                            InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
     internal_->set_user_achievement(
-      internal_, achievementId, percentComplete, cb.release(), wrapper);
+      internal_, achievementId, percentComplete, cb.ToCallbackData(), wrapper);
 }
 
-void AchievementManager::FetchUserAchievements(std::function<void(Result)> callback)
+void AchievementManager::FetchUserAchievements(InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->fetch_user_achievements(internal_, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->fetch_user_achievements(internal_, cb.ToCallbackData(), wrapper);
 }
 
 void AchievementManager::CountUserAchievements(std::int32_t* count)
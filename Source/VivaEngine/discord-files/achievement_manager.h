@@ -10,8 +10,8 @@ public:
 
     void SetUserAchievement(Snowflake achievementId,
                             std::uint8_t percentComplete,
-                            std::function<void(Result)> callback);
-    void FetchUserAchievements(std::function<void(Result)> callback);
+                            InlineDelegate<void(Result)> callback);
+    void FetchUserAchievements(InlineDelegate<void(Result)> callback);
     void CountUserAchievements(std::int32_t* count);
     Result GetUserAchievement(Snowflake userAchievementId, UserAchievement* userAchievement);
     Result GetUserAchievementAt(std::int32_t index, UserAchievement* userAchievement);
@@ -4,6 +4,7 @@
 
 #include "activity_manager.h"
 
+#include "callback_pool.h"
 #include "core.h"
 
 #include <cstring>
@@ -82,96 +83,66 @@ Result ActivityManager::RegisterSteam(std::uint32_t steamId)
     return static_cast<Result>(result);
 }
 
-void ActivityManager::UpdateActivity(Activity const& activity, std::function<void(Result)> callback)
+void ActivityManager::UpdateActivity(Activity const& activity, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
     internal_->update_activity(internal_,
                                reinterpret_cast<DiscordActivity*>(const_cast<Activity*>(&activity)),
-                               cb.release(),
+                               cb.ToCallbackData(),
                                wrapper);
 }
 
-void ActivityManager::ClearActivity(std::function<void(Result)> callback)
+void ActivityManager::ClearActivity(InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->clear_activity(internal_, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->clear_activity(internal_, cb.ToCallbackData(), wrapper);
 }
 
 void ActivityManager::SendRequestReply(UserId userId,
                                        ActivityJoinRequestReply reply,
-                                       std::function<void(Result)> callback)
+                                       InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
     internal_->send_request_reply(internal_,
                                   userId,
                                   static_cast<EDiscordActivityJoinRequestReply>(reply),
-                                  cb.release(),
+                                  cb.ToCallbackData(),
                                   wrapper);
 }
 
 void ActivityManager::SendInvite(UserId userId,
                                  ActivityActionType type,
                                  char const* content,
-                                 std::function<void(Result)> callback)
+                                 InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
     internal_->send_invite(internal_,
                            userId,
                            static_cast<EDiscordActivityActionType>(type),
                            const_cast<char*>(content),
-                           cb.release(),
+                           cb.ToCallbackData(),
                            wrapper);
 }
 
-void ActivityManager::AcceptInvite(UserId userId, std::function<void(Result)> callback)
+void ActivityManager::AcceptInvite(UserId userId, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->accept_invite(internal_, userId, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->accept_invite(internal_, userId, cb.ToCallbackData(), wrapper);
 }
 
 } // namespace discord
@@ -10,16 +10,16 @@ public:
 
     Result RegisterCommand(char const* command);
     Result RegisterSteam(std::uint32_t steamId);
-    void UpdateActivity(Activity const& activity, std::function<void(Result)> callback);
-    void ClearActivity(std::function<void(Result)> callback);
+    void UpdateActivity(Activity const& activity, InlineDelegate<void(Result)> callback);
+    void ClearActivity(InlineDelegate<void(Result)> callback);
     void SendRequestReply(UserId userId,
                           ActivityJoinRequestReply reply,
-                          std::function<void(Result)> callback);
+                          InlineDelegate<void(Result)> callback);
     void SendInvite(UserId userId,
                     ActivityActionType type,
                     char const* content,
-                    std::function<void(Result)> callback);
-    void AcceptInvite(UserId userId, std::function<void(Result)> callback);
+                    InlineDelegate<void(Result)> callback);
+    void AcceptInvite(UserId userId, InlineDelegate<void(Result)> callback);
 
     Event<char const*> OnActivityJoin;
     Event<char const*> OnActivitySpectate;
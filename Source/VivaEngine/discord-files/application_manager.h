@@ -8,11 +8,11 @@ class ApplicationManager final {
 public:
     ~ApplicationManager() = default;
 
-    void ValidateOrExit(std::function<void(Result)> callback);
+    void ValidateOrExit(InlineDelegate<void(Result)> callback);
     void GetCurrentLocale(char locale[128]);
     void GetCurrentBranch(char branch[4096]);
-    void GetOAuth2Token(std::function<void(Result, OAuth2Token const&)> callback);
-    void GetTicket(std::function<void(Result, char const*)> callback);
+    void GetOAuth2Token(InlineDelegate<void(Result, OAuth2Token const&)> callback);
+    void GetTicket(InlineDelegate<void(Result, char const*)> callback);
 
 private:
     friend class Core;
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "delegate.h"
+
+#include <cstddef>
+#include <utility>
+
+namespace discord {
+
+/**
+ * Slab-backed storage for the one-shot callbacks handed to the SDK as `callback_data`. Nodes are
+ * recycled through a free list, so once the pool has grown to its high-water mark issuing an
+ * async request no longer allocates. There is one pool per callback signature.
+ *
+ * Callbacks are stored as InlineDelegates, so a capture never allocates either. The free list is
+ * not locked: like every other call into the SDK, requests are issued and their callbacks run
+ * (from Core::RunCallbacks) on one thread.
+ */
+template <typename Signature>
+class CallbackPool;
+
+template <typename R, typename... Args>
+class CallbackPool<R(Args...)> final {
+public:
+    using Callback = InlineDelegate<R(Args...)>;
+
+    static constexpr std::size_t SlabSize = 64;
+
+private:
+    struct Node {
+        Callback fn;
+        Node* next{};
+    };
+
+    struct Slab {
+        Node nodes[SlabSize];
+        Slab* next{};
+    };
+
+public:
+    /**
+     * Typed reference to a pooled callback. Converts to and from the opaque pointer the SDK hands
+     * back to the static wrapper.
+     */
+    class Handle final {
+    public:
+        Handle() = default;
+
+        void* ToCallbackData() const { return node_; }
+        static Handle FromCallbackData(void* callbackData)
+        {
+            return Handle(static_cast<Node*>(callbackData));
+        }
+
+        explicit operator bool() const { return node_ != nullptr; }
+
+    private:
+        friend class CallbackPool;
+
+        explicit Handle(Node* node)
+          : node_(node)
+        {
+        }
+
+        Node* node_{};
+    };
+
+    static Handle Acquire(Callback callback)
+    {
+        auto& pool = Instance();
+        if (!pool.free_) {
+            pool.Grow();
+        }
+        Node* node = pool.free_;
+        pool.free_ = node->next;
+        node->fn = std::move(callback);
+        node->next = nullptr;
+        return Handle(node);
+    }
+
+    static void Release(Handle handle)
+    {
+        if (!handle.node_) {
+            return;
+        }
+
+        auto& pool = Instance();
+        handle.node_->fn = nullptr;
+        handle.node_->next = pool.free_;
+        pool.free_ = handle.node_;
+    }
+
+    /**
+     * Invokes the callback stored behind `callbackData` and returns its node to the pool. The node
+     * is only recycled after the call, so the callback may safely issue further requests.
+     */
+    static R Dispatch(void* callbackData, Args... args)
+    {
+        auto handle = Handle::FromCallbackData(callbackData);
+        if (!handle) {
+            return R();
+        }
+
+        if (!handle.node_->fn) {
+            Release(handle);
+            return R();
+        }
+
+        struct ReleaseOnExit {
+            Handle handle;
+            ~ReleaseOnExit() { Release(handle); }
+        } guard{handle};
+        return handle.node_->fn(args...);
+    }
+
+private:
+    CallbackPool() = default;
+    CallbackPool(CallbackPool const& rhs) = delete;
+    CallbackPool& operator=(CallbackPool const& rhs) = delete;
+
+    ~CallbackPool()
+    {
+        while (slabs_) {
+            auto* next = slabs_->next;
+            delete slabs_;
+            slabs_ = next;
+        }
+    }
+
+    static CallbackPool& Instance()
+    {
+        static CallbackPool pool;
+        return pool;
+    }
+
+    void Grow()
+    {
+        auto* slab = new Slab();
+        slab->next = slabs_;
+        slabs_ = slab;
+        for (std::size_t i = 0; i < SlabSize; ++i) {
+            slab->nodes[i].next = free_;
+            free_ = &slab->nodes[i];
+        }
+    }
+
+    Node* free_{};
+    Slab* slabs_{};
+};
+
+} // namespace discord
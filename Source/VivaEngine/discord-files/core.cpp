@@ -7,6 +7,12 @@
 #include <cstring>
 #include <memory>
 
+// Set to 1 when neither the SDK nor the mock is linked, Discord then behaves as if the client is not
+// running. VivaEngine.Build.cs defines this for Shipping builds on platforms without the SDK.
+#if !defined(DISCORD_DISABLED)
+#define DISCORD_DISABLED 0
+#endif
+
 namespace discord {
 
 Result Core::Create(ClientId clientId, std::uint64_t flags, Core** instance)
@@ -15,6 +21,12 @@ Result Core::Create(ClientId clientId, std::uint64_t flags, Core** instance)
         return Result::InternalError;
     }
 
+#if DISCORD_DISABLED
+    (void)clientId;
+    (void)flags;
+    (*instance) = nullptr;
+    return Result::NotRunning;
+#else
     (*instance) = new Core();
     DiscordCreateParams params{};
     DiscordCreateParamsSetDefault(&params);
@@ -38,6 +50,7 @@ Result Core::Create(ClientId clientId, std::uint64_t flags, Core** instance)
     }
 
     return static_cast<Result>(result);
+#endif
 }
 
 Core::~Core()
@@ -14,6 +14,8 @@
 #include "voice_manager.h"
 #include "achievement_manager.h"
 
+#include <functional>
+
 namespace discord {
 
 class Core final {
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace discord {
+
+/**
+ * Fixed-capacity replacement for std::function. The callable is stored in an inline buffer, so
+ * constructing, copying or moving a delegate never touches the heap. Callables that do not fit
+ * are rejected at compile time instead of silently falling back to an allocation.
+ */
+template <typename Signature, std::size_t Capacity = 8 * sizeof(void*)>
+class InlineDelegate;
+
+template <typename R, typename... Args, std::size_t Capacity>
+class InlineDelegate<R(Args...), Capacity> final {
+public:
+    static constexpr std::size_t InlineCapacity = Capacity;
+
+    InlineDelegate() = default;
+    InlineDelegate(std::nullptr_t) {}
+
+    template <typename F,
+              typename Fn = typename std::decay<F>::type,
+              typename = typename std::enable_if<!std::is_same<Fn, InlineDelegate>::value>::type>
+    InlineDelegate(F&& fn)
+    {
+        Assign<Fn>(std::forward<F>(fn));
+    }
+
+    InlineDelegate(InlineDelegate const& rhs)
+    {
+        if (rhs.ops_) {
+            rhs.ops_->copy(storage_, rhs.storage_);
+            ops_ = rhs.ops_;
+        }
+    }
+
+    InlineDelegate(InlineDelegate&& rhs) noexcept
+    {
+        if (rhs.ops_) {
+            rhs.ops_->move(storage_, rhs.storage_);
+            ops_ = rhs.ops_;
+            rhs.Reset();
+        }
+    }
+
+    ~InlineDelegate() { Reset(); }
+
+    InlineDelegate& operator=(InlineDelegate const& rhs)
+    {
+        if (this != &rhs) {
+            Reset();
+            if (rhs.ops_) {
+                rhs.ops_->copy(storage_, rhs.storage_);
+                ops_ = rhs.ops_;
+            }
+        }
+        return *this;
+    }
+
+    InlineDelegate& operator=(InlineDelegate&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            Reset();
+            if (rhs.ops_) {
+                rhs.ops_->move(storage_, rhs.storage_);
+                ops_ = rhs.ops_;
+                rhs.Reset();
+            }
+        }
+        return *this;
+    }
+
+    InlineDelegate& operator=(std::nullptr_t)
+    {
+        Reset();
+        return *this;
+    }
+
+    void Reset()
+    {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    explicit operator bool() const { return ops_ != nullptr; }
+
+    /**
+     * Calling an empty delegate asserts in debug builds and returns a value-initialized R
+     * otherwise, the same as CallbackPool does for a node without a callback.
+     */
+    R operator()(Args... args) const
+    {
+        assert(ops_ && "Called an empty InlineDelegate");
+        if (!ops_) {
+            return R();
+        }
+        return ops_->invoke(const_cast<unsigned char*>(storage_), std::forward<Args>(args)...);
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void* fn, Args... args);
+        void (*copy)(void* dst, void const* src);
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void* fn);
+    };
+
+    template <typename Fn>
+    struct OpsFor {
+        static R Invoke(void* fn, Args... args)
+        {
+            return (*static_cast<Fn*>(fn))(std::forward<Args>(args)...);
+        }
+        static void Copy(void* dst, void const* src)
+        {
+            ::new (dst) Fn(*static_cast<Fn const*>(src));
+        }
+        static void Move(void* dst, void* src) { ::new (dst) Fn(std::move(*static_cast<Fn*>(src))); }
+        static void Destroy(void* fn) { static_cast<Fn*>(fn)->~Fn(); }
+
+        static constexpr Ops table{&Invoke, &Copy, &Move, &Destroy};
+    };
+
+    template <typename Fn, typename F>
+    void Assign(F&& fn)
+    {
+        static_assert(sizeof(Fn) <= Capacity, "Callable does not fit in InlineDelegate storage");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t),
+                      "Callable is over-aligned for InlineDelegate");
+        static_assert(std::is_copy_constructible<Fn>::value,
+                      "InlineDelegate requires a copy constructible callable");
+        ::new (storage_) Fn(std::forward<F>(fn));
+        ops_ = &OpsFor<Fn>::table;
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    Ops const* ops_{};
+};
+
+} // namespace discord
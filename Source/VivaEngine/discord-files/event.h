@@ -1,6 +1,8 @@
 #pragma once
 
-#include <functional>
+#include "delegate.h"
+
+#include <algorithm>
 #include <vector>
 
 namespace discord {
@@ -9,6 +11,7 @@ template <typename... Args>
 class Event final {
 public:
     using Token = int;
+    using Handler = InlineDelegate<void(Args...)>;
 
     Event() { slots_.reserve(4); }
 
@@ -22,38 +25,97 @@ public:
     template <typename EventHandler>
     Token Connect(EventHandler slot)
     {
-        slots_.emplace_back(Slot{nextToken_, std::move(slot)});
+        // Connecting from inside a handler must not grow slots_ while it is being walked, so the
+        // new slot is parked until the outermost dispatch finishes.
+        auto& target = dispatchDepth_ > 0 ? pending_ : slots_;
+        target.emplace_back(Slot{nextToken_, Handler(std::move(slot))});
         return nextToken_++;
     }
 
     void Disconnect(Token token)
     {
+        for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+            if (it->token == token) {
+                pending_.erase(it);
+                return;
+            }
+        }
+
         for (auto& slot : slots_) {
             if (slot.token == token) {
-                slot = slots_.back();
-                slots_.pop_back();
+                if (dispatchDepth_ > 0) {
+                    // Handlers may disconnect themselves or others mid-dispatch; tombstone the
+                    // slot and compact once nothing is iterating.
+                    slot.token = DeadToken;
+                    hasDead_ = true;
+                }
+                else {
+                    slot = std::move(slots_.back());
+                    slots_.pop_back();
+                }
                 break;
             }
         }
     }
 
-    void DisconnectAll() { slots_ = {}; }
+    void DisconnectAll()
+    {
+        pending_.clear();
+        if (dispatchDepth_ > 0) {
+            for (auto& slot : slots_) {
+                slot.token = DeadToken;
+            }
+            hasDead_ = !slots_.empty();
+        }
+        else {
+            slots_.clear();
+        }
+    }
 
     void operator()(Args... args)
     {
-        for (auto const& slot : slots_) {
-            slot.fn(std::forward<Args>(args)...);
+        ++dispatchDepth_;
+        auto const count = slots_.size();
+        for (std::size_t i = 0; i < count; ++i) {
+            if (slots_[i].token != DeadToken) {
+                slots_[i].fn(args...);
+            }
+        }
+        if (--dispatchDepth_ == 0) {
+            Flush();
         }
     }
 
 private:
+    static constexpr Token DeadToken = -1;
+
     struct Slot {
         Token token;
-        std::function<void(Args...)> fn;
+        Handler fn;
     };
 
+    void Flush()
+    {
+        if (hasDead_) {
+            slots_.erase(std::remove_if(slots_.begin(),
+                                        slots_.end(),
+                                        [](Slot const& slot) { return slot.token == DeadToken; }),
+                         slots_.end());
+            hasDead_ = false;
+        }
+        if (!pending_.empty()) {
+            for (auto& slot : pending_) {
+                slots_.emplace_back(std::move(slot));
+            }
+            pending_.clear();
+        }
+    }
+
     Token nextToken_{};
+    int dispatchDepth_{};
+    bool hasDead_{};
     std::vector<Slot> slots_{};
+    std::vector<Slot> pending_{};
 };
 
 } // namespace discord
@@ -4,6 +4,7 @@
 
 #include "image_manager.h"
 
+#include "callback_pool.h"
 #include "core.h"
 
 #include <cstring>
@@ -13,23 +14,20 @@ namespace discord {
 
 void ImageManager::Fetch(ImageHandle handle,
                          bool refresh,
-                         std::function<void(Result, ImageHandle)> callback)
+                         InlineDelegate<void(Result, ImageHandle)> callback)
 {
     static auto wrapper =
       [](void* callbackData, EDiscordResult result, DiscordImageHandle handleResult) -> void {
-        std::unique_ptr<std::function<void(Result, ImageHandle)>> cb(
-          reinterpret_cast<std::function<void(Result, ImageHandle)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result), *reinterpret_cast<ImageHandle const*>(&handleResult));
+        CallbackPool<void(Result, ImageHandle)>::Dispatch(
+          callbackData,
+          static_cast<Result>(result),
+          *reinterpret_cast<ImageHandle const*>(&handleResult));
     };
-    std::unique_ptr<std::function<void(Result, ImageHandle)>> cb{};
-    cb.reset(new std::function<void(Result, ImageHandle)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result, ImageHandle)>::Acquire(std::move(callback));
     internal_->fetch(internal_,
                      *reinterpret_cast<DiscordImageHandle const*>(&handle),
                      (refresh ? 1 : 0),
-                     cb.release(),
+                     cb.ToCallbackData(),
                      wrapper);
 }
 
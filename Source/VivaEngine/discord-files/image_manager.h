@@ -8,7 +8,7 @@ class ImageManager final {
 public:
     ~ImageManager() = default;
 
-    void Fetch(ImageHandle handle, bool refresh, std::function<void(Result, ImageHandle)> callback);
+    void Fetch(ImageHandle handle, bool refresh, InlineDelegate<void(Result, ImageHandle)> callback);
     Result GetDimensions(ImageHandle handle, ImageDimensions* dimensions);
     Result GetData(ImageHandle handle, std::uint8_t* data, std::uint32_t dataLength);
 
@@ -4,6 +4,7 @@
 
 #include "lobby_manager.h"
 
+#include "callback_pool.h"
 #include "core.h"
 
 #include <cstring>
@@ -164,109 +165,79 @@ Result LobbyManager::GetMemberUpdateTransaction(LobbyId lobbyId,
 }
 
 void LobbyManager::CreateLobby(LobbyTransaction const& transaction,
-                               std::function<void(Result, Lobby const&)> callback)
+                               InlineDelegate<void(Result, Lobby const&)> callback)
 {
     static auto wrapper =
       [](void* callbackData, EDiscordResult result, DiscordLobby* lobby) -> void {
-        std::unique_ptr<std::function<void(Result, Lobby const&)>> cb(
-          reinterpret_cast<std::function<void(Result, Lobby const&)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result), *reinterpret_cast<Lobby const*>(lobby));
+        CallbackPool<void(Result, Lobby const&)>::Dispatch(
+          callbackData, static_cast<Result>(result), *reinterpret_cast<Lobby const*>(lobby));
     };
-    std::unique_ptr<std::function<void(Result, Lobby const&)>> cb{};
-    cb.reset(new std::function<void(Result, Lobby const&)>(std::move(callback)));
-    internal_->create_lobby(
-      internal_, const_cast<LobbyTransaction&>(transaction).Internal(), cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result, Lobby const&)>::Acquire(std::move(callback));
+    internal_->create_lobby(internal_,
+                            const_cast<LobbyTransaction&>(transaction).Internal(),
+                            cb.ToCallbackData(),
+                            wrapper);
 }
 
 void LobbyManager::UpdateLobby(LobbyId lobbyId,
                                LobbyTransaction const& transaction,
-                               std::function<void(Result)> callback)
+                               InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
     internal_->update_lobby(internal_,
                             lobbyId,
                             const_cast<LobbyTransaction&>(transaction).Internal(),
-                            cb.release(),
+                            cb.ToCallbackData(),
                             wrapper);
 }
 
-void LobbyManager::DeleteLobby(LobbyId lobbyId, std::function<void(Result)> callback)
+void LobbyManager::DeleteLobby(LobbyId lobbyId, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->delete_lobby(internal_, lobbyId, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->delete_lobby(internal_, lobbyId, cb.ToCallbackData(), wrapper);
 }
 
 void LobbyManager::ConnectLobby(LobbyId lobbyId,
                                 LobbySecret secret,
-                                std::function<void(Result, Lobby const&)> callback)
+                                InlineDelegate<void(Result, Lobby const&)> callback)
 {
     static auto wrapper =
       [](void* callbackData, EDiscordResult result, DiscordLobby* lobby) -> void {
-        std::unique_ptr<std::function<void(Result, Lobby const&)>> cb(
-          reinterpret_cast<std::function<void(Result, Lobby const&)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result), *reinterpret_cast<Lobby const*>(lobby));
+        CallbackPool<void(Result, Lobby const&)>::Dispatch(
+          callbackData, static_cast<Result>(result), *reinterpret_cast<Lobby const*>(lobby));
     };
-    std::unique_ptr<std::function<void(Result, Lobby const&)>> cb{};
-    cb.reset(new std::function<void(Result, Lobby const&)>(std::move(callback)));
-    internal_->connect_lobby(internal_, lobbyId, const_cast<char*>(secret), cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result, Lobby const&)>::Acquire(std::move(callback));
+    internal_->connect_lobby(
+      internal_, lobbyId, const_cast<char*>(secret), cb.ToCallbackData(), wrapper);
 }
 
 void LobbyManager::ConnectLobbyWithActivitySecret(
   LobbySecret activitySecret,
-  std::function<void(Result, Lobby const&)> callback)
+  InlineDelegate<void(Result, Lobby const&)> callback)
 {
     static auto wrapper =
       [](void* callbackData, EDiscordResult result, DiscordLobby* lobby) -> void {
-        std::unique_ptr<std::function<void(Result, Lobby const&)>> cb(
-          reinterpret_cast<std::function<void(Result, Lobby const&)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result), *reinterpret_cast<Lobby const*>(lobby));
+        CallbackPool<void(Result, Lobby const&)>::Dispatch(
+          callbackData, static_cast<Result>(result), *reinterpret_cast<Lobby const*>(lobby));
     };
-    std::unique_ptr<std::function<void(Result, Lobby const&)>> cb{};
-    cb.reset(new std::function<void(Result, Lobby const&)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result, Lobby const&)>::Acquire(std::move(callback));
     internal_->connect_lobby_with_activity_secret(
-      internal_, const_cast<char*>(activitySecret), cb.release(), wrapper);
+      internal_, const_cast<char*>(activitySecret), cb.ToCallbackData(), wrapper);
 }
 
-void LobbyManager::DisconnectLobby(LobbyId lobbyId, std::function<void(Result)> callback)
+void LobbyManager::DisconnectLobby(LobbyId lobbyId, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->disconnect_lobby(internal_, lobbyId, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->disconnect_lobby(internal_, lobbyId, cb.ToCallbackData(), wrapper);
 }
 
 Result LobbyManager::GetLobby(LobbyId lobbyId, Lobby* lobby)
@@ -401,43 +372,35 @@ Result LobbyManager::MemberMetadataCount(LobbyId lobbyId, UserId userId, std::in
 void LobbyManager::UpdateMember(LobbyId lobbyId,
                                 UserId userId,
                                 LobbyMemberTransaction const& transaction,
-                                std::function<void(Result)> callback)
+                                InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
     internal_->update_member(internal_,
                              lobbyId,
                              userId,
                              const_cast<LobbyMemberTransaction&>(transaction).Internal(),
-                             cb.release(),
+                             cb.ToCallbackData(),
                              wrapper);
 }
 
 void LobbyManager::SendLobbyMessage(LobbyId lobbyId,
                                     std::uint8_t* data,
                                     std::uint32_t dataLength,
-                                    std::function<void(Result)> callback)
+                                    InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->send_lobby_message(
-      internal_, lobbyId, reinterpret_cast<uint8_t*>(data), dataLength, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->send_lobby_message(internal_,
+                                  lobbyId,
+                                  reinterpret_cast<uint8_t*>(data),
+                                  dataLength,
+                                  cb.ToCallbackData(),
+                                  wrapper);
 }
 
 Result LobbyManager::GetSearchQuery(LobbySearchQuery* query)
@@ -450,20 +413,14 @@ Result LobbyManager::GetSearchQuery(LobbySearchQuery* query)
     return static_cast<Result>(result);
 }
 
-void LobbyManager::Search(LobbySearchQuery const& query, std::function<void(Result)> callback)
+void LobbyManager::Search(LobbySearchQuery const& query, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
     internal_->search(
-      internal_, const_cast<LobbySearchQuery&>(query).Internal(), cb.release(), wrapper);
+      internal_, const_cast<LobbySearchQuery&>(query).Internal(), cb.ToCallbackData(), wrapper);
 }
 
 void LobbyManager::LobbyCount(std::int32_t* count)
@@ -485,34 +442,22 @@ Result LobbyManager::GetLobbyId(std::int32_t index, LobbyId* lobbyId)
     return static_cast<Result>(result);
 }
 
-void LobbyManager::ConnectVoice(LobbyId lobbyId, std::function<void(Result)> callback)
+void LobbyManager::ConnectVoice(LobbyId lobbyId, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->connect_voice(internal_, lobbyId, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->connect_voice(internal_, lobbyId, cb.ToCallbackData(), wrapper);
 }
 
-void LobbyManager::DisconnectVoice(LobbyId lobbyId, std::function<void(Result)> callback)
+void LobbyManager::DisconnectVoice(LobbyId lobbyId, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->disconnect_voice(internal_, lobbyId, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->disconnect_voice(internal_, lobbyId, cb.ToCallbackData(), wrapper);
 }
 
 Result LobbyManager::ConnectNetwork(LobbyId lobbyId)
@@ -14,17 +14,17 @@ public:
                                       UserId userId,
                                       LobbyMemberTransaction* transaction);
     void CreateLobby(LobbyTransaction const& transaction,
-                     std::function<void(Result, Lobby const&)> callback);
+                     InlineDelegate<void(Result, Lobby const&)> callback);
     void UpdateLobby(LobbyId lobbyId,
                      LobbyTransaction const& transaction,
-                     std::function<void(Result)> callback);
-    void DeleteLobby(LobbyId lobbyId, std::function<void(Result)> callback);
+                     InlineDelegate<void(Result)> callback);
+    void DeleteLobby(LobbyId lobbyId, InlineDelegate<void(Result)> callback);
     void ConnectLobby(LobbyId lobbyId,
                       LobbySecret secret,
-                      std::function<void(Result, Lobby const&)> callback);
+                      InlineDelegate<void(Result, Lobby const&)> callback);
     void ConnectLobbyWithActivitySecret(LobbySecret activitySecret,
-                                        std::function<void(Result, Lobby const&)> callback);
-    void DisconnectLobby(LobbyId lobbyId, std::function<void(Result)> callback);
+                                        InlineDelegate<void(Result, Lobby const&)> callback);
+    void DisconnectLobby(LobbyId lobbyId, InlineDelegate<void(Result)> callback);
     Result GetLobby(LobbyId lobbyId, Lobby* lobby);
     Result GetLobbyActivitySecret(LobbyId lobbyId, char secret[128]);
     Result GetLobbyMetadataValue(LobbyId lobbyId, MetadataKey key, char value[4096]);
@@ -42,17 +42,17 @@ public:
     void UpdateMember(LobbyId lobbyId,
                       UserId userId,
                       LobbyMemberTransaction const& transaction,
-                      std::function<void(Result)> callback);
+                      InlineDelegate<void(Result)> callback);
     void SendLobbyMessage(LobbyId lobbyId,
                           std::uint8_t* data,
                           std::uint32_t dataLength,
-                          std::function<void(Result)> callback);
+                          InlineDelegate<void(Result)> callback);
     Result GetSearchQuery(LobbySearchQuery* query);
-    void Search(LobbySearchQuery const& query, std::function<void(Result)> callback);
+    void Search(LobbySearchQuery const& query, InlineDelegate<void(Result)> callback);
     void LobbyCount(std::int32_t* count);
     Result GetLobbyId(std::int32_t index, LobbyId* lobbyId);
-    void ConnectVoice(LobbyId lobbyId, std::function<void(Result)> callback);
-    void DisconnectVoice(LobbyId lobbyId, std::function<void(Result)> callback);
+    void ConnectVoice(LobbyId lobbyId, InlineDelegate<void(Result)> callback);
+    void DisconnectVoice(LobbyId lobbyId, InlineDelegate<void(Result)> callback);
     Result ConnectNetwork(LobbyId lobbyId);
     Result DisconnectNetwork(LobbyId lobbyId);
     Result FlushNetwork();
@@ -0,0 +1,2436 @@
+#if !defined(_CRT_SECURE_NO_WARNINGS)
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "mock_ffi.h"
+
+#if DISCORD_MOCK_FFI
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace discord {
+namespace mock {
+namespace {
+
+using ResultCallback = void(DISCORD_API*)(void* callback_data, enum EDiscordResult result);
+using LobbyCallback = void(DISCORD_API*)(void* callback_data,
+                                         enum EDiscordResult result,
+                                         struct DiscordLobby* lobby);
+using DataCallback = void(DISCORD_API*)(void* callback_data,
+                                        enum EDiscordResult result,
+                                        uint8_t* data,
+                                        uint32_t data_length);
+
+using Metadata = std::map<std::string, std::string>;
+
+struct MockCore;
+
+// Every vtable handed to the wrappers is the first member of one of these, so the pointer the
+// wrapper passes back can be converted to the owning core.
+template <typename Interface>
+struct Module {
+    Interface iface;
+    MockCore* core;
+};
+
+template <typename Interface>
+MockCore* CoreOf(Interface* manager)
+{
+    return reinterpret_cast<Module<Interface>*>(manager)->core;
+}
+
+struct LobbyEdit {
+    bool setType{};
+    EDiscordLobbyType type{};
+    bool setOwner{};
+    DiscordUserId owner{};
+    bool setCapacity{};
+    uint32_t capacity{};
+    bool setLocked{};
+    bool locked{};
+    Metadata set;
+    std::vector<std::string> erase;
+};
+
+struct LobbyTransaction {
+    IDiscordLobbyTransaction iface;
+    LobbyEdit* edit;
+};
+
+struct MemberTransaction {
+    IDiscordLobbyMemberTransaction iface;
+    LobbyEdit* edit;
+};
+
+struct SearchFilter {
+    std::string key;
+    EDiscordLobbySearchComparison comparison;
+    EDiscordLobbySearchCast cast;
+    std::string value;
+};
+
+struct SearchSpec {
+    std::vector<SearchFilter> filters;
+    uint32_t limit{~0u};
+};
+
+struct SearchQuery {
+    IDiscordLobbySearchQuery iface;
+    SearchSpec* spec;
+};
+
+struct LobbyState {
+    DiscordLobby lobby{};
+    Metadata metadata;
+    std::vector<DiscordUserId> members;
+    std::map<DiscordUserId, Metadata> memberMetadata;
+};
+
+struct StoredFile {
+    std::vector<uint8_t> data;
+    uint64_t lastModified{};
+};
+
+struct OutgoingMessage {
+    DiscordLobbyId lobbyId;
+    uint64_t to;
+    uint8_t channel;
+    bool reliable;
+    std::vector<uint8_t> data;
+};
+
+struct Delivery {
+    uint64_t due;
+    std::function<void()> fn;
+};
+
+struct MockCore {
+    Module<IDiscordCore> core{};
+    Module<IDiscordApplicationManager> application{};
+    Module<IDiscordUserManager> user{};
+    Module<IDiscordImageManager> image{};
+    Module<IDiscordActivityManager> activity{};
+    Module<IDiscordRelationshipManager> relationship{};
+    Module<IDiscordLobbyManager> lobby{};
+    Module<IDiscordNetworkManager> network{};
+    Module<IDiscordOverlayManager> overlay{};
+    Module<IDiscordStorageManager> storage{};
+    Module<IDiscordStoreManager> store{};
+    Module<IDiscordVoiceManager> voice{};
+    Module<IDiscordAchievementManager> achievement{};
+
+    DiscordCreateParams params{};
+    DiscordUserId userId{};
+    uint64_t tick{};
+    std::vector<Delivery> queue;
+
+    EDiscordLogLevel logLevel{DiscordLogLevel_Error};
+    void* logData{};
+    void(DISCORD_API* logHook)(void* hook_data, enum EDiscordLogLevel level, const char* message){};
+
+    DiscordActivity currentActivity{};
+    bool hasActivity{};
+    std::vector<DiscordRelationship> relationships;
+
+    std::vector<DiscordLobbyId> searchResults;
+    std::map<DiscordLobbyId, std::map<uint8_t, bool>> lobbyChannels;
+    std::vector<OutgoingMessage> lobbyOutbox;
+
+    std::map<DiscordNetworkPeerId, std::map<uint8_t, bool>> peers;
+    std::vector<OutgoingMessage> peerOutbox;
+
+    DiscordInputMode inputMode{};
+    bool selfMute{};
+    bool selfDeaf{};
+    std::map<DiscordSnowflake, bool> localMute;
+    std::map<DiscordSnowflake, uint8_t> localVolume;
+
+    std::map<DiscordSnowflake, DiscordUserAchievement> achievements;
+
+    std::vector<LobbyTransaction*> lobbyTransactions;
+    std::vector<MemberTransaction*> memberTransactions;
+    std::vector<SearchQuery*> searchQueries;
+};
+
+struct World {
+    std::recursive_mutex mutex;
+    Config config;
+    std::mt19937 rng{1};
+    DiscordUserId nextUserId{100000};
+    DiscordLobbyId nextLobbyId{1};
+    std::vector<MockCore*> cores;
+    std::map<DiscordLobbyId, LobbyState> lobbies;
+    std::map<DiscordUserId, std::map<std::string, StoredFile>> storage;
+};
+
+World& GetWorld()
+{
+    static World world;
+    return world;
+}
+
+using Lock = std::lock_guard<std::recursive_mutex>;
+
+template <std::size_t N>
+void CopyString(char (&dst)[N], std::string const& src)
+{
+    auto const length = std::min(src.size(), N - 1);
+    memcpy(dst, src.data(), length);
+    dst[length] = '\0';
+}
+
+bool Chance(float probability)
+{
+    if (probability <= 0.f) {
+        return false;
+    }
+    return std::uniform_real_distribution<float>(0.f, 1.f)(GetWorld().rng) < probability;
+}
+
+void Post(MockCore* core, std::function<void()> fn)
+{
+    core->queue.push_back(Delivery{core->tick + GetWorld().config.latencyTicks, std::move(fn)});
+}
+
+void Log(MockCore* core, EDiscordLogLevel level, std::string const& message)
+{
+    if (!core->logHook || level > core->logLevel) {
+        return;
+    }
+    auto hook = core->logHook;
+    auto data = core->logData;
+    Post(core, [hook, data, level, message]() { hook(data, level, message.c_str()); });
+}
+
+EDiscordResult Inject(MockCore* core, EDiscordResult result, char const* request)
+{
+    auto const& config = GetWorld().config;
+    if (result == DiscordResult_Ok && Chance(config.failureRate)) {
+        Log(core, DiscordLogLevel_Warn, std::string("mock: injected failure for ") + request);
+        return config.failureResult;
+    }
+    return result;
+}
+
+void PostResult(MockCore* core,
+                char const* request,
+                void* callbackData,
+                ResultCallback callback,
+                EDiscordResult result = DiscordResult_Ok)
+{
+    result = Inject(core, result, request);
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+MockCore* FindCore(DiscordUserId userId)
+{
+    for (auto* core : GetWorld().cores) {
+        if (core->userId == userId) {
+            return core;
+        }
+    }
+    return nullptr;
+}
+
+DiscordUser MakeUser(DiscordUserId userId)
+{
+    DiscordUser user{};
+    user.id = userId;
+    CopyString(user.username, "MockUser" + std::to_string(userId));
+    CopyString(user.discriminator, "0001");
+    CopyString(user.avatar, "mock" + std::to_string(userId));
+    return user;
+}
+
+LobbyState* FindLobby(DiscordLobbyId lobbyId)
+{
+    auto& lobbies = GetWorld().lobbies;
+    auto it = lobbies.find(lobbyId);
+    return it != lobbies.end() ? &it->second : nullptr;
+}
+
+bool IsMember(LobbyState const& state, DiscordUserId userId)
+{
+    return std::find(state.members.begin(), state.members.end(), userId) != state.members.end();
+}
+
+std::string MetadataKey(char const* key)
+{
+    // Search filters address lobby metadata as "metadata.<key>".
+    static char const prefix[] = "metadata.";
+    if (strncmp(key, prefix, sizeof(prefix) - 1) == 0) {
+        return key + sizeof(prefix) - 1;
+    }
+    return key;
+}
+
+template <typename Fn>
+void ForEachOtherMember(LobbyState const& state, DiscordUserId self, Fn fn)
+{
+    for (auto memberId : state.members) {
+        if (memberId == self) {
+            continue;
+        }
+        if (auto* member = FindCore(memberId)) {
+            fn(member);
+        }
+    }
+}
+
+void ApplyEdit(LobbyState& state, LobbyEdit const& edit)
+{
+    if (edit.setType) {
+        state.lobby.type = edit.type;
+    }
+    if (edit.setOwner) {
+        state.lobby.owner_id = edit.owner;
+    }
+    if (edit.setCapacity) {
+        state.lobby.capacity = edit.capacity;
+    }
+    if (edit.setLocked) {
+        state.lobby.locked = edit.locked;
+    }
+    for (auto const& key : edit.erase) {
+        state.metadata.erase(key);
+    }
+    for (auto const& entry : edit.set) {
+        state.metadata[entry.first] = entry.second;
+    }
+}
+
+void NotifyLobbyUpdate(LobbyState const& state)
+{
+    auto lobbyId = state.lobby.id;
+    for (auto memberId : state.members) {
+        if (auto* member = FindCore(memberId)) {
+            auto* events = member->params.lobby_events;
+            auto* data = member->params.event_data;
+            if (events && events->on_lobby_update) {
+                Post(member, [events, data, lobbyId]() { events->on_lobby_update(data, lobbyId); });
+            }
+        }
+    }
+}
+
+void LeaveLobby(MockCore* core, DiscordLobbyId lobbyId)
+{
+    auto* state = FindLobby(lobbyId);
+    if (!state) {
+        return;
+    }
+
+    auto userId = core->userId;
+    state->members.erase(std::remove(state->members.begin(), state->members.end(), userId),
+                         state->members.end());
+    state->memberMetadata.erase(userId);
+    core->lobbyChannels.erase(lobbyId);
+
+    if (state->members.empty()) {
+        GetWorld().lobbies.erase(lobbyId);
+        return;
+    }
+
+    if (state->lobby.owner_id == userId) {
+        state->lobby.owner_id = state->members.front();
+    }
+
+    ForEachOtherMember(*state, userId, [lobbyId, userId](MockCore* member) {
+        auto* events = member->params.lobby_events;
+        auto* data = member->params.event_data;
+        if (events && events->on_member_disconnect) {
+            Post(member, [events, data, lobbyId, userId]() {
+                events->on_member_disconnect(data, lobbyId, userId);
+            });
+        }
+    });
+}
+
+void JoinLobby(MockCore* core, LobbyState& state)
+{
+    auto userId = core->userId;
+    if (IsMember(state, userId)) {
+        return;
+    }
+
+    state.members.push_back(userId);
+    auto lobbyId = state.lobby.id;
+    ForEachOtherMember(state, userId, [lobbyId, userId](MockCore* member) {
+        auto* events = member->params.lobby_events;
+        auto* data = member->params.event_data;
+        if (events && events->on_member_connect) {
+            Post(member, [events, data, lobbyId, userId]() {
+                events->on_member_connect(data, lobbyId, userId);
+            });
+        }
+    });
+}
+
+bool MatchesFilter(LobbyState const& state, SearchFilter const& filter)
+{
+    auto it = state.metadata.find(filter.key);
+    if (it == state.metadata.end()) {
+        return false;
+    }
+
+    int order;
+    if (filter.cast == DiscordLobbySearchCast_Number) {
+        auto lhs = strtod(it->second.c_str(), nullptr);
+        auto rhs = strtod(filter.value.c_str(), nullptr);
+        order = lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+    }
+    else {
+        order = it->second.compare(filter.value);
+        order = order < 0 ? -1 : (order > 0 ? 1 : 0);
+    }
+
+    switch (filter.comparison) {
+    case DiscordLobbySearchComparison_LessThanOrEqual:
+        return order <= 0;
+    case DiscordLobbySearchComparison_LessThan:
+        return order < 0;
+    case DiscordLobbySearchComparison_Equal:
+        return order == 0;
+    case DiscordLobbySearchComparison_GreaterThan:
+        return order > 0;
+    case DiscordLobbySearchComparison_GreaterThanOrEqual:
+        return order >= 0;
+    case DiscordLobbySearchComparison_NotEqual:
+        return order != 0;
+    }
+    return false;
+}
+
+void RouteMessages(MockCore* sender, std::vector<OutgoingMessage>& outbox, bool lobby)
+{
+    auto const dropRate = GetWorld().config.unreliableDropRate;
+    for (auto& message : outbox) {
+        auto* target = FindCore(static_cast<DiscordUserId>(message.to));
+        if (!target) {
+            continue;
+        }
+
+        if (lobby) {
+            if (target->lobbyChannels.find(message.lobbyId) == target->lobbyChannels.end()) {
+                continue;
+            }
+        }
+        else if (target->peers.find(static_cast<DiscordNetworkPeerId>(sender->userId)) ==
+                 target->peers.end()) {
+            continue;
+        }
+
+        if (!message.reliable && Chance(dropRate)) {
+            Log(sender, DiscordLogLevel_Debug, "mock: dropped unreliable message");
+            continue;
+        }
+
+        auto* data = target->params.event_data;
+        auto from = sender->userId;
+        auto channel = message.channel;
+        if (lobby) {
+            auto* events = target->params.lobby_events;
+            if (!events || !events->on_network_message) {
+                continue;
+            }
+            auto lobbyId = message.lobbyId;
+            Post(target, [events, data, lobbyId, from, channel, payload = std::move(message.data)]() mutable {
+                events->on_network_message(data,
+                                           lobbyId,
+                                           from,
+                                           channel,
+                                           payload.data(),
+                                           static_cast<uint32_t>(payload.size()));
+            });
+        }
+        else {
+            auto* events = target->params.network_events;
+            if (!events || !events->on_message) {
+                continue;
+            }
+            Post(target, [events, data, from, channel, payload = std::move(message.data)]() mutable {
+                events->on_message(data,
+                                   static_cast<DiscordNetworkPeerId>(from),
+                                   channel,
+                                   payload.data(),
+                                   static_cast<uint32_t>(payload.size()));
+            });
+        }
+    }
+    outbox.clear();
+}
+
+// Core
+
+void DISCORD_API CoreDestroy(IDiscordCore* iface)
+{
+    auto* core = CoreOf(iface);
+    {
+        Lock lock(GetWorld().mutex);
+        std::vector<DiscordLobbyId> joined;
+        for (auto const& entry : GetWorld().lobbies) {
+            if (IsMember(entry.second, core->userId)) {
+                joined.push_back(entry.first);
+            }
+        }
+        for (auto lobbyId : joined) {
+            LeaveLobby(core, lobbyId);
+        }
+
+        auto& cores = GetWorld().cores;
+        cores.erase(std::remove(cores.begin(), cores.end(), core), cores.end());
+
+        for (auto* transaction : core->lobbyTransactions) {
+            delete transaction->edit;
+            delete transaction;
+        }
+        for (auto* transaction : core->memberTransactions) {
+            delete transaction->edit;
+            delete transaction;
+        }
+        for (auto* query : core->searchQueries) {
+            delete query->spec;
+            delete query;
+        }
+    }
+    delete core;
+}
+
+EDiscordResult DISCORD_API CoreRunCallbacks(IDiscordCore* iface)
+{
+    auto* core = CoreOf(iface);
+    std::vector<Delivery> due;
+    {
+        Lock lock(GetWorld().mutex);
+        ++core->tick;
+        auto split = std::stable_partition(core->queue.begin(),
+                                           core->queue.end(),
+                                           [core](Delivery const& delivery) {
+                                               return delivery.due < core->tick;
+                                           });
+        due.assign(std::make_move_iterator(core->queue.begin()), std::make_move_iterator(split));
+        core->queue.erase(core->queue.begin(), split);
+    }
+
+    for (auto& delivery : due) {
+        delivery.fn();
+    }
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API CoreSetLogHook(IDiscordCore* iface,
+                                EDiscordLogLevel minLevel,
+                                void* hookData,
+                                void(DISCORD_API* hook)(void* hook_data,
+                                                        enum EDiscordLogLevel level,
+                                                        const char* message))
+{
+    auto* core = CoreOf(iface);
+    Lock lock(GetWorld().mutex);
+    core->logLevel = minLevel;
+    core->logData = hookData;
+    core->logHook = hook;
+}
+
+template <typename Interface, Module<Interface> MockCore::*Member>
+Interface* DISCORD_API GetManager(IDiscordCore* iface)
+{
+    return &(CoreOf(iface)->*Member).iface;
+}
+
+// ApplicationManager
+
+void DISCORD_API AppValidateOrExit(IDiscordApplicationManager* manager,
+                                   void* callbackData,
+                                   ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "validate_or_exit", callbackData, callback);
+}
+
+void DISCORD_API AppGetCurrentLocale(IDiscordApplicationManager*, DiscordLocale* locale)
+{
+    CopyString(*locale, "en-US");
+}
+
+void DISCORD_API AppGetCurrentBranch(IDiscordApplicationManager*, DiscordBranch* branch)
+{
+    CopyString(*branch, "master");
+}
+
+void DISCORD_API AppGetOAuth2Token(IDiscordApplicationManager* manager,
+                                   void* callbackData,
+                                   void(DISCORD_API* callback)(void* callback_data,
+                                                               enum EDiscordResult result,
+                                                               struct DiscordOAuth2Token* token))
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto result = Inject(core, DiscordResult_Ok, "get_oauth2_token");
+    Post(core, [callbackData, callback, result]() {
+        DiscordOAuth2Token token{};
+        if (result == DiscordResult_Ok) {
+            CopyString(token.access_token, "mock-access-token");
+            CopyString(token.scopes, "identify");
+        }
+        callback(callbackData, result, &token);
+    });
+}
+
+void DISCORD_API AppGetTicket(IDiscordApplicationManager* manager,
+                              void* callbackData,
+                              void(DISCORD_API* callback)(void* callback_data,
+                                                          enum EDiscordResult result,
+                                                          const char* data))
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto result = Inject(core, DiscordResult_Ok, "get_ticket");
+    Post(core, [callbackData, callback, result]() {
+        callback(callbackData, result, result == DiscordResult_Ok ? "mock-ticket" : "");
+    });
+}
+
+// UserManager
+
+EDiscordResult DISCORD_API UserGetCurrentUser(IDiscordUserManager* manager, DiscordUser* user)
+{
+    *user = MakeUser(CoreOf(manager)->userId);
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API UserGetUser(IDiscordUserManager* manager,
+                             DiscordUserId userId,
+                             void* callbackData,
+                             void(DISCORD_API* callback)(void* callback_data,
+                                                         enum EDiscordResult result,
+                                                         struct DiscordUser* user))
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto result = Inject(core, FindCore(userId) ? DiscordResult_Ok : DiscordResult_NotFound, "get_user");
+    Post(core, [callbackData, callback, result, userId]() {
+        auto user = result == DiscordResult_Ok ? MakeUser(userId) : DiscordUser{};
+        callback(callbackData, result, &user);
+    });
+}
+
+EDiscordResult DISCORD_API UserGetPremiumType(IDiscordUserManager*, EDiscordPremiumType* type)
+{
+    *type = DiscordPremiumType_None;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API UserHasFlag(IDiscordUserManager*, EDiscordUserFlag, bool* hasFlag)
+{
+    *hasFlag = false;
+    return DiscordResult_Ok;
+}
+
+// ImageManager
+
+void DISCORD_API ImageFetch(IDiscordImageManager* manager,
+                            DiscordImageHandle handle,
+                            bool,
+                            void* callbackData,
+                            void(DISCORD_API* callback)(void* callback_data,
+                                                        enum EDiscordResult result,
+                                                        struct DiscordImageHandle handle_result))
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto result = Inject(
+      core, handle.size > 0 ? DiscordResult_Ok : DiscordResult_InvalidPayload, "image fetch");
+    Post(core, [callbackData, callback, result, handle]() { callback(callbackData, result, handle); });
+}
+
+EDiscordResult DISCORD_API ImageGetDimensions(IDiscordImageManager*,
+                                              DiscordImageHandle handle,
+                                              DiscordImageDimensions* dimensions)
+{
+    dimensions->width = handle.size;
+    dimensions->height = handle.size;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API ImageGetData(IDiscordImageManager*,
+                                        DiscordImageHandle handle,
+                                        uint8_t* data,
+                                        uint32_t dataLength)
+{
+    auto const required = handle.size * handle.size * 4;
+    if (dataLength < required) {
+        return DiscordResult_InsufficientBuffer;
+    }
+
+    // Deterministic per-user pattern so tests can tell avatars apart.
+    auto const seed = static_cast<uint32_t>(handle.id * 2654435761u);
+    for (uint32_t i = 0; i < required; i += 4) {
+        auto const pixel = i / 4;
+        data[i + 0] = static_cast<uint8_t>(seed >> 0) ^ static_cast<uint8_t>(pixel % handle.size);
+        data[i + 1] = static_cast<uint8_t>(seed >> 8) ^ static_cast<uint8_t>(pixel / handle.size);
+        data[i + 2] = static_cast<uint8_t>(seed >> 16);
+        data[i + 3] = 0xFF;
+    }
+    return DiscordResult_Ok;
+}
+
+// ActivityManager
+
+EDiscordResult DISCORD_API ActivityRegisterCommand(IDiscordActivityManager*, const char*)
+{
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API ActivityRegisterSteam(IDiscordActivityManager*, uint32_t)
+{
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API ActivityUpdate(IDiscordActivityManager* manager,
+                                DiscordActivity* activity,
+                                void* callbackData,
+                                ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto result = Inject(core, DiscordResult_Ok, "update_activity");
+    if (result == DiscordResult_Ok) {
+        core->currentActivity = *activity;
+        core->hasActivity = true;
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+void DISCORD_API ActivityClear(IDiscordActivityManager* manager,
+                               void* callbackData,
+                               ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto result = Inject(core, DiscordResult_Ok, "clear_activity");
+    if (result == DiscordResult_Ok) {
+        core->currentActivity = DiscordActivity{};
+        core->hasActivity = false;
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+void DISCORD_API ActivitySendRequestReply(IDiscordActivityManager* manager,
+                                          DiscordUserId,
+                                          EDiscordActivityJoinRequestReply,
+                                          void* callbackData,
+                                          ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "send_request_reply", callbackData, callback);
+}
+
+void DISCORD_API ActivitySendInvite(IDiscordActivityManager* manager,
+                                    DiscordUserId userId,
+                                    EDiscordActivityActionType type,
+                                    const char*,
+                                    void* callbackData,
+                                    ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto* target = FindCore(userId);
+    auto result = Inject(
+      core, target && core->hasActivity ? DiscordResult_Ok : DiscordResult_NotFound, "send_invite");
+    if (result == DiscordResult_Ok) {
+        auto* events = target->params.activity_events;
+        auto* data = target->params.event_data;
+        if (events && events->on_activity_invite) {
+            auto sender = MakeUser(core->userId);
+            auto activity = core->currentActivity;
+            Post(target, [events, data, type, sender, activity]() mutable {
+                events->on_activity_invite(data, type, &sender, &activity);
+            });
+        }
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+void DISCORD_API ActivityAcceptInvite(IDiscordActivityManager* manager,
+                                      DiscordUserId,
+                                      void* callbackData,
+                                      ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "accept_invite", callbackData, callback);
+}
+
+// RelationshipManager. Every other live core is reported as an online friend.
+
+void DISCORD_API RelationshipFilter(IDiscordRelationshipManager* manager,
+                                    void* filterData,
+                                    bool(DISCORD_API* filter)(void* filter_data,
+                                                              struct DiscordRelationship* relation))
+{
+    auto* core = CoreOf(manager);
+    std::vector<DiscordRelationship> all;
+    {
+        Lock lock(GetWorld().mutex);
+        for (auto* other : GetWorld().cores) {
+            if (other == core) {
+                continue;
+            }
+            DiscordRelationship relationship{};
+            relationship.type = DiscordRelationshipType_Friend;
+            relationship.user = MakeUser(other->userId);
+            relationship.presence.status = DiscordStatus_Online;
+            if (other->hasActivity) {
+                relationship.presence.activity = other->currentActivity;
+            }
+            all.push_back(relationship);
+        }
+    }
+
+    std::vector<DiscordRelationship> filtered;
+    for (auto& relationship : all) {
+        if (filter(filterData, &relationship)) {
+            filtered.push_back(relationship);
+        }
+    }
+
+    Lock lock(GetWorld().mutex);
+    core->relationships = std::move(filtered);
+}
+
+EDiscordResult DISCORD_API RelationshipCount(IDiscordRelationshipManager* manager, int32_t* count)
+{
+    Lock lock(GetWorld().mutex);
+    *count = static_cast<int32_t>(CoreOf(manager)->relationships.size());
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API RelationshipGet(IDiscordRelationshipManager* manager,
+                                           DiscordUserId userId,
+                                           DiscordRelationship* relationship)
+{
+    Lock lock(GetWorld().mutex);
+    for (auto const& entry : CoreOf(manager)->relationships) {
+        if (entry.user.id == userId) {
+            *relationship = entry;
+            return DiscordResult_Ok;
+        }
+    }
+    return DiscordResult_NotFound;
+}
+
+EDiscordResult DISCORD_API RelationshipGetAt(IDiscordRelationshipManager* manager,
+                                             uint32_t index,
+                                             DiscordRelationship* relationship)
+{
+    Lock lock(GetWorld().mutex);
+    auto const& relationships = CoreOf(manager)->relationships;
+    if (index >= relationships.size()) {
+        return DiscordResult_NotFound;
+    }
+    *relationship = relationships[index];
+    return DiscordResult_Ok;
+}
+
+// Lobby transactions and search queries
+
+LobbyEdit& EditOf(IDiscordLobbyTransaction* transaction)
+{
+    return *reinterpret_cast<LobbyTransaction*>(transaction)->edit;
+}
+
+LobbyEdit& EditOf(IDiscordLobbyMemberTransaction* transaction)
+{
+    return *reinterpret_cast<MemberTransaction*>(transaction)->edit;
+}
+
+EDiscordResult DISCORD_API TxnSetType(IDiscordLobbyTransaction* txn, EDiscordLobbyType type)
+{
+    EditOf(txn).setType = true;
+    EditOf(txn).type = type;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API TxnSetOwner(IDiscordLobbyTransaction* txn, DiscordUserId owner)
+{
+    EditOf(txn).setOwner = true;
+    EditOf(txn).owner = owner;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API TxnSetCapacity(IDiscordLobbyTransaction* txn, uint32_t capacity)
+{
+    EditOf(txn).setCapacity = true;
+    EditOf(txn).capacity = capacity;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API TxnSetMetadata(IDiscordLobbyTransaction* txn,
+                                          DiscordMetadataKey key,
+                                          DiscordMetadataValue value)
+{
+    EditOf(txn).set[key] = value;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API TxnDeleteMetadata(IDiscordLobbyTransaction* txn, DiscordMetadataKey key)
+{
+    EditOf(txn).set.erase(key);
+    EditOf(txn).erase.push_back(key);
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API TxnSetLocked(IDiscordLobbyTransaction* txn, bool locked)
+{
+    EditOf(txn).setLocked = true;
+    EditOf(txn).locked = locked;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API MemberTxnSetMetadata(IDiscordLobbyMemberTransaction* txn,
+                                                DiscordMetadataKey key,
+                                                DiscordMetadataValue value)
+{
+    EditOf(txn).set[key] = value;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API MemberTxnDeleteMetadata(IDiscordLobbyMemberTransaction* txn,
+                                                   DiscordMetadataKey key)
+{
+    EditOf(txn).set.erase(key);
+    EditOf(txn).erase.push_back(key);
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API QueryFilter(IDiscordLobbySearchQuery* query,
+                                       DiscordMetadataKey key,
+                                       EDiscordLobbySearchComparison comparison,
+                                       EDiscordLobbySearchCast cast,
+                                       DiscordMetadataValue value)
+{
+    reinterpret_cast<SearchQuery*>(query)->spec->filters.push_back(
+      SearchFilter{MetadataKey(key), comparison, cast, value});
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API QuerySort(IDiscordLobbySearchQuery*,
+                                     DiscordMetadataKey,
+                                     EDiscordLobbySearchCast,
+                                     DiscordMetadataValue)
+{
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API QueryLimit(IDiscordLobbySearchQuery* query, uint32_t limit)
+{
+    reinterpret_cast<SearchQuery*>(query)->spec->limit = limit;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API QueryDistance(IDiscordLobbySearchQuery*, EDiscordLobbySearchDistance)
+{
+    return DiscordResult_Ok;
+}
+
+LobbyEdit TakeEdit(MockCore* core, IDiscordLobbyTransaction* transaction)
+{
+    LobbyEdit edit;
+    auto* owned = reinterpret_cast<LobbyTransaction*>(transaction);
+    auto& list = core->lobbyTransactions;
+    auto it = std::find(list.begin(), list.end(), owned);
+    if (it != list.end()) {
+        edit = std::move(*owned->edit);
+        delete owned->edit;
+        delete owned;
+        list.erase(it);
+    }
+    return edit;
+}
+
+LobbyEdit TakeEdit(MockCore* core, IDiscordLobbyMemberTransaction* transaction)
+{
+    LobbyEdit edit;
+    auto* owned = reinterpret_cast<MemberTransaction*>(transaction);
+    auto& list = core->memberTransactions;
+    auto it = std::find(list.begin(), list.end(), owned);
+    if (it != list.end()) {
+        edit = std::move(*owned->edit);
+        delete owned->edit;
+        delete owned;
+        list.erase(it);
+    }
+    return edit;
+}
+
+IDiscordLobbyTransaction* NewLobbyTransaction(MockCore* core)
+{
+    auto* transaction = new LobbyTransaction{};
+    transaction->iface.set_type = &TxnSetType;
+    transaction->iface.set_owner = &TxnSetOwner;
+    transaction->iface.set_capacity = &TxnSetCapacity;
+    transaction->iface.set_metadata = &TxnSetMetadata;
+    transaction->iface.delete_metadata = &TxnDeleteMetadata;
+    transaction->iface.set_locked = &TxnSetLocked;
+    transaction->edit = new LobbyEdit();
+    core->lobbyTransactions.push_back(transaction);
+    return &transaction->iface;
+}
+
+// LobbyManager
+
+EDiscordResult DISCORD_API LobbyGetCreateTransaction(IDiscordLobbyManager* manager,
+                                                     IDiscordLobbyTransaction** transaction)
+{
+    Lock lock(GetWorld().mutex);
+    *transaction = NewLobbyTransaction(CoreOf(manager));
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyGetUpdateTransaction(IDiscordLobbyManager* manager,
+                                                     DiscordLobbyId lobbyId,
+                                                     IDiscordLobbyTransaction** transaction)
+{
+    Lock lock(GetWorld().mutex);
+    if (!FindLobby(lobbyId)) {
+        return DiscordResult_NotFound;
+    }
+    *transaction = NewLobbyTransaction(CoreOf(manager));
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyGetMemberTransaction(IDiscordLobbyManager* manager,
+                                                     DiscordLobbyId lobbyId,
+                                                     DiscordUserId userId,
+                                                     IDiscordLobbyMemberTransaction** transaction)
+{
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    if (!state || !IsMember(*state, userId)) {
+        return DiscordResult_NotFound;
+    }
+
+    auto* core = CoreOf(manager);
+    auto* owned = new MemberTransaction{};
+    owned->iface.set_metadata = &MemberTxnSetMetadata;
+    owned->iface.delete_metadata = &MemberTxnDeleteMetadata;
+    owned->edit = new LobbyEdit();
+    core->memberTransactions.push_back(owned);
+    *transaction = &owned->iface;
+    return DiscordResult_Ok;
+}
+
+void PostLobby(MockCore* core,
+               void* callbackData,
+               LobbyCallback callback,
+               EDiscordResult result,
+               DiscordLobby const& lobby)
+{
+    Post(core, [callbackData, callback, result, copy = lobby]() mutable {
+        callback(callbackData, result, &copy);
+    });
+}
+
+void DISCORD_API LobbyCreate(IDiscordLobbyManager* manager,
+                             IDiscordLobbyTransaction* transaction,
+                             void* callbackData,
+                             LobbyCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto edit = TakeEdit(core, transaction);
+    auto result = Inject(core, DiscordResult_Ok, "create_lobby");
+    if (result != DiscordResult_Ok) {
+        PostLobby(core, callbackData, callback, result, DiscordLobby{});
+        return;
+    }
+
+    auto& world = GetWorld();
+    auto lobbyId = world.nextLobbyId++;
+    auto& state = world.lobbies[lobbyId];
+    state.lobby.id = lobbyId;
+    state.lobby.type = DiscordLobbyType_Private;
+    state.lobby.owner_id = core->userId;
+    state.lobby.capacity = 16;
+    CopyString(state.lobby.secret, "mocksecret" + std::to_string(world.rng()));
+    ApplyEdit(state, edit);
+    state.members.push_back(core->userId);
+
+    PostLobby(core, callbackData, callback, result, state.lobby);
+}
+
+void DISCORD_API LobbyUpdate(IDiscordLobbyManager* manager,
+                             DiscordLobbyId lobbyId,
+                             IDiscordLobbyTransaction* transaction,
+                             void* callbackData,
+                             ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto edit = TakeEdit(core, transaction);
+    auto* state = FindLobby(lobbyId);
+    auto result = !state ? DiscordResult_NotFound
+                         : (state->lobby.owner_id != core->userId ? DiscordResult_InvalidPermissions
+                                                                  : DiscordResult_Ok);
+    result = Inject(core, result, "update_lobby");
+    if (result == DiscordResult_Ok) {
+        ApplyEdit(*state, edit);
+        NotifyLobbyUpdate(*state);
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+void DISCORD_API LobbyDelete(IDiscordLobbyManager* manager,
+                             DiscordLobbyId lobbyId,
+                             void* callbackData,
+                             ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    auto result = !state ? DiscordResult_NotFound
+                         : (state->lobby.owner_id != core->userId ? DiscordResult_InvalidPermissions
+                                                                  : DiscordResult_Ok);
+    result = Inject(core, result, "delete_lobby");
+    if (result == DiscordResult_Ok) {
+        for (auto memberId : state->members) {
+            if (auto* member = FindCore(memberId)) {
+                member->lobbyChannels.erase(lobbyId);
+                auto* events = member->params.lobby_events;
+                auto* data = member->params.event_data;
+                if (events && events->on_lobby_delete) {
+                    Post(member, [events, data, lobbyId]() {
+                        events->on_lobby_delete(data, lobbyId, 0);
+                    });
+                }
+            }
+        }
+        GetWorld().lobbies.erase(lobbyId);
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+void ConnectLobby(MockCore* core,
+                  DiscordLobbyId lobbyId,
+                  char const* secret,
+                  void* callbackData,
+                  LobbyCallback callback)
+{
+    auto* state = FindLobby(lobbyId);
+    auto result = DiscordResult_Ok;
+    if (!state) {
+        result = DiscordResult_NotFound;
+    }
+    else if (strcmp(state->lobby.secret, secret) != 0) {
+        result = DiscordResult_InvalidLobbySecret;
+    }
+    else if (!IsMember(*state, core->userId) &&
+             (state->lobby.locked || state->members.size() >= state->lobby.capacity)) {
+        result = DiscordResult_LobbyFull;
+    }
+
+    result = Inject(core, result, "connect_lobby");
+    if (result != DiscordResult_Ok) {
+        PostLobby(core, callbackData, callback, result, DiscordLobby{});
+        return;
+    }
+
+    JoinLobby(core, *state);
+    PostLobby(core, callbackData, callback, result, state->lobby);
+}
+
+void DISCORD_API LobbyConnect(IDiscordLobbyManager* manager,
+                              DiscordLobbyId lobbyId,
+                              DiscordLobbySecret secret,
+                              void* callbackData,
+                              LobbyCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    ConnectLobby(CoreOf(manager), lobbyId, secret, callbackData, callback);
+}
+
+void DISCORD_API LobbyConnectWithActivitySecret(IDiscordLobbyManager* manager,
+                                                DiscordLobbySecret activitySecret,
+                                                void* callbackData,
+                                                LobbyCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    char const* separator = strchr(activitySecret, ':');
+    auto lobbyId = static_cast<DiscordLobbyId>(strtoll(activitySecret, nullptr, 10));
+    ConnectLobby(CoreOf(manager), lobbyId, separator ? separator + 1 : "", callbackData, callback);
+}
+
+void DISCORD_API LobbyDisconnect(IDiscordLobbyManager* manager,
+                                 DiscordLobbyId lobbyId,
+                                 void* callbackData,
+                                 ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    auto result = state && IsMember(*state, core->userId) ? DiscordResult_Ok
+                                                          : DiscordResult_NotFound;
+    result = Inject(core, result, "disconnect_lobby");
+    if (result == DiscordResult_Ok) {
+        LeaveLobby(core, lobbyId);
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+EDiscordResult DISCORD_API LobbyGet(IDiscordLobbyManager*, DiscordLobbyId lobbyId, DiscordLobby* lobby)
+{
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    if (!state) {
+        return DiscordResult_NotFound;
+    }
+    *lobby = state->lobby;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyGetActivitySecret(IDiscordLobbyManager*,
+                                                  DiscordLobbyId lobbyId,
+                                                  DiscordLobbySecret* secret)
+{
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    if (!state) {
+        return DiscordResult_NotFound;
+    }
+    // "<id>:<secret>" must fit the same 128 bytes the secret alone may use
+    int const written = snprintf(*secret,
+                                 sizeof(DiscordLobbySecret),
+                                 "%lld:%s",
+                                 static_cast<long long>(lobbyId),
+                                 state->lobby.secret);
+    if (written < 0 || written >= static_cast<int>(sizeof(DiscordLobbySecret))) {
+        (*secret)[0] = '\0';
+        return DiscordResult_InternalError;
+    }
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyGetMetadataValue(IDiscordLobbyManager*,
+                                                 DiscordLobbyId lobbyId,
+                                                 DiscordMetadataKey key,
+                                                 DiscordMetadataValue* value)
+{
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    if (!state) {
+        return DiscordResult_NotFound;
+    }
+    auto it = state->metadata.find(key);
+    if (it == state->metadata.end()) {
+        return DiscordResult_NotFound;
+    }
+    CopyString(*value, it->second);
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyGetMetadataKey(IDiscordLobbyManager*,
+                                               DiscordLobbyId lobbyId,
+                                               int32_t index,
+                                               DiscordMetadataKey* key)
+{
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    if (!state || index < 0 || index >= static_cast<int32_t>(state->metadata.size())) {
+        return DiscordResult_NotFound;
+    }
+    CopyString(*key, std::next(state->metadata.begin(), index)->first);
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyMetadataCount(IDiscordLobbyManager*,
+                                              DiscordLobbyId lobbyId,
+                                              int32_t* count)
+{
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    if (!state) {
+        return DiscordResult_NotFound;
+    }
+    *count = static_cast<int32_t>(state->metadata.size());
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyMemberCount(IDiscordLobbyManager*,
+                                            DiscordLobbyId lobbyId,
+                                            int32_t* count)
+{
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    if (!state) {
+        return DiscordResult_NotFound;
+    }
+    *count = static_cast<int32_t>(state->members.size());
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyGetMemberUserId(IDiscordLobbyManager*,
+                                                DiscordLobbyId lobbyId,
+                                                int32_t index,
+                                                DiscordUserId* userId)
+{
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    if (!state || index < 0 || index >= static_cast<int32_t>(state->members.size())) {
+        return DiscordResult_NotFound;
+    }
+    *userId = state->members[index];
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyGetMemberUser(IDiscordLobbyManager*,
+                                              DiscordLobbyId lobbyId,
+                                              DiscordUserId userId,
+                                              DiscordUser* user)
+{
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    if (!state || !IsMember(*state, userId)) {
+        return DiscordResult_NotFound;
+    }
+    *user = MakeUser(userId);
+    return DiscordResult_Ok;
+}
+
+Metadata const* FindMemberMetadata(DiscordLobbyId lobbyId, DiscordUserId userId)
+{
+    auto* state = FindLobby(lobbyId);
+    if (!state || !IsMember(*state, userId)) {
+        return nullptr;
+    }
+    static Metadata const empty;
+    auto it = state->memberMetadata.find(userId);
+    return it != state->memberMetadata.end() ? &it->second : &empty;
+}
+
+EDiscordResult DISCORD_API LobbyGetMemberMetadataValue(IDiscordLobbyManager*,
+                                                       DiscordLobbyId lobbyId,
+                                                       DiscordUserId userId,
+                                                       DiscordMetadataKey key,
+                                                       DiscordMetadataValue* value)
+{
+    Lock lock(GetWorld().mutex);
+    auto* metadata = FindMemberMetadata(lobbyId, userId);
+    if (!metadata) {
+        return DiscordResult_NotFound;
+    }
+    auto it = metadata->find(key);
+    if (it == metadata->end()) {
+        return DiscordResult_NotFound;
+    }
+    CopyString(*value, it->second);
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyGetMemberMetadataKey(IDiscordLobbyManager*,
+                                                     DiscordLobbyId lobbyId,
+                                                     DiscordUserId userId,
+                                                     int32_t index,
+                                                     DiscordMetadataKey* key)
+{
+    Lock lock(GetWorld().mutex);
+    auto* metadata = FindMemberMetadata(lobbyId, userId);
+    if (!metadata || index < 0 || index >= static_cast<int32_t>(metadata->size())) {
+        return DiscordResult_NotFound;
+    }
+    CopyString(*key, std::next(metadata->begin(), index)->first);
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyMemberMetadataCount(IDiscordLobbyManager*,
+                                                    DiscordLobbyId lobbyId,
+                                                    DiscordUserId userId,
+                                                    int32_t* count)
+{
+    Lock lock(GetWorld().mutex);
+    auto* metadata = FindMemberMetadata(lobbyId, userId);
+    if (!metadata) {
+        return DiscordResult_NotFound;
+    }
+    *count = static_cast<int32_t>(metadata->size());
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API LobbyUpdateMember(IDiscordLobbyManager* manager,
+                                   DiscordLobbyId lobbyId,
+                                   DiscordUserId userId,
+                                   IDiscordLobbyMemberTransaction* transaction,
+                                   void* callbackData,
+                                   ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto edit = TakeEdit(core, transaction);
+    auto* state = FindLobby(lobbyId);
+    auto result = state && IsMember(*state, userId) ? DiscordResult_Ok : DiscordResult_NotFound;
+    result = Inject(core, result, "update_member");
+    if (result == DiscordResult_Ok) {
+        auto& metadata = state->memberMetadata[userId];
+        for (auto const& key : edit.erase) {
+            metadata.erase(key);
+        }
+        for (auto const& entry : edit.set) {
+            metadata[entry.first] = entry.second;
+        }
+        for (auto memberId : state->members) {
+            if (auto* member = FindCore(memberId)) {
+                auto* events = member->params.lobby_events;
+                auto* data = member->params.event_data;
+                if (events && events->on_member_update) {
+                    Post(member, [events, data, lobbyId, userId]() {
+                        events->on_member_update(data, lobbyId, userId);
+                    });
+                }
+            }
+        }
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+void DISCORD_API LobbySendMessage(IDiscordLobbyManager* manager,
+                                  DiscordLobbyId lobbyId,
+                                  uint8_t* data,
+                                  uint32_t dataLength,
+                                  void* callbackData,
+                                  ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    auto result = state && IsMember(*state, core->userId) ? DiscordResult_Ok
+                                                          : DiscordResult_NotFound;
+    result = Inject(core, result, "send_lobby_message");
+    if (result == DiscordResult_Ok) {
+        auto from = core->userId;
+        std::vector<uint8_t> payload(data, data + dataLength);
+        ForEachOtherMember(*state, from, [lobbyId, from, &payload](MockCore* member) {
+            auto* events = member->params.lobby_events;
+            auto* eventData = member->params.event_data;
+            if (events && events->on_lobby_message) {
+                Post(member, [events, eventData, lobbyId, from, payload]() mutable {
+                    events->on_lobby_message(eventData,
+                                             lobbyId,
+                                             from,
+                                             payload.data(),
+                                             static_cast<uint32_t>(payload.size()));
+                });
+            }
+        });
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+EDiscordResult DISCORD_API LobbyGetSearchQuery(IDiscordLobbyManager* manager,
+                                               IDiscordLobbySearchQuery** query)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto* owned = new SearchQuery{};
+    owned->iface.filter = &QueryFilter;
+    owned->iface.sort = &QuerySort;
+    owned->iface.limit = &QueryLimit;
+    owned->iface.distance = &QueryDistance;
+    owned->spec = new SearchSpec();
+    core->searchQueries.push_back(owned);
+    *query = &owned->iface;
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API LobbySearch(IDiscordLobbyManager* manager,
+                             IDiscordLobbySearchQuery* query,
+                             void* callbackData,
+                             ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto* owned = reinterpret_cast<SearchQuery*>(query);
+    auto& queries = core->searchQueries;
+    auto it = std::find(queries.begin(), queries.end(), owned);
+    SearchSpec spec;
+    if (it != queries.end()) {
+        spec = std::move(*owned->spec);
+        delete owned->spec;
+        delete owned;
+        queries.erase(it);
+    }
+
+    auto result = Inject(core, DiscordResult_Ok, "lobby search");
+    core->searchResults.clear();
+    if (result == DiscordResult_Ok) {
+        for (auto const& entry : GetWorld().lobbies) {
+            if (core->searchResults.size() >= spec.limit) {
+                break;
+            }
+            auto const& state = entry.second;
+            if (state.lobby.type != DiscordLobbyType_Public) {
+                continue;
+            }
+            bool matches = true;
+            for (auto const& filter : spec.filters) {
+                if (!MatchesFilter(state, filter)) {
+                    matches = false;
+                    break;
+                }
+            }
+            if (matches) {
+                core->searchResults.push_back(entry.first);
+            }
+        }
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+void DISCORD_API LobbyCount(IDiscordLobbyManager* manager, int32_t* count)
+{
+    Lock lock(GetWorld().mutex);
+    *count = static_cast<int32_t>(CoreOf(manager)->searchResults.size());
+}
+
+EDiscordResult DISCORD_API LobbyGetLobbyId(IDiscordLobbyManager* manager,
+                                           int32_t index,
+                                           DiscordLobbyId* lobbyId)
+{
+    Lock lock(GetWorld().mutex);
+    auto const& results = CoreOf(manager)->searchResults;
+    if (index < 0 || index >= static_cast<int32_t>(results.size())) {
+        return DiscordResult_NotFound;
+    }
+    *lobbyId = results[index];
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API LobbyConnectVoice(IDiscordLobbyManager* manager,
+                                   DiscordLobbyId,
+                                   void* callbackData,
+                                   ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "connect_voice", callbackData, callback);
+}
+
+void DISCORD_API LobbyDisconnectVoice(IDiscordLobbyManager* manager,
+                                      DiscordLobbyId,
+                                      void* callbackData,
+                                      ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "disconnect_voice", callbackData, callback);
+}
+
+EDiscordResult DISCORD_API LobbyConnectNetwork(IDiscordLobbyManager* manager, DiscordLobbyId lobbyId)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto* state = FindLobby(lobbyId);
+    if (!state || !IsMember(*state, core->userId)) {
+        return DiscordResult_NotFound;
+    }
+    core->lobbyChannels[lobbyId];
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyDisconnectNetwork(IDiscordLobbyManager* manager,
+                                                  DiscordLobbyId lobbyId)
+{
+    Lock lock(GetWorld().mutex);
+    return CoreOf(manager)->lobbyChannels.erase(lobbyId) ? DiscordResult_Ok : DiscordResult_NotFound;
+}
+
+EDiscordResult DISCORD_API LobbyFlushNetwork(IDiscordLobbyManager* manager)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    RouteMessages(core, core->lobbyOutbox, true);
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbyOpenNetworkChannel(IDiscordLobbyManager* manager,
+                                                   DiscordLobbyId lobbyId,
+                                                   uint8_t channelId,
+                                                   bool reliable)
+{
+    Lock lock(GetWorld().mutex);
+    auto& lobbies = CoreOf(manager)->lobbyChannels;
+    auto it = lobbies.find(lobbyId);
+    if (it == lobbies.end()) {
+        return DiscordResult_NotFound;
+    }
+    it->second[channelId] = reliable;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API LobbySendNetworkMessage(IDiscordLobbyManager* manager,
+                                                   DiscordLobbyId lobbyId,
+                                                   DiscordUserId userId,
+                                                   uint8_t channelId,
+                                                   uint8_t* data,
+                                                   uint32_t dataLength)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto lobby = core->lobbyChannels.find(lobbyId);
+    if (lobby == core->lobbyChannels.end()) {
+        return DiscordResult_NotFound;
+    }
+    auto channel = lobby->second.find(channelId);
+    if (channel == lobby->second.end()) {
+        return DiscordResult_InvalidChannel;
+    }
+    core->lobbyOutbox.push_back(OutgoingMessage{lobbyId,
+                                                static_cast<uint64_t>(userId),
+                                                channelId,
+                                                channel->second,
+                                                std::vector<uint8_t>(data, data + dataLength)});
+    return DiscordResult_Ok;
+}
+
+// NetworkManager. Peer ids are the numeric user ids of the other cores.
+
+void DISCORD_API NetGetPeerId(IDiscordNetworkManager* manager, DiscordNetworkPeerId* peerId)
+{
+    *peerId = static_cast<DiscordNetworkPeerId>(CoreOf(manager)->userId);
+}
+
+EDiscordResult DISCORD_API NetFlush(IDiscordNetworkManager* manager)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    RouteMessages(core, core->peerOutbox, false);
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API NetOpenPeer(IDiscordNetworkManager* manager,
+                                       DiscordNetworkPeerId peerId,
+                                       const char*)
+{
+    Lock lock(GetWorld().mutex);
+    CoreOf(manager)->peers[peerId];
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API NetUpdatePeer(IDiscordNetworkManager* manager,
+                                         DiscordNetworkPeerId peerId,
+                                         const char*)
+{
+    Lock lock(GetWorld().mutex);
+    auto const& peers = CoreOf(manager)->peers;
+    return peers.find(peerId) != peers.end() ? DiscordResult_Ok : DiscordResult_NotFound;
+}
+
+EDiscordResult DISCORD_API NetClosePeer(IDiscordNetworkManager* manager, DiscordNetworkPeerId peerId)
+{
+    Lock lock(GetWorld().mutex);
+    return CoreOf(manager)->peers.erase(peerId) ? DiscordResult_Ok : DiscordResult_NotFound;
+}
+
+EDiscordResult DISCORD_API NetOpenChannel(IDiscordNetworkManager* manager,
+                                          DiscordNetworkPeerId peerId,
+                                          DiscordNetworkChannelId channelId,
+                                          bool reliable)
+{
+    Lock lock(GetWorld().mutex);
+    auto& peers = CoreOf(manager)->peers;
+    auto it = peers.find(peerId);
+    if (it == peers.end()) {
+        return DiscordResult_NotFound;
+    }
+    it->second[channelId] = reliable;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API NetCloseChannel(IDiscordNetworkManager* manager,
+                                           DiscordNetworkPeerId peerId,
+                                           DiscordNetworkChannelId channelId)
+{
+    Lock lock(GetWorld().mutex);
+    auto& peers = CoreOf(manager)->peers;
+    auto it = peers.find(peerId);
+    if (it == peers.end() || !it->second.erase(channelId)) {
+        return DiscordResult_NotFound;
+    }
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API NetSendMessage(IDiscordNetworkManager* manager,
+                                          DiscordNetworkPeerId peerId,
+                                          DiscordNetworkChannelId channelId,
+                                          uint8_t* data,
+                                          uint32_t dataLength)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto peer = core->peers.find(peerId);
+    if (peer == core->peers.end()) {
+        return DiscordResult_NotFound;
+    }
+    auto channel = peer->second.find(channelId);
+    if (channel == peer->second.end()) {
+        return DiscordResult_InvalidChannel;
+    }
+    core->peerOutbox.push_back(OutgoingMessage{0,
+                                               peerId,
+                                               channelId,
+                                               channel->second,
+                                               std::vector<uint8_t>(data, data + dataLength)});
+    return DiscordResult_Ok;
+}
+
+// OverlayManager. The fake has no overlay; everything reports success and does nothing.
+
+void DISCORD_API OverlayIsEnabled(IDiscordOverlayManager*, bool* enabled)
+{
+    *enabled = false;
+}
+
+void DISCORD_API OverlayIsLocked(IDiscordOverlayManager*, bool* locked)
+{
+    *locked = true;
+}
+
+void DISCORD_API OverlaySetLocked(IDiscordOverlayManager* manager,
+                                  bool,
+                                  void* callbackData,
+                                  ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "set_locked", callbackData, callback);
+}
+
+void DISCORD_API OverlayOpenActivityInvite(IDiscordOverlayManager* manager,
+                                           EDiscordActivityActionType,
+                                           void* callbackData,
+                                           ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "open_activity_invite", callbackData, callback);
+}
+
+void DISCORD_API OverlayOpenGuildInvite(IDiscordOverlayManager* manager,
+                                        const char*,
+                                        void* callbackData,
+                                        ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "open_guild_invite", callbackData, callback);
+}
+
+void DISCORD_API OverlayOpenVoiceSettings(IDiscordOverlayManager* manager,
+                                          void* callbackData,
+                                          ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "open_voice_settings", callbackData, callback);
+}
+
+EDiscordResult DISCORD_API OverlayInitDrawingDxgi(IDiscordOverlayManager*, IDXGISwapChain*, bool)
+{
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API OverlayOnPresent(IDiscordOverlayManager*) {}
+
+void DISCORD_API OverlayForwardMessage(IDiscordOverlayManager*, MSG*) {}
+
+void DISCORD_API OverlayKeyEvent(IDiscordOverlayManager*, bool, const char*, EDiscordKeyVariant) {}
+
+void DISCORD_API OverlayCharEvent(IDiscordOverlayManager*, const char*) {}
+
+void DISCORD_API
+OverlayMouseButtonEvent(IDiscordOverlayManager*, uint8_t, int32_t, EDiscordMouseButton, int32_t, int32_t)
+{
+}
+
+void DISCORD_API OverlayMouseMotionEvent(IDiscordOverlayManager*, int32_t, int32_t) {}
+
+void DISCORD_API OverlayImeCommitText(IDiscordOverlayManager*, const char*) {}
+
+void DISCORD_API
+OverlayImeSetComposition(IDiscordOverlayManager*, const char*, DiscordImeUnderline*, uint32_t, int32_t, int32_t)
+{
+}
+
+void DISCORD_API OverlayImeCancelComposition(IDiscordOverlayManager*) {}
+
+void DISCORD_API OverlaySetImeCompositionRangeCallback(
+  IDiscordOverlayManager*,
+  void*,
+  void(DISCORD_API*)(void*, int32_t, int32_t, struct DiscordRect*, uint32_t))
+{
+}
+
+void DISCORD_API OverlaySetImeSelectionBoundsCallback(
+  IDiscordOverlayManager*,
+  void*,
+  void(DISCORD_API*)(void*, struct DiscordRect, struct DiscordRect, bool))
+{
+}
+
+bool DISCORD_API OverlayIsPointInsideClickZone(IDiscordOverlayManager*, int32_t, int32_t)
+{
+    return false;
+}
+
+// StorageManager. Files live in memory, keyed by user id, and survive core re-creation.
+
+std::map<std::string, StoredFile>& FilesOf(MockCore* core)
+{
+    return GetWorld().storage[core->userId];
+}
+
+EDiscordResult DISCORD_API StorageRead(IDiscordStorageManager* manager,
+                                       const char* name,
+                                       uint8_t* data,
+                                       uint32_t dataLength,
+                                       uint32_t* read)
+{
+    Lock lock(GetWorld().mutex);
+    auto& files = FilesOf(CoreOf(manager));
+    auto it = files.find(name);
+    if (it == files.end()) {
+        return DiscordResult_NotFound;
+    }
+    auto const size = static_cast<uint32_t>(it->second.data.size());
+    if (dataLength < size) {
+        return DiscordResult_InsufficientBuffer;
+    }
+    memcpy(data, it->second.data.data(), size);
+    *read = size;
+    return DiscordResult_Ok;
+}
+
+void PostRead(MockCore* core,
+              char const* request,
+              char const* name,
+              uint64_t offset,
+              uint64_t length,
+              void* callbackData,
+              DataCallback callback)
+{
+    auto& files = FilesOf(core);
+    auto it = files.find(name);
+    std::vector<uint8_t> payload;
+    auto result = DiscordResult_Ok;
+    if (it == files.end()) {
+        result = DiscordResult_NotFound;
+    }
+    else if (offset > it->second.data.size()) {
+        result = DiscordResult_InvalidPayload;
+    }
+    else {
+        auto const begin = it->second.data.begin() + static_cast<std::ptrdiff_t>(offset);
+        auto const available = it->second.data.size() - offset;
+        auto const end = begin + static_cast<std::ptrdiff_t>(std::min<uint64_t>(available, length));
+        payload.assign(begin, end);
+    }
+
+    result = Inject(core, result, request);
+    if (result != DiscordResult_Ok) {
+        payload.clear();
+    }
+    Post(core, [callbackData, callback, result, payload = std::move(payload)]() mutable {
+        callback(callbackData, result, payload.data(), static_cast<uint32_t>(payload.size()));
+    });
+}
+
+void DISCORD_API StorageReadAsync(IDiscordStorageManager* manager,
+                                  const char* name,
+                                  void* callbackData,
+                                  DataCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostRead(CoreOf(manager), "read_async", name, 0, ~0ull, callbackData, callback);
+}
+
+void DISCORD_API StorageReadAsyncPartial(IDiscordStorageManager* manager,
+                                         const char* name,
+                                         uint64_t offset,
+                                         uint64_t length,
+                                         void* callbackData,
+                                         DataCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostRead(CoreOf(manager), "read_async_partial", name, offset, length, callbackData, callback);
+}
+
+void WriteFile(MockCore* core, char const* name, uint8_t const* data, uint32_t dataLength)
+{
+    auto& file = FilesOf(core)[name];
+    file.data.assign(data, data + dataLength);
+    file.lastModified = static_cast<uint64_t>(std::time(nullptr));
+}
+
+EDiscordResult DISCORD_API StorageWrite(IDiscordStorageManager* manager,
+                                        const char* name,
+                                        uint8_t* data,
+                                        uint32_t dataLength)
+{
+    Lock lock(GetWorld().mutex);
+    WriteFile(CoreOf(manager), name, data, dataLength);
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API StorageWriteAsync(IDiscordStorageManager* manager,
+                                   const char* name,
+                                   uint8_t* data,
+                                   uint32_t dataLength,
+                                   void* callbackData,
+                                   ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto result = Inject(core, DiscordResult_Ok, "write_async");
+    if (result == DiscordResult_Ok) {
+        WriteFile(core, name, data, dataLength);
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+EDiscordResult DISCORD_API StorageDelete(IDiscordStorageManager* manager, const char* name)
+{
+    Lock lock(GetWorld().mutex);
+    return FilesOf(CoreOf(manager)).erase(name) ? DiscordResult_Ok : DiscordResult_NotFound;
+}
+
+EDiscordResult DISCORD_API StorageExists(IDiscordStorageManager* manager,
+                                         const char* name,
+                                         bool* exists)
+{
+    Lock lock(GetWorld().mutex);
+    auto const& files = FilesOf(CoreOf(manager));
+    *exists = files.find(name) != files.end();
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API StorageCount(IDiscordStorageManager* manager, int32_t* count)
+{
+    Lock lock(GetWorld().mutex);
+    *count = static_cast<int32_t>(FilesOf(CoreOf(manager)).size());
+}
+
+void FillStat(std::string const& name, StoredFile const& file, DiscordFileStat* stat)
+{
+    CopyString(stat->filename, name);
+    stat->size = file.data.size();
+    stat->last_modified = file.lastModified;
+}
+
+EDiscordResult DISCORD_API StorageStat(IDiscordStorageManager* manager,
+                                       const char* name,
+                                       DiscordFileStat* stat)
+{
+    Lock lock(GetWorld().mutex);
+    auto const& files = FilesOf(CoreOf(manager));
+    auto it = files.find(name);
+    if (it == files.end()) {
+        return DiscordResult_NotFound;
+    }
+    FillStat(it->first, it->second, stat);
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API StorageStatAt(IDiscordStorageManager* manager,
+                                         int32_t index,
+                                         DiscordFileStat* stat)
+{
+    Lock lock(GetWorld().mutex);
+    auto const& files = FilesOf(CoreOf(manager));
+    if (index < 0 || index >= static_cast<int32_t>(files.size())) {
+        return DiscordResult_NotFound;
+    }
+    auto it = std::next(files.begin(), index);
+    FillStat(it->first, it->second, stat);
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API StorageGetPath(IDiscordStorageManager* manager, DiscordPath* path)
+{
+    CopyString(*path, "mock-storage/" + std::to_string(CoreOf(manager)->userId));
+    return DiscordResult_Ok;
+}
+
+// StoreManager. No SKUs or entitlements.
+
+void DISCORD_API StoreFetchSkus(IDiscordStoreManager* manager,
+                                void* callbackData,
+                                ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "fetch_skus", callbackData, callback);
+}
+
+void DISCORD_API StoreCount(IDiscordStoreManager*, int32_t* count)
+{
+    *count = 0;
+}
+
+EDiscordResult DISCORD_API StoreGetSku(IDiscordStoreManager*, DiscordSnowflake, DiscordSku*)
+{
+    return DiscordResult_NotFound;
+}
+
+EDiscordResult DISCORD_API StoreGetSkuAt(IDiscordStoreManager*, int32_t, DiscordSku*)
+{
+    return DiscordResult_NotFound;
+}
+
+void DISCORD_API StoreFetchEntitlements(IDiscordStoreManager* manager,
+                                        void* callbackData,
+                                        ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "fetch_entitlements", callbackData, callback);
+}
+
+EDiscordResult DISCORD_API StoreGetEntitlement(IDiscordStoreManager*,
+                                               DiscordSnowflake,
+                                               DiscordEntitlement*)
+{
+    return DiscordResult_NotFound;
+}
+
+EDiscordResult DISCORD_API StoreGetEntitlementAt(IDiscordStoreManager*, int32_t, DiscordEntitlement*)
+{
+    return DiscordResult_NotFound;
+}
+
+EDiscordResult DISCORD_API StoreHasSkuEntitlement(IDiscordStoreManager*, DiscordSnowflake, bool* has)
+{
+    *has = false;
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API StoreStartPurchase(IDiscordStoreManager* manager,
+                                    DiscordSnowflake,
+                                    void* callbackData,
+                                    ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(
+      CoreOf(manager), "start_purchase", callbackData, callback, DiscordResult_PurchaseCanceled);
+}
+
+// VoiceManager
+
+EDiscordResult DISCORD_API VoiceGetInputMode(IDiscordVoiceManager* manager, DiscordInputMode* mode)
+{
+    Lock lock(GetWorld().mutex);
+    *mode = CoreOf(manager)->inputMode;
+    return DiscordResult_Ok;
+}
+
+void DISCORD_API VoiceSetInputMode(IDiscordVoiceManager* manager,
+                                   DiscordInputMode mode,
+                                   void* callbackData,
+                                   ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto result = Inject(core, DiscordResult_Ok, "set_input_mode");
+    if (result == DiscordResult_Ok) {
+        core->inputMode = mode;
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+EDiscordResult DISCORD_API VoiceIsSelfMute(IDiscordVoiceManager* manager, bool* mute)
+{
+    Lock lock(GetWorld().mutex);
+    *mute = CoreOf(manager)->selfMute;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API VoiceSetSelfMute(IDiscordVoiceManager* manager, bool mute)
+{
+    Lock lock(GetWorld().mutex);
+    CoreOf(manager)->selfMute = mute;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API VoiceIsSelfDeaf(IDiscordVoiceManager* manager, bool* deaf)
+{
+    Lock lock(GetWorld().mutex);
+    *deaf = CoreOf(manager)->selfDeaf;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API VoiceSetSelfDeaf(IDiscordVoiceManager* manager, bool deaf)
+{
+    Lock lock(GetWorld().mutex);
+    CoreOf(manager)->selfDeaf = deaf;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API VoiceIsLocalMute(IDiscordVoiceManager* manager,
+                                            DiscordSnowflake userId,
+                                            bool* mute)
+{
+    Lock lock(GetWorld().mutex);
+    auto const& mutes = CoreOf(manager)->localMute;
+    auto it = mutes.find(userId);
+    *mute = it != mutes.end() && it->second;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API VoiceSetLocalMute(IDiscordVoiceManager* manager,
+                                             DiscordSnowflake userId,
+                                             bool mute)
+{
+    Lock lock(GetWorld().mutex);
+    CoreOf(manager)->localMute[userId] = mute;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API VoiceGetLocalVolume(IDiscordVoiceManager* manager,
+                                               DiscordSnowflake userId,
+                                               uint8_t* volume)
+{
+    Lock lock(GetWorld().mutex);
+    auto const& volumes = CoreOf(manager)->localVolume;
+    auto it = volumes.find(userId);
+    *volume = it != volumes.end() ? it->second : 100;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API VoiceSetLocalVolume(IDiscordVoiceManager* manager,
+                                               DiscordSnowflake userId,
+                                               uint8_t volume)
+{
+    Lock lock(GetWorld().mutex);
+    CoreOf(manager)->localVolume[userId] = volume;
+    return DiscordResult_Ok;
+}
+
+// AchievementManager
+
+void DISCORD_API AchievementSet(IDiscordAchievementManager* manager,
+                                DiscordSnowflake achievementId,
+                                uint8_t percentComplete,
+                                void* callbackData,
+                                ResultCallback callback)
+{
+    auto* core = CoreOf(manager);
+    Lock lock(GetWorld().mutex);
+    auto result = Inject(core, DiscordResult_Ok, "set_user_achievement");
+    if (result == DiscordResult_Ok) {
+        auto& achievement = core->achievements[achievementId];
+        achievement.user_id = core->userId;
+        achievement.achievement_id = achievementId;
+        achievement.percent_complete = percentComplete;
+        if (percentComplete >= 100) {
+            CopyString(achievement.unlocked_at, "1970-01-01T00:00:00Z");
+        }
+
+        auto* events = core->params.achievement_events;
+        auto* data = core->params.event_data;
+        if (events && events->on_user_achievement_update) {
+            auto copy = achievement;
+            Post(core, [events, data, copy]() mutable {
+                events->on_user_achievement_update(data, &copy);
+            });
+        }
+    }
+    Post(core, [callbackData, callback, result]() { callback(callbackData, result); });
+}
+
+void DISCORD_API AchievementFetch(IDiscordAchievementManager* manager,
+                                  void* callbackData,
+                                  ResultCallback callback)
+{
+    Lock lock(GetWorld().mutex);
+    PostResult(CoreOf(manager), "fetch_user_achievements", callbackData, callback);
+}
+
+void DISCORD_API AchievementCount(IDiscordAchievementManager* manager, int32_t* count)
+{
+    Lock lock(GetWorld().mutex);
+    *count = static_cast<int32_t>(CoreOf(manager)->achievements.size());
+}
+
+EDiscordResult DISCORD_API AchievementGet(IDiscordAchievementManager* manager,
+                                          DiscordSnowflake achievementId,
+                                          DiscordUserAchievement* achievement)
+{
+    Lock lock(GetWorld().mutex);
+    auto const& achievements = CoreOf(manager)->achievements;
+    auto it = achievements.find(achievementId);
+    if (it == achievements.end()) {
+        return DiscordResult_NotFound;
+    }
+    *achievement = it->second;
+    return DiscordResult_Ok;
+}
+
+EDiscordResult DISCORD_API AchievementGetAt(IDiscordAchievementManager* manager,
+                                            int32_t index,
+                                            DiscordUserAchievement* achievement)
+{
+    Lock lock(GetWorld().mutex);
+    auto const& achievements = CoreOf(manager)->achievements;
+    if (index < 0 || index >= static_cast<int32_t>(achievements.size())) {
+        return DiscordResult_NotFound;
+    }
+    *achievement = std::next(achievements.begin(), index)->second;
+    return DiscordResult_Ok;
+}
+
+template <typename Interface>
+void Attach(Module<Interface>& module, MockCore* core)
+{
+    module.core = core;
+}
+
+MockCore* NewCore(DiscordCreateParams const& params, DiscordUserId userId)
+{
+    auto* core = new MockCore();
+    core->params = params;
+    core->userId = userId;
+
+    Attach(core->core, core);
+    core->core.iface.destroy = &CoreDestroy;
+    core->core.iface.run_callbacks = &CoreRunCallbacks;
+    core->core.iface.set_log_hook = &CoreSetLogHook;
+    core->core.iface.get_application_manager =
+      &GetManager<IDiscordApplicationManager, &MockCore::application>;
+    core->core.iface.get_user_manager = &GetManager<IDiscordUserManager, &MockCore::user>;
+    core->core.iface.get_image_manager = &GetManager<IDiscordImageManager, &MockCore::image>;
+    core->core.iface.get_activity_manager =
+      &GetManager<IDiscordActivityManager, &MockCore::activity>;
+    core->core.iface.get_relationship_manager =
+      &GetManager<IDiscordRelationshipManager, &MockCore::relationship>;
+    core->core.iface.get_lobby_manager = &GetManager<IDiscordLobbyManager, &MockCore::lobby>;
+    core->core.iface.get_network_manager = &GetManager<IDiscordNetworkManager, &MockCore::network>;
+    core->core.iface.get_overlay_manager = &GetManager<IDiscordOverlayManager, &MockCore::overlay>;
+    core->core.iface.get_storage_manager = &GetManager<IDiscordStorageManager, &MockCore::storage>;
+    core->core.iface.get_store_manager = &GetManager<IDiscordStoreManager, &MockCore::store>;
+    core->core.iface.get_voice_manager = &GetManager<IDiscordVoiceManager, &MockCore::voice>;
+    core->core.iface.get_achievement_manager =
+      &GetManager<IDiscordAchievementManager, &MockCore::achievement>;
+
+    Attach(core->application, core);
+    core->application.iface.validate_or_exit = &AppValidateOrExit;
+    core->application.iface.get_current_locale = &AppGetCurrentLocale;
+    core->application.iface.get_current_branch = &AppGetCurrentBranch;
+    core->application.iface.get_oauth2_token = &AppGetOAuth2Token;
+    core->application.iface.get_ticket = &AppGetTicket;
+
+    Attach(core->user, core);
+    core->user.iface.get_current_user = &UserGetCurrentUser;
+    core->user.iface.get_user = &UserGetUser;
+    core->user.iface.get_current_user_premium_type = &UserGetPremiumType;
+    core->user.iface.current_user_has_flag = &UserHasFlag;
+
+    Attach(core->image, core);
+    core->image.iface.fetch = &ImageFetch;
+    core->image.iface.get_dimensions = &ImageGetDimensions;
+    core->image.iface.get_data = &ImageGetData;
+
+    Attach(core->activity, core);
+    core->activity.iface.register_command = &ActivityRegisterCommand;
+    core->activity.iface.register_steam = &ActivityRegisterSteam;
+    core->activity.iface.update_activity = &ActivityUpdate;
+    core->activity.iface.clear_activity = &ActivityClear;
+    core->activity.iface.send_request_reply = &ActivitySendRequestReply;
+    core->activity.iface.send_invite = &ActivitySendInvite;
+    core->activity.iface.accept_invite = &ActivityAcceptInvite;
+
+    Attach(core->relationship, core);
+    core->relationship.iface.filter = &RelationshipFilter;
+    core->relationship.iface.count = &RelationshipCount;
+    core->relationship.iface.get = &RelationshipGet;
+    core->relationship.iface.get_at = &RelationshipGetAt;
+
+    Attach(core->lobby, core);
+    core->lobby.iface.get_lobby_create_transaction = &LobbyGetCreateTransaction;
+    core->lobby.iface.get_lobby_update_transaction = &LobbyGetUpdateTransaction;
+    core->lobby.iface.get_member_update_transaction = &LobbyGetMemberTransaction;
+    core->lobby.iface.create_lobby = &LobbyCreate;
+    core->lobby.iface.update_lobby = &LobbyUpdate;
+    core->lobby.iface.delete_lobby = &LobbyDelete;
+    core->lobby.iface.connect_lobby = &LobbyConnect;
+    core->lobby.iface.connect_lobby_with_activity_secret = &LobbyConnectWithActivitySecret;
+    core->lobby.iface.disconnect_lobby = &LobbyDisconnect;
+    core->lobby.iface.get_lobby = &LobbyGet;
+    core->lobby.iface.get_lobby_activity_secret = &LobbyGetActivitySecret;
+    core->lobby.iface.get_lobby_metadata_value = &LobbyGetMetadataValue;
+    core->lobby.iface.get_lobby_metadata_key = &LobbyGetMetadataKey;
+    core->lobby.iface.lobby_metadata_count = &LobbyMetadataCount;
+    core->lobby.iface.member_count = &LobbyMemberCount;
+    core->lobby.iface.get_member_user_id = &LobbyGetMemberUserId;
+    core->lobby.iface.get_member_user = &LobbyGetMemberUser;
+    core->lobby.iface.get_member_metadata_value = &LobbyGetMemberMetadataValue;
+    core->lobby.iface.get_member_metadata_key = &LobbyGetMemberMetadataKey;
+    core->lobby.iface.member_metadata_count = &LobbyMemberMetadataCount;
+    core->lobby.iface.update_member = &LobbyUpdateMember;
+    core->lobby.iface.send_lobby_message = &LobbySendMessage;
+    core->lobby.iface.get_search_query = &LobbyGetSearchQuery;
+    core->lobby.iface.search = &LobbySearch;
+    core->lobby.iface.lobby_count = &LobbyCount;
+    core->lobby.iface.get_lobby_id = &LobbyGetLobbyId;
+    core->lobby.iface.connect_voice = &LobbyConnectVoice;
+    core->lobby.iface.disconnect_voice = &LobbyDisconnectVoice;
+    core->lobby.iface.connect_network = &LobbyConnectNetwork;
+    core->lobby.iface.disconnect_network = &LobbyDisconnectNetwork;
+    core->lobby.iface.flush_network = &LobbyFlushNetwork;
+    core->lobby.iface.open_network_channel = &LobbyOpenNetworkChannel;
+    core->lobby.iface.send_network_message = &LobbySendNetworkMessage;
+
+    Attach(core->network, core);
+    core->network.iface.get_peer_id = &NetGetPeerId;
+    core->network.iface.flush = &NetFlush;
+    core->network.iface.open_peer = &NetOpenPeer;
+    core->network.iface.update_peer = &NetUpdatePeer;
+    core->network.iface.close_peer = &NetClosePeer;
+    core->network.iface.open_channel = &NetOpenChannel;
+    core->network.iface.close_channel = &NetCloseChannel;
+    core->network.iface.send_message = &NetSendMessage;
+
+    Attach(core->overlay, core);
+    core->overlay.iface.is_enabled = &OverlayIsEnabled;
+    core->overlay.iface.is_locked = &OverlayIsLocked;
+    core->overlay.iface.set_locked = &OverlaySetLocked;
+    core->overlay.iface.open_activity_invite = &OverlayOpenActivityInvite;
+    core->overlay.iface.open_guild_invite = &OverlayOpenGuildInvite;
+    core->overlay.iface.open_voice_settings = &OverlayOpenVoiceSettings;
+    core->overlay.iface.init_drawing_dxgi = &OverlayInitDrawingDxgi;
+    core->overlay.iface.on_present = &OverlayOnPresent;
+    core->overlay.iface.forward_message = &OverlayForwardMessage;
+    core->overlay.iface.key_event = &OverlayKeyEvent;
+    core->overlay.iface.char_event = &OverlayCharEvent;
+    core->overlay.iface.mouse_button_event = &OverlayMouseButtonEvent;
+    core->overlay.iface.mouse_motion_event = &OverlayMouseMotionEvent;
+    core->overlay.iface.ime_commit_text = &OverlayImeCommitText;
+    core->overlay.iface.ime_set_composition = &OverlayImeSetComposition;
+    core->overlay.iface.ime_cancel_composition = &OverlayImeCancelComposition;
+    core->overlay.iface.set_ime_composition_range_callback =
+      &OverlaySetImeCompositionRangeCallback;
+    core->overlay.iface.set_ime_selection_bounds_callback = &OverlaySetImeSelectionBoundsCallback;
+    core->overlay.iface.is_point_inside_click_zone = &OverlayIsPointInsideClickZone;
+
+    Attach(core->storage, core);
+    core->storage.iface.read = &StorageRead;
+    core->storage.iface.read_async = &StorageReadAsync;
+    core->storage.iface.read_async_partial = &StorageReadAsyncPartial;
+    core->storage.iface.write = &StorageWrite;
+    core->storage.iface.write_async = &StorageWriteAsync;
+    core->storage.iface.delete_ = &StorageDelete;
+    core->storage.iface.exists = &StorageExists;
+    core->storage.iface.count = &StorageCount;
+    core->storage.iface.stat = &StorageStat;
+    core->storage.iface.stat_at = &StorageStatAt;
+    core->storage.iface.get_path = &StorageGetPath;
+
+    Attach(core->store, core);
+    core->store.iface.fetch_skus = &StoreFetchSkus;
+    core->store.iface.count_skus = &StoreCount;
+    core->store.iface.get_sku = &StoreGetSku;
+    core->store.iface.get_sku_at = &StoreGetSkuAt;
+    core->store.iface.fetch_entitlements = &StoreFetchEntitlements;
+    core->store.iface.count_entitlements = &StoreCount;
+    core->store.iface.get_entitlement = &StoreGetEntitlement;
+    core->store.iface.get_entitlement_at = &StoreGetEntitlementAt;
+    core->store.iface.has_sku_entitlement = &StoreHasSkuEntitlement;
+    core->store.iface.start_purchase = &StoreStartPurchase;
+
+    Attach(core->voice, core);
+    core->voice.iface.get_input_mode = &VoiceGetInputMode;
+    core->voice.iface.set_input_mode = &VoiceSetInputMode;
+    core->voice.iface.is_self_mute = &VoiceIsSelfMute;
+    core->voice.iface.set_self_mute = &VoiceSetSelfMute;
+    core->voice.iface.is_self_deaf = &VoiceIsSelfDeaf;
+    core->voice.iface.set_self_deaf = &VoiceSetSelfDeaf;
+    core->voice.iface.is_local_mute = &VoiceIsLocalMute;
+    core->voice.iface.set_local_mute = &VoiceSetLocalMute;
+    core->voice.iface.get_local_volume = &VoiceGetLocalVolume;
+    core->voice.iface.set_local_volume = &VoiceSetLocalVolume;
+
+    Attach(core->achievement, core);
+    core->achievement.iface.set_user_achievement = &AchievementSet;
+    core->achievement.iface.fetch_user_achievements = &AchievementFetch;
+    core->achievement.iface.count_user_achievements = &AchievementCount;
+    core->achievement.iface.get_user_achievement = &AchievementGet;
+    core->achievement.iface.get_user_achievement_at = &AchievementGetAt;
+
+    return core;
+}
+
+} // namespace
+
+void SetConfig(Config const& config)
+{
+    auto& world = GetWorld();
+    Lock lock(world.mutex);
+    world.config = config;
+    world.rng.seed(config.seed);
+}
+
+Config GetConfig()
+{
+    auto& world = GetWorld();
+    Lock lock(world.mutex);
+    return world.config;
+}
+
+void Reset()
+{
+    auto& world = GetWorld();
+    Lock lock(world.mutex);
+    world.lobbies.clear();
+    world.storage.clear();
+    world.nextUserId = 100000;
+    world.nextLobbyId = 1;
+    world.rng.seed(world.config.seed);
+}
+
+} // namespace mock
+} // namespace discord
+
+enum EDiscordResult DISCORD_API DiscordCreate(DiscordVersion version,
+                                              struct DiscordCreateParams* params,
+                                              struct IDiscordCore** result)
+{
+    using namespace discord::mock;
+
+    if (!params || !result) {
+        return DiscordResult_InternalError;
+    }
+    *result = nullptr;
+    if (version != DISCORD_VERSION) {
+        return DiscordResult_InvalidVersion;
+    }
+
+    auto& world = GetWorld();
+    Lock lock(world.mutex);
+    if (world.config.createResult != DiscordResult_Ok) {
+        return world.config.createResult;
+    }
+
+    auto userId = world.config.userId != 0 ? world.config.userId : world.nextUserId++;
+    auto* core = NewCore(*params, userId);
+    world.cores.push_back(core);
+
+    auto* events = params->network_events;
+    if (events && events->on_route_update) {
+        auto* data = params->event_data;
+        auto route = "mock:" + std::to_string(userId);
+        Post(core, [events, data, route]() { events->on_route_update(data, route.c_str()); });
+    }
+
+    *result = &core->core.iface;
+    return DiscordResult_Ok;
+}
+
+#endif
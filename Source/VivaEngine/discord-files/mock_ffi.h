@@ -0,0 +1,47 @@
+#pragma once
+
+#include "ffi.h"
+
+#include <cstdint>
+
+// Set to 1 to link the wrappers against the in-process fake below instead of the
+// discord_game_sdk library. VivaEngine.Build.cs defines this for targets without the SDK.
+#if !defined(DISCORD_MOCK_FFI)
+#define DISCORD_MOCK_FFI 0
+#endif
+
+namespace discord {
+namespace mock {
+
+/**
+ * Behaviour of the fake SDK. All cores created in the process share one simulated Discord: lobbies
+ * created by one core can be joined by another, and lobby/peer network messages are routed between
+ * them, which makes two cores in one process a loopback pair.
+ */
+struct Config {
+    // Number of RunCallbacks() calls an async request, event or network message waits before it is
+    // delivered. Zero delivers on the next RunCallbacks(), the SDK never completes inline.
+    std::uint32_t latencyTicks{0};
+    // Probability in [0, 1] that an async request completes with failureResult instead of Ok.
+    float failureRate{0.f};
+    EDiscordResult failureResult{DiscordResult_ServiceUnavailable};
+    // Probability in [0, 1] that a message on an unreliable channel is silently dropped.
+    float unreliableDropRate{0.f};
+    // Result returned by DiscordCreate, e.g. NotRunning to exercise the "no client" path.
+    EDiscordResult createResult{DiscordResult_Ok};
+    // User id for the next created core. Zero hands out a fresh id per core; a fixed id keeps the
+    // same in-memory storage across core re-creation, like a real user restarting the game.
+    std::int64_t userId{0};
+    std::uint32_t seed{1};
+};
+
+void SetConfig(Config const& config);
+Config GetConfig();
+
+/**
+ * Drops all shared state (lobbies, user ids, RNG). Cores must be destroyed first.
+ */
+void Reset();
+
+} // namespace mock
+} // namespace discord
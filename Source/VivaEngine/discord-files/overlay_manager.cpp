@@ -4,6 +4,7 @@
 
 #include "overlay_manager.h"
 
+#include "callback_pool.h"
 #include "core.h"
 
 #include <cstring>
@@ -47,66 +48,42 @@ void OverlayManager::IsLocked(bool* locked)
     internal_->is_locked(internal_, reinterpret_cast<bool*>(locked));
 }
 
-void OverlayManager::SetLocked(bool locked, std::function<void(Result)> callback)
+void OverlayManager::SetLocked(bool locked, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->set_locked(internal_, (locked ? 1 : 0), cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->set_locked(internal_, (locked ? 1 : 0), cb.ToCallbackData(), wrapper);
 }
 
 void OverlayManager::OpenActivityInvite(ActivityActionType type,
-                                        std::function<void(Result)> callback)
+                                        InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
     internal_->open_activity_invite(
-      internal_, static_cast<EDiscordActivityActionType>(type), cb.release(), wrapper);
+      internal_, static_cast<EDiscordActivityActionType>(type), cb.ToCallbackData(), wrapper);
 }
 
-void OverlayManager::OpenGuildInvite(char const* code, std::function<void(Result)> callback)
+void OverlayManager::OpenGuildInvite(char const* code, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->open_guild_invite(internal_, const_cast<char*>(code), cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->open_guild_invite(internal_, const_cast<char*>(code), cb.ToCallbackData(), wrapper);
 }
 
-void OverlayManager::OpenVoiceSettings(std::function<void(Result)> callback)
+void OverlayManager::OpenVoiceSettings(InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->open_voice_settings(internal_, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->open_voice_settings(internal_, cb.ToCallbackData(), wrapper);
 }
 
 Result OverlayManager::InitDrawingDxgi(IDXGISwapChain* swapchain, bool useMessageForwarding)
@@ -179,7 +156,7 @@ void OverlayManager::ImeCancelComposition()
 }
 
 void OverlayManager::SetImeCompositionRangeCallback(
-  std::function<void(std::int32_t, std::int32_t, Rect*, std::uint32_t)>
+  InlineDelegate<void(std::int32_t, std::int32_t, Rect*, std::uint32_t)>
     onImeCompositionRangeChanged)
 {
     static auto wrapper = [](void* callbackData,
@@ -187,37 +164,26 @@ void OverlayManager::SetImeCompositionRangeCallback(
                              int32_t to,
                              DiscordRect* bounds,
                              uint32_t boundsLength) -> void {
-        std::unique_ptr<std::function<void(std::int32_t, std::int32_t, Rect*, std::uint32_t)>> cb(
-          reinterpret_cast<std::function<void(std::int32_t, std::int32_t, Rect*, std::uint32_t)>*>(
-            callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(from, to, reinterpret_cast<Rect*>(bounds), boundsLength);
+        CallbackPool<void(std::int32_t, std::int32_t, Rect*, std::uint32_t)>::Dispatch(
+          callbackData, from, to, reinterpret_cast<Rect*>(bounds), boundsLength);
     };
-    std::unique_ptr<std::function<void(std::int32_t, std::int32_t, Rect*, std::uint32_t)>> cb{};
-    cb.reset(new std::function<void(std::int32_t, std::int32_t, Rect*, std::uint32_t)>(
-      std::move(onImeCompositionRangeChanged)));
-    internal_->set_ime_composition_range_callback(internal_, cb.release(), wrapper);
+    auto cb = CallbackPool<void(std::int32_t, std::int32_t, Rect*, std::uint32_t)>::Acquire(
+      std::move(onImeCompositionRangeChanged));
+    internal_->set_ime_composition_range_callback(internal_, cb.ToCallbackData(), wrapper);
 }
 
 void OverlayManager::SetImeSelectionBoundsCallback(
-  std::function<void(Rect, Rect, bool)> onImeSelectionBoundsChanged)
+  InlineDelegate<void(Rect, Rect, bool)> onImeSelectionBoundsChanged)
 {
     static auto wrapper =
       [](void* callbackData, DiscordRect anchor, DiscordRect focus, bool isAnchorFirst) -> void {
-        std::unique_ptr<std::function<void(Rect, Rect, bool)>> cb(
-          reinterpret_cast<std::function<void(Rect, Rect, bool)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(*reinterpret_cast<Rect const*>(&anchor),
-              *reinterpret_cast<Rect const*>(&focus),
-              (isAnchorFirst != 0));
+        CallbackPool<void(Rect, Rect, bool)>::Dispatch(callbackData,
+                                                       *reinterpret_cast<Rect const*>(&anchor),
+                                                       *reinterpret_cast<Rect const*>(&focus),
+                                                       (isAnchorFirst != 0));
     };
-    std::unique_ptr<std::function<void(Rect, Rect, bool)>> cb{};
-    cb.reset(new std::function<void(Rect, Rect, bool)>(std::move(onImeSelectionBoundsChanged)));
-    internal_->set_ime_selection_bounds_callback(internal_, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Rect, Rect, bool)>::Acquire(std::move(onImeSelectionBoundsChanged));
+    internal_->set_ime_selection_bounds_callback(internal_, cb.ToCallbackData(), wrapper);
 }
 
 bool OverlayManager::IsPointInsideClickZone(std::int32_t x, std::int32_t y)
@@ -10,10 +10,10 @@ public:
 
     void IsEnabled(bool* enabled);
     void IsLocked(bool* locked);
-    void SetLocked(bool locked, std::function<void(Result)> callback);
-    void OpenActivityInvite(ActivityActionType type, std::function<void(Result)> callback);
-    void OpenGuildInvite(char const* code, std::function<void(Result)> callback);
-    void OpenVoiceSettings(std::function<void(Result)> callback);
+    void SetLocked(bool locked, InlineDelegate<void(Result)> callback);
+    void OpenActivityInvite(ActivityActionType type, InlineDelegate<void(Result)> callback);
+    void OpenGuildInvite(char const* code, InlineDelegate<void(Result)> callback);
+    void OpenVoiceSettings(InlineDelegate<void(Result)> callback);
     Result InitDrawingDxgi(IDXGISwapChain* swapchain, bool useMessageForwarding);
     void OnPresent();
     void ForwardMessage(MSG* message);
@@ -33,10 +33,10 @@ public:
                            std::int32_t to);
     void ImeCancelComposition();
     void SetImeCompositionRangeCallback(
-      std::function<void(std::int32_t, std::int32_t, Rect*, std::uint32_t)>
+      InlineDelegate<void(std::int32_t, std::int32_t, Rect*, std::uint32_t)>
         onImeCompositionRangeChanged);
     void SetImeSelectionBoundsCallback(
-      std::function<void(Rect, Rect, bool)> onImeSelectionBoundsChanged);
+      InlineDelegate<void(Rect, Rect, bool)> onImeSelectionBoundsChanged);
     bool IsPointInsideClickZone(std::int32_t x, std::int32_t y);
 
     Event<bool> OnToggle;
@@ -51,9 +51,8 @@ void RelationshipManager::Filter(std::function<bool(Relationship const&)> filter
         }
         return (*cb)(*reinterpret_cast<Relationship const*>(relationship));
     };
-    std::unique_ptr<std::function<bool(Relationship const&)>> cb{};
-    cb.reset(new std::function<bool(Relationship const&)>(std::move(filter)));
-    internal_->filter(internal_, cb.get(), wrapper);
+    // The SDK invokes the filter synchronously, so it can run straight off the argument.
+    internal_->filter(internal_, &filter, wrapper);
 }
 
 Result RelationshipManager::Count(std::int32_t* count)
@@ -2,6 +2,8 @@
 
 #include "types.h"
 
+#include <functional>
+
 namespace discord {
 
 class RelationshipManager final {
@@ -4,6 +4,7 @@
 
 #include "storage_manager.h"
 
+#include "callback_pool.h"
 #include "core.h"
 
 #include <cstring>
@@ -29,43 +30,33 @@ Result StorageManager::Read(char const* name,
 }
 
 void StorageManager::ReadAsync(char const* name,
-                               std::function<void(Result, std::uint8_t*, std::uint32_t)> callback)
+                               InlineDelegate<void(Result, std::uint8_t*, std::uint32_t)> callback)
 {
     static auto wrapper =
       [](void* callbackData, EDiscordResult result, uint8_t* data, uint32_t dataLength) -> void {
-        std::unique_ptr<std::function<void(Result, std::uint8_t*, std::uint32_t)>> cb(
-          reinterpret_cast<std::function<void(Result, std::uint8_t*, std::uint32_t)>*>(
-            callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result), data, dataLength);
+        CallbackPool<void(Result, std::uint8_t*, std::uint32_t)>::Dispatch(
+          callbackData, static_cast<Result>(result), data, dataLength);
     };
-    std::unique_ptr<std::function<void(Result, std::uint8_t*, std::uint32_t)>> cb{};
-    cb.reset(new std::function<void(Result, std::uint8_t*, std::uint32_t)>(std::move(callback)));
-    internal_->read_async(internal_, const_cast<char*>(name), cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result, std::uint8_t*, std::uint32_t)>::Acquire(
+      std::move(callback));
+    internal_->read_async(internal_, const_cast<char*>(name), cb.ToCallbackData(), wrapper);
 }
 
 void StorageManager::ReadAsyncPartial(
   char const* name,
   std::uint64_t offset,
   std::uint64_t length,
-  std::function<void(Result, std::uint8_t*, std::uint32_t)> callback)
+  InlineDelegate<void(Result, std::uint8_t*, std::uint32_t)> callback)
 {
     static auto wrapper =
       [](void* callbackData, EDiscordResult result, uint8_t* data, uint32_t dataLength) -> void {
-        std::unique_ptr<std::function<void(Result, std::uint8_t*, std::uint32_t)>> cb(
-          reinterpret_cast<std::function<void(Result, std::uint8_t*, std::uint32_t)>*>(
-            callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result), data, dataLength);
+        CallbackPool<void(Result, std::uint8_t*, std::uint32_t)>::Dispatch(
+          callbackData, static_cast<Result>(result), data, dataLength);
     };
-    std::unique_ptr<std::function<void(Result, std::uint8_t*, std::uint32_t)>> cb{};
-    cb.reset(new std::function<void(Result, std::uint8_t*, std::uint32_t)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result, std::uint8_t*, std::uint32_t)>::Acquire(
+      std::move(callback));
     internal_->read_async_partial(
-      internal_, const_cast<char*>(name), offset, length, cb.release(), wrapper);
+      internal_, const_cast<char*>(name), offset, length, cb.ToCallbackData(), wrapper);
 }
 
 Result StorageManager::Write(char const* name, std::uint8_t* data, std::uint32_t dataLength)
@@ -78,23 +69,17 @@ Result StorageManager::Write(char const* name, std::uint8_t* data, std::uint32_t
 void StorageManager::WriteAsync(char const* name,
                                 std::uint8_t* data,
                                 std::uint32_t dataLength,
-                                std::function<void(Result)> callback)
+                                InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
     internal_->write_async(internal_,
                            const_cast<char*>(name),
                            reinterpret_cast<uint8_t*>(data),
                            dataLength,
-                           cb.release(),
+                           cb.ToCallbackData(),
                            wrapper);
 }
 
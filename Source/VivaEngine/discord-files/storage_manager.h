@@ -13,16 +13,16 @@ public:
                 std::uint32_t dataLength,
                 std::uint32_t* read);
     void ReadAsync(char const* name,
-                   std::function<void(Result, std::uint8_t*, std::uint32_t)> callback);
+                   InlineDelegate<void(Result, std::uint8_t*, std::uint32_t)> callback);
     void ReadAsyncPartial(char const* name,
                           std::uint64_t offset,
                           std::uint64_t length,
-                          std::function<void(Result, std::uint8_t*, std::uint32_t)> callback);
+                          InlineDelegate<void(Result, std::uint8_t*, std::uint32_t)> callback);
     Result Write(char const* name, std::uint8_t* data, std::uint32_t dataLength);
     void WriteAsync(char const* name,
                     std::uint8_t* data,
                     std::uint32_t dataLength,
-                    std::function<void(Result)> callback);
+                    InlineDelegate<void(Result)> callback);
     Result Delete(char const* name);
     Result Exists(char const* name, bool* exists);
     void Count(std::int32_t* count);
@@ -4,6 +4,7 @@
 
 #include "store_manager.h"
 
+#include "callback_pool.h"
 #include "core.h"
 
 #include <cstring>
@@ -43,19 +44,13 @@ IDiscordStoreEvents StoreManager::events_{
   &StoreEvents::OnEntitlementDelete,
 };
 
-void StoreManager::FetchSkus(std::function<void(Result)> callback)
+void StoreManager::FetchSkus(InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->fetch_skus(internal_, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->fetch_skus(internal_, cb.ToCallbackData(), wrapper);
 }
 
 void StoreManager::CountSkus(std::int32_t* count)
@@ -87,19 +82,13 @@ Result StoreManager::GetSkuAt(std::int32_t index, Sku* sku)
     return static_cast<Result>(result);
 }
 
-void StoreManager::FetchEntitlements(std::function<void(Result)> callback)
+void StoreManager::FetchEntitlements(InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->fetch_entitlements(internal_, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->fetch_entitlements(internal_, cb.ToCallbackData(), wrapper);
 }
 
 void StoreManager::CountEntitlements(std::int32_t* count)
@@ -144,19 +133,13 @@ Result StoreManager::HasSkuEntitlement(Snowflake skuId, bool* hasEntitlement)
     return static_cast<Result>(result);
 }
 
-void StoreManager::StartPurchase(Snowflake skuId, std::function<void(Result)> callback)
+void StoreManager::StartPurchase(Snowflake skuId, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->start_purchase(internal_, skuId, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->start_purchase(internal_, skuId, cb.ToCallbackData(), wrapper);
 }
 
 } // namespace discord
@@ -4,6 +4,7 @@
 
 #include "user_manager.h"
 
+#include "callback_pool.h"
 #include "core.h"
 
 #include <cstring>
@@ -40,19 +41,14 @@ Result UserManager::GetCurrentUser(User* currentUser)
     return static_cast<Result>(result);
 }
 
-void UserManager::GetUser(UserId userId, std::function<void(Result, User const&)> callback)
+void UserManager::GetUser(UserId userId, InlineDelegate<void(Result, User const&)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result, DiscordUser* user) -> void {
-        std::unique_ptr<std::function<void(Result, User const&)>> cb(
-          reinterpret_cast<std::function<void(Result, User const&)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result), *reinterpret_cast<User const*>(user));
+        CallbackPool<void(Result, User const&)>::Dispatch(
+          callbackData, static_cast<Result>(result), *reinterpret_cast<User const*>(user));
     };
-    std::unique_ptr<std::function<void(Result, User const&)>> cb{};
-    cb.reset(new std::function<void(Result, User const&)>(std::move(callback)));
-    internal_->get_user(internal_, userId, cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result, User const&)>::Acquire(std::move(callback));
+    internal_->get_user(internal_, userId, cb.ToCallbackData(), wrapper);
 }
 
 Result UserManager::GetCurrentUserPremiumType(PremiumType* premiumType)
@@ -9,7 +9,7 @@ public:
     ~UserManager() = default;
 
     Result GetCurrentUser(User* currentUser);
-    void GetUser(UserId userId, std::function<void(Result, User const&)> callback);
+    void GetUser(UserId userId, InlineDelegate<void(Result, User const&)> callback);
     Result GetCurrentUserPremiumType(PremiumType* premiumType);
     Result CurrentUserHasFlag(UserFlag flag, bool* hasFlag);
 
@@ -4,6 +4,7 @@
 
 #include "voice_manager.h"
 
+#include "callback_pool.h"
 #include "core.h"
 
 #include <cstring>
@@ -40,20 +41,16 @@ Result VoiceManager::GetInputMode(InputMode* inputMode)
     return static_cast<Result>(result);
 }
 
-void VoiceManager::SetInputMode(InputMode inputMode, std::function<void(Result)> callback)
+void VoiceManager::SetInputMode(InputMode inputMode, InlineDelegate<void(Result)> callback)
 {
     static auto wrapper = [](void* callbackData, EDiscordResult result) -> void {
-        std::unique_ptr<std::function<void(Result)>> cb(
-          reinterpret_cast<std::function<void(Result)>*>(callbackData));
-        if (!cb || !(*cb)) {
-            return;
-        }
-        (*cb)(static_cast<Result>(result));
+        CallbackPool<void(Result)>::Dispatch(callbackData, static_cast<Result>(result));
     };
-    std::unique_ptr<std::function<void(Result)>> cb{};
-    cb.reset(new std::function<void(Result)>(std::move(callback)));
-    internal_->set_input_mode(
-      internal_, *reinterpret_cast<DiscordInputMode const*>(&inputMode), cb.release(), wrapper);
+    auto cb = CallbackPool<void(Result)>::Acquire(std::move(callback));
+    internal_->set_input_mode(internal_,
+                              *reinterpret_cast<DiscordInputMode const*>(&inputMode),
+                              cb.ToCallbackData(),
+                              wrapper);
 }
 
 Result VoiceManager::IsSelfMute(bool* mute)
@@ -9,7 +9,7 @@ public:
     ~VoiceManager() = default;
 
     Result GetInputMode(InputMode* inputMode);
-    void SetInputMode(InputMode inputMode, std::function<void(Result)> callback);
+    void SetInputMode(InputMode inputMode, InlineDelegate<void(Result)> callback);
     Result IsSelfMute(bool* mute);
     Result SetSelfMute(bool mute);
     Result IsSelfDeaf(bool* deaf);